@@ -66,6 +66,12 @@ class MleDppActor : public MleDwpActor, public MleDppItem
 	 */
 	virtual int write(MleDppActorGroupOutput *out);
 
+	/**
+	 * Add the string property values of the actor, including those it
+	 * gets from templates, to the string pool of the output.
+	 */
+	void internStrings(MleDppActorGroupOutput *out);
+
 	/**
 	 * Override operator new.
 	 *
@@ -99,6 +105,14 @@ class MleDppActor : public MleDwpActor, public MleDppItem
 	/**
 	 */
 	virtual int writeContents(MleDppActorGroupOutput *out);
+
+	/**
+	 * Find the class of the actor, following any templates, and make it
+	 * the current actor class of the output.
+	 *
+	 * @return The runtime index of the actor class.
+	 */
+	int findActorClass(MleDppActorGroupOutput *out);
 };
 
 #endif /* __MLE_DPP_ACTOR_H_ */
@@ -98,6 +98,17 @@ class MleDppActorGroupOutput
 		char* actorIDfilename, 
 		char* groupIDfilename);
 
+	/**
+	 * @brief Initialize the class with index tables that are already built.
+	 *
+	 * The tables are shared, not owned; they must have been built with
+	 * the workprint's discriminators set and must outlive this object.
+	 */
+	MlBoolean init(
+		MleDppTblMgr* table,
+		char* actorIDfilename, 
+		char* groupIDfilename);
+
 	/**
 	 * @brief Set output sink for Digital Playprint.
 	 *
@@ -135,6 +146,12 @@ class MleDppActorGroupOutput
     MlScalarType getScalarFormat(void)
 	{ return m_scalarFormat; };
 
+	/**
+	 * Check whether writeScalar() converts to 16.16 fixed point.
+	 */
+    MlBoolean getConvertFloatToFixed(void)
+	{ return m_convertFloatToFixed != 0; };
+
 	/**
 	 * @brief Set the path for the generated output.
 	 *
@@ -159,6 +176,260 @@ class MleDppActorGroupOutput
 	 */
 	static void setVerbosity(MlBoolean verbose);
 
+	/**
+	 * @brief Emit an actor directory with each group chunk.
+	 *
+	 * The directory lets the runtime find and decode single actors
+	 * of a group. Each actor is written so that it does not depend on
+	 * the property offset or length set by the actor before it.
+	 *
+	 * @param enable Set to <b>true</b> to emit the directory.
+	 */
+	static void setActorDirectory(MlBoolean enable);
+
+	/**
+	 * @brief Leave out properties that equal their class default.
+	 *
+	 * The default of a property is the value given for it under the
+	 * MleDwpActorDef of the actor's class, found through the actor's
+	 * templates. Actors are constructed with those values, so writing
+	 * them again only costs chunk space and load time.
+	 *
+	 * @param enable Set to <b>true</b> to leave out default properties.
+	 */
+	static void setElideDefaults(MlBoolean enable);
+
+	/**
+	 * @brief Check whether default properties are left out.
+	 */
+	static MlBoolean getElideDefaults(void)
+	{ return g_elideDefaults; };
+
+	/**
+	 * @brief Divert the output to memory.
+	 *
+	 * Items written until endCapture() do not reach the chunk. The
+	 * property offset and length are forgotten while capturing, so an
+	 * item always encodes the same way, and are restored afterwards.
+	 */
+	void beginCapture(void);
+
+	/**
+	 * @brief Stop diverting the output to memory.
+	 *
+	 * @param length Set to the number of bytes captured.
+	 *
+	 * @return The captured bytes are returned. They are valid until
+	 * the next capture.
+	 */
+	const unsigned char *endCapture(int *length);
+
+	/**
+	 * @brief Count a property left out of an actor of the current class.
+	 *
+	 * @param bytes The size of the property as it would have been written.
+	 */
+	void addElided(int bytes);
+
+	/**
+	 * @brief Print the properties left out, and the bytes saved, for
+	 * each actor class.
+	 *
+	 * @param fp The file to print to.
+	 */
+	void reportElided(FILE *fp);
+
+	/**
+	 * @brief Write actors that repeat an earlier actor of their group
+	 * as clones of it.
+	 *
+	 * A clone names the earlier actor and is followed only by the
+	 * properties that differ from it. Clones are not written when the
+	 * group has an actor directory, since a directory entry must decode
+	 * on its own.
+	 *
+	 * @param enable Set to <b>true</b> to write clones.
+	 */
+	static void setCloneActors(MlBoolean enable);
+
+	/**
+	 * @brief Check whether actors are written as clones.
+	 */
+	static MlBoolean getCloneActors(void)
+	{ return g_cloneActors && ! g_actorDirectory; };
+
+	/**
+	 * @brief Write the properties of each actor ordered to share
+	 * property offset and length opcodes.
+	 *
+	 * Properties of the same length are written together, in runtime
+	 * offset order, so one setPropertyLengthOpcode serves the run.
+	 * Roles follow the properties.
+	 *
+	 * @param enable Set to <b>true</b> to order properties.
+	 */
+	static void setOrderProperties(MlBoolean enable);
+
+	/**
+	 * @brief Check whether properties are ordered.
+	 */
+	static MlBoolean getOrderProperties(void)
+	{ return g_orderProperties; };
+
+	/**
+	 * @brief Write the properties of an actor in the order that needs
+	 * the fewest property offset and length opcodes.
+	 *
+	 * @param properties The properties, each as captured by
+	 * beginCapture() and endCapture(); NULL entries are skipped.
+	 * @param lengths The length of each property.
+	 * @param numProperties The number of entries in properties.
+	 * @param inherited Properties set to <b>true</b> are skipped; may be
+	 * NULL.
+	 */
+	int writeProperties(unsigned char **properties, const int *lengths,
+		int numProperties, const MlBoolean *inherited);
+
+	/**
+	 * @brief Print the opcodes and bytes that ordering properties saved.
+	 *
+	 * @param fp The file to print to.
+	 */
+	void reportOrdering(FILE *fp);
+
+	/**
+	 * @brief Keep the strings of each group in a string pool.
+	 *
+	 * Each distinct string property value of a group is written once,
+	 * ahead of the actors, and string properties name it by index.
+	 *
+	 * @param enable Set to <b>true</b> to pool strings.
+	 */
+	static void setStringPool(MlBoolean enable);
+
+	/**
+	 * @brief Check whether strings are pooled.
+	 */
+	static MlBoolean getStringPool(void)
+	{ return g_stringPool; };
+
+	/**
+	 * @brief Add a string to the pool of the current group chunk.
+	 *
+	 * @return The index of the string in the pool is returned.
+	 */
+	int internString(const char *s);
+
+	/**
+	 * @brief Find a string in the pool of the current group chunk.
+	 *
+	 * @return The index of the string is returned, or -1 if the pool of
+	 * the current chunk does not hold it.
+	 */
+	int findString(const char *s);
+
+	/**
+	 * @brief Write the string pool of the current group chunk.
+	 *
+	 * It must follow the group header and come before the first actor.
+	 * Nothing is written if the pool is empty.
+	 */
+	int writeStringPool(void);
+
+	/**
+	 * @brief Write the array properties of a class in a smaller encoding.
+	 *
+	 * The encodings are described in agopcode.h. An array is still
+	 * written in full if its values do not suit the encoding or the
+	 * encoding would not make it smaller.
+	 *
+	 * @param className The actor or set class, or NULL to forget every
+	 * setting.
+	 * @param property The property, or NULL for every array property of
+	 * the class. A property setting wins over a class setting.
+	 * @param encoding halfArrayEncoding, norm16ArrayEncoding,
+	 * deltaArrayEncoding, or 0 to write the arrays in full.
+	 */
+	static void setArrayEncoding(const char *className, const char *property,
+		int encoding);
+
+	/**
+	 * @brief Get the encoding set for the current property.
+	 *
+	 * @return The encoding is returned, or 0 if the property is written
+	 * in full.
+	 */
+	int getArrayEncoding(void);
+
+	/**
+	 * @brief Write the current property as an encoded float array.
+	 *
+	 * @param byteLength The size of one element.
+	 * @param values numElements * components floats.
+	 * @param numElements The number of elements.
+	 * @param components The number of floats in an element.
+	 * @param encoding halfArrayEncoding or norm16ArrayEncoding.
+	 *
+	 * @return 0 is returned if the array was written, or 1 if nothing was
+	 * written because the values do not suit the encoding or it would
+	 * save nothing.
+	 */
+	int writeEncodedFloatArray(int byteLength, const float *values,
+		int numElements, int components, int encoding);
+
+	/**
+	 * @brief Write the current property as an encoded int array.
+	 *
+	 * @param values numElements ints.
+	 * @param numElements The number of elements.
+	 * @param encoding deltaArrayEncoding.
+	 *
+	 * @return 0 is returned if the array was written, or 1 if nothing was
+	 * written because the encoding would save nothing.
+	 */
+	int writeEncodedIntArray(const int *values, int numElements, int encoding);
+
+	/**
+	 * @brief Start an actor, as a clone of an earlier actor of the group
+	 * when that leaves less to write.
+	 *
+	 * An earlier actor of the same class qualifies if the new actor sets
+	 * every property it set. The one whose fixed-length property values
+	 * match the most bytes is chosen.
+	 *
+	 * @param actorClass The runtime index of the actor's class.
+	 * @param properties The actor's properties, each as captured by
+	 * beginCapture() and endCapture(); NULL entries are skipped.
+	 * @param lengths The length of each property.
+	 * @param numProperties The number of entries in properties.
+	 * @param inherited Set to <b>true</b> for each property the clone
+	 * inherits; those must not be written.
+	 */
+	void writeActorStart(int actorClass, unsigned char **properties,
+		const int *lengths, int numProperties, MlBoolean *inherited);
+
+	/**
+	 * @brief Write a property captured by beginCapture() and endCapture().
+	 *
+	 * The property offset and length are only written where they differ
+	 * from the current ones, as if the property were written directly.
+	 */
+	int writeCaptured(const unsigned char *data, int length);
+
+	/**
+	 * @brief Mark the start of an actor in the current group chunk.
+	 *
+	 * This is called just before the createActorOpcode is written.
+	 *
+	 * @param actorClass The runtime index of the actor's class.
+	 */
+	void beginActor(int actorClass);
+
+	/**
+	 * @brief Mark the end of the last actor in the current group chunk.
+	 */
+	void endActors(void);
+
 	// output functions
 	//   write{String,Int,Float,Char} write an item of the indicated
 	//   type to the output.  All the functions return FALSE if an
@@ -196,6 +467,9 @@ class MleDppActorGroupOutput
 	/** The table manager for generated output. */
 	MleDppTblMgr *m_table;
 
+	/** Whether m_table is deleted with this object. */
+	MlBoolean m_ownsTable;
+
 	/** Pointer to an array of Media References. */
 	MleDwpMediaRef** m_references;
     /** The number of Media References in the array. */
@@ -262,10 +536,99 @@ class MleDppActorGroupOutput
 	// The root of the Digital Workprint.
     MleDwpItem *m_root;
 
+	// The actor directory of the current group chunk, as
+	// (offset, class) pairs.
+	int *m_actorEntries;
+	int m_numActorEntries;
+	// Offset of the first opcode after the last actor.
+	int m_actorsEnd;
+
+	// Return the current offset in the group stream.
+	int getStreamOffset(void);
+
+	// Write the actor directory of the current group chunk.
+	int writeActorDirectory(void);
+
+	// Output captured by beginCapture(), and the property offset and
+	// length it put aside.
+	unsigned char *m_capture;
+	int m_captureLength;
+	int m_captureSize;
+	MlBoolean m_capturing;
+	long m_savedOffset;
+	long m_savedLength;
+
+	// The actor classes with elided properties, and the number of
+	// properties and bytes left out of each.
+	char **m_elidedClasses;
+	int *m_elidedCounts;
+	int m_numElidedClasses;
+
+	// Write bytes to the output, or to the capture buffer.
+	int writeBytes(const void *data, unsigned int length);
+
+	// Write the property offset and length where they differ from the
+	// current ones.
+	void writePropertyState(int byteLength);
+
+	// Write a 16-bit value in the byte order of the chunk.
+	int writeShort(unsigned short s);
+
+	// The actors of the current group chunk, in creation order, as
+	// (class, first property, number of properties) triples, and their
+	// properties as (offset, fixed, hash, data, length) records with the
+	// data held in m_cloneData.
+	int *m_cloneActors;
+	int m_numCloneActors;
+	int *m_cloneProperties;
+	int m_numCloneProperties;
+	unsigned char *m_cloneData;
+	int m_cloneDataLength;
+
+	// Return the bytes an earlier actor saves the new one as a clone, or
+	// -1 if it does not qualify.
+	int getCloneSaving(int actor, const int *records,
+		unsigned char **properties, int numProperties, MlBoolean *inherited);
+
+	// Forget the actors of the current group chunk.
+	void clearCloneActors(void);
+
+	// The property offset and length opcodes, and their bytes, that
+	// ordering properties left out.
+	int m_orderedOpcodes;
+	int m_orderedBytes;
+	// The offset and length the last ordered actor left, and those its
+	// given order would have left, to carry the count to the next actor.
+	long m_orderedOffset, m_orderedLength;
+	long m_givenOffset, m_givenLength;
+
+	// The string pool of the current group chunk, with the hash of each
+	// string to speed up lookups.
+	char **m_poolStrings;
+	int *m_poolHashes;
+	int m_numPoolStrings;
+
+	// Empty the string pool.
+	void clearStringPool(void);
+
 	// The directory path for the generated output.
 	static MlePath *g_outputDir;
 	// Be verbose.
 	static MlBoolean g_verbose;
+	// Emit actor directories.
+	static MlBoolean g_actorDirectory;
+	// Leave out default properties.
+	static MlBoolean g_elideDefaults;
+	// Write clones of repeated actors.
+	static MlBoolean g_cloneActors;
+	// Pool the strings of each group.
+	static MlBoolean g_stringPool;
+	// Order the properties of each actor.
+	static MlBoolean g_orderProperties;
+	// The array encodings, keyed by "class" or "class.property".
+	static char **g_arrayEncodingKeys;
+	static int *g_arrayEncodings;
+	static int g_numArrayEncodings;
 };
 
 
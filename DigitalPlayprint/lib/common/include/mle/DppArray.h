@@ -95,6 +95,16 @@ class MleDppArray : public MleDwpArray, public MleDppDatatype
     virtual int writeElement(MleDppActorGroupOutput *,void *) const = 0;
 
     virtual int write(MleDppActorGroupOutput *out, MleDwpDataUnion *data) const;
+
+    /**
+     * Write the array in the encoding set for the current property.
+     *
+     * @return 0 is returned if the array was written, or 1 if the
+     * datatype or its values do not suit the encoding and nothing was
+     * written. This default never encodes.
+     */
+    virtual int writeEncoded(MleDppActorGroupOutput *out, MleArray<char> *array,
+        int encoding) const;
 	
 	/**
 	 * Override operator new.
@@ -82,6 +82,8 @@ class MleDppFloatArray : public MleDppArray
 
     virtual int writeElement(MleDppActorGroupOutput *out,void *data) const;
 
+    virtual int writeEncoded(MleDppActorGroupOutput *out,MleArray<char> *array,int encoding) const;
+
     /**
 	 * Returns the binary size of a float in bytes.
 	 */
@@ -78,6 +78,8 @@ class MleDppIntArray : public MleDppArray
 	 */
     virtual int writeElement(MleDppActorGroupOutput *out,void *data) const;
 
+    virtual int writeEncoded(MleDppActorGroupOutput *out,MleArray<char> *array,int encoding) const;
+
 	/**
 	 */
 	virtual int getElementSize(void) const;
@@ -60,6 +60,23 @@ class MleDppProperty : public MleDwpProperty, public MleDppItem
 
 	virtual ~MleDppProperty(void);
 
+	/**
+	 * @brief Check whether this property sets the value the actor
+	 * class gives it by default.
+	 *
+	 * The default is the property of the same name under the class's
+	 * MleDwpActorDef. The two are compared as they would be written.
+	 * Media references are resolved per group and never match.
+	 *
+	 * @param out The output the property would be written to.
+	 * @param actorDef The MleDwpActorDef of the actor's class.
+	 * @param length Set to the size of the written property if it
+	 * matches.
+	 *
+	 * @return <b>TRUE</b> is returned if the property can be left out.
+	 */
+	MlBoolean isClassDefault(MleDppActorGroupOutput *out, MleDwpItem *actorDef, int *length);
+
 	/**
 	 * Override operator new.
 	 *
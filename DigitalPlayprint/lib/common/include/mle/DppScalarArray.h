@@ -79,6 +79,8 @@ class MleDppScalarArray : public MleDppArray
 	 */
 	virtual int writeElement(MleDppActorGroupOutput *out,void *data) const;
 
+    virtual int writeEncoded(MleDppActorGroupOutput *out,MleArray<char> *array,int encoding) const;
+
     /**
 	 */
     virtual int getElementSize(void) const;
@@ -82,6 +82,15 @@ class MleDppSceneOutput
 		char* tags,
 		char* sceneIDfilename);
 
+	/**
+	 * @brief Initialize the class with index tables that are already built.
+	 *
+	 * The tables are shared, not owned, and must outlive this object.
+	 */
+	MlBoolean init(
+		MleDppTblMgr* table,
+		char* sceneIDfilename);
+
 	// Set output sink.
 	int openFile(const char *filename);
 
@@ -130,6 +139,10 @@ class MleDppSceneOutput
 
 	int writeIndex(long index);
 
+	// Append a group name to the name section that follows the
+	// chunk contents. The first call ends the contents.
+	int writeName(const char *name);
+
 	/**
 	 * Override operator new.
 	 *
@@ -166,6 +179,8 @@ class MleDppSceneOutput
 
 	MleDppTblMgr *m_table;
 
+	MlBoolean m_ownsTable;
+
 	int m_sceneCount;
 
 	/** File pointer to a Scene Chunk File. */
@@ -190,6 +205,8 @@ class MleDppSceneOutput
 	long m_lastOffset;
 	// Length of last Digital Playprint chunk.
 	long m_lastLength;
+	// Offset of the name section, or -1 if no names were written.
+	long m_nameStart;
 	// The floating-point arithmetic format to use.
     MlScalarType m_scalarFormat;
 
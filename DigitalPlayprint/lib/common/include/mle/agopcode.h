@@ -63,10 +63,114 @@ enum {
     createForumOpcode			= 0x8d,
 	createSetOpcode				= 0x8d,
     endForumOpcode				= 0x8e,
-	endSetOpcode				= 0x8e
+	endSetOpcode				= 0x8e,
+    defineClassLayoutOpcode		= 0x8f,
+    createActorBlockOpcode		= 0x90,
+    cloneActorOpcode			= 0x91,
+    defineStringPoolOpcode		= 0x92,
+    copyPooledStringOpcode		= 0x93,
+    copyEncodedArrayPropertyOpcode	= 0x94
 };
 
 #define valueBits 7
 #define valueMask ((1 << (valueBits)) - 1) 
 
+/*
+ * An actor group chunk may carry an actor directory after its
+ * endActorGroupOpcode: an (offset, class) int pair for each actor, the
+ * offset of the first opcode after the last actor, the number of actors
+ * and this tag, all in the byte order of the chunk. Offsets are relative
+ * to the start of the group stream (the group class). Interpreters stop
+ * at endActorGroupOpcode and never see it.
+ */
+#define actorDirectoryTag 0x61646972 /* 'adir' */
+
+/*
+ * Runs of actors that share a class, the same fixed-length properties and
+ * the same bindings may be packed into class blocks:
+ *
+ *   defineClassLayoutOpcode layout actorClass numProperties
+ *       (propertyOffset propertyLength)... numBindings (set role)...
+ *   createActorBlockOpcode layout numActors dataLength data
+ *
+ * All operands are ints in the byte order of the chunk, since indexes
+ * cannot follow one another. The data holds, for each property of the
+ * layout in turn, the values of all numActors actors. Each actor of a
+ * block is created, given its property values and then bound as if by
+ * setForumOpcode set and bindDelegateOpcode role for each binding. A
+ * block leaves the current property offset and length undefined, and the
+ * current set at that of the last binding.
+ */
+
+/*
+ * cloneActorOpcode actor creates an actor of the same class as the
+ * actor'th actor created by the group (counting from zero, and counting
+ * each actor of a class block) and gives it that actor's fixed-length
+ * property values, including those it inherited itself. Every other
+ * property that actor was given is set again by the clone, so copying
+ * all of its properties is also correct. Bindings are never inherited.
+ */
+
+/*
+ * A group may keep the strings of its string properties in one pool:
+ *
+ *   defineStringPoolOpcode numStrings dataLength data
+ *   copyPooledStringOpcode string
+ *
+ * numStrings and dataLength are ints in the byte order of the chunk. The
+ * data holds the strings back to back, each ended by a zero byte, so they
+ * can be used where they lie. The pool comes before the first actor and
+ * there is at most one per group. copyPooledStringOpcode string sets the
+ * property at the current offset to the string'th string of the pool, as
+ * copyDynamicPropertyOpcode would with the same bytes.
+ */
+
+/*
+ * Large array properties may be written in a smaller encoding:
+ *
+ *   copyEncodedArrayPropertyOpcode numElements encoding dataLength data
+ *
+ * The operands are ints in the byte order of the chunk. The current
+ * property length is the size of one element, which is made of 32-bit
+ * components. Decoding the data gives the same elements that
+ * copyArrayPropertyOpcode numElements would carry. The encodings are:
+ *
+ *   halfArrayEncoding: each float component as an IEEE half float. The
+ *     relative error is at most 2^-11 for magnitudes from 2^-14 to 65504,
+ *     and the absolute error at most 2^-25 below that. Larger values are
+ *     never encoded this way.
+ *   norm16ArrayEncoding: a (min, max) float pair for each component of
+ *     the element, then each float component as an unsigned 16-bit step
+ *     from min to max. The error is at most (max - min) / 131070, plus
+ *     float rounding.
+ *   deltaArrayEncoding: for 32-bit int elements only, the difference
+ *     from the previous element (the first from zero), zigzag mapped to
+ *     an unsigned value and written in 7-bit groups, least significant
+ *     first, with the high bit set on all but the last. It is exact.
+ *
+ * Halves and 16-bit steps are in the byte order of the chunk.
+ */
+#define halfArrayEncoding 1
+#define norm16ArrayEncoding 2
+#define deltaArrayEncoding 3
+
+/*
+ * A group may give its loader allocation hints, so that it can make one
+ * arena allocation for all of its actors and dynamic properties. The
+ * groupHintsFlag is then set in the group class, and the hints come
+ * between it and the actor count, which must be followed by an opcode:
+ *
+ *   hintsLength numClasses (actorClass numActors)... numDynamic dynamicBytes
+ *
+ * All are ints in the byte order of the chunk. hintsLength is the number
+ * of bytes after it, so that hints may be added later. The actor counts
+ * are given for each class, since only the runtime knows the size of an
+ * actor; numActors counts the actors of class blocks and clones too.
+ * numDynamic is the number of dynamic, pooled string and array properties
+ * and dynamicBytes the bytes they take once decoded (strings with their
+ * zero byte). Loaders that do not know the flag must not be given such
+ * a group.
+ */
+#define groupHintsFlag 0x40000000
+
 #endif /* __MLE_DPP_ACTORGROUPOPCODE_H_ */
@@ -44,6 +44,7 @@
 
 // Include system header files.
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
@@ -73,6 +74,25 @@
 MlePath *MleDppActorGroupOutput::g_outputDir = NULL;
 // Be verbose.
 MlBoolean MleDppActorGroupOutput::g_verbose = FALSE;
+// Emit actor directories.
+MlBoolean MleDppActorGroupOutput::g_actorDirectory = FALSE;
+// Leave out default properties.
+MlBoolean MleDppActorGroupOutput::g_elideDefaults = FALSE;
+// Write clones of repeated actors.
+MlBoolean MleDppActorGroupOutput::g_cloneActors = FALSE;
+// Pool the strings of each group.
+MlBoolean MleDppActorGroupOutput::g_stringPool = FALSE;
+// Order the properties of each actor.
+MlBoolean MleDppActorGroupOutput::g_orderProperties = FALSE;
+// The array encodings.
+char **MleDppActorGroupOutput::g_arrayEncodingKeys = NULL;
+int *MleDppActorGroupOutput::g_arrayEncodings = NULL;
+int MleDppActorGroupOutput::g_numArrayEncodings = 0;
+
+// The most earlier actors of a class tried as the original of a clone.
+#define MAX_CLONE_CANDIDATES 64
+// The fields of a property record of a clone candidate.
+#define CLONE_RECORD_SIZE 5
 
 
 #ifdef _WINDOWS
@@ -127,9 +147,17 @@ MleDppActorGroupOutput::MleDppActorGroupOutput(MleDwpItem *root, char isFixed,
     m_curSetChunkFile(NULL), m_convertFloatToFixed(isFixed),
     m_littleEndian(isLittle), m_lastOffset(-1), m_lastLength(0),
     m_currentActorClass(NULL), m_currentSetClass(NULL),
-    m_currentProperty(NULL), m_references(NULL),
+    m_currentProperty(NULL), m_table(NULL), m_ownsTable(FALSE), m_references(NULL),
     m_numReferences(0), m_actorCount(0), m_actorCountCumulative(0),
-    m_actorid(NULL), m_groupid(NULL), m_package(NULL), m_root(root)
+    m_actorid(NULL), m_groupid(NULL), m_package(NULL), m_root(root),
+    m_actorEntries(NULL), m_numActorEntries(0), m_actorsEnd(-1),
+    m_capture(NULL), m_captureLength(0), m_captureSize(0), m_capturing(FALSE),
+    m_elidedClasses(NULL), m_elidedCounts(NULL), m_numElidedClasses(0),
+    m_cloneActors(NULL), m_numCloneActors(0), m_cloneProperties(NULL),
+    m_numCloneProperties(0), m_cloneData(NULL), m_cloneDataLength(0),
+    m_orderedOpcodes(0), m_orderedBytes(0),
+    m_orderedOffset(-1), m_orderedLength(-1), m_givenOffset(-1), m_givenLength(-1),
+    m_poolStrings(NULL), m_poolHashes(NULL), m_numPoolStrings(0)
 {
     if (m_language)
     {
@@ -147,6 +175,28 @@ MleDppActorGroupOutput::init(
     char *tags,
     char *actoridFileName,
     char *groupidFileName)
+{
+    // Build the tables to process.
+    MleDppTblMgr *table = new MleDppTblMgr;
+    table->setDiscriminators(m_root, tags);
+    table->buildIndexTables(m_root);
+
+    if (! init(table, actoridFileName, groupidFileName))
+    {
+        delete table;
+        return FALSE;
+    }
+    m_ownsTable = TRUE;
+
+    return TRUE;
+}
+
+
+MlBoolean
+MleDppActorGroupOutput::init(
+    MleDppTblMgr *table,
+    char *actoridFileName,
+    char *groupidFileName)
 {
     // For now set the format of scalar to be default (16.16),
     // but in the future set it based on user input to the DPP generator.
@@ -159,10 +209,9 @@ MleDppActorGroupOutput::init(
 
     setScalarFormat();
 
-    // Build the tables to process.
-    m_table = new MleDppTblMgr;
-    m_table->setDiscriminators(m_root, tags);
-    m_table->buildIndexTables(m_root);
+    // Use the tables we were given.
+    m_table = table;
+    m_ownsTable = FALSE;
 
     // Open the ActorId file.
     char *actoridPath = _expandPath(actoridFileName);
@@ -172,7 +221,6 @@ MleDppActorGroupOutput::init(
         fprintf(stderr,"Unable to open %s: %d\n",actoridPath,errno);
         if (g_outputDir != NULL)
             mlFree(actoridPath);
-        delete m_table;
         m_table = NULL;
         return FALSE;
     }
@@ -190,7 +238,6 @@ MleDppActorGroupOutput::init(
         }
         mlFClose(m_actorid);
         m_actorid = NULL;
-        delete m_table;
         m_table = NULL;
         return FALSE;
     }
@@ -271,8 +318,9 @@ MleDppActorGroupOutput::init(
 
 MleDppActorGroupOutput::~MleDppActorGroupOutput()
 {
-    // Delete the table.
-    delete m_table;
+    // Delete the table, unless it is shared.
+    if (m_ownsTable)
+        delete m_table;
 
     // Close the Digital Playprint.
     closeFile();
@@ -311,6 +359,19 @@ MleDppActorGroupOutput::~MleDppActorGroupOutput()
 
     if (m_package)
         mlFree(m_package);
+    if (m_actorEntries)
+        mlFree(m_actorEntries);
+    if (m_capture)
+        mlFree(m_capture);
+    clearCloneActors();
+    clearStringPool();
+    for (int i = 0; i < m_numElidedClasses; i++)
+        mlFree(m_elidedClasses[i]);
+    if (m_elidedClasses)
+    {
+        mlFree(m_elidedClasses);
+        mlFree(m_elidedCounts);
+    }
 }
 
 
@@ -359,11 +420,15 @@ int MleDppActorGroupOutput::closeFile(void)
     m_lastOffset = -1;
     m_lastLength = 0;
     m_actorCount = 0;
+    clearCloneActors();
+    clearStringPool();
 
     if (m_fp == NULL)
         return 1;
 
     writeOpcode(endActorGroupOpcode);
+    if (g_actorDirectory)
+        writeActorDirectory();
     int stringStart = mlFTell(m_fp);
     if (m_references)
     {
@@ -491,6 +556,26 @@ void MleDppActorGroupOutput::setFilePointer(FILE *ufp)
 }
 
 
+/*
+    This function writes raw bytes to the output, or to the capture
+    buffer while capturing.
+*/
+int MleDppActorGroupOutput::writeBytes(const void *data, unsigned int length)
+{
+    if (! m_capturing)
+        return (mlFWrite(data, 1, length, m_fp) == length) ? 0 : 1;
+
+    if (m_captureLength + (int)length > m_captureSize)
+    {
+        while (m_captureLength + (int)length > m_captureSize)
+            m_captureSize = (m_captureSize == 0) ? 64 : 2 * m_captureSize;
+        m_capture = (unsigned char *)mlRealloc(m_capture, m_captureSize);
+    }
+    memcpy(m_capture + m_captureLength, data, length);
+    m_captureLength += length;
+    return 0;
+}
+
 /*
     This function writes a string to the output.
 */
@@ -500,10 +585,7 @@ int MleDppActorGroupOutput::writeString(const char *s)
     
     MLE_ASSERT(length > 0);
 
-    if ( mlFWrite(s, 1, length, m_fp) == length )
-        return 0;
-    else
-        return 1;
+    return writeBytes(s, length);
 }
 
 /*
@@ -526,10 +608,7 @@ int MleDppActorGroupOutput::writeInt(int d)
         data[2] = (unsigned char)(intBits >> 8);
         data[3] = (unsigned char)(intBits);
     }
-    if ( mlFWrite(data, 1, 4, m_fp) == 4 )
-        return 0;
-    else
-        return 1;
+    return writeBytes(data, 4);
 }
 
 /*
@@ -554,10 +633,7 @@ int MleDppActorGroupOutput::writeScalar(float f)
         data[2] = (unsigned char)(floatBits >> 8);
         data[3] = (unsigned char)(floatBits);
     }
-    if ( mlFWrite(data, 1, 4, m_fp) == 4 )
-        return 0;
-    else
-        return 1;
+    return writeBytes(data, 4);
 }
 
 int MleDppActorGroupOutput::writeFloat(float f)
@@ -579,10 +655,7 @@ int MleDppActorGroupOutput::writeFloat(float f)
         data[2] = (unsigned char)(floatBits >> 8);
         data[3] = (unsigned char)(floatBits);
     }
-    if ( mlFWrite(data, 1, 4, m_fp) == 4 )
-        return 0;
-    else
-        return 1;
+    return writeBytes(data, 4);
 }
 
 /*
@@ -590,18 +663,12 @@ int MleDppActorGroupOutput::writeFloat(float f)
 */
 int MleDppActorGroupOutput::writeChar(char c)
 {
-    if ( mlFWrite(&c, 1, 1, m_fp) == 1 )
-        return 0;
-    else
-        return 1;
+    return writeBytes(&c, 1);
 }
 
 int MleDppActorGroupOutput::writeOpcode(unsigned char opcode)
 {
-    if ( mlFWrite(&opcode, 1, 1, m_fp) == 1 )
-        return 0;
-    else
-        return 1;
+    return writeBytes(&opcode, 1);
 }
 
 int MleDppActorGroupOutput::writeIndex(long index)
@@ -617,7 +684,7 @@ int MleDppActorGroupOutput::writeIndex(long index)
         {
             writeOut = 1;
             bits = (unsigned char)(index >> valueBits * counter & valueMask);
-            if (mlFWrite(&bits, 1, 1, m_fp) != 1)
+            if (writeBytes(&bits, 1) != 0)
                 return 1;
         }
     }
@@ -689,7 +756,7 @@ int MleDppActorGroupOutput::writeOffsetLength(int byteLength)
     return 0;
 }
 
-int MleDppActorGroupOutput::writeArrayOffsetLength(int byteLength,int numElements)
+void MleDppActorGroupOutput::writePropertyState(int byteLength)
 {
     long offset;
 
@@ -719,11 +786,34 @@ int MleDppActorGroupOutput::writeArrayOffsetLength(int byteLength,int numElement
         writeIndex(byteLength);
         m_lastLength = byteLength;
     }
+}
+
+int MleDppActorGroupOutput::writeArrayOffsetLength(int byteLength,int numElements)
+{
+    writePropertyState(byteLength);
     writeOpcode(copyArrayPropertyOpcode);
     writeInt(numElements);
     return 0;
 }
 
+/*
+    This function writes a 16-bit value in big or little endian order.
+*/
+int MleDppActorGroupOutput::writeShort(unsigned short s)
+{
+    unsigned char data[2];
+
+    if (m_littleEndian)
+    {
+        data[1] = (unsigned char)(s >> 8);
+        data[0] = (unsigned char)(s);
+    } else {
+        data[0] = (unsigned char)(s >> 8);
+        data[1] = (unsigned char)(s);
+    }
+    return writeBytes(data, 2);
+}
+
 
 void MleDppActorGroupOutput::setOutputDirectory(const char *path)
 {
@@ -757,6 +847,801 @@ void MleDppActorGroupOutput::setVerbosity(MlBoolean verbose)
     g_verbose = verbose;
 }
 
+
+void MleDppActorGroupOutput::setElideDefaults(MlBoolean enable)
+{
+    g_elideDefaults = enable;
+}
+
+
+void MleDppActorGroupOutput::beginCapture(void)
+{
+    MLE_ASSERT(! m_capturing);
+
+    m_savedOffset = m_lastOffset;
+    m_savedLength = m_lastLength;
+    m_lastOffset = -1;
+    m_lastLength = 0;
+    m_captureLength = 0;
+    m_capturing = TRUE;
+}
+
+
+const unsigned char *MleDppActorGroupOutput::endCapture(int *length)
+{
+    MLE_ASSERT(m_capturing);
+
+    m_lastOffset = m_savedOffset;
+    m_lastLength = m_savedLength;
+    m_capturing = FALSE;
+
+    *length = m_captureLength;
+    return m_capture;
+}
+
+
+void MleDppActorGroupOutput::addElided(int bytes)
+{
+    int i;
+
+    MLE_ASSERT(m_currentActorClass != NULL);
+    for (i = 0; i < m_numElidedClasses; i++)
+    {
+        if (strcmp(m_elidedClasses[i], m_currentActorClass) == 0)
+            break;
+    }
+
+    if (i == m_numElidedClasses)
+    {
+        m_elidedClasses = (char **)mlRealloc(m_elidedClasses,
+            (m_numElidedClasses + 1) * sizeof(char *));
+        m_elidedCounts = (int *)mlRealloc(m_elidedCounts,
+            2 * (m_numElidedClasses + 1) * sizeof(int));
+        m_elidedClasses[i] = (char *)mlMalloc(strlen(m_currentActorClass) + 1);
+        strcpy(m_elidedClasses[i], m_currentActorClass);
+        m_elidedCounts[2 * i] = 0;
+        m_elidedCounts[2 * i + 1] = 0;
+        m_numElidedClasses++;
+    }
+
+    m_elidedCounts[2 * i]++;
+    m_elidedCounts[2 * i + 1] += bytes;
+}
+
+
+void MleDppActorGroupOutput::reportElided(FILE *fp)
+{
+    int properties = 0, bytes = 0;
+
+    for (int i = 0; i < m_numElidedClasses; i++)
+    {
+        fprintf(fp, "%s: %d default properties elided, %d bytes saved\n",
+            m_elidedClasses[i], m_elidedCounts[2 * i], m_elidedCounts[2 * i + 1]);
+        properties += m_elidedCounts[2 * i];
+        bytes += m_elidedCounts[2 * i + 1];
+    }
+    fprintf(fp, "Total: %d default properties elided, %d bytes saved\n",
+        properties, bytes);
+}
+
+
+void MleDppActorGroupOutput::setCloneActors(MlBoolean enable)
+{
+    g_cloneActors = enable;
+}
+
+
+// Read the property offset and length leading a captured property, and
+// return the offset of the opcode that follows them.
+static int parseCaptured(const unsigned char *data, int length,
+    long *offset, long *propertyLength)
+{
+    int i = 0;
+
+    *offset = -1;
+    *propertyLength = 0;
+    if ((i < length) && (data[i] == setPropertyOffsetOpcode))
+    {
+        for (*offset = 0, i++; (i < length) && (data[i] <= valueMask); i++)
+            *offset = (*offset << valueBits) | data[i];
+    }
+    if ((i < length) && (data[i] == setPropertyLengthOpcode))
+    {
+        for (i++; (i < length) && (data[i] <= valueMask); i++)
+            *propertyLength = (*propertyLength << valueBits) | data[i];
+    }
+
+    return i;
+}
+
+
+// Hash a captured property or a pooled string (32-bit FNV-1a).
+static int hashBytes(const unsigned char *data, int length)
+{
+    unsigned int hash = 2166136261u;
+
+    for (int i = 0; i < length; i++)
+        hash = (hash ^ data[i]) * 16777619u;
+    return (int)hash;
+}
+
+
+int MleDppActorGroupOutput::getCloneSaving(int actor, const int *records,
+    unsigned char **properties, int numProperties, MlBoolean *inherited)
+{
+    int saving = 0;
+    int first = m_cloneActors[3 * actor + 1];
+    int count = m_cloneActors[3 * actor + 2];
+
+    for (int i = 0; i < count; i++)
+    {
+        const int *original = &m_cloneProperties[CLONE_RECORD_SIZE * (first + i)];
+        int j;
+
+        // The clone must set again whatever the original set.
+        for (j = 0; j < numProperties; j++)
+        {
+            if ((properties[j] != NULL) && (records[CLONE_RECORD_SIZE * j] == original[0]))
+                break;
+        }
+        if (j == numProperties)
+            return -1;
+
+        // Fixed-length values that match are inherited.
+        const int *record = &records[CLONE_RECORD_SIZE * j];
+        if (original[1] && record[1] && (original[2] == record[2]) &&
+            (original[4] == record[4]) &&
+            (memcmp(&m_cloneData[original[3]], properties[j], record[4]) == 0))
+        {
+            saving += record[4];
+            if (inherited != NULL)
+                inherited[j] = TRUE;
+        }
+    }
+
+    return saving;
+}
+
+
+void MleDppActorGroupOutput::writeActorStart(int actorClass,
+    unsigned char **properties, const int *lengths, int numProperties,
+    MlBoolean *inherited)
+{
+    int i, best = -1, bestSaving = 0, tried = 0;
+    long offset, propertyLength;
+
+    // Describe the new actor's properties as the earlier ones are.
+    int *records = (int *)mlMalloc((numProperties + 1) * CLONE_RECORD_SIZE * sizeof(int));
+    for (i = 0; i < numProperties; i++)
+    {
+        int *record = &records[CLONE_RECORD_SIZE * i];
+        inherited[i] = FALSE;
+        if (properties[i] == NULL)
+            continue;
+
+        int start = parseCaptured(properties[i], lengths[i], &offset, &propertyLength);
+        record[0] = (int)offset;
+        record[1] = (start < lengths[i]) && (properties[i][start] == copyPropertyOpcode);
+        record[2] = hashBytes(properties[i], lengths[i]);
+        record[3] = m_cloneDataLength;
+        record[4] = lengths[i];
+    }
+
+    // Try the latest actors of the class first.
+    for (i = m_numCloneActors - 1; (i >= 0) && (tried < MAX_CLONE_CANDIDATES); i--)
+    {
+        if (m_cloneActors[3 * i] != actorClass)
+            continue;
+        tried++;
+
+        int saving = getCloneSaving(i, records, properties, numProperties, NULL);
+        if (saving > bestSaving)
+        {
+            best = i;
+            bestSaving = saving;
+        }
+    }
+
+    if (best >= 0)
+    {
+        getCloneSaving(best, records, properties, numProperties, inherited);
+        writeOpcode(cloneActorOpcode);
+        writeIndex(best);
+    } else
+    {
+        writeOpcode(createActorOpcode);
+        writeIndex(actorClass);
+    }
+
+    // Remember the actor as a candidate for later clones.
+    m_cloneActors = (int *)mlRealloc(m_cloneActors,
+        3 * (m_numCloneActors + 1) * sizeof(int));
+    m_cloneActors[3 * m_numCloneActors] = actorClass;
+    m_cloneActors[3 * m_numCloneActors + 1] = m_numCloneProperties;
+    m_cloneActors[3 * m_numCloneActors + 2] = 0;
+    for (i = 0; i < numProperties; i++)
+    {
+        if (properties[i] == NULL)
+            continue;
+
+        m_cloneProperties = (int *)mlRealloc(m_cloneProperties,
+            CLONE_RECORD_SIZE * (m_numCloneProperties + 1) * sizeof(int));
+        memcpy(&m_cloneProperties[CLONE_RECORD_SIZE * m_numCloneProperties],
+            &records[CLONE_RECORD_SIZE * i], CLONE_RECORD_SIZE * sizeof(int));
+        m_cloneProperties[CLONE_RECORD_SIZE * m_numCloneProperties + 3] = m_cloneDataLength;
+        m_cloneData = (unsigned char *)mlRealloc(m_cloneData, m_cloneDataLength + lengths[i]);
+        memcpy(&m_cloneData[m_cloneDataLength], properties[i], lengths[i]);
+        m_cloneDataLength += lengths[i];
+        m_numCloneProperties++;
+        m_cloneActors[3 * m_numCloneActors + 2]++;
+    }
+    m_numCloneActors++;
+
+    mlFree(records);
+}
+
+
+int MleDppActorGroupOutput::writeCaptured(const unsigned char *data, int length)
+{
+    long offset, propertyLength;
+    int start = parseCaptured(data, length, &offset, &propertyLength);
+
+    if ((offset >= 0) && (offset != m_lastOffset))
+    {
+        writeOpcode(setPropertyOffsetOpcode);
+        writeIndex(offset);
+        m_lastOffset = offset;
+    }
+    if ((propertyLength != 0) && (propertyLength != m_lastLength))
+    {
+        writeOpcode(setPropertyLengthOpcode);
+        writeIndex(propertyLength);
+        m_lastLength = propertyLength;
+    }
+
+    return writeBytes(data + start, length - start);
+}
+
+
+void MleDppActorGroupOutput::setOrderProperties(MlBoolean enable)
+{
+    g_orderProperties = enable;
+}
+
+
+// The number of bytes writeIndex() writes for an index.
+static int indexSize(long index)
+{
+    int size = 0;
+
+    for ( ; index > 0; index >>= valueBits)
+        size++;
+    return size;
+}
+
+
+// Count the offset and length opcodes writeCaptured() writes for a
+// property, and update the current offset and length.
+static void countState(long offset, long propertyLength,
+    long *lastOffset, long *lastLength, int *opcodes, int *bytes)
+{
+    if ((offset >= 0) && (offset != *lastOffset))
+    {
+        (*opcodes)++;
+        *bytes += 1 + indexSize(offset);
+        *lastOffset = offset;
+    }
+    if ((propertyLength != 0) && (propertyLength != *lastLength))
+    {
+        (*opcodes)++;
+        *bytes += 1 + indexSize(propertyLength);
+        *lastLength = propertyLength;
+    }
+}
+
+
+// A property of an actor, as ordered by writeProperties().
+typedef struct _OrderedProperty
+{
+    int rank;
+    long propertyLength;
+    long offset;
+    int index;
+} OrderedProperty;
+
+static int compareOrderedProperties(const void *a, const void *b)
+{
+    const OrderedProperty *p = (const OrderedProperty *)a;
+    const OrderedProperty *q = (const OrderedProperty *)b;
+
+    if (p->rank != q->rank)
+        return p->rank - q->rank;
+    if (p->propertyLength != q->propertyLength)
+        return (p->propertyLength < q->propertyLength) ? -1 : 1;
+    if (p->offset != q->offset)
+        return (p->offset < q->offset) ? -1 : 1;
+    return p->index - q->index;
+}
+
+
+int MleDppActorGroupOutput::writeProperties(unsigned char **properties,
+    const int *lengths, int numProperties, const MlBoolean *inherited)
+{
+    OrderedProperty *order = (OrderedProperty *)mlMalloc(
+        (numProperties + 1) * sizeof(OrderedProperty));
+    long lastOffset = m_lastOffset, lastLength = m_lastLength;
+    int i, count = 0, status = 0;
+    int givenOpcodes = 0, givenBytes = 0, opcodes = 0, bytes = 0;
+
+    // Follow on from the given order of the last actor, if nothing has
+    // been written in between.
+    if ((m_lastOffset == m_orderedOffset) && (m_lastLength == m_orderedLength))
+    {
+        lastOffset = m_givenOffset;
+        lastLength = m_givenLength;
+    }
+
+    for (i = 0; i < numProperties; i++)
+    {
+        if ((properties[i] == NULL) || ((inherited != NULL) && inherited[i]))
+            continue;
+
+        OrderedProperty *p = &order[count++];
+        parseCaptured(properties[i], lengths[i], &p->offset, &p->propertyLength);
+        p->index = i;
+
+        // Properties that need no length go first, then those of the
+        // current length, then the rest by length.
+        if (p->propertyLength == 0)
+            p->rank = 0;
+        else if (p->propertyLength == m_lastLength)
+            p->rank = 1;
+        else
+            p->rank = 2;
+
+        // What the property costs in the order it was given.
+        countState(p->offset, p->propertyLength, &lastOffset, &lastLength,
+            &givenOpcodes, &givenBytes);
+    }
+
+    qsort(order, count, sizeof(OrderedProperty), compareOrderedProperties);
+
+    m_givenOffset = lastOffset;
+    m_givenLength = lastLength;
+    lastOffset = m_lastOffset;
+    lastLength = m_lastLength;
+    for (i = 0; i < count; i++)
+    {
+        countState(order[i].offset, order[i].propertyLength,
+            &lastOffset, &lastLength, &opcodes, &bytes);
+        status |= writeCaptured(properties[order[i].index], lengths[order[i].index]);
+    }
+    m_orderedOpcodes += givenOpcodes - opcodes;
+    m_orderedBytes += givenBytes - bytes;
+    m_orderedOffset = m_lastOffset;
+    m_orderedLength = m_lastLength;
+
+    mlFree(order);
+    return status;
+}
+
+
+void MleDppActorGroupOutput::reportOrdering(FILE *fp)
+{
+    fprintf(fp, "Total: %d property offset and length opcodes saved by ordering, %d bytes saved\n",
+        m_orderedOpcodes, m_orderedBytes);
+}
+
+
+void MleDppActorGroupOutput::clearCloneActors(void)
+{
+    if (m_cloneActors != NULL)
+        mlFree(m_cloneActors);
+    if (m_cloneProperties != NULL)
+        mlFree(m_cloneProperties);
+    if (m_cloneData != NULL)
+        mlFree(m_cloneData);
+    m_cloneActors = NULL;
+    m_cloneProperties = NULL;
+    m_cloneData = NULL;
+    m_numCloneActors = 0;
+    m_numCloneProperties = 0;
+    m_cloneDataLength = 0;
+}
+
+
+void MleDppActorGroupOutput::setStringPool(MlBoolean enable)
+{
+    g_stringPool = enable;
+}
+
+
+int MleDppActorGroupOutput::findString(const char *s)
+{
+    if (m_numPoolStrings == 0 || m_fp == NULL || m_fp != m_curGroupChunkFile)
+        return -1;
+
+    int length = strlen(s);
+    int hash = hashBytes((const unsigned char *)s, length);
+    for (int i = 0; i < m_numPoolStrings; i++)
+    {
+        if (m_poolHashes[i] == hash && strcmp(m_poolStrings[i], s) == 0)
+            return i;
+    }
+    return -1;
+}
+
+
+int MleDppActorGroupOutput::internString(const char *s)
+{
+    int index = findString(s);
+    if (index >= 0 || m_fp == NULL || m_fp != m_curGroupChunkFile)
+        return index;
+
+    int length = strlen(s);
+    m_poolStrings = (char **)mlRealloc(m_poolStrings,
+        (m_numPoolStrings + 1) * sizeof(char *));
+    m_poolHashes = (int *)mlRealloc(m_poolHashes,
+        (m_numPoolStrings + 1) * sizeof(int));
+    m_poolStrings[m_numPoolStrings] = (char *)mlMalloc(length + 1);
+    strcpy(m_poolStrings[m_numPoolStrings], s);
+    m_poolHashes[m_numPoolStrings] = hashBytes((const unsigned char *)s, length);
+    return m_numPoolStrings++;
+}
+
+
+int MleDppActorGroupOutput::writeStringPool(void)
+{
+    int status = 0;
+    int i, dataLength = 0;
+
+    if (m_numPoolStrings == 0)
+        return 0;
+
+    for (i = 0; i < m_numPoolStrings; i++)
+        dataLength += strlen(m_poolStrings[i]) + 1;
+
+    status |= writeOpcode(defineStringPoolOpcode);
+    status |= writeInt(m_numPoolStrings);
+    status |= writeInt(dataLength);
+    for (i = 0; i < m_numPoolStrings; i++)
+        status |= writeBytes(m_poolStrings[i], strlen(m_poolStrings[i]) + 1);
+
+    return status;
+}
+
+
+void MleDppActorGroupOutput::clearStringPool(void)
+{
+    for (int i = 0; i < m_numPoolStrings; i++)
+        mlFree(m_poolStrings[i]);
+    if (m_poolStrings != NULL)
+        mlFree(m_poolStrings);
+    if (m_poolHashes != NULL)
+        mlFree(m_poolHashes);
+    m_poolStrings = NULL;
+    m_poolHashes = NULL;
+    m_numPoolStrings = 0;
+}
+
+
+void MleDppActorGroupOutput::setArrayEncoding(const char *className,
+    const char *property, int encoding)
+{
+    int i;
+
+    if (className == NULL)
+    {
+        for (i = 0; i < g_numArrayEncodings; i++)
+            mlFree(g_arrayEncodingKeys[i]);
+        if (g_arrayEncodingKeys != NULL)
+            mlFree(g_arrayEncodingKeys);
+        if (g_arrayEncodings != NULL)
+            mlFree(g_arrayEncodings);
+        g_arrayEncodingKeys = NULL;
+        g_arrayEncodings = NULL;
+        g_numArrayEncodings = 0;
+        return;
+    }
+
+    char *key = (char *)mlMalloc(strlen(className) +
+        (property ? strlen(property) + 1 : 0) + 1);
+    strcpy(key, className);
+    if (property != NULL)
+    {
+        strcat(key, ".");
+        strcat(key, property);
+    }
+
+    for (i = 0; i < g_numArrayEncodings; i++)
+    {
+        if (strcmp(g_arrayEncodingKeys[i], key) == 0)
+        {
+            g_arrayEncodings[i] = encoding;
+            mlFree(key);
+            return;
+        }
+    }
+
+    g_arrayEncodingKeys = (char **)mlRealloc(g_arrayEncodingKeys,
+        (g_numArrayEncodings + 1) * sizeof(char *));
+    g_arrayEncodings = (int *)mlRealloc(g_arrayEncodings,
+        (g_numArrayEncodings + 1) * sizeof(int));
+    g_arrayEncodingKeys[g_numArrayEncodings] = key;
+    g_arrayEncodings[g_numArrayEncodings] = encoding;
+    g_numArrayEncodings++;
+}
+
+
+int MleDppActorGroupOutput::getArrayEncoding(void)
+{
+    const char *className = m_curSetChunkFile ? m_currentSetClass : m_currentActorClass;
+    int encoding = 0;
+
+    if (g_numArrayEncodings == 0 || className == NULL || m_currentProperty == NULL)
+        return 0;
+
+    int length = strlen(className);
+    for (int i = 0; i < g_numArrayEncodings; i++)
+    {
+        const char *key = g_arrayEncodingKeys[i];
+        if (strncmp(key, className, length) != 0)
+            continue;
+        if (key[length] == '\0')
+            encoding = g_arrayEncodings[i];
+        else if (key[length] == '.' && strcmp(&key[length + 1], m_currentProperty) == 0)
+            return g_arrayEncodings[i];
+    }
+    return encoding;
+}
+
+
+// Convert a float to an IEEE half float, rounding to nearest even. The
+// magnitude must be at most 65504.
+static unsigned short floatToHalf(float f)
+{
+    unsigned int bits, sign, mantissa, half, rest, middle;
+    int exponent, shift;
+
+    memcpy(&bits, &f, sizeof(bits));
+    sign = (bits >> 16) & 0x8000;
+    exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+    mantissa = bits & 0x7fffff;
+
+    if (exponent <= 0)
+    {
+        // Subnormal, in units of 2^-24; anything under 2^-25 is zero.
+        if (exponent < -10)
+            return (unsigned short)sign;
+        mantissa |= 0x800000;
+        shift = 14 - exponent;
+    } else
+    {
+        mantissa |= (unsigned int)exponent << 23;
+        shift = 13;
+    }
+
+    // A carry out of the mantissa correctly bumps the exponent.
+    half = mantissa >> shift;
+    rest = mantissa & ((1u << shift) - 1);
+    middle = 1u << (shift - 1);
+    if (rest > middle || (rest == middle && (half & 1)))
+        half++;
+    return (unsigned short)(sign | half);
+}
+
+
+int MleDppActorGroupOutput::writeEncodedFloatArray(int byteLength,
+    const float *values, int numElements, int components, int encoding)
+{
+    int i, c, count = numElements * components;
+    int dataLength = 2 * count;
+    unsigned short *steps;
+    float *ranges = NULL;
+
+    if (components <= 0 || byteLength != components * (int)sizeof(float))
+        return 1;
+
+    switch (encoding)
+    {
+      case halfArrayEncoding:
+        for (i = 0; i < count; i++)
+        {
+            // NaN fails this test too.
+            if (! (values[i] >= -65504.0f && values[i] <= 65504.0f))
+                return 1;
+        }
+        break;
+
+      case norm16ArrayEncoding:
+        ranges = (float *)mlMalloc(2 * components * sizeof(float));
+        for (c = 0; c < components; c++)
+        {
+            ranges[2 * c] = ranges[2 * c + 1] = (count > 0) ? values[c] : 0.0f;
+            for (i = c; i < count; i += components)
+            {
+                if (values[i] < ranges[2 * c])
+                    ranges[2 * c] = values[i];
+                if (values[i] > ranges[2 * c + 1])
+                    ranges[2 * c + 1] = values[i];
+            }
+            // The span must be finite, which rules out NaN and infinity.
+            float span = ranges[2 * c + 1] - ranges[2 * c];
+            if (! (span >= 0.0f && span <= 3.4e38f))
+            {
+                mlFree(ranges);
+                return 1;
+            }
+        }
+        dataLength += 2 * components * sizeof(float);
+        break;
+
+      default:
+        return 1;
+    }
+
+    // The encoding must beat the plain array.
+    if (3 * (int)sizeof(int) + dataLength >= (int)sizeof(int) + 4 * count)
+    {
+        if (ranges != NULL)
+            mlFree(ranges);
+        return 1;
+    }
+
+    steps = (unsigned short *)mlMalloc((count + 1) * sizeof(unsigned short));
+    for (i = 0, c = 0; i < count; i++)
+    {
+        if (encoding == halfArrayEncoding)
+            steps[i] = floatToHalf(values[i]);
+        else
+        {
+            float span = ranges[2 * c + 1] - ranges[2 * c];
+            steps[i] = (span > 0.0f) ?
+                (unsigned short)((values[i] - ranges[2 * c]) / span * 65535.0f + 0.5f) : 0;
+        }
+        if (++c == components)
+            c = 0;
+    }
+
+    int status = 0;
+    writePropertyState(byteLength);
+    status |= writeOpcode(copyEncodedArrayPropertyOpcode);
+    status |= writeInt(numElements);
+    status |= writeInt(encoding);
+    status |= writeInt(dataLength);
+    for (c = 0; ranges != NULL && c < 2 * components; c++)
+    {
+        // The bits of the float, in the byte order of the chunk.
+        int bits;
+        memcpy(&bits, &ranges[c], sizeof(bits));
+        status |= writeInt(bits);
+    }
+    for (i = 0; i < count; i++)
+        status |= writeShort(steps[i]);
+
+    mlFree(steps);
+    if (ranges != NULL)
+        mlFree(ranges);
+    return status;
+}
+
+
+int MleDppActorGroupOutput::writeEncodedIntArray(const int *values,
+    int numElements, int encoding)
+{
+    unsigned int previous = 0, delta, zigzag;
+    int i, dataLength = 0;
+
+    if (encoding != deltaArrayEncoding)
+        return 1;
+
+    // Five 7-bit groups hold any 32-bit value.
+    unsigned char *data = (unsigned char *)mlMalloc(5 * numElements + 1);
+    for (i = 0; i < numElements; i++)
+    {
+        delta = (unsigned int)values[i] - previous;
+        previous = (unsigned int)values[i];
+        zigzag = (delta << 1) ^ (0u - (delta >> 31));
+        while (zigzag >= 0x80)
+        {
+            data[dataLength++] = (unsigned char)(zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        data[dataLength++] = (unsigned char)zigzag;
+    }
+
+    // The encoding must beat the plain array.
+    if (3 * (int)sizeof(int) + dataLength >= (int)sizeof(int) + 4 * numElements)
+    {
+        mlFree(data);
+        return 1;
+    }
+
+    int status = 0;
+    writePropertyState(sizeof(int));
+    status |= writeOpcode(copyEncodedArrayPropertyOpcode);
+    status |= writeInt(numElements);
+    status |= writeInt(encoding);
+    status |= writeInt(dataLength);
+    status |= writeBytes(data, dataLength);
+
+    mlFree(data);
+    return status;
+}
+
+
+void MleDppActorGroupOutput::setActorDirectory(MlBoolean enable)
+{
+    g_actorDirectory = enable;
+}
+
+
+int MleDppActorGroupOutput::getStreamOffset(void)
+{
+    // The stream starts after the media reference offset.
+    return mlFTell(m_fp) - sizeof(int);
+}
+
+
+void MleDppActorGroupOutput::beginActor(int actorClass)
+{
+    if (! g_actorDirectory || m_fp == NULL || m_fp != m_curGroupChunkFile)
+        return;
+
+    // Forget the property offset and length of the previous actor so that
+    // this actor can be decoded on its own.
+    m_lastOffset = -1;
+    m_lastLength = 0;
+
+    m_actorEntries = (int *)mlRealloc(m_actorEntries,
+        (m_numActorEntries + 1) * 2 * sizeof(int));
+    m_actorEntries[2 * m_numActorEntries] = getStreamOffset();
+    m_actorEntries[2 * m_numActorEntries + 1] = actorClass;
+    m_numActorEntries++;
+}
+
+
+void MleDppActorGroupOutput::endActors(void)
+{
+    if (! g_actorDirectory || m_fp == NULL || m_fp != m_curGroupChunkFile)
+        return;
+
+    m_actorsEnd = getStreamOffset();
+
+    // Delegate attachments may follow; they name actors by index, so
+    // do not let them depend on the last actor's property state either.
+    m_lastOffset = -1;
+    m_lastLength = 0;
+}
+
+
+int MleDppActorGroupOutput::writeActorDirectory(void)
+{
+    int status = 0;
+
+    // Without an explicit end, the actors run up to the endActorGroupOpcode.
+    if (m_actorsEnd < 0)
+        m_actorsEnd = getStreamOffset() - 1;
+
+    for (int i = 0; i < m_numActorEntries; i++)
+    {
+        status |= writeInt(m_actorEntries[2 * i]);
+        status |= writeInt(m_actorEntries[2 * i + 1]);
+    }
+    status |= writeInt(m_actorsEnd);
+    status |= writeInt(m_numActorEntries);
+    status |= writeInt(actorDirectoryTag);
+
+    // Reset for the next group.
+    if (m_actorEntries != NULL)
+        mlFree(m_actorEntries);
+    m_actorEntries = NULL;
+    m_numActorEntries = 0;
+    m_actorsEnd = -1;
+
+    return status;
+}
+
 void *
 MleDppActorGroupOutput::operator new(size_t tSize)
 {
@@ -105,7 +105,7 @@ MleDppSceneOutput::MleDppSceneOutput(
   : m_sceneCount(0), m_fp(NULL), m_curSceneChunkFile(NULL),
     m_convertFloatToFixed(isFixed), m_language(language),
     m_littleEndian(isLittle), m_lastOffset(-1), m_lastLength(0),
-    m_currentGroupClass(NULL),
+    m_nameStart(-1), m_currentGroupClass(NULL), m_table(NULL), m_ownsTable(FALSE),
     m_sceneid(NULL), m_package(package), m_root(root)
 {
     if (m_language)
@@ -121,7 +121,8 @@ MleDppSceneOutput::MleDppSceneOutput(
 
 MleDppSceneOutput::~MleDppSceneOutput()
 { 
-    delete m_table;
+    if (m_ownsTable)
+        delete m_table;
 
     closeFile();
 
@@ -149,6 +150,27 @@ MlBoolean
 MleDppSceneOutput::init(
     char *tags,
     char *sceneidFileName)
+{
+    // Build the tables to process.
+    MleDppTblMgr *table = new MleDppTblMgr; 
+    table->setDiscriminators(m_root, tags);
+    table->buildIndexTables(m_root);
+
+    if (! init(table, sceneidFileName))
+    {
+        delete table;
+        return FALSE;
+    }
+    m_ownsTable = TRUE;
+
+    return TRUE;
+}
+
+
+MlBoolean
+MleDppSceneOutput::init(
+    MleDppTblMgr *table,
+    char *sceneidFileName)
 {
     // For now set the format of scalar to be default (16.16),
     // but in the future set it based on user input to the PP generator.
@@ -160,10 +182,9 @@ MleDppSceneOutput::init(
 
     setScalarFormat();
 
-    // Build the tables to process.
-    m_table = new MleDppTblMgr; 
-    m_table->setDiscriminators(m_root, tags);
-    m_table->buildIndexTables(m_root);
+    // Use the tables we were given.
+    m_table = table;
+    m_ownsTable = FALSE;
 
     // Calculate the date time stamp.
     time_t now;
@@ -178,7 +199,6 @@ MleDppSceneOutput::init(
     {
         if (g_outputDir != NULL)
             mlFree(sceneidPath);
-        delete m_table;
         m_table = NULL;
         return FALSE;
     }
@@ -261,7 +281,8 @@ int MleDppSceneOutput::closeFile(void)
         return 1;
 
     // Update length.
-    int stringStart = mlFTell(m_fp);
+    int stringStart = (m_nameStart >= 0) ? m_nameStart : mlFTell(m_fp);
+    m_nameStart = -1;
     mlFSeek(m_fp, 0, SEEK_SET);
     mlFWrite(&stringStart, sizeof(int), 1, m_fp);
     mlFSeek(m_fp, 0, SEEK_END);
@@ -298,6 +319,22 @@ int MleDppSceneOutput::writeString(const char *s)
         return 1;
 }
 
+/*
+    This function writes a NUL-terminated name to the name section.
+*/
+int MleDppSceneOutput::writeName(const char *name)
+{
+    unsigned int length = strlen(name) + 1;
+
+    if (m_nameStart < 0)
+        m_nameStart = mlFTell(m_fp);
+
+    if ( mlFWrite(name, 1, length, m_fp) == length )
+        return 0;
+    else
+        return 1;
+}
+
 /*
     This function writes an int in big or little endian order.
 */
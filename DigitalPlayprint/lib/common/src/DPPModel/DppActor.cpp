@@ -48,6 +48,7 @@
 // Import Digital Workprint header files.
 //#include "mle/DwpActor.h"
 #include "mle/DwpActorTemplate.h"
+#include "mle/DwpActorDef.h"
 #include "mle/DwpFinder.h"
 #include "mle/DwpInput.h"
 #include "mle/DwpOutput.h"
@@ -56,6 +57,7 @@
 #include "mle/DppActor.h"
 #include "mle/DppRoleBinding.h"
 #include "mle/DppProperty.h"
+#include "mle/DppString.h"
 #include "mle/DppActorGroupOutput.h"
 #include "mle/DppTblMgr.h"
 
@@ -78,10 +80,8 @@ MleDppActor::~MleDppActor()
 }
 
 int
-MleDppActor::writeContents(MleDppActorGroupOutput *out)
+MleDppActor::findActorClass(MleDppActorGroupOutput *out)
 {
-	out->writeOpcode(createActorOpcode);
-
 	// Find the actor class
 	//   We must find out if we have a template, because a template
 	//   is not a class.  A template refers to a class.
@@ -101,9 +101,17 @@ MleDppActor::writeContents(MleDppActorGroupOutput *out)
 		tmplFinder.setName(className);
 	}
 
-	int actorClassNumber = out->m_table->actorClassRuntimeName(className); 
-	out->writeIndex(actorClassNumber);
 	out->m_currentActorClass = className;
+	return out->m_table->actorClassRuntimeName(className);
+}
+
+int
+MleDppActor::writeContents(MleDppActorGroupOutput *out)
+{
+	int actorClassNumber = findActorClass(out);
+	out->beginActor(actorClassNumber);
+	out->writeOpcode(createActorOpcode);
+	out->writeIndex(actorClassNumber);
 	return 0;
 }
 
@@ -129,7 +137,14 @@ int
 MleDppActor::write(MleDppActorGroupOutput *out)
 {
 	// Write the actor contents.
-	writeContents(out);
+	//   A clone is only started once its properties are known.
+	MlBoolean clone = MleDppActorGroupOutput::getCloneActors();
+	MlBoolean order = MleDppActorGroupOutput::getOrderProperties();
+	int actorClassNumber = 0;
+	if ( clone )
+		actorClassNumber = findActorClass(out);
+	else
+		writeContents(out);
 
 	// Create a dictionary of subitems.
 	//   We are going to manufacture names for subitems by concatenating
@@ -209,11 +224,34 @@ MleDppActor::write(MleDppActorGroupOutput *out)
 		tmplFinder.setName(((MleDwpActorTemplate *)tmpl)->getActorClass());
 	}
 
-	// Now loop through the dictionary and write subitems.
+	// Find the class defaults; the templates have already been followed
+	// to the actor class.
+	MleDwpItem *actorDef = NULL;
+	if ( MleDppActorGroupOutput::getElideDefaults() )
+	{
+		MleDwpFinder actorDefFinder(MleDwpActorDef::typeId,out->m_currentActorClass);
+		actorDef = actorDefFinder.find(root);
+	}
+
+	// Now loop through the dictionary and collect the subitems to write.
+	int numItems = 0;
+	MleDwpDictIter countIter(subItem);
+	while ( countIter.getKey() )
+	{
+		numItems++;
+		countIter.next();
+	}
+	MleDppItem **items = (MleDppItem **)mlMalloc((numItems + 1) * sizeof(MleDppItem *));
+	unsigned char **encodings = (unsigned char **)mlMalloc((numItems + 1) * sizeof(unsigned char *));
+	int *lengths = (int *)mlMalloc((numItems + 1) * sizeof(int));
+	MlBoolean *inherited = (MlBoolean *)mlMalloc((numItems + 1) * sizeof(MlBoolean));
+	numItems = 0;
+
 	MleDwpDictIter subItemIter(subItem);
 	while ( subItemIter.getKey() )
 	{
 		MleDppItem *item = NULL;
+		MlBoolean property = FALSE;
 
 		MleDwpItem *dwpItem = (MleDwpItem *)subItemIter.getValue();
 		if (dwpItem->isa(MleDppRoleBinding::typeId))
@@ -224,21 +262,109 @@ MleDppActor::write(MleDppActorGroupOutput *out)
 		} else if (dwpItem->isa(MleDppProperty::typeId))
 		{
 			MleDppProperty *dppItem = (MleDppProperty *)dwpItem;
-			item = dppItem;
+			int length;
+			if ( actorDef != NULL && dppItem->isClassDefault(out,actorDef,&length) )
+				// The actor is constructed with this value.
+				out->addElided(length);
+			else
+			{
+				item = dppItem;
+				property = TRUE;
+			}
 		}
 
 		//MleDppItem *item = dynamic_cast<MleDppItem *>((dwpItem);
 
-		// Write out the item.
 		if (item != NULL)
-			item->write(out);
+		{
+			// Capture the encoding of properties a clone may inherit,
+			// or that are to be ordered.
+			items[numItems] = item;
+			encodings[numItems] = NULL;
+			lengths[numItems] = 0;
+			inherited[numItems] = FALSE;
+			if ( (clone || order) && property )
+			{
+				out->beginCapture();
+				item->write(out);
+				const unsigned char *data = out->endCapture(&lengths[numItems]);
+				encodings[numItems] = (unsigned char *)mlMalloc(lengths[numItems] + 1);
+				memcpy(encodings[numItems],data,lengths[numItems]);
+			}
+			numItems++;
+		}
 
 		subItemIter.next();
 	}
 
+	// Start the actor as a clone, if an earlier actor matches it.
+	if ( clone )
+	{
+		out->beginActor(actorClassNumber);
+		out->writeActorStart(actorClassNumber,encodings,lengths,numItems,inherited);
+	}
+
+	// Write out the items; ordered properties go ahead of the roles.
+	if ( order )
+		out->writeProperties(encodings,lengths,numItems,inherited);
+	for ( int i = 0; i < numItems; i++ )
+	{
+		if ( encodings[i] != NULL )
+		{
+			if ( ! order && ! inherited[i] )
+				out->writeCaptured(encodings[i],lengths[i]);
+			mlFree(encodings[i]);
+		} else
+			items[i]->write(out);
+	}
+
+	mlFree(items);
+	mlFree(encodings);
+	mlFree(lengths);
+	mlFree(inherited);
+
 	return 0;
 }
 
+// Pools the value of a string property.
+static void
+internProperty(MleDppActorGroupOutput *out,MleDwpItem *item)
+{
+	if ( ! item->isa(MleDppProperty::typeId) )
+		return;
+
+	MleDppProperty *property = (MleDppProperty *)item;
+	if ( property->m_data.m_datatype != NULL &&
+		 property->m_data.m_datatype->isa(MleDppString::typeId) &&
+		 property->m_data.m_u.v != NULL )
+		out->internString((char *)property->m_data.m_u.v);
+}
+
+// Template values the actor overrides are pooled too; that costs a few
+// bytes but saves building the dictionary write() uses.
+void
+MleDppActor::internStrings(MleDppActorGroupOutput *out)
+{
+	MleDwpItem *child;
+	for ( child = getFirstChild(); child; child = child->getNext() )
+		internProperty(out,child);
+
+	// Find the root.
+	MleDwpItem *root = this;
+	while ( root->getParent() )
+		root = root->getParent();
+
+	// Follow the actor templates.
+	MleDwpFinder tmplFinder(MleDwpActorTemplate::typeId,getActorClass());
+	MleDwpItem *tmpl;
+	while ( tmpl = tmplFinder.find(root) )
+	{
+		for ( child = tmpl->getFirstChild(); child; child = child->getNext() )
+			internProperty(out,child);
+		tmplFinder.setName(((MleDwpActorTemplate *)tmpl)->getActorClass());
+	}
+}
+
 void *
 MleDppActor::operator new(size_t tSize)
 {
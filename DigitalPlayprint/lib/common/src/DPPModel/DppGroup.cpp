@@ -149,6 +149,14 @@ MleDppGroup::write(MleDppActorGroupOutput *out)
     // write out the number of actors in the group to the chunk
     out->writeIndex(numActors);
 
+    // Pool the strings of the actors ahead of them.
+    if (MleDppActorGroupOutput::getStringPool())
+    {
+        for ( i = 0; i < numActors; i++ )
+            actor[i]->internStrings(out);
+        out->writeStringPool();
+    }
+
     // do weird media reference stuff
     root = this->getParent();
     MleDwpItem *parent;
@@ -199,6 +207,9 @@ MleDppGroup::write(MleDppActorGroupOutput *out)
 			        actor[i]->getName(), i + out->m_actorCountCumulative);
 		}
 	}
+    // Anything after this belongs to the group, not to the last actor.
+    out->endActors();
+
     // Expect the actorCount to contain the running sum of every
     // actor we\'ve seen so far.
     out->m_actorCount += numActors;
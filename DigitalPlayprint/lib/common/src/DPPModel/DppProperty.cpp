@@ -47,6 +47,7 @@
 
 // Include Digital Workprint header files.
 #include "mle/DwpDatatype.h"
+#include "mle/DwpFinder.h"
 
 // Include Digital Playprint header files.
 #include "mle/DppProperty.h"
@@ -181,6 +182,42 @@ MleDppProperty::writeContents(MleDppActorGroupOutput *out)
 	return 0;
 }
 
+MlBoolean
+MleDppProperty::isClassDefault(MleDppActorGroupOutput *out, MleDwpItem *actorDef, int *length)
+{
+	if ( m_data.m_datatype == NULL || m_data.m_datatype->isa(MleDppVoidStar::typeId) )
+		return FALSE;
+
+	// Find the default given by the actor class.
+	MleDwpFinder defaultFinder(MleDppProperty::typeId, getName());
+	MleDppProperty *classDefault = (MleDppProperty *)defaultFinder.find(actorDef);
+	if ( classDefault == NULL || classDefault == this ||
+		 classDefault->m_data.m_datatype == NULL ||
+		 classDefault->m_data.m_datatype->isa(MleDppVoidStar::typeId) )
+		return FALSE;
+
+	// Encode both values the way they would go into the chunk.
+	int valueLength, defaultLength;
+	out->beginCapture();
+	writeContents(out);
+	const unsigned char *encoded = out->endCapture(&valueLength);
+	unsigned char *value = (unsigned char *)mlMalloc(valueLength + 1);
+	memcpy(value, encoded, valueLength);
+
+	out->beginCapture();
+	classDefault->writeContents(out);
+	encoded = out->endCapture(&defaultLength);
+
+	MlBoolean same = (valueLength > 0) && (valueLength == defaultLength) &&
+		(memcmp(value, encoded, valueLength) == 0);
+	mlFree(value);
+
+	// Writing the default also named it the current property.
+	out->m_currentProperty = getName();
+	*length = valueLength;
+	return same;
+}
+
 void *
 MleDppProperty::operator new(size_t tSize)
 {
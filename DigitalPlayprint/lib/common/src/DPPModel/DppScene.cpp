@@ -140,6 +140,11 @@ MleDppScene::write(MleDppSceneOutput *out)
 
     }
 
+    // Name the groups after the chunk contents, so the Playprint
+    // mastering tools can find what the scene depends on.
+    for ( i = 0; i < numGroups; i++ )
+        out->writeName(groups[i]->getName());
+
     // The scene\'s part of the sceneid.h file.
     // We don\'t know our number, so instead count on the sceneCount
     // member to hold it for us, and on out to traverse the set of 
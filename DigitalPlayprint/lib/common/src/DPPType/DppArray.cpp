@@ -52,6 +52,10 @@ int MleDppArray::write(MleDppActorGroupOutput * out,MleDwpDataUnion * data) cons
 {
 	MleArray<char> * array = (MleArray<char> *) data->m_u.v;
 
+	int encoding = out->getArrayEncoding();
+	if ( encoding != 0 && writeEncoded ( out, array, encoding ) == 0 )
+		return 0;
+
 	int size = getElementSize();
 
     out->writeArrayOffsetLength(size,array->size());
@@ -64,6 +68,11 @@ int MleDppArray::write(MleDppActorGroupOutput * out,MleDwpDataUnion * data) cons
 	return 0;
 }
 
+int MleDppArray::writeEncoded(MleDppActorGroupOutput *out,MleArray<char> *array,int encoding) const
+{
+	return 1;
+}
+
 void *
 MleDppArray::operator new(size_t tSize)
 {
@@ -68,6 +68,13 @@ MleDppFloatArray::writeElement(MleDppActorGroupOutput *out,void *data) const
 	return out->writeFloat(*(float *)data);
 }
 
+int
+MleDppFloatArray::writeEncoded(MleDppActorGroupOutput *out,MleArray<char> *array,int encoding) const
+{
+	return out->writeEncodedFloatArray(sizeof(float),(const float *)(char *)*array,
+		array->size(),1,encoding);
+}
+
 int
 MleDppFloatArray::getElementSize(void) const
 {
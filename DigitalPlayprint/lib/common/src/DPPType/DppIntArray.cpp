@@ -69,6 +69,12 @@ MleDppIntArray::writeElement(MleDppActorGroupOutput *out, void *data) const
 	return out->writeInt(*(int *)data);
 }
 
+int
+MleDppIntArray::writeEncoded(MleDppActorGroupOutput *out,MleArray<char> *array,int encoding) const
+{
+	return out->writeEncodedIntArray((const int *)(char *)*array,array->size(),encoding);
+}
+
 int
 MleDppIntArray::getElementSize(void) const
 {
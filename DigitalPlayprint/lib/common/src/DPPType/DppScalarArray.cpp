@@ -79,6 +79,16 @@ MleDppScalarArray::writeElement(MleDppActorGroupOutput *out,void *data) const
 	return out->writeScalar(*(float *)data);
 }
 
+int
+MleDppScalarArray::writeEncoded(MleDppActorGroupOutput *out,MleArray<char> *array,int encoding) const
+{
+	// Only float scalars are encoded.
+	if (out->getConvertFloatToFixed() || getElementSize() != sizeof(float))
+		return 1;
+	return out->writeEncodedFloatArray(sizeof(float),(const float *)(char *)*array,
+		array->size(),1,encoding);
+}
+
 int
 MleDppScalarArray::getElementSize(void) const
 {
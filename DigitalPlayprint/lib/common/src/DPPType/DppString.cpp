@@ -54,13 +54,24 @@ MLE_DWP_DATATYPE_SOURCE(MleDppString,"string",MleDwpString);
 
 //
 // Strings in the Playprint must be preceeded by a command that will allocate
-// the storage for them.
+// the storage for them, unless the group's string pool holds them.
 //
 
 int
 MleDppString::write(MleDppActorGroupOutput *out,MleDwpDataUnion *data) const
 {
 	out->writeOffset();
+
+	int string = -1;
+	if ( data->m_u.v )
+		string = out->findString((char *)data->m_u.v);
+	if ( string >= 0 )
+	{
+		out->writeOpcode(copyPooledStringOpcode);
+		out->writeIndex(string);
+		return 0;
+	}
+
 	out->writeOpcode(copyDynamicPropertyOpcode);
 
 	if ( data->m_u.v )
@@ -102,6 +102,16 @@ MleDppVector3Array::writeElement(MleDppActorGroupOutput *out,void *data) const
 	}
 }
 
+int
+MleDppVector3Array::writeEncoded(MleDppActorGroupOutput *out,MleArray<char> *array,int encoding) const
+{
+	// Only float vectors are encoded.
+	if (out->getScalarFormat() != ML_SCALAR_FLOAT || getElementSize() != 3 * sizeof(float))
+		return 1;
+	return out->writeEncodedFloatArray(getElementSize(),(const float *)(char *)*array,
+		array->size(),3,encoding);
+}
+
 int
 MleDppVector3Array::getElementSize(void) const
 {
@@ -0,0 +1,224 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file DppBuild.h
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_DPP_BUILD_H_
+#define __MLE_DPP_BUILD_H_
+
+
+// Include Magic Lantern header files.
+#include <mle/mlTypes.h>
+
+// Include Digital Playprint header files.
+#include "mle/Dpp.h"
+
+// Declare external references.
+class MleDwpItem;
+class MleDppTblMgr;
+class MleDppBuild;
+
+
+/**
+ * A build stage. It returns <b>TRUE</b> if it succeeded.
+ *
+ * @param build The build the stage belongs to.
+ * @param clientData The data given when the stage was added.
+ */
+typedef MlBoolean (*MleDppBuildStage)(MleDppBuild *build,void *clientData);
+
+
+/**
+ * This class builds a title from a Digital Workprint in one process.
+ *
+ * The workprint is read, and its index tables are built, once. The
+ * mastering stages (tables, groups, scenes, media, layout script and
+ * playprint) are then run as a dependency graph, each stage as soon
+ * as the stages it depends on have finished. Stages that do not depend
+ * on each other run at the same time, so they must only read the
+ * workprint and the index tables.
+ */
+class MleDppBuild
+{
+    // Declare member variables.
+    private:
+
+        MleDwpItem   *m_root;        // Root of instantiated DWP.
+        MleDppTblMgr *m_tables;      // Index tables of the DWP.
+        char         *m_workprint;   // Name of the DWP file.
+        char         *m_tags;        // DWP discriminator tags.
+        MlBoolean     m_verbose;     // Verbosity flag.
+
+        char            **m_names;         // Name of each stage.
+        MleDppBuildStage *m_stages;        // Each stage.
+        void            **m_clientData;    // Data for each stage.
+        int               m_numStages;     // Number of stages.
+        int              *m_dependencies;  // Stage and prerequisite pairs.
+        int               m_numDependencies;
+
+    // Declare member functions.
+    public:
+
+        /**
+         * @brief The default constructor.
+         */
+        MleDppBuild(void);
+
+        /**
+         * @brief The destructor.
+         *
+         * The DWP and its index tables are deleted.
+         */
+        virtual ~MleDppBuild(void);
+
+        /**
+         * @brief Read the Digital Workprint and build its index tables.
+         *
+         * @param workprint The name of the DWP file.
+         * @param tags A ':' delimited string of discriminator tags.
+         *
+         * @return <b>TRUE</b> is returned if the DWP was read.
+         */
+        MlBoolean open(char *workprint,char *tags);
+
+        /**
+         * @brief Get the root of the Digital Workprint.
+         */
+        MleDwpItem *getRoot(void)
+        { return(m_root); };
+
+        /**
+         * @brief Get the index tables of the Digital Workprint.
+         *
+         * They are built with the discriminators for the tags set.
+         */
+        MleDppTblMgr *getTables(void)
+        { return(m_tables); };
+
+        /**
+         * @brief Get the name of the Digital Workprint file.
+         */
+        char *getWorkprint(void)
+        { return(m_workprint); };
+
+        /**
+         * @brief Get the discriminator tags.
+         */
+        char *getTags(void)
+        { return(m_tags); };
+
+        /**
+         * @brief Add a stage.
+         *
+         * @param name The name of the stage, for messages.
+         * @param stage The stage.
+         * @param clientData Passed to the stage.
+         *
+         * @return The number of the stage is returned.
+         */
+        int addStage(const char *name,MleDppBuildStage stage,void *clientData);
+
+        /**
+         * @brief Make a stage wait for another one.
+         *
+         * @param stage The number of the stage that waits.
+         * @param prerequisite The number of the stage that must finish
+         * first.
+         *
+         * @return <b>FALSE</b> is returned if either stage is unknown.
+         */
+        MlBoolean addDependency(int stage,int prerequisite);
+
+        /**
+         * @brief Run the stages.
+         *
+         * A stage whose prerequisite failed is not run.
+         *
+         * @param jobs The number of stages that may run at once; 0 means
+         * one per processor.
+         *
+         * @return <b>TRUE</b> is returned if every stage succeeded.
+         */
+        MlBoolean run(int jobs);
+
+        /**
+         * Set verbosity.
+         *
+         * @param flag If <code>TRUE</code> then each stage is reported
+         * as it starts and finishes.
+         */
+        void setVerbose(MlBoolean flag)
+        { m_verbose = flag; }
+
+        /**
+         * Override operator new.
+         *
+         * @param tSize The size, in bytes, to allocate.
+         */
+        void* operator new(size_t tSize);
+
+        /**
+         * Override operator new array.
+         *
+         * @param tSize The size, in bytes, to allocate.
+         */
+        void* operator new[](size_t tSize);
+
+        /**
+         * Override operator delete.
+         *
+         * @param p A pointer to the memory to delete.
+         */
+        void  operator delete(void *p);
+
+        /**
+         * Override operator delete array.
+         *
+         * @param p A pointer to the memory to delete.
+         */
+        void  operator delete[](void* p);
+
+    private:
+
+        // Run stages until none are left that can run.
+        void runStages(void *schedule);
+};
+
+
+#endif /* __MLE_DPP_BUILD_H_ */
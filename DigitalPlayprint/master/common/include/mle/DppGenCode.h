@@ -54,6 +54,7 @@
 // Declare external references.
 class MleDwpInput;
 class MleDwpItem;
+class MleDppTblMgr;
 
 
 /**
@@ -76,6 +77,17 @@ class MleDppGenCode
 
         MleDppGenCode(char *filename,char language,char *package);
 
+        /**
+         * @brief Generate code for a Digital Workprint that has already
+         * been read.
+         *
+         * @param root The root of the instantiated DWP. It is not
+         * deleted with this object.
+         * @param language The programming language to generate.
+         * @param package Packaging information for Java.
+         */
+        MleDppGenCode(MleDwpItem *root,char language,char *package);
+
         /**
 		 * @brief The destructor.
 		 */
@@ -92,6 +104,15 @@ class MleDppGenCode
         // MlBoolean verifyWorkprint(char *tags);
 
         MlBoolean generateTitle(char *tags);
+
+        /**
+         * @brief Generate the title tables from index tables that are
+         * already built.
+         *
+         * @param tblMgr The index tables, built with the discriminators
+         * for the target set.
+         */
+        MlBoolean generateTitle(MleDppTblMgr *tblMgr);
 	   
 		/**
 		 * @brief Set the path for the generated output.
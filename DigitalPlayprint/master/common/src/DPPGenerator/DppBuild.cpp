@@ -0,0 +1,356 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file DppBuild.cpp
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#include <stdio.h>
+#include <string.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Include Magic Lantern header files.
+#include <mle/mlTypes.h>
+#include <mle/mlAssert.h>
+#include <mle/mlMalloc.h>
+
+// Include Magic Lantern Digital Workprint header files.
+#include "mle/DwpInput.h"
+#include "mle/DwpItem.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/Dpp.h"
+#include "mle/DppTblMgr.h"
+#include "mle/DppBuild.h"
+
+
+// The state of a stage while the stages run.
+#define STAGE_WAITING  0   /* Waiting to run. */
+#define STAGE_RUNNING  1   /* Running. */
+#define STAGE_DONE     2   /* Finished successfully. */
+#define STAGE_FAILED   3   /* Finished unsuccessfully. */
+#define STAGE_SKIPPED  4   /* Not run, because a prerequisite failed. */
+
+// The progress of the stages, shared between the workers.
+typedef struct _BuildSchedule
+{
+    int                     *state;    /* The state of each stage. */
+    int                     *waiting;  /* Unfinished prerequisites of each stage. */
+    int                     running;   /* Number of stages running. */
+    std::mutex              lock;      /* Guards the fields above. */
+    std::condition_variable changed;   /* Signalled when a stage finishes. */
+} BuildSchedule;
+
+
+static char *_copyString(const char *s)
+{
+    char *copy = (char *)mlMalloc(strlen(s) + 1);
+    strcpy(copy,s);
+    return(copy);
+}
+
+
+// Skip every stage that waits, directly or not, for the given one.
+static void _skipDependents(int stage,int *state,const int *dependencies,
+    int numDependencies,char **names)
+{
+    for (int i = 0; i < numDependencies; i++)
+    {
+        int dependent = dependencies[2 * i];
+
+        if ((dependencies[2 * i + 1] == stage) &&
+            (state[dependent] == STAGE_WAITING))
+        {
+            fprintf(stderr,"Skipping %s; a stage it needs failed.\n",
+                names[dependent]);
+            state[dependent] = STAGE_SKIPPED;
+            _skipDependents(dependent,state,dependencies,numDependencies,names);
+        }
+    }
+}
+
+
+MleDppBuild::MleDppBuild(void)
+  : m_root(NULL), m_tables(NULL), m_workprint(NULL), m_tags(NULL),
+    m_verbose(FALSE), m_names(NULL), m_stages(NULL), m_clientData(NULL),
+    m_numStages(0), m_dependencies(NULL), m_numDependencies(0)
+{
+    // Initialize Digital Workprint/Playprint toolkit.
+    mleDppInit();
+}
+
+
+MleDppBuild::~MleDppBuild(void)
+{
+    // Take the discriminators off the DWP before it goes.
+    if (m_tables != NULL)
+    {
+        m_tables->setDiscriminators(m_root,NULL);
+        delete m_tables;
+    }
+    if (m_root != NULL)
+        delete m_root;
+
+    for (int i = 0; i < m_numStages; i++)
+        mlFree(m_names[i]);
+    if (m_names != NULL)
+        mlFree(m_names);
+    if (m_stages != NULL)
+        mlFree(m_stages);
+    if (m_clientData != NULL)
+        mlFree(m_clientData);
+    if (m_dependencies != NULL)
+        mlFree(m_dependencies);
+    if (m_workprint != NULL)
+        mlFree(m_workprint);
+    if (m_tags != NULL)
+        mlFree(m_tags);
+}
+
+
+MlBoolean MleDppBuild::open(char *workprint,char *tags)
+{
+    // Declare local variables.
+    MleDwpInput *in;
+
+    MLE_ASSERT(m_root == NULL);
+
+    // Open the DWP.
+    in = new MleDwpInput;
+    MLE_ASSERT(in);
+    if (in->openFile(workprint) > 0)
+    {
+        delete in;
+        return(FALSE);
+    }
+
+    // Build the entire DWP, instantiating each MleDwpItem.
+    m_root = MleDwpItem::readAll(in);
+    in->closeFile();
+    delete in;
+    if (m_root == NULL)
+        return(FALSE);
+
+    m_workprint = _copyString(workprint);
+    m_tags = _copyString(tags);
+
+    // Build the index tables every stage shares. This also sets the
+    // discriminators on the DWP.
+    m_tables = new MleDppTblMgr;
+    MLE_ASSERT(m_tables);
+    m_tables->setDiscriminators(m_root,m_tags);
+    if (! m_tables->buildIndexTables(m_root))
+        return(FALSE);
+
+    return(TRUE);
+}
+
+
+int MleDppBuild::addStage(const char *name,MleDppBuildStage stage,void *clientData)
+{
+    int n = m_numStages + 1;
+
+    m_names = (char **)mlRealloc(m_names,n * sizeof(char *));
+    m_stages = (MleDppBuildStage *)mlRealloc(m_stages,n * sizeof(MleDppBuildStage));
+    m_clientData = (void **)mlRealloc(m_clientData,n * sizeof(void *));
+
+    m_names[m_numStages] = _copyString(name);
+    m_stages[m_numStages] = stage;
+    m_clientData[m_numStages] = clientData;
+
+    return(m_numStages++);
+}
+
+
+MlBoolean MleDppBuild::addDependency(int stage,int prerequisite)
+{
+    if ((stage < 0) || (stage >= m_numStages) ||
+        (prerequisite < 0) || (prerequisite >= m_numStages) ||
+        (stage == prerequisite))
+        return(FALSE);
+
+    m_dependencies = (int *)mlRealloc(m_dependencies,
+        2 * (m_numDependencies + 1) * sizeof(int));
+    m_dependencies[2 * m_numDependencies] = stage;
+    m_dependencies[2 * m_numDependencies + 1] = prerequisite;
+    m_numDependencies++;
+
+    return(TRUE);
+}
+
+
+void MleDppBuild::runStages(void *schedule)
+{
+    BuildSchedule *sched = (BuildSchedule *)schedule;
+    std::unique_lock<std::mutex> lock(sched->lock);
+
+    for (;;)
+    {
+        // Find a stage whose prerequisites have all finished.
+        int next = -1;
+        for (int i = 0; (i < m_numStages) && (next < 0); i++)
+        {
+            if ((sched->state[i] == STAGE_WAITING) && (sched->waiting[i] == 0))
+                next = i;
+        }
+
+        if (next < 0)
+        {
+            // Nothing is left to start once nothing is running.
+            if (sched->running == 0)
+                break;
+            sched->changed.wait(lock);
+            continue;
+        }
+
+        sched->state[next] = STAGE_RUNNING;
+        sched->running++;
+        if (m_verbose)
+            fprintf(stdout,"Starting %s\n",m_names[next]);
+
+        lock.unlock();
+        MlBoolean ok = m_stages[next](this,m_clientData[next]);
+        lock.lock();
+
+        sched->running--;
+        if (ok)
+        {
+            sched->state[next] = STAGE_DONE;
+            if (m_verbose)
+                fprintf(stdout,"Finished %s\n",m_names[next]);
+
+            // Release the stages that were waiting for this one.
+            for (int i = 0; i < m_numDependencies; i++)
+            {
+                if (m_dependencies[2 * i + 1] == next)
+                    sched->waiting[m_dependencies[2 * i]]--;
+            }
+        } else
+        {
+            sched->state[next] = STAGE_FAILED;
+            fprintf(stderr,"%s failed.\n",m_names[next]);
+            _skipDependents(next,sched->state,m_dependencies,
+                m_numDependencies,m_names);
+        }
+        sched->changed.notify_all();
+    }
+}
+
+
+MlBoolean MleDppBuild::run(int jobs)
+{
+    // Declare local variables.
+    BuildSchedule sched;
+    MlBoolean status = TRUE;
+    int numWorkers;
+
+    sched.state = (int *)mlMalloc((m_numStages + 1) * sizeof(int));
+    sched.waiting = (int *)mlMalloc((m_numStages + 1) * sizeof(int));
+    sched.running = 0;
+    for (int i = 0; i < m_numStages; i++)
+    {
+        sched.state[i] = STAGE_WAITING;
+        sched.waiting[i] = 0;
+    }
+    for (int i = 0; i < m_numDependencies; i++)
+        sched.waiting[m_dependencies[2 * i]]++;
+
+    // Each worker takes the next stage that is ready until none are left.
+    numWorkers = jobs;
+    if (numWorkers <= 0)
+        numWorkers = (int)std::thread::hardware_concurrency();
+    if (numWorkers > m_numStages)
+        numWorkers = m_numStages;
+    if (numWorkers <= 1)
+        runStages(&sched);
+    else
+    {
+        std::thread *workers = new std::thread[numWorkers];
+        for (int i = 0; i < numWorkers; i++)
+            workers[i] = std::thread(&MleDppBuild::runStages,this,(void *)&sched);
+        for (int i = 0; i < numWorkers; i++)
+            workers[i].join();
+        delete [] workers;
+    }
+
+    for (int i = 0; i < m_numStages; i++)
+    {
+        if (sched.state[i] == STAGE_WAITING)
+            fprintf(stderr,"%s was never run; its dependencies form a cycle.\n",
+                m_names[i]);
+        if (sched.state[i] != STAGE_DONE)
+            status = FALSE;
+    }
+
+    mlFree(sched.state);
+    mlFree(sched.waiting);
+
+    return(status);
+}
+
+
+void *
+MleDppBuild::operator new(size_t tSize)
+{
+    void *p = mlMalloc(tSize);
+    return p;
+}
+
+
+void
+MleDppBuild::operator delete(void *p)
+{
+    mlFree(p);
+}
+
+
+void*
+MleDppBuild::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+
+void
+MleDppBuild::operator delete[](void* p)
+{
+    mlFree(p);
+}
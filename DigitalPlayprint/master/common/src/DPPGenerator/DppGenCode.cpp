@@ -100,6 +100,14 @@ MleDppGenCode::MleDppGenCode(char *filename,char language,char *package)
 }
 
 
+MleDppGenCode::MleDppGenCode(MleDwpItem *root,char language,char *package)
+  : m_wp(NULL), m_root(root), m_language(language), m_package(package),
+    m_verbose(FALSE)
+{
+    // Nothing to read; the DWP is owned by the caller.
+}
+
+
 MleDppGenCode::~MleDppGenCode()
 {
     // XXX -- should close the DWP here; however, there is no API for this.
@@ -214,6 +222,14 @@ MlBoolean MleDppGenCode::generateTitle(char *tags)
         return(FALSE);
     }
 
+    return(generateTitle(&tblMgr));
+}
+
+
+MlBoolean MleDppGenCode::generateTitle(MleDppTblMgr *tables)
+{
+    MleDppTblMgr &tblMgr = *tables;
+
     // Read code generation template.
     MleTemplate pTemplate;
     readTitleTemplate(pTemplate);
@@ -0,0 +1,667 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file dppbuild.cpp
+ * @ingroup MleDPPMaster
+ *
+ * Program to build a Digital Playprint in one pass.
+ *
+ * It does the work of gentables, gengroup, genscene, genmedia, genppscript
+ * and gendpp, reading the Digital Workprint and building its index tables
+ * only once.
+ */
+
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#ifdef _WINDOWS
+#include <windows.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Include Magic Lantern header files.
+#include <mle/mlMalloc.h>
+#include <mle/mlAssert.h>
+#include <mle/MlePath.h>
+#ifdef _WINDOWS
+#include <mle/mlGetOpt.h>
+#include <mle/MleWin32Path.h>
+#else
+#include <unistd.h>
+#include <mle/MleLinuxPath.h>
+#endif /* _WINDOWS */
+
+// Include Digital Workprint header files.
+#include "mle/DwpItem.h"
+#include "mle/DwpFinder.h"
+
+// Include Digital Playprint header files.
+#include "mle/Dpp.h"
+#include "mle/DppItem.h"
+#include "mle/DppGroup.h"
+#include "mle/DppScene.h"
+#include "mle/DppSet.h"
+#include "mle/DppTblMgr.h"
+#include "mle/DppActorGroupOutput.h"
+#include "mle/DppSceneOutput.h"
+#include "mle/DppGenCode.h"
+#include "mle/DppBuild.h"
+
+#include "../genmedia/mediaout.h"
+#include "../layout/ppscript.h"
+#include "../layout/pplayout.h"
+#include "../layout/DppLayoutManager.h"
+
+// Declare external references.
+extern int runLayoutScript(LayoutState *state);
+
+
+#ifdef _WINDOWS
+static char *getCanonicalPath(char *path)
+{
+    char *cpath = NULL;
+    MleWin32Path *wpath = new MleWin32Path((MlChar *)path, true);
+    cpath = _strdup((char *)wpath->getPath());
+    delete wpath;
+    return cpath;
+}
+#else
+static char *getCanonicalPath(char *path)
+{
+    return strdup(path);
+}
+#endif /* _WINDOWS */
+
+
+// Argument structures for parser.
+typedef struct _ArgStruct
+{
+    char       *commandName;  /* Name of command. */
+    MlBoolean  byteOrder;     /* TRUE = Little Endian, FALSE = Big Endian. */
+    MlBoolean  fixedPt;       /* TRUE = Fixed-Point, FALSE = Floating-Point. */
+    MlBoolean  language;      /* TRUE = Java, FALSE = C++. */
+    char       *package;      /* The Java package. */
+    char       *tags;         /* Digital Workprint tags. */
+    char       *workprint;    /* Name of workprint file to build. */
+    char       *playprint;    /* Name of playprint file to build. */
+    char       *outputDir;    /* Directory to redirect output to. */
+    int        jobs;          /* Number of stages run at once (0 = one per processor). */
+    MlBoolean  verbose;       /* Be verbose. */
+    MlBoolean  elide;         /* Leave out default properties. */
+    MlBoolean  clone;         /* Write repeated actors as clones. */
+    MlBoolean  pool;          /* Pool the strings of each group. */
+    MlBoolean  order;         /* Order the properties of each actor. */
+    MlUInt     alignment;     /* Chunk payload alignment, in bytes (0 = none). */
+    MlBoolean  packMedia;     /* Write media as packed 'mpak' chunks. */
+    MlBoolean  indexMedia;    /* Write a 'midx' index in media lists. */
+    MlBoolean  classBlocks;   /* Pack like actors into class blocks. */
+    MlBoolean  groupHints;    /* Write allocation hints in group headers. */
+    MlBoolean  sceneLayout;   /* Write each scene's chunks together. */
+    MlBoolean  hashContent;   /* Seal the playprint with a content hash. */
+    char       **traces;      /* Access traces to lay the chunks out by. */
+    int        numTraces;     /* Number of access traces. */
+    char       *codefile;     /* Root name of the chunk index files. */
+    char       *script;       /* Name of the layout script. */
+} ArgStruct;
+
+
+const char *usage_str = "\
+Syntax:   dppbuild  [-b|-l] [-f] [-j <package>|-c] [-d <dir>] [-p <jobs>]\n\
+                    [-e] [-r] [-s] [-o] [-a <bytes>] [-m] [-i] [-k] [-g] [-n]\n\
+                    [-t <trace> ...] [-x] [-v]\n\
+                    <tags> <workprint> <playprint>\n\
+\n\
+          -b                   Use Big Endian byte ordering (default)\n\
+          -l                   Use Little Endian byte ordering\n\
+          -f                   Generate fixed-point arithmetic values\n\
+          -c                   Generate C++ compliant files (default)\n\
+          -j <package>         Generate Java compliant files\n\
+          -d <dir>             Directory where files are generated\n\
+          -p <jobs>            Number of stages to run at once\n\
+                               (default is one per processor)\n\
+          -e, -r, -s, -o       As for gengroup\n\
+          -a, -m, -k, -g, -n   As for gendpp\n\
+          -i                   As for gendpp\n\
+          -t <trace>           As for gendpp; may be given more than once\n\
+          -x                   As for gendpp\n\
+          -v                   Be verbose\n\
+          <tags>               Digital Workprint tags\n\
+          <workprint>          Digital Workprint\n\
+          <playprint>          Digital Playprint to build\n\
+\n\
+Function: Build a Magic Lantern Digital Playprint.\n\
+\n\
+The runtime tables, the Group, Scene and MediaRef chunk files, the layout\n\
+script and the playprint are generated as gentables, gengroup, genscene,\n\
+genmedia, genppscript and gendpp would, but the Digital Workprint is read\n\
+only once. The Actor, Group and Scene ID files are named actorid.h,\n\
+groupid.h and sceneid.h (ActorID.java, GroupID.java and SceneID.java with\n\
+-j), and the media inventory mediainv.txt. The layout script and the chunk\n\
+index files are named after the playprint.\n";
+
+
+int parseArgs(int argc, char *argv[], ArgStruct *args)
+{
+    /* Declare local variables. */
+    int c;
+    int errflg;
+    extern char *optarg;
+    extern int optind;
+
+    errflg = 0;
+    while ((c = getopt(argc, argv, "blfj:cd:p:ersoa:mikgnt:xv")) != -1)
+    {
+        switch (c)
+        {
+          case 'b':
+            /* Use Big Endian byte ordering. */
+            args->byteOrder = FALSE;
+            break;
+          case 'l':
+            /* Use Little Endian byte ordering. */
+            args->byteOrder = TRUE;
+            break;
+          case 'f':
+            /* Use Fixed-Point arithmetic. */
+            args->fixedPt = TRUE;
+            break;
+          case 'j':
+            /* Generate code for Java programming language. */
+            args->language = TRUE;
+            args->package = optarg;
+            break;
+          case 'c':
+            /* Generate code for C++ programming language. */
+            args->language = FALSE;
+            break;
+          case 'd':
+            /* Place files in this directory. */
+            args->outputDir = optarg;
+            break;
+          case 'p':
+            /* Run this many stages at once. */
+            args->jobs = atoi(optarg);
+            if (args->jobs <= 0)
+                errflg++;
+            break;
+          case 'e':
+            /* Leave out default properties. */
+            args->elide = TRUE;
+            break;
+          case 'r':
+            /* Write repeated actors as clones. */
+            args->clone = TRUE;
+            break;
+          case 's':
+            /* Pool the strings of each group. */
+            args->pool = TRUE;
+            break;
+          case 'o':
+            /* Order the properties of each actor. */
+            args->order = TRUE;
+            break;
+          case 'a':
+            /* Chunk payload alignment. */
+            args->alignment = atoi(optarg);
+            if ((args->alignment != 16) && (args->alignment != 64) &&
+                (args->alignment != 4096))
+                errflg++;
+            break;
+          case 'm':
+            /* Packed media. */
+            args->packMedia = TRUE;
+            break;
+          case 'i':
+            /* Media index. */
+            args->indexMedia = TRUE;
+            break;
+          case 'k':
+            /* Class blocks. */
+            args->classBlocks = TRUE;
+            break;
+          case 'g':
+            /* Allocation hints. */
+            args->groupHints = TRUE;
+            break;
+          case 'n':
+            /* Script order. */
+            args->sceneLayout = FALSE;
+            break;
+          case 't':
+            /* Access trace. */
+            args->traces = (char **)mlRealloc(args->traces,
+                (args->numTraces + 1) * sizeof(char *));
+            args->traces[args->numTraces++] = getCanonicalPath(optarg);
+            break;
+          case 'x':
+            /* Content hash. */
+            args->hashContent = TRUE;
+            break;
+          case 'v':
+            /* Be verbose. */
+            args->verbose = TRUE;
+            break;
+          case '?':
+            errflg++;
+        }
+    }
+
+    if (errflg)
+    {
+        (void)fprintf(stderr, "%s\n", usage_str);
+        return FALSE;
+    }
+
+    for ( ; optind < argc; optind++)
+    {
+        if (! args->tags)
+        {
+#ifdef _WINDOWS
+            args->tags = _strdup(argv[optind]);
+#else
+            args->tags = strdup(argv[optind]);
+#endif /* _WINDOWS */
+        } else if (! args->workprint)
+        {
+            args->workprint = getCanonicalPath(argv[optind]);
+        } else if (! args->playprint)
+        {
+#ifdef _WINDOWS
+            args->playprint = _strdup(argv[optind]);
+#else
+            args->playprint = strdup(argv[optind]);
+#endif /* _WINDOWS */
+        } else
+        {
+            fprintf(stderr,"%s\n",usage_str);
+            return FALSE;
+        }
+    }
+
+    /* If there is no specified workprint, complain. */
+    if (args->tags == NULL ||
+        args->workprint == NULL ||
+        args->playprint == NULL ||
+        ((args->language == TRUE) && (args->package == NULL)))
+    {
+        fprintf(stderr,"%s\n",usage_str);
+        return FALSE;
+    }
+
+    /* Having made it to here implies that we have good arguments. */
+
+    return TRUE;
+}
+
+
+// Name the layout script and the chunk index files after the playprint.
+static void nameLayoutFiles(ArgStruct *args)
+{
+    const char *base = strrchr(args->playprint, '/');
+#ifdef _WINDOWS
+    const char *bslash = strrchr(args->playprint, '\\');
+    if ((bslash != NULL) && ((base == NULL) || (bslash > base)))
+        base = bslash;
+#endif /* _WINDOWS */
+    base = (base != NULL) ? base + 1 : args->playprint;
+
+    const char *dot = strrchr(base, '.');
+    size_t length = (dot != NULL) ? (size_t)(dot - base) : strlen(base);
+
+    args->codefile = (char *)mlMalloc(length + 1);
+    strncpy(args->codefile, base, length);
+    args->codefile[length] = '\0';
+
+    args->script = (char *)mlMalloc(length + 4);
+    strcpy(args->script, args->codefile);
+    strcat(args->script, ".py");
+}
+
+
+// Utility to append the output directory to the specified path.
+static char *_expandPath(ArgStruct *args, const char *path)
+{
+    size_t length = strlen(path) + 1;
+    if (args->outputDir != NULL)
+        length += strlen(args->outputDir) + 1;
+
+    char *tmpPath = (char *)mlMalloc(length);
+    tmpPath[0] = '\0';
+    if (args->outputDir != NULL)
+    {
+        strcpy(tmpPath, args->outputDir);
+#ifdef _WINDOWS
+        strcat(tmpPath, "\\");
+#else /* ! _WINDOWS */
+        strcat(tmpPath, "/");
+#endif /* _WINDOWS */
+    }
+    strcat(tmpPath, path);
+
+    return tmpPath;
+}
+
+
+// gentables: the runtime tables.
+static MlBoolean _genTables(MleDppBuild *build, void *clientData)
+{
+    ArgStruct *args = (ArgStruct *)clientData;
+
+    MleDppGenCode *gc = new MleDppGenCode(build->getRoot(),
+        args->language, args->package);
+    gc->setVerbose(args->verbose);
+    MlBoolean status = gc->generateTitle(build->getTables());
+    delete gc;
+
+    return status;
+}
+
+
+// gengroup: the Group and Set chunk files, and the Actor and Group ID files.
+static MlBoolean _genGroups(MleDppBuild *build, void *clientData)
+{
+    ArgStruct *args = (ArgStruct *)clientData;
+    MleDwpItem *root = build->getRoot();
+    int i;
+
+    MleDppActorGroupOutput *out = new MleDppActorGroupOutput(root,
+        args->fixedPt, args->byteOrder, args->language, args->package);
+    if (! out->init(build->getTables(),
+            (char *)(args->language ? "ActorID.java" : "actorid.h"),
+            (char *)(args->language ? "GroupID.java" : "groupid.h")))
+    {
+        fprintf(stderr,"%s : %s\n",args->commandName,
+                "Unable to initialize Actor/Group output");
+        delete out;
+        return FALSE;
+    }
+
+    // Set the scalar format.
+    if (args->fixedPt)
+        out->setScalarFormat(ML_SCALAR_FIXED_16_16);
+    else
+        out->setScalarFormat(ML_SCALAR_FLOAT);
+
+    // Write each MleDwpGroup to its chunk file.
+    MleDwpFinder groupFinder(MleDwpGroup::typeId,NULL,1);
+    groupFinder.find(root);
+    int nItems = groupFinder.getNumItems();
+    MleDwpItem **items = groupFinder.getItems();
+    for (i = 0; i < nItems; i++)
+    {
+        ((MleDppGroup *)items[i])->write(out);
+        out->closeFile();
+    }
+
+    // Write each MleDwpSet to its chunk file.
+    MleDwpFinder setFinder(MleDppSet::typeId,NULL,1);
+    setFinder.find(root);
+    nItems = setFinder.getNumItems();
+    items = setFinder.getItems();
+    for (i = 0; i < nItems; i++)
+    {
+        ((MleDppSet *)items[i])->write(out);
+    }
+
+    // Report what leaving out default properties saved.
+    if (args->elide)
+        out->reportElided(stdout);
+
+    // Report what ordering properties saved.
+    if (args->order)
+        out->reportOrdering(stdout);
+
+    delete out;
+    return TRUE;
+}
+
+
+// genscene: the Scene chunk files and the Scene ID file.
+static MlBoolean _genScenes(MleDppBuild *build, void *clientData)
+{
+    ArgStruct *args = (ArgStruct *)clientData;
+    MleDwpItem *root = build->getRoot();
+    MlBoolean status = TRUE;
+
+    MleDppSceneOutput *out = new MleDppSceneOutput(root,
+        args->fixedPt, args->byteOrder, args->language, args->package);
+    if (! out->init(build->getTables(),
+            (char *)(args->language ? "SceneID.java" : "sceneid.h")))
+    {
+        fprintf(stderr,"%s : %s\n",args->commandName,
+                "Unable to initialize Scene output");
+        delete out;
+        return FALSE;
+    }
+
+    if (args->fixedPt)
+        out->setScalarFormat(ML_SCALAR_FIXED_16_16);
+    else
+        out->setScalarFormat(ML_SCALAR_FLOAT);
+
+    // Write each MleDwpScene to its chunk file.
+    MleDwpFinder sceneFinder(MleDwpScene::typeId,NULL,1);
+    sceneFinder.find(root);
+    int nScenes = sceneFinder.getNumItems();
+    MleDwpItem **scenes = sceneFinder.getItems();
+    for (int i = 0; (i < nScenes) && status; i++)
+    {
+        ((MleDppScene *)scenes[i])->write(out);
+        if (out->closeFile() != 0)
+            status = FALSE;
+    }
+
+    delete out;
+    return status;
+}
+
+
+// genmedia: the MediaRef chunk files and the media inventory.
+static MlBoolean _genMedia(MleDppBuild *build, void *clientData)
+{
+    ArgStruct *args = (ArgStruct *)clientData;
+
+    // The chunk files are written one at a time; the other stages
+    // supply the parallelism.
+    return genMediaChunks(build->getRoot(), build->getTables(),
+        args->commandName, build->getWorkprint(), (char *)"mediainv.txt",
+        args->outputDir, args->byteOrder, 1) == 0;
+}
+
+
+// genppscript: the default layout script.
+static MlBoolean _genScript(MleDppBuild *build, void *clientData)
+{
+    ArgStruct *args = (ArgStruct *)clientData;
+
+    return genPlayprintScript(build->getRoot(), args->commandName,
+        args->playprint, args->script, args->codefile, args->outputDir) == 0;
+}
+
+
+// gendpp: the playprint and the chunk index files.
+static MlBoolean _genPlayprint(MleDppBuild *build, void *clientData)
+{
+    ArgStruct *args = (ArgStruct *)clientData;
+    LayoutState *state;
+    int status;
+
+    // Initialize the playprint layout state as gendpp would.
+    state = (LayoutState *)mlMalloc(sizeof(LayoutState));
+    MLE_ASSERT(state);
+    state->m_commandName = args->commandName;
+    state->m_byteOrder = args->byteOrder;
+    state->m_scriptfile = _expandPath(args, args->script);
+    state->m_playprint = NULL;
+    state->m_codefile = NULL;
+    state->m_codefd = NULL;
+    state->m_headerfd = NULL;
+    state->m_tmplate = NULL;
+    state->m_workprint = build->getWorkprint();
+    state->m_outputDir = (args->outputDir != NULL) ? args->outputDir : (char *)".";
+    state->m_inputDir = args->outputDir;
+    state->m_language = args->language;
+    state->m_package = args->package;
+    state->m_root = build->getRoot();
+    state->m_tags = build->getTags();
+    state->m_alignment = args->alignment;
+    state->m_packMedia = args->packMedia;
+    state->m_indexMedia = args->indexMedia;
+    state->m_classBlocks = args->classBlocks;
+    state->m_groupHints = args->groupHints;
+    state->m_hashContent = args->hashContent;
+    state->m_contentHash = 0;
+    state->m_sceneLayout = args->sceneLayout;
+    state->m_traces = args->traces;
+    state->m_numTraces = args->numTraces;
+    state->m_dpp = NULL;
+    state->m_chunks = new MleDppChunkTable();
+
+    // gendpp reads the workprint without discriminators. It depends on
+    // every other stage, so none of them is still reading it.
+    state->m_root->setDiscriminator(NULL);
+
+    DppLayoutManager::getInstance()->setState(state);
+    status = runLayoutScript(state);
+
+    // Clean up state.
+    delete state->m_chunks;
+    mlFree(state->m_scriptfile);
+    mlFree(state);
+
+    return status == 0;
+}
+
+
+int main(int argc,char *argv[])
+{
+    // Declare local variables.
+    ArgStruct args;
+    MleDppBuild *build;
+
+    // Parse arguments.
+    args.commandName = argv[0];
+    args.byteOrder = FALSE;
+    args.fixedPt = FALSE;
+    args.language = FALSE;
+    args.package = NULL;
+    args.tags = NULL;
+    args.workprint = NULL;
+    args.playprint = NULL;
+    args.outputDir = NULL;
+    args.jobs = 0;
+    args.verbose = FALSE;
+    args.elide = FALSE;
+    args.clone = FALSE;
+    args.pool = FALSE;
+    args.order = FALSE;
+    args.alignment = 0;
+    args.packMedia = FALSE;
+    args.indexMedia = FALSE;
+    args.classBlocks = FALSE;
+    args.groupHints = FALSE;
+    args.sceneLayout = TRUE;
+    args.hashContent = FALSE;
+    args.traces = NULL;
+    args.numTraces = 0;
+    args.codefile = NULL;
+    args.script = NULL;
+    if (! parseArgs(argc, argv, &args))
+    {
+        exit(1);
+    }
+    nameLayoutFiles(&args);
+
+    // Set the group output options.
+    if (args.verbose)
+    {
+        MleDppActorGroupOutput::setVerbosity(TRUE);
+    }
+    if (args.elide)
+    {
+        MleDppActorGroupOutput::setElideDefaults(TRUE);
+    }
+    if (args.clone)
+    {
+        MleDppActorGroupOutput::setCloneActors(TRUE);
+    }
+    if (args.pool)
+    {
+        MleDppActorGroupOutput::setStringPool(TRUE);
+    }
+    if (args.order)
+    {
+        MleDppActorGroupOutput::setOrderProperties(TRUE);
+    }
+
+    // Redirect the generated output.
+    if (args.outputDir != NULL)
+    {
+        MleDppGenCode::setOutputDirectory(args.outputDir);
+        MleDppActorGroupOutput::setOutputDirectory(args.outputDir);
+        MleDppSceneOutput::setOutputDirectory(args.outputDir);
+    }
+
+    // Read the workprint and build its index tables, once.
+    build = new MleDppBuild;
+    build->setVerbose(args.verbose);
+    if (! build->open(args.workprint, args.tags))
+    {
+        fprintf(stderr,"%s : %s\n",args.commandName,
+                "Unable to open Digital Workprint");
+        exit(1);
+    }
+
+    // Every other stage must finish before the playprint is laid out,
+    // since gendpp clears the discriminators they read the workprint
+    // with; nothing else depends on anything.
+    int tables = build->addStage("gentables", _genTables, &args);
+    int groups = build->addStage("gengroup", _genGroups, &args);
+    int scenes = build->addStage("genscene", _genScenes, &args);
+    int media = build->addStage("genmedia", _genMedia, &args);
+    int script = build->addStage("genppscript", _genScript, &args);
+    int layout = build->addStage("gendpp", _genPlayprint, &args);
+    build->addDependency(layout, tables);
+    build->addDependency(layout, groups);
+    build->addDependency(layout, scenes);
+    build->addDependency(layout, media);
+    build->addDependency(layout, script);
+
+    MlBoolean status = build->run(args.jobs);
+
+    // Clean-up and return.
+    delete build;
+    return status ? 0 : 1;
+}
@@ -68,6 +68,7 @@
 
 // Include Digital Playprint header files.
 #include "mle/agopcode.h"
+#include "../dumpgroup/dumpvisitor.h"
 #include "mle/ppinput.h"
 
 static int dumpBytes(const char *buffer, size_t size);
@@ -78,12 +79,6 @@ static int dumpMref(void *clientdata, void *calldata);
 static int readDpp(char *filename);
 
 static unsigned char *readFileToMemory(char *filename, int *size);
-static void parseStream(unsigned char*& contents, int size);
-static long readIndex(unsigned char*& contents);
-static int readInt(unsigned char*& contents);
-static int writeInt(long value);
-static int copyInt(unsigned char*& contents);
-static unsigned char nextStreamByte(unsigned char*& streamPtrRef);
 
 // Argument structures for parser.
 typedef struct _pattern
@@ -195,7 +190,7 @@ int main(int argc, char **argv)
         g_bigEndian = FALSE;
 
     //contents = readFileToMemory(args.playprint, &size);
-    //parseStream(contents, size);
+    //dumpGroupStream(contents, size, ! g_bigEndian);
 
     // Todo: Validate that the args.playprint exists and is readable.
     // Also, expand the filename into an absolute path.
@@ -236,6 +231,8 @@ static int dumpHeader(void *clientdata, void *calldata)
 	MleDppHeader *header = (MleDppHeader *) calldata;
 
 	fprintf(stdout,"\t%s: %d\n","Version", header->m_version);
+	if (header->m_alignment != 0)
+		fprintf(stdout,"\t%s: %u\n","Payload Alignment", header->m_alignment);
 
 	char *datestamp = ctime((time_t *)&header->m_date);
 	fprintf(stdout,"\t%s: %s\n","Creation Date", datestamp);
@@ -255,6 +252,8 @@ static int dumpTOC(void *clientdata, void *calldata)
 		MlDppQuark label = nextEntry->m_entry.m_label;
 		unsigned long offset = nextEntry->m_entry.m_offset;
 		fprintf(stdout, "\tProcessing next entry: quark = %u: offset = %lu.\n", label, offset);
+		if (nextEntry->m_name != NULL)
+			fprintf(stdout, "\t\tname = %s: size = %u.\n", nextEntry->m_name, nextEntry->m_size);
 	    nextEntry = nextEntry->m_next;
 	}
 	fprintf(stdout, "\n");
@@ -362,278 +361,3 @@ static unsigned char *readFileToMemory(char *filename, int *size)
 
     return data;
 }
-
-
-static void parseStream(unsigned char*& contents, int size)
-{
-    long propertyLength = 0;
-    int currentActor, currentRole, currentSet, opcode, index;
-    unsigned char *contentsEnd = contents+size;
-    
-    currentActor = -1;
-    currentRole = -1;
-    currentSet = -1;
-
-    int offset = readInt(contents);
-    printf("Media Reference Offset (offset=%d)\n",offset);
-
-    int groupId = readInt(contents);
-    printf("Group Id: %d\n",groupId);
-
-    long numActors = readIndex(contents);
-    printf("Number of Actors: %ld\n\n",numActors);
-    
-    while ( contents < contentsEnd )
-    {
-        opcode = (int)*contents++;
-        switch (opcode)
-        {
-          case setSetOpcode:
-            if (currentActor)
-            {
-                currentActor = -1;
-                currentRole = -1;
-            }
-            currentSet = readIndex(contents);
-            printf("%04x %03d SetSet set=%d\n",
-               opcode, currentSet,currentSet);
-            break;
-
-          case createActorOpcode:
-            currentActor = readIndex(contents);
-            printf("%04x %03d CreateActor actor=%d\n",
-               opcode, currentActor, currentActor);
-            break;
-
-          case bindRoleOpcode:
-            index = readIndex(contents);
-            printf("%04x %03d BindRole role=%d, # actor=%d\n",
-               opcode, index, index, currentActor);
-            if ( currentActor == -1 )
-            {
-                printf("         # ERROR: currentActor undefined.\n");
-            }
-            if ( currentRole != -1 )
-            {
-                printf("         # ERROR: currentRole already defined (%d)\n",
-                   currentRole);
-            }
-            currentRole = index;
-            break;
-
-          case parentRoleOpcode:
-            index = readIndex(contents);
-            printf("%04x %03d ParentRole role=%d\n",
-               opcode, index, index);
-
-            // XXX At the moment, we always generate a role attachment,
-            //   even when no role is present.  This is tested and ignored
-            //   in actorgc.cxx.  This is slightly wasteful, but we'll fix
-            //   it in the playprint generation code rewrite.  In the meantime,
-            //   don't print this error.
-    //        if (currentRole == -1) {
-    //        printf("         # ERROR: currentRole undefined.\n");
-    //        }
-            if (currentSet == -1)
-            {
-                printf("         # ERROR: currentSet undefined.\n");
-            }
-            currentRole = -1;
-            break;
-
-          case childRoleOpcode:
-            index = readIndex(contents);
-            printf("%04x %03d ChildRole role=%d\n",
-               opcode, index, index);
-            break;
-
-          case setPropertyOffsetOpcode:
-            index = readIndex(contents);
-            printf("%04x %03d SetProperty index=%d\n",
-               opcode, index, index);
-            break;
-
-          case setPropertyLengthOpcode:
-            propertyLength = readIndex(contents);
-            printf("%04x %03ld SetPropertyLength length=%ld\n",
-               opcode, propertyLength, propertyLength );
-            break;
-
-          case copyPropertyOpcode:
-            printf("%04x     CopyProperty", opcode);
-            long bytesToCopy;
-            for ( bytesToCopy=0 ; bytesToCopy<propertyLength ; bytesToCopy++)
-            {
-                if ( bytesToCopy%8 == 0 )
-                {
-                    printf("\n         Data");
-                }
-                printf(" %02x",nextStreamByte(contents));
-            }
-            printf("\n");
-            break;
-
-          case copyArrayPropertyOpcode:
-            {
-                printf("%04x     CopyArrayProperty", opcode);
-                int numElements = copyInt(contents);
-                int arrayLength = propertyLength * numElements;
-                for ( bytesToCopy=0 ; bytesToCopy<arrayLength ; bytesToCopy++)
-                {
-                    if ( bytesToCopy%8 == 0 )
-                    {
-                        printf("\n         Data");
-                    }
-                    printf(" %02x",nextStreamByte(contents));
-                }
-                printf("\n");
-            }
-            break;
-
-          case endActorGroupOpcode:
-            printf("%04x     EndActorGroup\n", opcode);
-            contents = contentsEnd;
-            break;
-
-          case copyDynamicPropertyOpcode:
-            {
-                char charbuf[9];
-                char nb;
-                int i;
-                int length = copyInt(contents);
-                printf("%04x %03d CopyDynamicProperty\n", opcode, length);
-                for ( i=0 ; i<length ; i++ )
-                {
-                    if ( i%8 == 0 )
-                    {
-                        printf("         Data");
-                    }
-                    nb = nextStreamByte(contents);
-                    printf(" %02x", nb);
-                    if ( isprint(nb) )
-                    {
-                        charbuf[i%8] = nb;
-                    } else {
-                        charbuf[i%8] = '.';
-                    }
-                    if ( i%8 == 7 )
-                    {
-                        charbuf[8] = 0;
-                        printf("    # \"%s\"\n", charbuf);
-                        sprintf(charbuf, "%*.*s", (int)(sizeof charbuf-1), (int)(sizeof charbuf-1), " ");
-                    }
-                }
-                if ( i%8 != 0 )
-                {
-                    charbuf[i%8] = 0;
-                    for ( ; i%8!=0 ; i++ )
-                    {
-                        printf("   ");
-                    }
-                    printf("    # \"%s\"\n", charbuf);
-                }
-            }
-            break;
-
-          case copyMediaRefOpcode:
-            index = readIndex(contents);
-            printf("%04x %03d CopyMediaRef mediaref=%d\n",
-               opcode, index, index);
-            break;
-
-          case createSetOpcode:
-            {
-                long set = readIndex(contents);
-                printf("%04x %03ld CreateSet set=%ld\n", opcode, set, set);
-            }
-            break;
-
-          case endSetOpcode:
-            printf("%04x     EndSet\n", opcode);
-    //        contents = contentsEnd;
-            break;
-
-          default:
-            printf("         # ERROR: invalid opcode(%d)\n",opcode);
-        }
-    }
-}
-
-static long readIndex(unsigned char*& contents)
-{
-    long value = 0;
-    signed char byte;
-    
-    while ((byte = nextStreamByte(contents)) >= 0)
-    {
-        value = (value << valueBits) | byte;
-    }
-    contents--; /* Back up one, since while loop always over-advances by one. */
-    return value;
-}
-
-static unsigned char nextStreamByte(unsigned char*& streamPtrRef)
-{
-    return *streamPtrRef++;
-}
-
-static int readInt(unsigned char*& streamPtrRef)
-{
-    long value = 0;
-
-    if (! g_bigEndian)
-    {
-        // Little Endian format.
-        value = nextStreamByte(streamPtrRef);
-        value = value | (nextStreamByte(streamPtrRef) << 8);
-        value = value | (nextStreamByte(streamPtrRef) << 16);
-        value = value | (nextStreamByte(streamPtrRef) << 24);
-    } else
-    {
-        // Big Endian format.
-        value = nextStreamByte(streamPtrRef);
-        value = (value<<8) | nextStreamByte(streamPtrRef);
-        value = (value<<8) | nextStreamByte(streamPtrRef);
-        value = (value<<8) | nextStreamByte(streamPtrRef);
-    }
-
-    return value;
-}
-
-static int writeInt(long index)
-{
-    int value = 0;
-    unsigned char tmpValue =0;
-
-    if (! g_bigEndian)
-    {
-        // Little Endian format.
-        tmpValue = (index) & 0xff;
-        value |= tmpValue;
-        tmpValue = (index>>8) & 0xff;
-        value |= tmpValue;
-        tmpValue = (index>>16) & 0xff;
-        value |= tmpValue;
-        tmpValue = (index>>24) & 0xff;
-        value |= tmpValue;
-    } else
-    {
-        // Big Endian format.
-        tmpValue = (index>>24) & 0xff;
-        value = tmpValue;
-        tmpValue = (index>>16) & 0xff;
-        value = (value<<8) | tmpValue;
-        tmpValue = (index>>8) & 0xff;
-        value = (value<<8) | tmpValue;
-        tmpValue = (index) & 0xff;
-        value = (value<<8) | tmpValue;
-    }
-
-    return value;
-}
-
-static int copyInt(unsigned char*& streamPtrRef)
-{
-    long strmValue = readInt(streamPtrRef);
-    return writeInt(strmValue);
-};
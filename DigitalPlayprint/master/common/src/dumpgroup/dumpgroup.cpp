@@ -66,14 +66,9 @@
 
 // Include Digital Playprint header files.
 #include "mle/agopcode.h"
+#include "dumpvisitor.h"
 
 static unsigned char *readFileToMemory(char *filename, int *size);
-static void parseStream(unsigned char*& contents, int size);
-static long readIndex(unsigned char*& contents);
-static int readInt(unsigned char*& contents);
-static int writeInt(long value);
-static int copyInt(unsigned char*& contents);
-static unsigned char nextStreamByte(unsigned char*& streamPtrRef);
 
 // Argument structures for parser.
 typedef struct _pattern
@@ -184,7 +179,7 @@ int main(int argc, char **argv)
 		g_bigEndian = FALSE;
 
     contents = readFileToMemory(args.chunkFile, &size);
-    parseStream(contents, size);
+    dumpGroupStream(contents, size, ! g_bigEndian);
     return 0;
 }
 
@@ -243,278 +238,3 @@ static unsigned char *readFileToMemory(char *filename, int *size)
 
     return data;
 }
-
-
-static void parseStream(unsigned char*& contents, int size)
-{
-    long propertyLength = 0;
-    int currentActor, currentRole, currentSet, opcode, index;
-    unsigned char *contentsEnd = contents+size;
-    
-    currentActor = -1;
-    currentRole = -1;
-    currentSet = -1;
-
-	int offset = readInt(contents);
-	printf("Media Reference Offset (offset=%d)\n",offset);
-
-	int groupId = readInt(contents);
-	printf("Group Id: %d\n",groupId);
-
-	long numActors = readIndex(contents);
-	printf("Number of Actors: %ld\n\n",numActors);
-    
-    while ( contents < contentsEnd )
-	{
-		opcode = (int)*contents++;
-		switch (opcode)
-		{
-		  case setSetOpcode:
-			if (currentActor)
-			{
-				currentActor = -1;
-				currentRole = -1;
-			}
-			currentSet = readIndex(contents);
-			printf("%04x %03d SetSet set=%d\n",
-			   opcode, currentSet,currentSet);
-			break;
-
-		  case createActorOpcode:
-			currentActor = readIndex(contents);
-			printf("%04x %03d CreateActor actor=%d\n",
-			   opcode, currentActor, currentActor);
-			break;
-
-		  case bindRoleOpcode:
-			index = readIndex(contents);
-			printf("%04x %03d BindRole role=%d, # actor=%d\n",
-			   opcode, index, index, currentActor);
-			if ( currentActor == -1 )
-			{
-				printf("         # ERROR: currentActor undefined.\n");
-			}
-			if ( currentRole != -1 )
-			{
-				printf("         # ERROR: currentRole already defined (%d)\n",
-				   currentRole);
-			}
-			currentRole = index;
-			break;
-
-		  case parentRoleOpcode:
-			index = readIndex(contents);
-			printf("%04x %03d ParentRole role=%d\n",
-			   opcode, index, index);
-
-			// XXX At the moment, we always generate a role attachment,
-			//   even when no role is present.  This is tested and ignored
-			//   in actorgc.cxx.  This is slightly wasteful, but we'll fix
-			//   it in the playprint generation code rewrite.  In the meantime,
-			//   don't print this error.
-	//	    if (currentRole == -1) {
-	//		printf("         # ERROR: currentRole undefined.\n");
-	//	    }
-			if (currentSet == -1)
-			{
-				printf("         # ERROR: currentSet undefined.\n");
-			}
-			currentRole = -1;
-			break;
-
-		  case childRoleOpcode:
-			index = readIndex(contents);
-			printf("%04x %03d ChildRole role=%d\n",
-			   opcode, index, index);
-			break;
-
-		  case setPropertyOffsetOpcode:
-			index = readIndex(contents);
-			printf("%04x %03d SetProperty index=%d\n",
-			   opcode, index, index);
-			break;
-
-		  case setPropertyLengthOpcode:
-			propertyLength = readIndex(contents);
-			printf("%04x %03ld SetPropertyLength length=%ld\n",
-			   opcode, propertyLength, propertyLength );
-			break;
-
-		  case copyPropertyOpcode:
-			printf("%04x     CopyProperty", opcode);
-			long bytesToCopy;
-			for ( bytesToCopy=0 ; bytesToCopy<propertyLength ; bytesToCopy++)
-			{
-				if ( bytesToCopy%8 == 0 )
-				{
-					printf("\n         Data");
-				}
-				printf(" %02x",nextStreamByte(contents));
-			}
-			printf("\n");
-			break;
-
-		  case copyArrayPropertyOpcode:
-			{
-				printf("%04x     CopyArrayProperty", opcode);
-				int numElements = copyInt(contents);
-				int arrayLength = propertyLength * numElements;
-				for ( bytesToCopy=0 ; bytesToCopy<arrayLength ; bytesToCopy++)
-				{
-					if ( bytesToCopy%8 == 0 )
-					{
-						printf("\n         Data");
-					}
-					printf(" %02x",nextStreamByte(contents));
-				}
-				printf("\n");
-			}
-			break;
-
-		  case endActorGroupOpcode:
-			printf("%04x     EndActorGroup\n", opcode);
-			contents = contentsEnd;
-			break;
-
-		  case copyDynamicPropertyOpcode:
-			{
-				char charbuf[9];
-				char nb;
-				int i;
-				int length = copyInt(contents);
-				printf("%04x %03d CopyDynamicProperty\n", opcode, length);
-				for ( i=0 ; i<length ; i++ )
-				{
-					if ( i%8 == 0 )
-					{
-						printf("         Data");
-					}
-					nb = nextStreamByte(contents);
-					printf(" %02x", nb);
-					if ( isprint(nb) )
-					{
-						charbuf[i%8] = nb;
-					} else {
-						charbuf[i%8] = '.';
-					}
-					if ( i%8 == 7 )
-					{
-						charbuf[8] = 0;
-						printf("    # \"%s\"\n", charbuf);
-						sprintf(charbuf, "%*.*s", (int)(sizeof charbuf-1), (int)(sizeof charbuf-1), " ");
-					}
-				}
-				if ( i%8 != 0 )
-				{
-					charbuf[i%8] = 0;
-					for ( ; i%8!=0 ; i++ )
-					{
-						printf("   ");
-					}
-					printf("    # \"%s\"\n", charbuf);
-				}
-			}
-			break;
-
-		  case copyMediaRefOpcode:
-			index = readIndex(contents);
-			printf("%04x %03d CopyMediaRef mediaref=%d\n",
-			   opcode, index, index);
-			break;
-
-		  case createSetOpcode:
-			{
-				long set = readIndex(contents);
-				printf("%04x %03ld CreateSet set=%ld\n", opcode, set, set);
-			}
-			break;
-
-		  case endSetOpcode:
-			printf("%04x     EndSet\n", opcode);
-	//	    contents = contentsEnd;
-			break;
-
-		  default:
-			printf("         # ERROR: invalid opcode(%d)\n",opcode);
-		}
-    }
-}
-
-static long readIndex(unsigned char*& contents)
-{
-	long value = 0;
-	signed char byte;
-	
-	while ((byte = nextStreamByte(contents)) >= 0)
-	{
-		value = (value << valueBits) | byte;
-	}
-	contents--; /* Back up one, since while loop always over-advances by one. */
-	return value;
-}
-
-static unsigned char nextStreamByte(unsigned char*& streamPtrRef)
-{
-	return *streamPtrRef++;
-}
-
-static int readInt(unsigned char*& streamPtrRef)
-{
-    long value = 0;
-
-	if (! g_bigEndian)
-	{
-		// Little Endian format.
-		value = nextStreamByte(streamPtrRef);
-		value = value | (nextStreamByte(streamPtrRef) << 8);
-		value = value | (nextStreamByte(streamPtrRef) << 16);
-		value = value | (nextStreamByte(streamPtrRef) << 24);
-	} else
-	{
-		// Big Endian format.
-		value = nextStreamByte(streamPtrRef);
-		value = (value<<8) | nextStreamByte(streamPtrRef);
-		value = (value<<8) | nextStreamByte(streamPtrRef);
-		value = (value<<8) | nextStreamByte(streamPtrRef);
-	}
-
-    return value;
-}
-
-static int writeInt(long index)
-{
-	int value = 0;
-	unsigned char tmpValue =0;
-
-    if (! g_bigEndian)
-	{
-		// Little Endian format.
-		tmpValue = (index) & 0xff;
-		value |= tmpValue;
-		tmpValue = (index>>8) & 0xff;
-		value |= tmpValue;
-		tmpValue = (index>>16) & 0xff;
-		value |= tmpValue;
-		tmpValue = (index>>24) & 0xff;
-		value |= tmpValue;
-	} else
-	{
-		// Big Endian format.
-		tmpValue = (index>>24) & 0xff;
-		value = tmpValue;
-		tmpValue = (index>>16) & 0xff;
-		value = (value<<8) | tmpValue;
-		tmpValue = (index>>8) & 0xff;
-		value = (value<<8) | tmpValue;
-		tmpValue = (index) & 0xff;
-		value = (value<<8) | tmpValue;
-	}
-
-    return value;
-}
-
-static int copyInt(unsigned char*& streamPtrRef)
-{
-	long strmValue = readInt(streamPtrRef);
-	return writeInt(strmValue);
-};
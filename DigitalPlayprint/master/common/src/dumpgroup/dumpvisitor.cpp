@@ -0,0 +1,339 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file dumpvisitor.cpp
+ * @ingroup MleDPPMaster
+ *
+ * Prints the instructions of Group chunks, for dumpgroup and dumpdpp.
+ */
+
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#include <stdio.h>
+#include <ctype.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+
+// Include Digital Playprint header files.
+#include "mle/agopcode.h"
+#include "mle/agdecode.h"
+#include "mle/agblock.h"
+#include "mle/agpool.h"
+#include "mle/aghints.h"
+
+#include "dumpvisitor.h"
+
+// Print each instruction of an actor group or set chunk.
+class DumpVisitor : public MleDppOpcodeVisitor
+{
+  public:
+
+    DumpVisitor(MlBoolean littleEndian)
+      : m_littleEndian(littleEndian),
+        m_currentActor(-1), m_currentRole(-1), m_currentSet(-1)
+    {}
+
+    MlBoolean visit(const MleDppInstruction *instruction);
+
+  private:
+
+    MlBoolean m_littleEndian;
+    int m_currentActor, m_currentRole, m_currentSet;
+    MleDppStringPool m_pool;
+};
+
+static void dumpData(const MleDppInstruction *instruction)
+{
+    for (int i = 0; i < instruction->m_dataLength; i++)
+    {
+        if ( i%8 == 0 )
+        {
+            printf("\n         Data");
+        }
+        printf(" %02x",instruction->m_data[i]);
+    }
+    printf("\n");
+}
+
+MlBoolean DumpVisitor::visit(const MleDppInstruction *instruction)
+{
+    int opcode = instruction->m_opcode;
+    int index = instruction->m_operand;
+
+    switch (opcode)
+    {
+      case setSetOpcode:
+        if (m_currentActor)
+        {
+            m_currentActor = -1;
+            m_currentRole = -1;
+        }
+        m_currentSet = index;
+        printf("%04x %03d SetSet set=%d\n",
+           opcode, m_currentSet, m_currentSet);
+        break;
+
+      case createActorOpcode:
+        m_currentActor = index;
+        printf("%04x %03d CreateActor actor=%d\n",
+           opcode, m_currentActor, m_currentActor);
+        break;
+
+      case cloneActorOpcode:
+        // The clone has the class of the actor it copies.
+        m_currentActor = index;
+        printf("%04x %03d CloneActor original=%d\n",
+           opcode, index, index);
+        break;
+
+      case bindRoleOpcode:
+        printf("%04x %03d BindRole role=%d, # actor=%d\n",
+           opcode, index, index, m_currentActor);
+        if ( m_currentActor == -1 )
+        {
+            printf("         # ERROR: currentActor undefined.\n");
+        }
+        if ( m_currentRole != -1 )
+        {
+            printf("         # ERROR: currentRole already defined (%d)\n",
+               m_currentRole);
+        }
+        m_currentRole = index;
+        break;
+
+      case parentRoleOpcode:
+        printf("%04x %03d ParentRole role=%d\n",
+           opcode, index, index);
+
+        // XXX At the moment, we always generate a role attachment,
+        //   even when no role is present.  This is tested and ignored
+        //   in actorgc.cxx.  This is slightly wasteful, but we'll fix
+        //   it in the playprint generation code rewrite.  In the meantime,
+        //   don't print the error for an undefined currentRole.
+        if (m_currentSet == -1)
+        {
+            printf("         # ERROR: currentSet undefined.\n");
+        }
+        m_currentRole = -1;
+        break;
+
+      case childRoleOpcode:
+        printf("%04x %03d ChildRole role=%d\n",
+           opcode, index, index);
+        break;
+
+      case setPropertyOffsetOpcode:
+        printf("%04x %03d SetProperty index=%d\n",
+           opcode, index, index);
+        break;
+
+      case setPropertyLengthOpcode:
+        printf("%04x %03d SetPropertyLength length=%d\n",
+           opcode, index, index);
+        break;
+
+      case copyPropertyOpcode:
+        printf("%04x     CopyProperty", opcode);
+        dumpData(instruction);
+        break;
+
+      case copyArrayPropertyOpcode:
+        printf("%04x     CopyArrayProperty", opcode);
+        dumpData(instruction);
+        break;
+
+      case endActorGroupOpcode:
+        printf("%04x     EndActorGroup\n", opcode);
+        break;
+
+      case copyDynamicPropertyOpcode:
+        {
+            char charbuf[9];
+            char nb;
+            int i;
+            int length = instruction->m_dataLength;
+            printf("%04x %03d CopyDynamicProperty\n", opcode, length);
+            for ( i=0 ; i<length ; i++ )
+            {
+                if ( i%8 == 0 )
+                {
+                    printf("         Data");
+                }
+                nb = instruction->m_data[i];
+                printf(" %02x", (unsigned char)nb);
+                if ( isprint((unsigned char)nb) )
+                {
+                    charbuf[i%8] = nb;
+                } else {
+                    charbuf[i%8] = '.';
+                }
+                if ( i%8 == 7 )
+                {
+                    charbuf[8] = 0;
+                    printf("    # \"%s\"\n", charbuf);
+                }
+            }
+            if ( i%8 != 0 )
+            {
+                charbuf[i%8] = 0;
+                for ( ; i%8!=0 ; i++ )
+                {
+                    printf("   ");
+                }
+                printf("    # \"%s\"\n", charbuf);
+            }
+        }
+        break;
+
+      case copyMediaRefOpcode:
+        printf("%04x %03d CopyMediaRef mediaref=%d\n",
+           opcode, index, index);
+        break;
+
+      case createSetOpcode:
+        printf("%04x %03d CreateSet set=%d\n", opcode, index, index);
+        break;
+
+      case endSetOpcode:
+        printf("%04x     EndSet\n", opcode);
+        break;
+
+      case defineClassLayoutOpcode:
+        {
+            MleDppClassLayout layout(m_littleEndian);
+            if (! layout.set(instruction))
+            {
+                printf("%04x %03d DefineClassLayout layout=%d\n", opcode, index, index);
+                printf("         # ERROR: malformed layout.\n");
+                break;
+            }
+            printf("%04x %03d DefineClassLayout layout=%d class=%d size=%d\n",
+               opcode, index, index, layout.getActorClass(), layout.getRecordSize());
+            for (int i = 0; i < layout.getNumProperties(); i++)
+                printf("         Property index=%d length=%d\n",
+                   layout.getPropertyOffset(i), layout.getPropertyLength(i));
+            for (int i = 0; i < layout.getNumBindings(); i++)
+                printf("         Binding set=%d role=%d\n",
+                   layout.getBindingSet(i), layout.getBindingRole(i));
+        }
+        break;
+
+      case createActorBlockOpcode:
+        printf("%04x %03d CreateActorBlock layout=%d actors=%d",
+           opcode, index, index, instruction->m_count);
+        dumpData(instruction);
+        break;
+
+      case defineStringPoolOpcode:
+        printf("%04x %03d DefineStringPool strings=%d\n", opcode, index, index);
+        if (! m_pool.set(instruction))
+        {
+            printf("         # ERROR: malformed string pool.\n");
+            break;
+        }
+        for (int i = 0; i < m_pool.getNumStrings(); i++)
+            printf("         String %d \"%s\"\n", i, m_pool.getString(i));
+        break;
+
+      case copyPooledStringOpcode:
+        if (m_pool.getString(index) != NULL)
+            printf("%04x %03d CopyPooledString string=%d # \"%s\"\n",
+               opcode, index, index, m_pool.getString(index));
+        else
+            printf("%04x %03d CopyPooledString string=%d\n", opcode, index, index);
+        break;
+
+      case copyEncodedArrayPropertyOpcode:
+        printf("%04x     CopyEncodedArray elements=%d encoding=%s", opcode,
+           instruction->m_operand,
+           (instruction->m_count == halfArrayEncoding) ? "half" :
+           ((instruction->m_count == norm16ArrayEncoding) ? "norm16" : "delta"));
+        dumpData(instruction);
+        break;
+    }
+
+    return TRUE;
+}
+
+void dumpGroupStream(unsigned char*& contents, int size, MlBoolean littleEndian)
+{
+    MleDppOpcodeDecoder decoder(littleEndian);
+    DumpVisitor visitor(littleEndian);
+    MlInt groupId, numActors;
+
+    if (size < (int)sizeof(int))
+    {
+        printf("# ERROR: chunk too short.\n");
+        return;
+    }
+
+    int offset = decoder.readInt(contents);
+    printf("Media Reference Offset (offset=%d)\n",offset);
+    contents += sizeof(int);
+    size -= sizeof(int);
+
+    int start = decoder.decodeGroupHeader(contents, size, &groupId, &numActors);
+    if (start < 0)
+    {
+        printf("# ERROR: malformed group header.\n");
+        return;
+    }
+    printf("Group Id: %d\n",groupId);
+    printf("Number of Actors: %d\n",numActors);
+
+    MleDppGroupHints hints(littleEndian);
+    if (hints.read(contents, size))
+    {
+        for (int i = 0; i < hints.getNumClasses(); i++)
+            printf("Hint: %d actors of class %d\n",
+               hints.getNumActors(i), hints.getActorClass(i));
+        printf("Hint: %d dynamic properties, %d bytes\n",
+           hints.getNumDynamic(), hints.getDynamicBytes());
+    }
+    printf("\n");
+
+    // The decoder checks every operand against the end of the stream.
+    int status = decoder.decode(contents, size, start, &visitor);
+    int stop = decoder.getOffset();
+    if (status == MLE_DPP_DECODE_BADOPCODE)
+    {
+        printf("         # ERROR: invalid opcode(%d)\n",contents[stop]);
+    } else if (status != MLE_DPP_DECODE_OK)
+    {
+        printf("         # ERROR: malformed instruction at offset %d (status %d)\n",
+           stop, status);
+    }
+    contents += stop;
+}
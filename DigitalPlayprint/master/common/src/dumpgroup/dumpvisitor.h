@@ -0,0 +1,61 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file dumpvisitor.h
+ * @ingroup MleDPPMaster
+ *
+ * Prints the instructions of Group chunks, for dumpgroup and dumpdpp.
+ */
+
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_DPP_DUMPVISITOR_H_
+#define __MLE_DPP_DUMPVISITOR_H_
+
+// Include Magic Lantern header files.
+#include <mle/mlTypes.h>
+
+/**
+ * Print a Group chunk: its media reference offset, its header and
+ * allocation hints, then each of its instructions. Malformed chunks are
+ * reported rather than trusted.
+ *
+ * @param contents The chunk, just past its size; it is advanced past
+ * the instructions that were printed.
+ * @param size The size of the chunk, in bytes.
+ * @param littleEndian TRUE if the chunk is Little Endian.
+ */
+extern void dumpGroupStream(unsigned char*& contents, int size,
+    MlBoolean littleEndian);
+
+#endif /* __MLE_DPP_DUMPVISITOR_H_ */
@@ -121,12 +121,19 @@ typedef struct _ArgStruct
     char       *package;      /* The Java package. */
     char       *tags;         /* Digital Workprint tags. */
     int        verbose;       /* Be verbose. */
+    MlBoolean  directory;     /* Emit actor directories. */
+    MlBoolean  elide;         /* Leave out default properties. */
+    MlBoolean  clone;         /* Write repeated actors as clones. */
+    MlBoolean  pool;          /* Pool the strings of each group. */
+    char       *encodings;    /* File of array property encodings. */
+    MlBoolean  order;         /* Order the properties of each actor. */
     char       *outputDir;    /* Directory to redirect output to. */
 } ArgStruct;
 
 
 const char *usage_str = "\
-Syntax:   gengroup  [-b|-l] [-f] [-j <package>|c] [-v] [-d <dir>]\n\
+Syntax:   gengroup  [-b|-l] [-f] [-j <package>|c] [-a] [-e] [-r] [-s] [-q <file>]\n\
+                    [-o] [-v] [-d <dir>]\n\
                     <tags> <workprint> <actor_id_file> <group_id_file>\n\
 \n\
           -b                   Use Big Endian byte ordering (default)\n\
@@ -134,6 +141,19 @@ Syntax:   gengroup  [-b|-l] [-f] [-j <package>|c] [-v] [-d <dir>]\n\
           -f                   Generate fixed-point arithmetic values\n\
           -c                   Generate C++ compliant files (default)\n\
           -j <package>         Gerneate Java compliant files\n\
+          -a                   Add an actor directory to each Group chunk\n\
+          -e                   Leave out properties equal to the class\n\
+                               default and report the bytes saved\n\
+          -r                   Write actors that repeat an earlier actor of\n\
+                               their group as clones of it (ignored with -a)\n\
+          -s                   Keep each distinct string of a group once,\n\
+                               in a string pool ahead of its actors\n\
+          -q <file>            Write the array properties named in <file> in\n\
+                               a smaller encoding; each line holds\n\
+                               <class>[.<property>] half|norm16|delta|full\n\
+          -o                   Write the properties of each actor grouped by\n\
+                               length and in runtime offset order, and\n\
+                               report the opcodes and bytes saved\n\
           -v                   Be verbose\n\
           -d <dir>             Directory where generate files are built\n\
           <tags>               Digital Workprint tags\n\
@@ -149,6 +169,50 @@ If the -j option is specified, then Java files will be generated for the Actor\n
 and Group ID files.\n";
 
 
+// Read the array encodings, one "<class>[.<property>] <encoding>" per line.
+static MlBoolean readArrayEncodings(const char *filename)
+{
+    // Declare local variables.
+    FILE *fp;
+    char line[512], name[256], value[32];
+    char *property;
+    int lineNumber = 0, encoding;
+
+    if ((fp = fopen(filename, "r")) == NULL)
+        return FALSE;
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        lineNumber++;
+        if (sscanf(line, "%255s %31s", name, value) != 2 || name[0] == '#')
+            continue;
+
+        if (strcmp(value, "half") == 0)
+            encoding = halfArrayEncoding;
+        else if (strcmp(value, "norm16") == 0)
+            encoding = norm16ArrayEncoding;
+        else if (strcmp(value, "delta") == 0)
+            encoding = deltaArrayEncoding;
+        else if (strcmp(value, "full") == 0)
+            encoding = 0;
+        else
+        {
+            fprintf(stderr, "%s:%d: unknown encoding \"%s\"\n",
+                filename, lineNumber, value);
+            fclose(fp);
+            return FALSE;
+        }
+
+        if ((property = strchr(name, '.')) != NULL)
+            *property++ = '\0';
+        MleDppActorGroupOutput::setArrayEncoding(name, property, encoding);
+    }
+
+    fclose(fp);
+    return TRUE;
+}
+
+
 int parseArgs(int argc, char *argv[], ArgStruct *args)
 {
     /* declare local variables */
@@ -158,7 +222,7 @@ int parseArgs(int argc, char *argv[], ArgStruct *args)
     extern int optind;
     
     errflg = 0;
-    while ((c = getopt(argc, argv, "blfj:cvd:")) != -1)
+    while ((c = getopt(argc, argv, "blfj:caersq:ovd:")) != -1)
     {
         switch (c)
         {
@@ -187,6 +251,30 @@ int parseArgs(int argc, char *argv[], ArgStruct *args)
             /* Place files in this directory. */
             args->outputDir = optarg;
             break;
+          case 'a':
+            /* Index the actors of each group. */
+            args->directory = TRUE;
+            break;
+          case 'e':
+            /* Elide default properties. */
+            args->elide = TRUE;
+            break;
+          case 'r':
+            /* Clone repeated actors. */
+            args->clone = TRUE;
+            break;
+          case 's':
+            /* Pool strings. */
+            args->pool = TRUE;
+            break;
+          case 'q':
+            /* Encode array properties. */
+            args->encodings = optarg;
+            break;
+          case 'o':
+            /* Order properties. */
+            args->order = TRUE;
+            break;
           case 'v':
             args->verbose = TRUE;
             break;
@@ -267,6 +355,12 @@ int main(int argc,char *argv[])
     args.package = NULL;
     args.tags = NULL;
     args.verbose = FALSE;
+    args.directory = FALSE;
+    args.elide = FALSE;
+    args.clone = FALSE;
+    args.pool = FALSE;
+    args.encodings = NULL;
+    args.order = FALSE;
     args.outputDir = NULL;
     if (! parseArgs(argc, argv, &args))
     {
@@ -278,6 +372,44 @@ int main(int argc,char *argv[])
     {
         MleDppActorGroupOutput::setVerbosity(TRUE);
     }
+
+    // Index the actors of each group chunk.
+    if (args.directory)
+    {
+        MleDppActorGroupOutput::setActorDirectory(TRUE);
+    }
+
+    // Leave out the properties actors are constructed with.
+    if (args.elide)
+    {
+        MleDppActorGroupOutput::setElideDefaults(TRUE);
+    }
+
+    // Write actors as copies of earlier ones where they can be.
+    if (args.clone)
+    {
+        MleDppActorGroupOutput::setCloneActors(TRUE);
+    }
+
+    // Keep one copy of each string of a group.
+    if (args.pool)
+    {
+        MleDppActorGroupOutput::setStringPool(TRUE);
+    }
+
+    // Share property offset and length opcodes between properties.
+    if (args.order)
+    {
+        MleDppActorGroupOutput::setOrderProperties(TRUE);
+    }
+
+    // Write the named array properties in a smaller encoding.
+    if (args.encodings && ! readArrayEncodings(args.encodings))
+    {
+        fprintf(stderr,"%s : %s\n",args.commandName,
+                "Unable to read array encodings");
+        exit(1);
+    }
     
     // Initialize Digital Playprint/Workprint toolkit.
     mleDppInit();
@@ -400,6 +532,14 @@ int main(int argc,char *argv[])
         ((MleDppSet *)items[i])->write(out);
     }
 
+    // Report what leaving out default properties saved.
+    if (args.elide)
+        out->reportElided(stdout);
+
+    // Report what ordering properties saved.
+    if (args.order)
+        out->reportOrdering(stdout);
+
     // Clean-up and return.
     delete out;
     return 0;
@@ -44,9 +44,8 @@
 #include <windows.h>
 #endif
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <sys/types.h>
-#include <time.h>
 
 // Include Magic Lantern header files.
 #include <mle/mlMalloc.h>
@@ -68,12 +67,11 @@
 #include <mle/DwpFinder.h>
 #include <mle/DwpMediaRef.h>
 
-// Include Digital Playprint Runtime header files.
-#include "mle/mrefchk.h"
-
 // Include Digital Playprint header files.
 #include "mle/DppTblMgr.h"
 
+#include "mediaout.h"
+
 #define MLE_DWP_TYPE_MEDIAREF  "MleDwpMediaRef"
 #define MLE_DWP_TYPE_TARGET    "MleDwpMediaRefTarget"
 
@@ -120,14 +118,17 @@ typedef struct _ArgStruct
     char       *inventory;    /* Name of media inventory file to build. */
     char       *tags;         /* Digital Workprint tags. */
     char       *outputDir;    /* Directory where chunk files get built. */
+    int        jobs;          /* Number of chunk file writers (0 = one per processor). */
 } ArgStruct;
 
 
 const char *usage_str = "\
-Syntax:   genmedia  [-b|-l] [-d <directory>] <tags> <workprint> <media_inventory>\n\
+Syntax:   genmedia  [-b|-l] [-d <directory>] [-j <jobs>] <tags> <workprint> <media_inventory>\n\
           -b                   Use Big Endian byte ordering\n\
           -l                   Use Little Endian byte ordering\n\
           -d <directory>       Directory where chunk files are built\n\
+          -j <jobs>            Number of chunk files to write at once\n\
+                               (default is one per processor)\n\
           <tags>               Digital Workprint tags\n\
           <workprint>          Digital Workprint\n\
           <media_inventory>    Generated media inventory file\n\
@@ -154,7 +155,7 @@ int parseArgs(int argc, char *argv[], ArgStruct *args)
 
     errflg = 0;
     //while ((c = getopt(argc, argv, "bld::")) != -1)
-    while ((c = getopt(argc, argv, "bld:")) != -1)
+    while ((c = getopt(argc, argv, "bld:j:")) != -1)
     {
         switch (c)
         {
@@ -170,6 +171,12 @@ int parseArgs(int argc, char *argv[], ArgStruct *args)
             /* Place files in this directory. */
             args->outputDir = optarg;
             break;
+          case 'j':
+            /* Write this many chunk files at once. */
+            args->jobs = atoi(optarg);
+            if (args->jobs <= 0)
+                errflg++;
+            break;
           case '?':
             errflg++;
         }
@@ -220,45 +227,12 @@ int parseArgs(int argc, char *argv[], ArgStruct *args)
     return TRUE;
 }
 
-// The global directory for generated output.
-static MlePath *g_outputDir = NULL;
-
-
-// Utility to append the global directory path to the specified path.
-static char *_expandPath(char * path)
-{
-    MLE_ASSERT(path);
-
-    MlePath *dir = g_outputDir;
-
-    // Expand directory path, if necessary.
-    char *tmpPath;
-    if (dir != NULL)
-    {
-        tmpPath = (char *)mlMalloc(strlen((char *)dir->getPlatformPath()) + strlen(path) + 2);
-        strcpy(tmpPath,(char *)dir->getPlatformPath());
-#ifdef _WINDOWS
-        strcat(tmpPath,"\\");
-#else /* ! _WINDOWS */
-        strcat(tmpPath,"/");
-#endif /* _WINDOWS */
-        strcat(tmpPath,path);
-    } else
-        tmpPath = path;
-
-    return tmpPath;
-}
-
-
 int
 main(int argc,char **argv)
 {
     // Declare local variables.
     ArgStruct args;
-    int littleEndian = 0;
-    FILE *inventoryOut = NULL;
     MleDwpInput *in;
-    MleMrefChunkFile *out;
 
     // parse arguments
     args.commandName = argv[0];
@@ -268,49 +242,11 @@ main(int argc,char **argv)
     args.inventory = NULL;
     args.tags = NULL;
     args.outputDir = NULL;
+    args.jobs = 0;
     if (! parseArgs(argc, argv, &args))
     {
       exit(1);
     }
-    
-    // Redirect generated output.
-#ifdef _WINDOWS
-    if (args.outputDir != NULL)
-    {
-        g_outputDir = new MleWin32Path((MlChar *)args.outputDir,true);
-    }
-#else
-    if (args.outputDir != NULL)
-    {
-        g_outputDir = new MleLinuxPath((MlChar *)args.outputDir,true);
-    }
-#endif /* _WINDOWS */
-
-    // Check for Little Endian  byte ordering.
-    if (args.byteOrder)
-        littleEndian = 1;
-
-    // Open output file (media inventory file).
-    if (args.inventory != NULL)
-    {
-        char * inventoryPath;
-        if (g_outputDir != NULL)
-            inventoryPath = _expandPath(args.inventory);
-        else
-            inventoryPath = args.inventory;
-        inventoryOut = mlFOpen(inventoryPath, "w");
-
-        if (g_outputDir != NULL)
-            mlFree(inventoryPath);
-
-        fprintf(inventoryOut,"/*\n * Digital Workprint: %s\n * Media Inventory\n */\n",
-            args.workprint);
-    } else
-    {
-        fprintf(stderr,"%s : Error : Could not create media inventory file %s.[c,h]\n",
-               args.commandName,args.inventory);
-        return 1;
-    }
 
     // Initialize Workprint readers and writers.
     mleDwpInit();
@@ -339,43 +275,8 @@ main(int argc,char **argv)
         exit(1);
     }
 
-    // Set discriminators for finding all MediaRefs.
-    char *processTags;
-    char *tag,*nextTag;
-    MleDwpTagAllDiscriminator *discriminator = new MleDwpTagAllDiscriminator;
-#if defined(_WINDOWS)
-    processTags = _strdup(args.tags);
-#else
-    processTags = strdup(args.tags);
-#endif
-    tag = processTags;
-    while (tag)
-    {
-        nextTag = strchr(tag,':');
-        if (nextTag) *nextTag++ = '\0';
-        discriminator->addTag(tag);
-        tag = nextTag;
-    }
-    root->setDiscriminator(discriminator);
-    mlFree(processTags);
-
-    // Find all MediaRef items in the DWP.
-    MleDwpFinder mediaRefFinder;
-    MleDwpMediaRef **mediaRefItems;
-    MleDwpMediaRefTargetMedia *entries;
-    int numItems,numEntries;
-
-    mediaRefFinder.setType(MleDwpMediaRef::typeId);
-    mediaRefFinder.setFindAll(1);
-    mediaRefFinder.find(root);
-    mediaRefItems = (MleDwpMediaRef **)mediaRefFinder.getItems();
-    numItems = mediaRefFinder.getNumItems();
-
-    // Create Digital Playprint media chunk files
-    // and media inventory file for the given target
-    // MleDppMediaOutput *pp_out = new MleDppMediaOutput(args.tags,0,littleEndian);
-
-    // Process the media references.
+    // Set discriminators for finding all MediaRefs, and build the
+    // table of MediaRef classes.
     MleDppTblMgr tblMgr;
     tblMgr.setDiscriminators(root, args.tags);
     if (! tblMgr.buildIndexTables(root)) {
@@ -383,143 +284,15 @@ main(int argc,char **argv)
                 "Unable to build table of MediaRef classes.");
         return(-1);
     }
-    TblMgrItems *mrefTable = tblMgr.getMediaRefTable();
-
-    MleDwpMediaRef *nextMediaRef;
-    unsigned long mrefType;
-
-    for (int i = 0; i < numItems; i++)
-    {
-        MleChunkFileHeader hdrData;
-        MleMediaRefInfoChunk mrefInfo;
-
-        // Initialize chunk file header info.
-        hdrData.m_id = i;
-        hdrData.m_version = MleMrefChunkFile::PLAYPRINT_VERSION;
-        hdrData.m_time = time(NULL);
-        hdrData.m_crc = 0;
-
-        nextMediaRef = mediaRefItems[i];
-
-        // Build filename string.
-        char *fileName = (char *) mlMalloc(strlen(nextMediaRef->getName())+5);
-        strcpy(fileName,nextMediaRef->getName());
-        strcat(fileName,".chk");
-
-        // Redirect the generated output.
-        char *filePath;
-        if (g_outputDir != NULL)
-        {
-            filePath = _expandPath(fileName);
-        } else
-            filePath = fileName;
-
-        // Create chunk file.
-        out = new MleMrefChunkFile(filePath,MleChunkFile::WRITING);
-        if (littleEndian)
-        {
-#if BYTE_ORDER == BIG_ENDIAN
-            out->setSwap(TRUE);
-#endif
-            out->begin(MLE_DPP_CREATEPPLE);
-        } else {
-#if BYTE_ORDER == LITTLE_ENDIAN
-            out->setSwap(TRUE);
-#endif
-            out->begin(MLE_DPP_CREATEPPBE);
-        }
-        out->writeHeader(&hdrData);
-        out->beginList();
-
-        // Calculate class table index.
-        mrefType = 0;
-        for (int k = 0; k < tblMgr.getMediaRefTableSize(); k++)
-        {
-            if (! strcmp(nextMediaRef->getMediaRefClass(),
-                         ((MediaRefClassTableItem *)mrefTable->items[k])->name))
-                break;
-            else
-                mrefType++;
-        }
-
-        // Retrieve target entries from MediaRef.
-        numEntries = nextMediaRef->queryTargetEntries(&entries);
-
-        // Write MediaRef 'info' chunk.
-        mrefInfo.m_flags = 0;
-        mrefInfo.m_type = mrefType;
-        mrefInfo.m_numMrefs = numEntries;
-        out->writeInfo(&mrefInfo);
-
-        // Process target entries.
-        for (int j = 0; j < numEntries; j++)
-        {
-            MleMediaRefChunk mrefData;
-
-            if (entries[j].m_flags == MleMrefChunkFile::EXTERNAL)
-            {
-                // Process media data.
-                //char *targetFilename = (char *)mlMalloc(
-                //    strlen(entries[j].m_filename)+1);
-                //strcpy(targetFilename,entries[j].m_filename);
-#ifdef _WINDOWS
-                MleWin32Path *targetPath = new MleWin32Path((MlChar *)entries[j].m_filename,false);
-#else
-                MleLinuxPath *targetPath = new MleLinuxPath((MlChar *)entries[j].m_filename,false);
-#endif
 
-                mrefData.m_flags = MleMrefChunkFile::EXTERNAL;
-                //mrefData.m_size = strlen(targetFilename);
-                mrefData.m_size = strlen((char *)targetPath->getPlatformPath());
-                mrefData.m_type = mlDppStringToTag(entries[j].m_label,0);
-                //mrefData.m_data = targetFilename;
-                mrefData.m_data = (char *)targetPath->getPlatformPath();
-
-                // Write chunk data.
-                out->writeData(&mrefData);
-
-                // Clean up.
-                //mlFree(targetFilename);
-                delete targetPath;
-            } else
-            {
-                printf("%s: Warning: %s, %s\n",
-                       args.commandName,
-                       nextMediaRef->getName(),
-                       "internal media referencing is not supported in this release.");
-                return 1;
-            }
-        }
-
-        // Close chunk file.
-        out->endList();
-        out->end();
-        delete out;
-
-        // Process inventory file.
-        if (inventoryOut != NULL)
-            fprintf(inventoryOut,
-                "\nMEDIA %s (INVENTORY NOT YET SUPPORTED)\n",
-                nextMediaRef->getName());
-
-        // Clean up.
-        mlFree(fileName);
-        mlFree(entries);
-        if (g_outputDir != NULL)
-        {
-            mlFree(filePath);
-        }
-    }
+    // Create Digital Playprint media chunk files
+    // and media inventory file for the given target.
+    int status = genMediaChunks(root, &tblMgr, args.commandName,
+        args.workprint, args.inventory, args.outputDir,
+        args.byteOrder, args.jobs);
 
     // Close the DWP.
     in->closeFile();
 
-    // Close the inventory file.
-    if (inventoryOut != NULL)
-        mlFClose(inventoryOut);
-
-    // Cleanup and exit.
-    delete g_outputDir;
-
-    return 0;
+    return status;
 }
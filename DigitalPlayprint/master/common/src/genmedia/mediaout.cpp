@@ -0,0 +1,436 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file mediaout.cpp
+ * @ingroup MleDPPMaster
+ *
+ * Writes the MediaRef chunk files of a Digital Workprint.
+ */
+
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#ifdef _WINDOWS
+#include <windows.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <time.h>
+#include <atomic>
+#include <thread>
+
+// Include Magic Lantern header files.
+#include <mle/mlMalloc.h>
+#include <mle/mlFileio.h>
+#include <mle/mlAssert.h>
+#include <mle/MlePath.h>
+#ifdef _WINDOWS
+#include <mle/MleWin32Path.h>
+#else
+#include <mle/MleLinuxPath.h>
+#endif
+
+// Include Digital Workprint header files.
+#include <mle/Dwp.h>
+#include <mle/DwpItem.h>
+#include <mle/DwpFinder.h>
+#include <mle/DwpMediaRef.h>
+
+// Include Digital Playprint Runtime header files.
+#include "mle/mrefchk.h"
+
+// Include Digital Playprint header files.
+#include "mle/DppTblMgr.h"
+
+#include "mediaout.h"
+
+
+// Utility to append a directory path to the specified path.
+static char *_expandPath(MlePath *dir, char *path)
+{
+    MLE_ASSERT(path);
+
+    // Expand directory path, if necessary.
+    char *tmpPath;
+    if (dir != NULL)
+    {
+        tmpPath = (char *)mlMalloc(strlen((char *)dir->getPlatformPath()) + strlen(path) + 2);
+        strcpy(tmpPath,(char *)dir->getPlatformPath());
+#ifdef _WINDOWS
+        strcat(tmpPath,"\\");
+#else /* ! _WINDOWS */
+        strcat(tmpPath,"/");
+#endif /* _WINDOWS */
+        strcat(tmpPath,path);
+    } else
+        tmpPath = path;
+
+    return tmpPath;
+}
+
+
+// An entry of the MediaRef class table, for finding class indexes by name.
+typedef struct _MediaRefClassIndex
+{
+    char *name;   /* Name of the MediaRef class. */
+    int  index;   /* Index of the class in the table. */
+} MediaRefClassIndex;
+
+// Order class table entries by name, then by index.
+static int _compareClassIndex(const void *a, const void *b)
+{
+    const MediaRefClassIndex *x = (const MediaRefClassIndex *)a;
+    const MediaRefClassIndex *y = (const MediaRefClassIndex *)b;
+    int cmp = strcmp(x->name, y->name);
+
+    if (cmp != 0)
+        return cmp;
+    return x->index - y->index;
+}
+
+// Match a class table entry by name only.
+static int _compareClassName(const void *a, const void *b)
+{
+    return strcmp(((const MediaRefClassIndex *)a)->name,
+                  ((const MediaRefClassIndex *)b)->name);
+}
+
+
+// One media reference chunk file to write.
+typedef struct _MediaJob
+{
+    char          *filePath;    /* Path of the chunk file. */
+    const char    *name;        /* Name of the media reference. */
+    unsigned long mrefType;     /* Index of the MediaRef class. */
+    int           numEntries;   /* Number of target entries. */
+    MlUInt        *labels;      /* Tag of each target entry. */
+    char          **paths;      /* Platform path of each target entry. */
+    MlBoolean     written;      /* TRUE once the chunk file is complete. */
+} MediaJob;
+
+// The chunk files shared out between the workers.
+typedef struct _MediaQueue
+{
+    MediaJob         *jobs;          /* The chunk files, in workprint order. */
+    int              numJobs;        /* Number of chunk files. */
+    std::atomic<int> next;           /* Next chunk file to write. */
+    int              littleEndian;   /* Write Little Endian chunk files. */
+    time_t           time;           /* Time stamp of every chunk file. */
+} MediaQueue;
+
+
+// Write the chunk file of one media reference.
+static MlBoolean _writeMediaChunk(MediaJob *job, int id, int littleEndian, time_t now)
+{
+    MleChunkFileHeader hdrData;
+    MleMediaRefInfoChunk mrefInfo;
+    MlBoolean ok;
+
+    // Initialize chunk file header info.
+    hdrData.m_id = id;
+    hdrData.m_version = MleMrefChunkFile::PLAYPRINT_VERSION;
+    hdrData.m_time = (MlUInt)now;
+    hdrData.m_crc = 0;
+
+    // Create chunk file.
+    MleMrefChunkFile *out = new MleMrefChunkFile(job->filePath,MleChunkFile::WRITING);
+    if (out->getFp() == NULL)
+    {
+        delete out;
+        return FALSE;
+    }
+    if (littleEndian)
+    {
+#if BYTE_ORDER == BIG_ENDIAN
+        out->setSwap(TRUE);
+#endif
+        ok = out->begin(MLE_DPP_CREATEPPLE);
+    } else {
+#if BYTE_ORDER == LITTLE_ENDIAN
+        out->setSwap(TRUE);
+#endif
+        ok = out->begin(MLE_DPP_CREATEPPBE);
+    }
+    ok = ok && out->writeHeader(&hdrData);
+    ok = ok && out->beginList();
+
+    // Write MediaRef 'info' chunk.
+    mrefInfo.m_flags = 0;
+    mrefInfo.m_type = job->mrefType;
+    mrefInfo.m_numMrefs = job->numEntries;
+    ok = ok && out->writeInfo(&mrefInfo);
+
+    // Process target entries.
+    for (int j = 0; ok && (j < job->numEntries); j++)
+    {
+        MleMediaRefChunk mrefData;
+
+        mrefData.m_flags = MleMrefChunkFile::EXTERNAL;
+        mrefData.m_size = strlen(job->paths[j]);
+        mrefData.m_type = job->labels[j];
+        mrefData.m_data = job->paths[j];
+
+        // Write chunk data.
+        ok = out->writeData(&mrefData);
+    }
+
+    // Close chunk file.
+    ok = ok && out->endList();
+    ok = ok && out->end();
+    delete out;
+
+    return ok;
+}
+
+// Write chunk files until there are none left.
+static void _runMediaWorker(MediaQueue *queue)
+{
+    int i;
+
+    while ((i = queue->next.fetch_add(1)) < queue->numJobs)
+        queue->jobs[i].written = _writeMediaChunk(&queue->jobs[i], i,
+            queue->littleEndian, queue->time);
+}
+
+
+int genMediaChunks(MleDwpItem *root, MleDppTblMgr *tables,
+    const char *commandName, const char *workprint, char *inventory,
+    const char *outputDir, MlBoolean littleEndian, int jobs)
+{
+    // Declare local variables.
+    MlePath *dir = NULL;
+    FILE *inventoryOut = NULL;
+    int status = 0;
+
+    // Redirect generated output.
+#ifdef _WINDOWS
+    if (outputDir != NULL)
+    {
+        dir = new MleWin32Path((MlChar *)outputDir,true);
+    }
+#else
+    if (outputDir != NULL)
+    {
+        dir = new MleLinuxPath((MlChar *)outputDir,true);
+    }
+#endif /* _WINDOWS */
+
+    // Open output file (media inventory file).
+    char *inventoryPath = _expandPath(dir, inventory);
+    inventoryOut = mlFOpen(inventoryPath, "w");
+    if (dir != NULL)
+        mlFree(inventoryPath);
+    if (inventoryOut == NULL)
+    {
+        fprintf(stderr,"%s : Error : Could not create media inventory file %s.\n",
+               commandName,inventory);
+        delete dir;
+        return 1;
+    }
+
+    fprintf(inventoryOut,"/*\n * Digital Workprint: %s\n * Media Inventory\n */\n",
+        workprint);
+
+    // Find all MediaRef items in the DWP.
+    MleDwpFinder mediaRefFinder;
+    MleDwpMediaRef **mediaRefItems;
+    MleDwpMediaRefTargetMedia *entries;
+    int numItems;
+
+    mediaRefFinder.setType(MleDwpMediaRef::typeId);
+    mediaRefFinder.setFindAll(1);
+    mediaRefFinder.find(root);
+    mediaRefItems = (MleDwpMediaRef **)mediaRefFinder.getItems();
+    numItems = mediaRefFinder.getNumItems();
+
+    // Process the media references.
+    TblMgrItems *mrefTable = tables->getMediaRefTable();
+
+    // Find the class index of each media reference once, up front.
+    int numClasses = tables->getMediaRefTableSize();
+    MediaRefClassIndex *classIndex = (MediaRefClassIndex *)
+        mlMalloc((numClasses + 1) * sizeof(MediaRefClassIndex));
+    for (int k = 0; k < numClasses; k++)
+    {
+        classIndex[k].name = ((MediaRefClassTableItem *)mrefTable->items[k])->name;
+        classIndex[k].index = k;
+    }
+    qsort(classIndex, numClasses, sizeof(MediaRefClassIndex), _compareClassIndex);
+
+    // Gather what each chunk file needs, so that the workers only write.
+    // The workprint and path classes are only used from this thread.
+    MediaJob *mediaJobs = (MediaJob *)mlMalloc((numItems + 1) * sizeof(MediaJob));
+    int numJobs;
+    for (numJobs = 0; (numJobs < numItems) && (status == 0); numJobs++)
+    {
+        MleDwpMediaRef *nextMediaRef = mediaRefItems[numJobs];
+        MediaJob *job = &mediaJobs[numJobs];
+
+        // Build filename string.
+        char *fileName = (char *) mlMalloc(strlen(nextMediaRef->getName())+5);
+        strcpy(fileName,nextMediaRef->getName());
+        strcat(fileName,".chk");
+
+        // Redirect the generated output.
+        if (dir != NULL)
+        {
+            job->filePath = _expandPath(dir, fileName);
+            mlFree(fileName);
+        } else
+            job->filePath = fileName;
+
+        // Calculate class table index; unknown classes get the table size.
+        MediaRefClassIndex key, *found;
+        key.name = (char *)nextMediaRef->getMediaRefClass();
+        key.index = -1;
+        found = (MediaRefClassIndex *)bsearch(&key, classIndex, numClasses,
+            sizeof(MediaRefClassIndex), _compareClassName);
+        if (found != NULL)
+        {
+            // Class names may repeat; the first entry in the table wins.
+            while ((found > classIndex) && ! strcmp(found[-1].name, key.name))
+                found--;
+            job->mrefType = found->index;
+        } else
+            job->mrefType = numClasses;
+
+        // Retrieve target entries from MediaRef.
+        int numEntries = nextMediaRef->queryTargetEntries(&entries);
+        job->name = nextMediaRef->getName();
+        job->numEntries = 0;
+        job->labels = (MlUInt *)mlMalloc((numEntries + 1) * sizeof(MlUInt));
+        job->paths = (char **)mlMalloc((numEntries + 1) * sizeof(char *));
+        job->written = FALSE;
+
+        for (int j = 0; j < numEntries; j++)
+        {
+            if (entries[j].m_flags == MleMrefChunkFile::EXTERNAL)
+            {
+#ifdef _WINDOWS
+                MleWin32Path *targetPath = new MleWin32Path((MlChar *)entries[j].m_filename,false);
+                job->paths[j] = _strdup((char *)targetPath->getPlatformPath());
+#else
+                MleLinuxPath *targetPath = new MleLinuxPath((MlChar *)entries[j].m_filename,false);
+                job->paths[j] = strdup((char *)targetPath->getPlatformPath());
+#endif
+                job->labels[j] = mlDppStringToTag(entries[j].m_label,0);
+                job->numEntries++;
+
+                // Clean up.
+                delete targetPath;
+            } else
+            {
+                printf("%s: Warning: %s, %s\n",
+                       commandName,
+                       nextMediaRef->getName(),
+                       "internal media referencing is not supported in this release.");
+                status = 1;
+                break;
+            }
+        }
+        mlFree(entries);
+    }
+    mlFree(classIndex);
+
+    // As before, the media references ahead of an internal one are still
+    // written; the internal one and those after it are not.
+    int numReady = (status == 0) ? numJobs : numJobs - 1;
+
+    // Write the chunk files. Each worker takes the next unwritten media
+    // reference until none are left, so a slow file does not hold up
+    // the others.
+    if (numReady > 0)
+    {
+        MediaQueue queue;
+        queue.jobs = mediaJobs;
+        queue.numJobs = numReady;
+        queue.next = 0;
+        queue.littleEndian = littleEndian ? 1 : 0;
+        queue.time = time(NULL);
+
+        int numWorkers = jobs;
+        if (numWorkers <= 0)
+            numWorkers = (int)std::thread::hardware_concurrency();
+        if (numWorkers > numReady)
+            numWorkers = numReady;
+        if (numWorkers <= 1)
+            _runMediaWorker(&queue);
+        else
+        {
+            std::thread *workers = new std::thread[numWorkers];
+            for (int i = 0; i < numWorkers; i++)
+                workers[i] = std::thread(_runMediaWorker, &queue);
+            for (int i = 0; i < numWorkers; i++)
+                workers[i].join();
+            delete [] workers;
+        }
+    }
+
+    // Report in workprint order, so the inventory is the same however
+    // the work was shared out.
+    for (int i = 0; i < numJobs; i++)
+    {
+        MediaJob *job = &mediaJobs[i];
+
+        if (i < numReady)
+        {
+            if (! job->written)
+            {
+                fprintf(stderr,"%s : Error : Unable to write media chunk file %s.\n",
+                        commandName, job->filePath);
+                status = 1;
+            }
+
+            // Process inventory file.
+            fprintf(inventoryOut,
+                "\nMEDIA %s (INVENTORY NOT YET SUPPORTED)\n",
+                job->name);
+        }
+
+        // Clean up.
+        for (int j = 0; j < job->numEntries; j++)
+            free(job->paths[j]);
+        mlFree(job->paths);
+        mlFree(job->labels);
+        mlFree(job->filePath);
+    }
+    mlFree(mediaJobs);
+
+    // Close the inventory file.
+    mlFClose(inventoryOut);
+    delete dir;
+
+    return status;
+}
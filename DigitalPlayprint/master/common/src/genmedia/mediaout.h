@@ -0,0 +1,74 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file mediaout.h
+ * @ingroup MleDPPMaster
+ *
+ * Writes the MediaRef chunk files of a Digital Workprint.
+ */
+
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_DPP_MEDIAOUT_H_
+#define __MLE_DPP_MEDIAOUT_H_
+
+// Include Magic Lantern header files.
+#include <mle/mlTypes.h>
+
+// Declare external references.
+class MleDwpItem;
+class MleDppTblMgr;
+
+/**
+ * Write a chunk file for each MediaRef of the workprint, and the media
+ * inventory file.
+ *
+ * @param root The workprint, with its discriminators set.
+ * @param tables The index tables of the workprint.
+ * @param commandName The name of the command, for messages.
+ * @param workprint The name of the workprint, for the inventory.
+ * @param inventory The name of the media inventory file.
+ * @param outputDir The directory where files are written, or NULL.
+ * @param littleEndian TRUE to write Little Endian chunk files.
+ * @param jobs The number of chunk files to write at once; 0 means one
+ * per processor.
+ *
+ * @return 0 is returned if every file was written. A MediaRef with
+ * internal media is not supported; the chunk files ahead of it are still
+ * written, but not its own or any after it, and 1 is returned.
+ */
+extern int genMediaChunks(MleDwpItem *root, MleDppTblMgr *tables,
+    const char *commandName, const char *workprint, char *inventory,
+    const char *outputDir, MlBoolean littleEndian, int jobs);
+
+#endif /* __MLE_DPP_MEDIAOUT_H_ */
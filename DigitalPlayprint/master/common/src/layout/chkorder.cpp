@@ -0,0 +1,392 @@
+/**
+ * @file chkorder.cpp
+ * @ingroup MleDPPMaster
+ *
+ * Chunk ordering phase of Digital Playprint construction.
+ *
+ * This module decides the order chunks are written in, so that the data
+ * of a scene can be read with as few seeks as possible. The order comes
+ * from the scenes themselves or from traces of a title being played.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source code, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+
+// Include system header files.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Include Magic Lantern header files.
+#include <mle/mlMalloc.h>
+#include <mle/mlAssert.h>
+
+// Include Digital Playprint header files.
+#include "mle/scenechk.h"
+#include "pplayout.h"
+
+
+/*
+ * The chunks each chunk needs, as chunk table indexes: a scene needs
+ * its groups, a group its media and the sets its actors are placed in.
+ */
+typedef struct {
+    MlInt *m_needs;
+    MlInt  m_numNeeds;
+} ChunkNeeds;
+
+static MlInt findChunk(MleDppChunkTable *chunks, MlChunkEntryType type, const char *name)
+{
+    for (MlInt i = 0; i < chunks->getUsed(); i++)
+    {
+        if (chunks->getType(i) == type && strcmp(chunks->getName(i), name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void readGroupNeeds(LayoutState *state, MlInt index,
+                           const MlInt *setChunks, int numSets, ChunkNeeds *entry)
+{
+    MleDppChunkTable *chunks = state->m_chunks;
+
+    // Group chunk files are read as MleDppOutput::writeGroup() reads them.
+    MlBoolean isLittle = state->m_byteOrder;
+#if BYTE_ORDER == LITTLE_ENDIAN
+    isLittle = ML_TRUE;
+#endif
+    MleDppActorGroupChunk *groupChunk =
+        new MleDppActorGroupChunk(chunks->getFilename(index), isLittle);
+
+    // The sets are only known once the group has been parsed; the media
+    // indexes do not matter for that.
+    MlInt numMedia = groupChunk->countNames();
+    MlInt *indices = (MlInt *) mlMalloc((numMedia + 1) * sizeof(MlInt));
+    memset(indices, 0, (numMedia + 1) * sizeof(MlInt));
+    MlInt size;
+    mlFree((void *) groupChunk->resolveNames(&size, indices));
+    mlFree(indices);
+
+    const MlInt *sets = groupChunk->getSets();
+    MlInt numGroupSets = groupChunk->countSets();
+    entry->m_needs = (MlInt *) mlMalloc((numMedia + numGroupSets + 1) * sizeof(MlInt));
+    entry->m_numNeeds = 0;
+
+    // Sets come first; every actor is placed in one.
+    for (MlInt i = 0; i < numGroupSets; i++)
+    {
+        if (sets[i] >= 0 && sets[i] < numSets && setChunks[sets[i]] >= 0)
+            entry->m_needs[entry->m_numNeeds++] = setChunks[sets[i]];
+    }
+
+    // Media references are resolved by name, as writeGroup() does.
+    if (numMedia > 0)
+    {
+        for (const char *name = groupChunk->getNames(); name != NULL;
+             name = groupChunk->nextName(name))
+        {
+            MlInt media = findChunk(chunks, CHUNK_MEDIA, name);
+            if (media >= 0)
+                entry->m_needs[entry->m_numNeeds++] = media;
+        }
+    }
+
+    delete groupChunk;
+}
+
+static void readSceneNeeds(LayoutState *state, MlInt index, ChunkNeeds *entry)
+{
+    MleDppChunkTable *chunks = state->m_chunks;
+    MleDppSceneChunk *sceneChunk =
+        new MleDppSceneChunk(chunks->getFilename(index), state->m_byteOrder);
+
+    MlInt numGroups = sceneChunk->countNames();
+    entry->m_needs = (MlInt *) mlMalloc((numGroups + 1) * sizeof(MlInt));
+    entry->m_numNeeds = 0;
+    if (numGroups > 0)
+    {
+        for (const char *name = sceneChunk->getNames(); name != NULL;
+             name = sceneChunk->nextName(name))
+        {
+            MlInt group = findChunk(chunks, CHUNK_GROUP, name);
+            if (group >= 0)
+                entry->m_needs[entry->m_numNeeds++] = group;
+        }
+    }
+
+    delete sceneChunk;
+}
+
+/*
+ * Place a chunk after everything it needs that has not been placed yet,
+ * so that a scene can be loaded front to back.
+ */
+static void placeChunk(MlInt index, ChunkNeeds *needs, MlBoolean *placed,
+                       MlInt *order, int *numPlaced)
+{
+    if (placed[index])
+        return;
+    placed[index] = TRUE;
+
+    for (MlInt i = 0; i < needs[index].m_numNeeds; i++)
+        placeChunk(needs[index].m_needs[i], needs, placed, order, numPlaced);
+
+    order[(*numPlaced)++] = index;
+}
+
+/*
+ * Order the chunks so that the data of each scene, in chunk table order,
+ * is contiguous: its sets and media, each group after what it needs, then
+ * the scene chunk. Data shared between scenes is placed with the first
+ * scene to use it. Chunks no scene needs keep their relative
+ * order at the end. Returns the number of chunks in order[], which is
+ * only a write order; the chunk table, and so the TOC indexes, are left
+ * alone.
+ */
+int layoutSceneOrder(LayoutState *state, const MlInt *setChunks, int numSets, MlInt *order)
+{
+    MleDppChunkTable *chunks = state->m_chunks;
+    int numChunks = chunks->getUsed();
+    int numPlaced = 0;
+    MlInt i;
+
+    ChunkNeeds *needs = (ChunkNeeds *) mlMalloc((numChunks + 1) * sizeof(ChunkNeeds));
+    MlBoolean *placed = (MlBoolean *) mlMalloc((numChunks + 1) * sizeof(MlBoolean));
+    MLE_ASSERT(needs && placed);
+    memset(needs, 0, (numChunks + 1) * sizeof(ChunkNeeds));
+    memset(placed, 0, (numChunks + 1) * sizeof(MlBoolean));
+
+    for (i = 0; i < numChunks; i++)
+    {
+        if (chunks->getType(i) == CHUNK_GROUP)
+            readGroupNeeds(state, i, setChunks, numSets, &needs[i]);
+        else if (chunks->getType(i) == CHUNK_SCENE)
+            readSceneNeeds(state, i, &needs[i]);
+    }
+
+    for (i = 0; i < numChunks; i++)
+    {
+        if (chunks->getType(i) == CHUNK_SCENE)
+            placeChunk(i, needs, placed, order, &numPlaced);
+    }
+    for (i = 0; i < numChunks; i++)
+    {
+        if (! placed[i])
+            placeChunk(i, needs, placed, order, &numPlaced);
+    }
+
+    for (i = 0; i < numChunks; i++)
+    {
+        if (needs[i].m_needs)
+            mlFree(needs[i].m_needs);
+    }
+    mlFree(needs);
+    mlFree(placed);
+
+    return numPlaced;
+}
+
+/*
+ * Reads that follow each other this closely (in milliseconds) are taken
+ * to belong to the same load, and their chunks to be needed together.
+ */
+#define TRACE_BURST_GAP 100
+
+/*
+ * How soon each chunk is first read, summed over the traces that read it.
+ */
+typedef struct {
+    MlInt  m_index;       /* Chunk table index. */
+    double m_burst;       /* When the load that first read it began. */
+    double m_first;       /* When it was first read. */
+    double m_rank;        /* How many chunks were read before it. */
+    int    m_numTraces;   /* Number of traces that read it. */
+} ChunkAccess;
+
+static int compareAccess(const void *a, const void *b)
+{
+    const ChunkAccess *aAccess = (const ChunkAccess *) a;
+    const ChunkAccess *bAccess = (const ChunkAccess *) b;
+
+    // Averages over the traces that read each chunk.
+    double aBurst = aAccess->m_burst / aAccess->m_numTraces;
+    double bBurst = bAccess->m_burst / bAccess->m_numTraces;
+    if (aBurst != bBurst)
+        return (aBurst < bBurst) ? -1 : 1;
+    double aFirst = aAccess->m_first / aAccess->m_numTraces;
+    double bFirst = bAccess->m_first / bAccess->m_numTraces;
+    if (aFirst != bFirst)
+        return (aFirst < bFirst) ? -1 : 1;
+    double aRank = aAccess->m_rank / aAccess->m_numTraces;
+    double bRank = bAccess->m_rank / bAccess->m_numTraces;
+    if (aRank != bRank)
+        return (aRank < bRank) ? -1 : 1;
+    return aAccess->m_index - bAccess->m_index;
+}
+
+static MlBoolean readTrace(const char *filename, int numChunks, ChunkAccess *access)
+{
+    MleDppTraceHeader header;
+    MleDppTraceRecord record;
+    MlBoolean swap;
+
+    FILE *fp = mlFOpen(filename, "rb");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "Warning: unable to open trace %s.\n", filename);
+        return FALSE;
+    }
+
+    // Traces are written in the byte order of the machine that ran the title.
+    if (mlFRead(&header, sizeof(header), 1, fp) != 1 ||
+        (header.m_magic != MLE_DPP_TRACE_MAGIC &&
+         header.m_magic != mlDppSwapInt(MLE_DPP_TRACE_MAGIC)))
+    {
+        fprintf(stderr, "Warning: %s is not a playprint trace.\n", filename);
+        mlFClose(fp);
+        return FALSE;
+    }
+    swap = (header.m_magic != MLE_DPP_TRACE_MAGIC);
+    if (swap)
+        mlDppSwapIntArray((MlUInt *) &header, sizeof(header) / sizeof(MlUInt));
+    if (header.m_version != MLE_DPP_TRACE_VERSION || (int) header.m_numEntries != numChunks)
+    {
+        fprintf(stderr, "Warning: trace %s is for a different playprint.\n", filename);
+        mlFClose(fp);
+        return FALSE;
+    }
+
+    // First pass: when each chunk was first read, and the load it was in.
+    MlUInt *burst = (MlUInt *) mlMalloc((numChunks + 1) * sizeof(MlUInt));
+    MlUInt *first = (MlUInt *) mlMalloc((numChunks + 1) * sizeof(MlUInt));
+    MlUInt *rank = (MlUInt *) mlMalloc((numChunks + 1) * sizeof(MlUInt));
+    MlBoolean *seen = (MlBoolean *) mlMalloc((numChunks + 1) * sizeof(MlBoolean));
+    MLE_ASSERT(burst && first && rank && seen);
+    memset(seen, 0, (numChunks + 1) * sizeof(MlBoolean));
+
+    MlUInt burstStart = 0, lastTime = 0, duration = 1, numSeen = 0;
+    MlBoolean any = FALSE;
+    while (mlFRead(&record, sizeof(record), 1, fp) == 1)
+    {
+        if (swap)
+            mlDppSwapIntArray((MlUInt *) &record, sizeof(record) / sizeof(MlUInt));
+        if (! any || record.m_time > lastTime + TRACE_BURST_GAP)
+            burstStart = record.m_time;
+        lastTime = record.m_time;
+        any = TRUE;
+
+        if (record.m_index < (MlUInt) numChunks && ! seen[record.m_index])
+        {
+            seen[record.m_index] = TRUE;
+            burst[record.m_index] = burstStart;
+            first[record.m_index] = record.m_time;
+            rank[record.m_index] = numSeen++;
+        }
+    }
+    mlFClose(fp);
+    if (lastTime > 0)
+        duration = lastTime;
+
+    // Traces of different lengths count alike.
+    for (int i = 0; i < numChunks; i++)
+    {
+        if (seen[i])
+        {
+            access[i].m_burst += (double) burst[i] / duration;
+            access[i].m_first += (double) first[i] / duration;
+            access[i].m_rank += (double) rank[i] / numSeen;
+            access[i].m_numTraces++;
+        }
+    }
+
+    mlFree(burst);
+    mlFree(first);
+    mlFree(rank);
+    mlFree(seen);
+    return TRUE;
+}
+
+/*
+ * Order the chunks by how soon the traces read them. Chunks first read
+ * in the same load, in every trace, end up next to each other, in the
+ * order they were read; loads that come earlier come first. Chunks no
+ * trace read follow in the order given by fallback[]. Returns the number
+ * of chunks in order[]; as with layoutSceneOrder(), the TOC indexes are
+ * left alone.
+ */
+int layoutTraceOrder(LayoutState *state, const MlInt *fallback, MlInt *order)
+{
+    int numChunks = state->m_chunks->getUsed();
+    int numTraces = 0;
+    int i;
+
+    ChunkAccess *access = (ChunkAccess *) mlMalloc((numChunks + 1) * sizeof(ChunkAccess));
+    MLE_ASSERT(access);
+    memset(access, 0, (numChunks + 1) * sizeof(ChunkAccess));
+    for (i = 0; i < numChunks; i++)
+        access[fallback[i]].m_index = fallback[i];
+
+    for (i = 0; i < state->m_numTraces; i++)
+    {
+        if (readTrace(state->m_traces[i], numChunks, access))
+            numTraces++;
+    }
+
+    if (numTraces > 0)
+    {
+        // Chunks no trace read keep the fallback order, after the rest.
+        ChunkAccess *sorted = (ChunkAccess *) mlMalloc((numChunks + 1) * sizeof(ChunkAccess));
+        MLE_ASSERT(sorted);
+        int numRead = 0, numPlaced;
+        for (i = 0; i < numChunks; i++)
+        {
+            if (access[fallback[i]].m_numTraces > 0)
+                sorted[numRead++] = access[fallback[i]];
+        }
+        numPlaced = numRead;
+        for (i = 0; i < numChunks; i++)
+        {
+            if (access[fallback[i]].m_numTraces == 0)
+                sorted[numPlaced++] = access[fallback[i]];
+        }
+        qsort(sorted, numRead, sizeof(ChunkAccess), compareAccess);
+        for (i = 0; i < numChunks; i++)
+            order[i] = sorted[i].m_index;
+        mlFree(sorted);
+    } else {
+        for (i = 0; i < numChunks; i++)
+            order[i] = fallback[i];
+    }
+
+    mlFree(access);
+    return numChunks;
+}
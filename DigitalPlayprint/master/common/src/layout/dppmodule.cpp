@@ -52,6 +52,7 @@
 #endif
 #include <mle/mlMalloc.h>
 #include <mle/mlFileio.h>
+#include <mle/mlReadFile.h>
 #include <mle/mlConfig.h>
 #include <mle/MlePath.h>
 
@@ -61,6 +62,9 @@
 // Declare external functions.
 extern int gencodeStart(LayoutState *, char *, char *);
 extern void gencodeTables(LayoutState *);
+extern int gencodeSetChunks(LayoutState *, MlInt **);
+extern int layoutSceneOrder(LayoutState *, const MlInt *, int, MlInt *);
+extern int layoutTraceOrder(LayoutState *, const MlInt *, MlInt *);
 
 /*
  * An Exception object for the dpp module.
@@ -156,6 +160,15 @@ dpp_beginPlayprint(PyObject *self, PyObject *args)
     }
     MLE_ASSERT(state->m_dpp);
 
+    // The alignment and the room for a content hash are recorded in
+    // the header, so set them first.
+    state->m_dpp->setAlignment(state->m_alignment);
+    state->m_dpp->setHashContent(state->m_hashContent);
+    state->m_dpp->setPackMedia(state->m_packMedia);
+    state->m_dpp->setIndexMedia(state->m_indexMedia);
+    MleDppActorGroupChunk::setClassBlocks(state->m_classBlocks);
+    MleDppActorGroupChunk::setGroupHints(state->m_groupHints);
+
     state->m_dpp->begin(state->m_byteOrder? MLE_DPP_CREATEPPLE: MLE_DPP_CREATEPPBE);
     state->m_dpp->writeHeader();
 
@@ -179,11 +192,46 @@ dpp_endPlayprint(PyObject *self, PyObject *args)
     // If m_dpp is null, then the playprint has already been completed.
     if (state->m_dpp == nullptr) Py_RETURN_NONE;
 
+    // Store byte-identical chunks only once; the TOC entries of the
+    // duplicates alias the offset of the first copy.
+    state->m_dpp->setDedup(TRUE);
+
     // Generate the TOC...
-    state->m_dpp->beginTOC(state->m_chunks->getUsed());
+    int numChunks = state->m_chunks->getUsed();
+    state->m_dpp->beginTOC(numChunks);
+
+    // Runtime set numbers, as used by group chunks, map to set chunks.
+    MlInt *setChunks;
+    int numSets = gencodeSetChunks(state, &setChunks);
+    state->m_dpp->setSetChunks(setChunks, numSets);
+
+    // Decide the order the chunks are written in. Each chunk keeps its
+    // TOC index, and so its generated symbol, whatever the order.
+    MlInt *order = (MlInt *) mlMalloc((numChunks + 1) * sizeof(MlInt));
+    MLE_ASSERT(order);
+    if (state->m_sceneLayout)
+        layoutSceneOrder(state, setChunks, numSets, order);
+    else {
+        for (int i = 0; i < numChunks; i++)
+            order[i] = i;
+    }
+    if (setChunks)
+        mlFree(setChunks);
+
+    // Chunks the traces show being read go first, in the order the
+    // title read them.
+    if (state->m_numTraces > 0) {
+        MlInt *fallback = order;
+        order = (MlInt *) mlMalloc((numChunks + 1) * sizeof(MlInt));
+        MLE_ASSERT(order);
+        layoutTraceOrder(state, fallback, order);
+        mlFree(fallback);
+    }
 
     // Write out the chunks...
-    for (int i = 0; i < state->m_chunks->getUsed() ; i++) {
+    for (int k = 0; k < numChunks; k++) {
+        int i = order[k];
+        state->m_dpp->setTOCIndex(i);
         switch (state->m_chunks->getType(i)) {
             case CHUNK_GROUP:
                 //contents = readFileToMemory(state->m_chunks->getFilename(i), &size);
@@ -191,20 +239,43 @@ dpp_endPlayprint(PyObject *self, PyObject *args)
                 state->m_dpp->writeGroup(state->m_chunks, i);
                 break;
             case CHUNK_MEDIA:
-                state->m_dpp->writeMedia(state->m_chunks->getFilename(i));
+                state->m_dpp->writeMedia(state->m_chunks, i);
                 break;
             case CHUNK_SET:
-                state->m_dpp->writeSet(state->m_chunks->getFilename(i));
+                state->m_dpp->writeSet(state->m_chunks, i);
                 break;
             case CHUNK_SCENE:
                 state->m_dpp->writeScene(state->m_chunks, i);
                 break;
         }
     }
+    mlFree(order);
+
+    // Report the space saved by sharing duplicate chunks.
+    if (state->m_dpp->getDedupCount() > 0)
+        fprintf(stdout, "%s: %u duplicate chunk(s) shared, %u bytes saved\n",
+                state->m_playprint, state->m_dpp->getDedupCount(),
+                state->m_dpp->getDedupBytes());
+
+    // Describe what each scene needs, so that it can be loaded with a
+    // few large reads.
+    state->m_dpp->writeManifest();
 
     // Seal up the playprint file...
     state->m_dpp->endTOC();
     state->m_dpp->end();
+
+    // Record where each chunk landed and, if asked, hash the result, so
+    // that the generated code can locate chunks without reading the TOC.
+    for (int i = 0; i < state->m_chunks->getUsed(); i++) {
+        MlUInt offset, size;
+        MlDppTag type;
+        if (state->m_dpp->getTOCEntry(i, &offset, &size, &type))
+            state->m_chunks->setLocation(i, offset, size, type);
+    }
+    if (state->m_hashContent)
+        state->m_dpp->writeContentHash();
+    state->m_contentHash = state->m_dpp->getContentHash();
     delete state->m_dpp;
     state->m_dpp = nullptr;
 
@@ -705,3 +776,89 @@ void
 endPlayprint() {
     dpp_endPlayprint(NULL, NULL);
 }
+
+
+/*
+ * Run a playprint layout script with the dpp module. The layout state
+ * must be set on the DppLayoutManager. Returns 0 if the script ran, or
+ * the exit status for the command otherwise.
+ */
+int
+runLayoutScript(LayoutState *state)
+{
+#if USE_PYTHON_SIMPLE_STRING
+    char *script = nullptr;
+    size_t scriptSize = 0;
+
+    // Read in the script file...
+    MlePath *scriptFile = nullptr;
+#if _WINDOWS
+    scriptFile = new MleWin32Path((MlChar *)(state->m_scriptfile), true);
+#else /* ! _WINDOWS */
+    scriptFile = new MleLinuxPath((MlChar *)state->m_scriptfile, true);
+#endif
+
+    if ((script = mlReadFile((char*)scriptFile->getPlatformPath(), TRUE, TRUE, 0, &scriptSize)) == NULL) {
+        perror(state->m_scriptfile);
+        delete scriptFile;
+        return 2;
+    }
+    if (scriptFile != NULL)
+        delete scriptFile;
+#endif /* USE_PYTHON_SIMPLE_STRING */
+
+    // Setup Python and execute sript...
+    // Add the built-in module, before Py_Initialize.
+    if (PyImport_AppendInittab("dpp", PyInit_dpp) == -1) {
+        fprintf(stderr, "Error: could not extend in-built modules table.\n");
+#if USE_PYTHON_SIMPLE_STRING
+        mlFree(script);
+#endif
+        return 1;
+    }
+
+    // Initialize Python interpreter.
+    Py_Initialize();
+
+    // Call python command script.
+    FILE *fp = mlFOpen(state->m_scriptfile, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: could not open script file %s: %s\n",
+                state->m_scriptfile, strerror(errno));
+#if USE_PYTHON_SIMPLE_STRING
+        mlFree(script);
+#endif
+        Py_Finalize();
+        return 1;
+    }
+#if USE_PYTHON_SIMPLE_STRING
+    if (PyRun_SimpleString(script) != 0) {
+        fprintf(stderr, "Error: could not execute script file %s\n",
+                state->m_scriptfile);
+        mlFree(script);
+        mlFClose(fp);
+        Py_Finalize();
+        return 1;
+    }
+    mlFree(script);
+#else /* ! USE_PYTHON_SIMPLE_STRING */
+    // Note: PyRun_SimpleFile() does not work on Windows with a binary file pointer.
+    PyRun_SimpleFile(fp, state->m_scriptfile);
+#endif
+    mlFClose(fp);
+
+    // Terminate Python interpreter.
+    Py_Finalize();
+
+    // Todo: validate python script completion.
+
+    // Check for more chunks cached.  This would happen if the script
+    // ommitted a final endplayprint command, or simply used the -o
+    // option to specify the output file.
+
+    if (state->m_chunks->getUsed() > 0) {
+        endPlayprint();
+    }
+
+    return 0;
+}
@@ -80,63 +80,65 @@ int gencodeStart(LayoutState *state, char *headerfilename, char *codefilename)
     MleTemplateProcess *process;
 
     // Do the work necessary to create an in-memory workprint we can
-    // pass to the subsidiary routines.
-    MLE_ASSERT( NULL == state->m_root );
-
-    char *wpFile;
-    if (state->m_workprint == NULL)
-    {
-        /*
-         * Determine the workprint file name based on the playprint
-         * script file name.
-         *
-         * This will not work if workprint and playprint do not
-         * have the same name.
-         */
-        char *sourceName = state->m_scriptfile;
-        char *lastDot = strrchr(sourceName, '.');
-        if (lastDot)
-            *lastDot = '\0';
-        wpFile = new char[strlen(sourceName) + strlen(".dwp") + 1];
-        sprintf(wpFile, "%s.dwp", sourceName);
-        if (lastDot)
-             *lastDot = '.';
-    } else
+    // pass to the subsidiary routines, unless the caller has already
+    // read it.
+    if (state->m_root == NULL)
     {
+        char *wpFile;
+        if (state->m_workprint == NULL)
+        {
+            /*
+             * Determine the workprint file name based on the playprint
+             * script file name.
+             *
+             * This will not work if workprint and playprint do not
+             * have the same name.
+             */
+            char *sourceName = state->m_scriptfile;
+            char *lastDot = strrchr(sourceName, '.');
+            if (lastDot)
+                *lastDot = '\0';
+            wpFile = new char[strlen(sourceName) + strlen(".dwp") + 1];
+            sprintf(wpFile, "%s.dwp", sourceName);
+            if (lastDot)
+                 *lastDot = '.';
+        } else
+        {
 //        MlePath *wpPath;
 //#if _WINDOWS
 //        wpPath = new MleWin32Path((MlChar *)state->m_workprint,true);
 //        wpFile = (char *)wpPath->getPlatformPath();
 //#else /* ! _WINDOWS */
-        wpFile = state->m_workprint;
+            wpFile = state->m_workprint;
 //#endif
-    }
+        }
 
-    /*
-     * Initialize the workprint toolkit.
-     */
-    mleDwpInit();
+        /*
+         * Initialize the workprint toolkit.
+         */
+        mleDwpInit();
 
-    MleDwpInput *wp = new MleDwpInput;
-    MLE_ASSERT(wp);
+        MleDwpInput *wp = new MleDwpInput;
+        MLE_ASSERT(wp);
 
-    // Open the workprint.
-    int status = wp->openFile(wpFile);
-    // Todo: Log the status so that we know if the wpFile failed because it was invalid.
-    MLE_ASSERT(status == 0);
+        // Open the workprint.
+        int status = wp->openFile(wpFile);
+        // Todo: Log the status so that we know if the wpFile failed because it was invalid.
+        MLE_ASSERT(status == 0);
 
-    /*
-     * Read in the workprint.
-     */
-    state->m_root = MleDwpItem::readAll(wp);
-    // Todo: Log the status so that we know if the wp failed because it was invalid.
-    MLE_ASSERT(state->m_root);
+        /*
+         * Read in the workprint.
+         */
+        state->m_root = MleDwpItem::readAll(wp);
+        // Todo: Log the status so that we know if the wp failed because it was invalid.
+        MLE_ASSERT(state->m_root);
 
-    if (state->m_workprint == NULL)
-        delete [] wpFile;
+        if (state->m_workprint == NULL)
+            delete [] wpFile;
 
-    wp->closeFile();
-    delete wp;
+        wp->closeFile();
+        delete wp;
+    }
 
     // Left with a new state->m_root here.
 
@@ -178,7 +180,7 @@ int gencodeStart(LayoutState *state, char *headerfilename, char *codefilename)
     //gbindings->defineConstant("HEADER_FILENAME", headerfilename );
     gbindings->defineConstant("CODE_FILENAME", codefilename );
     MleTemplateBindingCallback doTOCSymbols, doTab;
-    MleTemplateBindingCallback doSetToChunk;
+    MleTemplateBindingCallback doSetToChunk, doTOCLocations;
     gbindings->defineCallback("DO_TOC_SYMBOLS",
                   doTOCSymbols,
                   (void *)state);
@@ -188,6 +190,9 @@ int gencodeStart(LayoutState *state, char *headerfilename, char *codefilename)
     gbindings->defineCallback("DO_SET_TO_CHUNK",
                   doSetToChunk,
                   (void *)state);
+    gbindings->defineCallback("DO_TOC_LOCATIONS",
+                  doTOCLocations,
+                  (void *)state);
     if (state->m_language)
         gbindings->defineConstant("PACKAGE", state->m_package);
     else
@@ -224,9 +229,16 @@ void gencodeTables(LayoutState *state)
 {
     MleTemplateProcess *process;
     MleTemplateBindings lbindings;
+    char contentHash[16];
     
     lbindings.defineConstant("PLAYPRINT_FILENAME", state->m_playprint);
 
+    // The generated chunk locations are only valid for the playprint
+    // with this content hash.
+    sprintf(contentHash, "0x%08x", state->m_contentHash);
+    lbindings.defineConstant("CONTENT_HASH", contentHash);
+    lbindings.defineConstant("CHUNK_COUNT", state->m_chunks->getUsed());
+
     if (state->m_language != TRUE)
     {
         // Only necessary for C/C++ code generation.
@@ -247,6 +259,55 @@ void gencodeTables(LayoutState *state)
     delete process;
 }
 
+/*
+ * Map each runtime set number, as used by group chunks, to the chunk
+ * table index of its set chunk (-1 if it has none). The caller frees the
+ * map with mlFree(). Returns the number of sets.
+ */
+int gencodeSetChunks(LayoutState *state, MlInt **setChunks)
+{
+    MleDppChunkTable *chunks = state->m_chunks;
+    MleDppTblMgr *tblMgr;
+    TblMgrItems *setTable;
+    int i, j, numChunk, numSet;
+
+    *setChunks = NULL;
+    if (state->m_root == NULL)
+        return 0;
+
+    tblMgr = new MleDppTblMgr();
+    MLE_ASSERT(tblMgr);
+    if (! tblMgr->buildIndexTables(state->m_root))
+    {
+        delete tblMgr;
+        return 0;
+    }
+
+    setTable = tblMgr->getSetTable();
+    numSet = setTable->used;
+    numChunk = chunks->getUsed();
+    if (numSet > 0)
+        *setChunks = (MlInt *) mlMalloc(numSet * sizeof(MlInt));
+    for (i = 0; i < numSet; i++)
+    {
+        char *setName = (((SetTableItem **) (setTable->items))[i])->name;
+
+        (*setChunks)[i] = -1;
+        for (j = 0; j < numChunk; j++)
+        {
+            if (chunks->getType(j) == CHUNK_SET &&
+                strcmp(setName, chunks->getName(j)) == 0)
+            {
+                (*setChunks)[i] = j;
+                break;
+            }
+        }
+    }
+
+    delete tblMgr;
+    return numSet;
+}
+
 void doTOCSymbols(MleTemplateProcess *ptp, char *section, void *data)
 {
     MleTemplateBindings lbindings;
@@ -423,3 +484,61 @@ doSetToChunk(MleTemplateProcess *ptp, char *section, void *data)
         delete tblMgr;
     }
 }
+
+void
+doTOCLocations(MleTemplateProcess *ptp, char *section, void *data)
+{
+    char beginSection[100], entrySection[100], endSection[100];
+    char offset[16], size[16], tag[16];
+    int i, numChunk;
+    LayoutState *state = (LayoutState *) data;
+    MleDppChunkTable *chunks = state->m_chunks;
+    MleTemplateBindings localBinding;
+
+    /*
+     * Prepare for code generation.
+     */
+    sprintf(beginSection, section, "BEGIN");
+    sprintf(entrySection, section, "ENTRY");
+    sprintf(endSection, section, "END");
+    MleTemplateProcess processBegin(beginSection, ptp->getTemplate(),
+                   &localBinding, ptp->getFileDescriptor());
+    MleTemplateProcess processEntry(entrySection, ptp->getTemplate(),
+                   &localBinding, ptp->getFileDescriptor());
+    MleTemplateProcess processEnd(endSection, ptp->getTemplate(),
+                   &localBinding, ptp->getFileDescriptor());
+
+    /*
+     * Fill in the table heading.
+     */
+    numChunk = chunks->getUsed();
+    if (numChunk > 0)
+        localBinding.defineConstant("VALUE", "[] = {");
+    else
+        localBinding.defineConstant("VALUE", "[] = {0};");
+    processBegin.go();
+
+    if (numChunk == 0)
+        return;
+
+    /*
+     * Fill in one entry per chunk, in TOC order.
+     */
+    for (i = 0; i < numChunk; i++)
+    {
+        sprintf(offset, "0x%08x", chunks->getOffset(i));
+        sprintf(size, "0x%08x", chunks->getSize(i));
+        sprintf(tag, "0x%08x", chunks->getTag(i));
+        localBinding.defineConstant("NAME", chunks->getName(i));
+        localBinding.defineConstant("VALUE", i);
+        localBinding.defineConstant("OFFSET", offset);
+        localBinding.defineConstant("SIZE", size);
+        localBinding.defineConstant("TYPE", tag);
+        processEntry.go();
+    }
+
+    /*
+     * Fill in the table ending.
+     */
+    processEnd.go();
+}
@@ -74,6 +74,8 @@
 #include "mle/DwpSet.h"
 #include "mle/DwpTagAllDiscriminator.h"
 
+#include "ppscript.h"
+
 
 // Declare external routines.
 //extern MlBoolean mlVerifyTargetWorkprint(MleDwpItem *root,char *tags);
@@ -271,107 +273,10 @@ static MlBoolean setDiscriminators(MleDwpItem *tree, char *tags)
 }
 
 
-#if 0
-static void
-processAutoLoadGroup(FILE *scriptOut, MleDwpItem *root)
-{
-    int i, numItems;
-    MleDwpFinder finder;
-    MleDwpBoot **items;
-
-    /*
-     * Find all the Boot item in the workprint.  Currently, this assumes
-     * only group can be associated with the Boot token in the workprint.
-     */
-    finder.setType(FwWpBoot::typeId);
-    finder.setFindAll(TRUE);
-    finder.find(root);
-    items = (FwWpBoot **) finder.getItems();
-    numItems = finder.getNumItems();
-
-    if (numItems > 0)
-	{
-		fprintf(scriptOut, "%s%s%s",
-			"# autoloadgroup declares the actor/delegate groups that ",
-			"are automatically\n",
-			"# loaded in at the beginning of the title.\n");
-
-		for (i = 0; i < numItems; i++)
-			fprintf(scriptOut, "autoloadgroup %s\n", items[i]->getName());
-
-		fprintf(scriptOut, "\n");
-    }
-}
-#endif
-
-
-static void
-processAddSet(FILE *scriptOut, MleDwpItem *root)
-{
-    const char *name;
-    int i, numItems;
-    MleDwpFinder finder;
-    MleDwpBoot **items;
-
-    /*
-     * Find all the Set items in the workprint.
-     */
-    finder.setType(MleDwpSet::typeId);
-    finder.setFindAll(TRUE);
-    finder.find(root);
-    items = (MleDwpBoot **) finder.getItems();
-    numItems = finder.getNumItems();
-
-    for(i = 0; i < numItems; i++)
-	{
-		name = items[i]->getName();
-#if defined(USE_PYTHON)
-        fprintf(scriptOut, "dpp.addset(\"%s.chk\", \"%s\")\n", name, name);
-#else
-		fprintf(scriptOut, "addset %s.chk %s\n", name, name);
-#endif
-    }
-}
-
-
-// The global directory for generated output.
-static MlePath *g_outputDir = NULL;
-
-
-// Utility to append the global directory path to the specified path.
-static char *_expandPath(char * path)
-{
-	MLE_ASSERT(path);
-
-	MlePath *dir = g_outputDir;
-
-	// Expand directory path, if necessary.
-	char *tmpPath;
-	if (dir != NULL)
-	{
-		tmpPath = (char *)mlMalloc(strlen((char *)dir->getPlatformPath()) + strlen(path) + 2);
-		strcpy(tmpPath,(char *)dir->getPlatformPath());
-#if defined(_WINDOWS)
-		strcat(tmpPath,"\\");
-#else /* ! _WINDOWS */
-		strcat(tmpPath,"/");
-#endif /* _WINDOWS */
-		strcat(tmpPath,path);
-	} else
-		tmpPath = path;
-
-	return tmpPath;
-}
-
-
 int
 main(int argc, char **argv)
 {
     // Declare local variables.
-    FILE *scriptOut = NULL;
-    const char *name;
-    int numItems;
-    int i;
     ArgStruct args;
 
     // Parse arguments.
@@ -386,60 +291,6 @@ main(int argc, char **argv)
 	{
       exit(1);
     }
-	
-	// Redirect generated output.
-#if defined(_WINDOWS)
-	if (args.outputDir != NULL)
-	{
-		g_outputDir = new MleWin32Path((MlChar *)args.outputDir,true);
-	}
-#else
-	if (args.outputDir != NULL)
-	{
-		g_outputDir = new MleLinuxPath((MlChar *)args.outputDir,true);
-	}
-#endif /* _WINDOWS */
-
-    // Open output file (TCL/Python script).
-    if (args.script != NULL)
-    {
-        char * tmpPath;
-        if (g_outputDir != NULL)
-            tmpPath = _expandPath(args.script);
-        else
-            tmpPath = args.script;
-        scriptOut = mlFOpen(tmpPath, "w");
-
-        if (g_outputDir != NULL)
-            mlFree(tmpPath);
-
-    } else
-    {
-        fprintf(stderr,"%s Error: %s, %s, %s, %s\n",
-               args.commandName,
-               "Could not create script file",
-               args.script, 
-               "from workprint",
-           args.workprint);
-        exit(1);
-    }
-
-    // Emit header comments:
-#if defined(USE_PYTHON)
-    fprintf(scriptOut, "%s: %s\n%s\n%s\n%s\n\n",
-            "# Magic Lantern Digtial Playprint Layout Script",
-            args.script, "#",
-            "# This is a Python default script generated by the mastering system.",
-            "# Edit this script if necessary and use it as input to gendpp.");
-
-    fprintf(scriptOut, "import dpp;\n");
-#else
-    fprintf(scriptOut, "%s: %s\n%s\n%s\n%s\n\n",
-            "# Magic Lantern Digtial Playprint Layout Script",
-            args.script, "#",
-            "# This is a TCL default script generated by the mastering system.",
-            "# Edit this script if necessary and use it as input to gendpp.");
-#endif
 
     // Initialize WorkPrint readers and writers.
     mleDwpInit();
@@ -448,24 +299,6 @@ main(int argc, char **argv)
     // Open the DWP.
     in->openFile(args.workprint);
 
-    // Begin script.
-    fprintf(scriptOut,"%s\n%s\n%s%s.cxx and %s.h.\n%s\n",
-        "# codefile declares the name of the file in which to put the Group,",
-        "# Media, Set and Scene chunk indices. The files will be named",
-        "# ",
-        args.chunkIndexFile, args.chunkIndexFile,
-        "# These files should be linked to your title.");
-
-#if defined(USE_PYTHON)
-    fprintf(scriptOut, "%s(\"%s\")\n\n",
-        "dpp.codefile",
-        args.chunkIndexFile);
-#else
-    fprintf(scriptOut,"%s %s\n\n",
-        "codefile",
-        args.chunkIndexFile);
-#endif
-
     // Build the entire DWP, instantiating each MleDwpItem.
     MleDwpItem *root;
     root = MleDwpItem::readAll(in);
@@ -481,97 +314,12 @@ main(int argc, char **argv)
     // Set the DWP discriminator tags.
     setDiscriminators(root, args.tags);
 
-    fprintf(scriptOut,"%s\n%s\n\n",
-        "# Following is the default script for adding Actor/Role",
-        "# Groups, Media, Sets and Scenes into your title.");
-
-#if defined(USE_PYTHON)
-    fprintf(scriptOut, "%s(\"%s\")\n",
-        "dpp.beginplayprint",
-         args.playprint);
-#else
-    fprintf(scriptOut, "%s %s\n",
-        "beginplayprint",
-         args.playprint);
-#endif
-
-    // Find all Actor Group items in the DWP.
-    MleDwpFinder groupFinder;
-    MleDwpGroup **groupItems;
-
-    groupFinder.setType(MleDwpGroup::typeId);
-    groupFinder.setFindAll(1);
-    groupFinder.find(root);
-    groupItems = (MleDwpGroup **)groupFinder.getItems();
-    numItems = groupFinder.getNumItems();
-
-    // Output to Playprint script.
-    for (i = 0; i < numItems; i++)
+    // Write the script.
+    if (genPlayprintScript(root, args.commandName, args.playprint,
+        args.script, args.chunkIndexFile, args.outputDir) != 0)
     {
-        name = groupItems[i]->getName();
-#if defined(USE_PYTHON)
-        fprintf(scriptOut, "dpp.addgroup(\"%s.chk\", \"%s\")\n", name, name);
-#else
-        fprintf(scriptOut, "addgroup %s.chk %s\n", name, name);
-#endif
-    }
-
-    // Find all MediaRef items in the DWP.
-    MleDwpFinder mediaRefFinder;
-    MleDwpMediaRef **mediaRefItems;
-
-    mediaRefFinder.setType(MleDwpMediaRef::typeId);
-    mediaRefFinder.setFindAll(1);
-    mediaRefFinder.find(root);
-    mediaRefItems = (MleDwpMediaRef **)mediaRefFinder.getItems();
-    numItems = mediaRefFinder.getNumItems();
-
-    // Output to Playprint script.
-    for (i = 0; i < numItems; i++)
-    {
-        name = mediaRefItems[i]->getName();
-#if defined(USE_PYTHON)
-        fprintf(scriptOut, "dpp.addmedia(\"%s.chk\", \"%s\")\n", name, name);
-#else
-        fprintf(scriptOut, "addmedia %s.chk %s\n", name, name);
-#endif
-    }
-
-    // Process all Set instances in the DWP.
-    processAddSet(scriptOut, root);
-
-    // Find all Scene items in the DWP.
-    MleDwpFinder sceneFinder;
-    MleDwpScene **sceneItems;
-
-    sceneFinder.setType(MleDwpScene::typeId);
-    sceneFinder.setFindAll(1);
-    sceneFinder.find(root);
-    sceneItems = (MleDwpScene **)sceneFinder.getItems();
-    numItems = sceneFinder.getNumItems();
-
-    // Output to Playprint script.
-    for (i = 0; i < numItems; i++)
-    {
-        name = sceneItems[i]->getName();
-#if defined(USE_PYTHON)
-        fprintf(scriptOut, "dpp.addscene(\"%s.chk\", \"%s\")\n", name, name);
-#else
-        fprintf(scriptOut, "addscene %s.chk %s\n", name, name);
-#endif
+        exit(1);
     }
 
-    // End script.
-#if defined(USE_PYTHON)
-    fprintf(scriptOut, "dpp.endplayprint()\n");
-#else
-    fprintf(scriptOut, "endplayprint\n");
-    fprintf(scriptOut, "exit\n");
-#endif
-
-    // Close file.
-    mlFClose(scriptOut);
-
     return 0;
 }
-
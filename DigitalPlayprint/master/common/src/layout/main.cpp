@@ -104,6 +104,7 @@ static int parseArgs(int argc, char *argv[], LayoutState *);
 static char *readFileToMemory(char *, int *);
 int gencodeStart(LayoutState *, char *, char *);
 void gencodeTables(LayoutState *);
+int gencodeSetChunks(LayoutState *, MlInt **);
 
 Tcl_CmdProc codeFile;
 Tcl_CmdProc beginPlayPrint;
@@ -153,6 +154,9 @@ int main(int argc, char *argv[])
     state.m_inputDir = NULL;
     state.m_codefile = NULL;
     state.m_chunks = new MleDppChunkTable();
+    state.m_indexMedia = FALSE;
+    state.m_hashContent = FALSE;
+    state.m_contentHash = 0;
     state.m_scriptfile = NULL;
     state.m_root = NULL;
     state.m_tags = NULL;
@@ -754,6 +758,12 @@ int beginPlayPrint(ClientData cd, Tcl_Interp *interp, int argc, CONST84 char *ar
     }
     MLE_ASSERT(state->m_dpp);
 
+    /*
+     * The room for a content hash is recorded in the header, so set it first.
+     */
+
+    state->m_dpp->setHashContent(state->m_hashContent);
+
     state->m_dpp->begin(state->m_byteOrder? MLE_DPP_CREATEPPLE: MLE_DPP_CREATEPPBE);
     state->m_dpp->writeHeader();
 
@@ -787,6 +797,16 @@ int endPlayPrint(ClientData cd, Tcl_Interp *interp, int argc, CONST84 char *argv
 
     state->m_dpp->beginTOC(state->m_chunks->getUsed());
 
+    /*
+     * Runtime set numbers, as used by group chunks, map to set chunks...
+     */
+
+    MlInt *setChunks;
+    int numSets = gencodeSetChunks(state, &setChunks);
+    state->m_dpp->setSetChunks(setChunks, numSets);
+    if (setChunks)
+        mlFree(setChunks);
+
     /*
      * Write out the chunks...
      */
@@ -801,10 +821,10 @@ int endPlayPrint(ClientData cd, Tcl_Interp *interp, int argc, CONST84 char *argv
             state->m_dpp->writeGroup(state->m_chunks, i);
             break;
           case CHUNK_MEDIA:
-            state->m_dpp->writeMedia(state->m_chunks->getFilename(i));
+            state->m_dpp->writeMedia(state->m_chunks, i);
             break;
           case CHUNK_SET:
-            state->m_dpp->writeSet(state->m_chunks->getFilename(i));
+            state->m_dpp->writeSet(state->m_chunks, i);
             break;
           case CHUNK_SCENE:
             state->m_dpp->writeScene(state->m_chunks, i);
@@ -812,12 +832,34 @@ int endPlayPrint(ClientData cd, Tcl_Interp *interp, int argc, CONST84 char *argv
         }
     }
 
+    /*
+     * Describe what each scene needs...
+     */
+
+    state->m_dpp->writeManifest();
+
     /*
      * Seal up the playprint file...
      */
 
     state->m_dpp->endTOC();
     state->m_dpp->end();
+
+    /*
+     * Record where each chunk landed and, if asked, hash the result, so
+     * that the generated code can locate chunks without reading the TOC...
+     */
+
+    for ( i=0 ; i<state->m_chunks->getUsed() ; i++ )
+    {
+        MlUInt offset, size;
+        MlDppTag type;
+        if ( state->m_dpp->getTOCEntry(i, &offset, &size, &type) )
+            state->m_chunks->setLocation(i, offset, size, type);
+    }
+    if ( state->m_hashContent )
+        state->m_dpp->writeContentHash();
+    state->m_contentHash = state->m_dpp->getContentHash();
     delete state->m_dpp;
 
     /*
@@ -75,6 +75,16 @@ typedef struct {
 	char             *m_package;      /* The Java package. */
     MleDwpItem       *m_root;         /* The root item of the input workprint. */
     char             *m_tags;         /* DWP discriminators. */
+    MlUInt            m_alignment;    /* Chunk payload alignment, in bytes (0 = none). */
+    MlBoolean         m_packMedia;    /* TRUE = write media as packed 'mpak' chunks. */
+    MlBoolean         m_indexMedia;   /* TRUE = write a 'midx' index in media lists. */
+    MlBoolean         m_classBlocks;  /* TRUE = pack like actors into class blocks. */
+    MlBoolean         m_groupHints;   /* TRUE = write allocation hints in group headers. */
+    MlBoolean         m_hashContent;  /* TRUE = seal the playprint with a content hash. */
+    MlUInt            m_contentHash;  /* Content hash of the finished playprint. */
+    MlBoolean         m_sceneLayout;  /* TRUE = write each scene's chunks together. */
+    char            **m_traces;       /* Access traces to lay the chunks out by. */
+    int               m_numTraces;    /* Number of access traces. */
 	MleDppOutput     *m_dpp;          /* Internal management class for DPP. */
     MleDppChunkTable *m_chunks;       /* Internal management class for chunks. */
 } LayoutState;
@@ -0,0 +1,331 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file ppscript.cpp
+ * @ingroup MleDPPMaster
+ *
+ * Writes the default layout script of a Digital Workprint, as a Python
+ * script when USE_PYTHON is defined and as a TCL script otherwise.
+ */
+
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+// Include system header files.
+#if defined(_WINDOWS)
+#include <windows.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+
+// Include Magic Lantern header files.
+#include <mle/mlTypes.h>
+#include <mle/mlMalloc.h>
+#include <mle/mlFileio.h>
+#include <mle/mlAssert.h>
+#include <mle/MlePath.h>
+#if defined(_WINDOWS)
+#include <mle/MleWin32Path.h>
+#else
+#include <mle/MleLinuxPath.h>
+#endif
+
+// Include DWP header files.
+#include "mle/Dwp.h"
+#include "mle/DwpItem.h"
+#include "mle/DwpFinder.h"
+#include "mle/DwpGroup.h"
+#include "mle/DwpMediaRef.h"
+#include "mle/DwpScene.h"
+#include "mle/DwpBoot.h"
+#include "mle/DwpSet.h"
+
+#include "ppscript.h"
+
+
+#if 0
+static void
+processAutoLoadGroup(FILE *scriptOut, MleDwpItem *root)
+{
+    int i, numItems;
+    MleDwpFinder finder;
+    MleDwpBoot **items;
+
+    /*
+     * Find all the Boot item in the workprint.  Currently, this assumes
+     * only group can be associated with the Boot token in the workprint.
+     */
+    finder.setType(FwWpBoot::typeId);
+    finder.setFindAll(TRUE);
+    finder.find(root);
+    items = (FwWpBoot **) finder.getItems();
+    numItems = finder.getNumItems();
+
+    if (numItems > 0)
+	{
+		fprintf(scriptOut, "%s%s%s",
+			"# autoloadgroup declares the actor/delegate groups that ",
+			"are automatically\n",
+			"# loaded in at the beginning of the title.\n");
+
+		for (i = 0; i < numItems; i++)
+			fprintf(scriptOut, "autoloadgroup %s\n", items[i]->getName());
+
+		fprintf(scriptOut, "\n");
+    }
+}
+#endif
+
+
+static void
+processAddSet(FILE *scriptOut, MleDwpItem *root)
+{
+    const char *name;
+    int i, numItems;
+    MleDwpFinder finder;
+    MleDwpBoot **items;
+
+    /*
+     * Find all the Set items in the workprint.
+     */
+    finder.setType(MleDwpSet::typeId);
+    finder.setFindAll(TRUE);
+    finder.find(root);
+    items = (MleDwpBoot **) finder.getItems();
+    numItems = finder.getNumItems();
+
+    for(i = 0; i < numItems; i++)
+	{
+		name = items[i]->getName();
+#if defined(USE_PYTHON)
+        fprintf(scriptOut, "dpp.addset(\"%s.chk\", \"%s\")\n", name, name);
+#else
+		fprintf(scriptOut, "addset %s.chk %s\n", name, name);
+#endif
+    }
+}
+
+
+// Utility to append a directory path to the specified path.
+static char *_expandPath(MlePath *dir, char * path)
+{
+	MLE_ASSERT(path);
+
+	// Expand directory path, if necessary.
+	char *tmpPath;
+	if (dir != NULL)
+	{
+		tmpPath = (char *)mlMalloc(strlen((char *)dir->getPlatformPath()) + strlen(path) + 2);
+		strcpy(tmpPath,(char *)dir->getPlatformPath());
+#if defined(_WINDOWS)
+		strcat(tmpPath,"\\");
+#else /* ! _WINDOWS */
+		strcat(tmpPath,"/");
+#endif /* _WINDOWS */
+		strcat(tmpPath,path);
+	} else
+		tmpPath = path;
+
+	return tmpPath;
+}
+
+
+int
+genPlayprintScript(MleDwpItem *root, const char *commandName,
+    char *playprint, char *script, char *chunkIndexFile,
+    const char *outputDir)
+{
+    // Declare local variables.
+    MlePath *dir = NULL;
+    FILE *scriptOut = NULL;
+    const char *name;
+    int numItems;
+    int i;
+
+	// Redirect generated output.
+#if defined(_WINDOWS)
+	if (outputDir != NULL)
+	{
+		dir = new MleWin32Path((MlChar *)outputDir,true);
+	}
+#else
+	if (outputDir != NULL)
+	{
+		dir = new MleLinuxPath((MlChar *)outputDir,true);
+	}
+#endif /* _WINDOWS */
+
+    // Open output file (TCL/Python script).
+    char * tmpPath = _expandPath(dir, script);
+    scriptOut = mlFOpen(tmpPath, "w");
+    if (dir != NULL)
+        mlFree(tmpPath);
+    delete dir;
+
+    if (scriptOut == NULL)
+    {
+        fprintf(stderr,"%s Error: %s, %s\n",
+               commandName,
+               "Could not create script file",
+               script);
+        return 1;
+    }
+
+    // Emit header comments:
+#if defined(USE_PYTHON)
+    fprintf(scriptOut, "%s: %s\n%s\n%s\n%s\n\n",
+            "# Magic Lantern Digtial Playprint Layout Script",
+            script, "#",
+            "# This is a Python default script generated by the mastering system.",
+            "# Edit this script if necessary and use it as input to gendpp.");
+
+    fprintf(scriptOut, "import dpp;\n");
+#else
+    fprintf(scriptOut, "%s: %s\n%s\n%s\n%s\n\n",
+            "# Magic Lantern Digtial Playprint Layout Script",
+            script, "#",
+            "# This is a TCL default script generated by the mastering system.",
+            "# Edit this script if necessary and use it as input to gendpp.");
+#endif
+
+    // Begin script.
+    fprintf(scriptOut,"%s\n%s\n%s%s.cxx and %s.h.\n%s\n",
+        "# codefile declares the name of the file in which to put the Group,",
+        "# Media, Set and Scene chunk indices. The files will be named",
+        "# ",
+        chunkIndexFile, chunkIndexFile,
+        "# These files should be linked to your title.");
+
+#if defined(USE_PYTHON)
+    fprintf(scriptOut, "%s(\"%s\")\n\n",
+        "dpp.codefile",
+        chunkIndexFile);
+#else
+    fprintf(scriptOut,"%s %s\n\n",
+        "codefile",
+        chunkIndexFile);
+#endif
+
+    fprintf(scriptOut,"%s\n%s\n\n",
+        "# Following is the default script for adding Actor/Role",
+        "# Groups, Media, Sets and Scenes into your title.");
+
+#if defined(USE_PYTHON)
+    fprintf(scriptOut, "%s(\"%s\")\n",
+        "dpp.beginplayprint",
+         playprint);
+#else
+    fprintf(scriptOut, "%s %s\n",
+        "beginplayprint",
+         playprint);
+#endif
+
+    // Find all Actor Group items in the DWP.
+    MleDwpFinder groupFinder;
+    MleDwpGroup **groupItems;
+
+    groupFinder.setType(MleDwpGroup::typeId);
+    groupFinder.setFindAll(1);
+    groupFinder.find(root);
+    groupItems = (MleDwpGroup **)groupFinder.getItems();
+    numItems = groupFinder.getNumItems();
+
+    // Output to Playprint script.
+    for (i = 0; i < numItems; i++)
+    {
+        name = groupItems[i]->getName();
+#if defined(USE_PYTHON)
+        fprintf(scriptOut, "dpp.addgroup(\"%s.chk\", \"%s\")\n", name, name);
+#else
+        fprintf(scriptOut, "addgroup %s.chk %s\n", name, name);
+#endif
+    }
+
+    // Find all MediaRef items in the DWP.
+    MleDwpFinder mediaRefFinder;
+    MleDwpMediaRef **mediaRefItems;
+
+    mediaRefFinder.setType(MleDwpMediaRef::typeId);
+    mediaRefFinder.setFindAll(1);
+    mediaRefFinder.find(root);
+    mediaRefItems = (MleDwpMediaRef **)mediaRefFinder.getItems();
+    numItems = mediaRefFinder.getNumItems();
+
+    // Output to Playprint script.
+    for (i = 0; i < numItems; i++)
+    {
+        name = mediaRefItems[i]->getName();
+#if defined(USE_PYTHON)
+        fprintf(scriptOut, "dpp.addmedia(\"%s.chk\", \"%s\")\n", name, name);
+#else
+        fprintf(scriptOut, "addmedia %s.chk %s\n", name, name);
+#endif
+    }
+
+    // Process all Set instances in the DWP.
+    processAddSet(scriptOut, root);
+
+    // Find all Scene items in the DWP.
+    MleDwpFinder sceneFinder;
+    MleDwpScene **sceneItems;
+
+    sceneFinder.setType(MleDwpScene::typeId);
+    sceneFinder.setFindAll(1);
+    sceneFinder.find(root);
+    sceneItems = (MleDwpScene **)sceneFinder.getItems();
+    numItems = sceneFinder.getNumItems();
+
+    // Output to Playprint script.
+    for (i = 0; i < numItems; i++)
+    {
+        name = sceneItems[i]->getName();
+#if defined(USE_PYTHON)
+        fprintf(scriptOut, "dpp.addscene(\"%s.chk\", \"%s\")\n", name, name);
+#else
+        fprintf(scriptOut, "addscene %s.chk %s\n", name, name);
+#endif
+    }
+
+    // End script.
+#if defined(USE_PYTHON)
+    fprintf(scriptOut, "dpp.endplayprint()\n");
+#else
+    fprintf(scriptOut, "endplayprint\n");
+    fprintf(scriptOut, "exit\n");
+#endif
+
+    // Close file.
+    mlFClose(scriptOut);
+
+    return 0;
+}
+
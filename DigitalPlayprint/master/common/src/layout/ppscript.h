@@ -0,0 +1,65 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file ppscript.h
+ * @ingroup MleDPPMaster
+ *
+ * Writes the default layout script of a Digital Workprint.
+ */
+
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_DPP_PPSCRIPT_H_
+#define __MLE_DPP_PPSCRIPT_H_
+
+// Declare external references.
+class MleDwpItem;
+
+/**
+ * Write the default layout script of a workprint. It adds every Group,
+ * MediaRef, Set and Scene to the playprint.
+ *
+ * @param root The workprint, with its discriminators set.
+ * @param commandName The name of the command, for messages.
+ * @param playprint The name of the playprint the script builds.
+ * @param script The name of the script file.
+ * @param chunkIndexFile The root name of the chunk index files.
+ * @param outputDir The directory where the script is written, or NULL.
+ *
+ * @return 0 is returned if the script was written.
+ */
+extern int genPlayprintScript(MleDwpItem *root, const char *commandName,
+    char *playprint, char *script, char *chunkIndexFile,
+    const char *outputDir);
+
+#endif /* __MLE_DPP_PPSCRIPT_H_ */
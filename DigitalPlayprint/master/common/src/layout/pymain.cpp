@@ -79,7 +79,8 @@
 
 const char *usage_str = "\
 Syntax:   gendpp  [-b|-l] [-j <package> | -c] [-d <dir>] [-s <dir>]\n\
-                  <tags> <workprint> <script>\n\
+                  [-a <bytes>] [-m] [-i] [-k] [-g] [-n] [-t <trace> ...]\n\
+                  [-x] <tags> <workprint> <script>\n\
 \n\
           -b            Use Big Endian byte ordering\n\
           -l            Use Little Endian byte ordering\n\
@@ -88,6 +89,22 @@ Syntax:   gendpp  [-b|-l] [-j <package> | -c] [-d <dir>] [-s <dir>]\n\
           -d <dir>      Directory where ouput is generated\n\
           -s <dir>      Directory where resources can be found,\n\
                         relative to script commands\n\
+          -a <bytes>    Align chunk payloads to 16, 64 or 4096 bytes\n\
+          -m            Pack the media of each MediaRef into one\n\
+                        aligned chunk\n\
+          -i            Index the media in each MediaRef list, so\n\
+                        that any one can be reached directly\n\
+          -k            Pack runs of like actors in group chunks\n\
+                        into class blocks\n\
+          -g            Write allocation hints in group chunk\n\
+                        headers\n\
+          -n            Write chunks in script order instead of\n\
+                        keeping each scene's chunks together\n\
+          -t <trace>    Order chunks by when they were read in an\n\
+                        access trace; may be given more than once\n\
+          -x            Seal the playprint with a content hash, so\n\
+                        that the generated chunk location tables\n\
+                        can be used in place of its TOC\n\
           <tags>        Digital Workprint tags\n\
           <workprint>   Digital Workprint\n\
           <script>      Playprint Layout Script\n\
@@ -101,8 +118,7 @@ necessary for finding the location of each chunk in the playprint.\n";
 static char *readFileToMemory(char *, int *);
 
 // Declare external references.
-extern "C" PyObject *PyInit_dpp(void);
-extern void endPlayprint();
+extern int runLayoutScript(LayoutState *state);
 
 //
 // Get a canonical path definition for the specified input.
@@ -133,7 +149,7 @@ static int parseArgs(int argc, char *argv[], LayoutState *state)
     extern int optind;
 
     errflg = 0;
-    while ((c = getopt(argc, argv, "blcj:d:s:")) != EOF ) {
+    while ((c = getopt(argc, argv, "blcj:d:s:a:mikgnt:x")) != EOF ) {
         switch (c) {
           case 'b':
             // Big Endian.
@@ -158,11 +174,53 @@ static int parseArgs(int argc, char *argv[], LayoutState *state)
           case 's':
             state->m_inputDir = optarg;
             break;
+          case 'a':
+            // Chunk payload alignment.
+            state->m_alignment = atoi(optarg);
+            if ((state->m_alignment != 16) && (state->m_alignment != 64) &&
+                (state->m_alignment != 4096))
+                errflg++;
+            break;
+          case 'm':
+            // Packed media.
+            state->m_packMedia = TRUE;
+            break;
+          case 'i':
+            // Media index.
+            state->m_indexMedia = TRUE;
+            break;
+          case 'k':
+            // Class blocks.
+            state->m_classBlocks = TRUE;
+            break;
+          case 'g':
+            // Allocation hints.
+            state->m_groupHints = TRUE;
+            break;
+          case 'n':
+            // Script order.
+            state->m_sceneLayout = FALSE;
+            break;
+          case 't':
+            // Access trace.
+            state->m_traces = (char **) mlRealloc(state->m_traces,
+                (state->m_numTraces + 1) * sizeof(char *));
+            state->m_traces[state->m_numTraces++] = getCanonicalPath(optarg);
+            break;
+          case 'x':
+            // Content hash.
+            state->m_hashContent = TRUE;
+            break;
           case '?':
             errflg++;
         }
     }
 
+    if (errflg) {
+        fprintf(stderr,"%s\n",usage_str);
+        return FALSE;
+    }
+
     for ( ; optind < argc; optind++) {
         if (! state->m_tags) {
             state->m_tags = strdup(argv[optind]);
@@ -195,10 +253,6 @@ static int parseArgs(int argc, char *argv[], LayoutState *state)
 int main(int argc, char *argv[])
 {
     LayoutState *state = nullptr;
-#if USE_PYTHON_SIMPLE_STRING
-    char *script = nullptr;
-    size_t scriptSize = 0;
-#endif /* USE_PYTHON_SIMPLE_STRING */
 
     // Initialize the playprint layout state.
     state = (LayoutState *)mlMalloc(sizeof(LayoutState));
@@ -219,6 +273,16 @@ int main(int argc, char *argv[])
         state->m_tags = nullptr;
         state->m_language = FALSE;
         state->m_package = nullptr;
+        state->m_alignment = 0;
+        state->m_packMedia = FALSE;
+        state->m_indexMedia = FALSE;
+        state->m_classBlocks = FALSE;
+        state->m_groupHints = FALSE;
+        state->m_hashContent = FALSE;
+        state->m_contentHash = 0;
+        state->m_sceneLayout = TRUE;
+        state->m_traces = nullptr;
+        state->m_numTraces = 0;
     }
 
     DppLayoutManager *mgr = DppLayoutManager::getInstance();
@@ -233,75 +297,10 @@ int main(int argc, char *argv[])
 
     //__asm int 3h
 
-    // Read in the script file...
-#if USE_PYTHON_SIMPLE_STRING
-    MlePath *scriptFile = nullptr;
-#if _WINDOWS
-    scriptFile = new MleWin32Path((MlChar *)(state->m_scriptfile), true);
-#else /* ! _WINDOWS */
-    scriptFile = new MleLinuxPath((MlChar *)state->m_scriptfile, true);;
-#endif
-
-#if 0
-    if ((script = readFileToMemory((char *)scriptFile->getPlatformPath(), &scriptSize)) == NULL ) {
-        perror(state->m_scriptfile);
-        exit(2);
-    }
-#else
-    if ((script = mlReadFile((char*)scriptFile->getPlatformPath(), TRUE, TRUE, 0, &scriptSize)) == NULL) {
-        perror(state->m_scriptfile);
-        exit(2);
-    }
-#endif /* 0 */
-    if (scriptFile != NULL)
-        delete scriptFile;
-#endif /* USE_PYTHON_SIMPLE_STRING */
-
-    // Setup Python and execute sript...
-    // Add the built-in module, before Py_Initialize.
-    if (PyImport_AppendInittab("dpp", PyInit_dpp) == -1) {
-        fprintf(stderr, "Error: could not extend in-built modules table.\n");
-        exit(1);
-    }
-
-    // Initialize Python interpreter.
-    Py_Initialize();
-
-    // Call python command script.
-    //PyRun_SimpleString("print('Hello World from Embedded Python!!!')");
-#if _WINDOWS
-    FILE* fp = mlFOpen(state->m_scriptfile, "r");
-#else
-    FILE *fp = mlFOpen(state->m_scriptfile, "r");
-#endif
-    if (fp == NULL) {
-        fprintf(stderr, "Error: could not open script file %s: %s\n",
-                state->m_scriptfile, strerror(errno));
-        exit(1);
-	}
-#if USE_PYTHON_SIMPLE_STRING
-    if (PyRun_SimpleString(script) != 0) {
-        fprintf(stderr, "Error: could not execute script file %s\n",
-                state->m_scriptfile);
-        exit(1);
-	}
-#else /* ! USE_PYTHON_SIMPLE_STRING */
-	// Note: PyRun_SimpleFile() does not work on Windows with a binary file pointer.
-    PyRun_SimpleFile(fp, state->m_scriptfile);
-#endif
-    
-    // Terminate Python interpreter.
-    Py_Finalize();
-
-    // Todo: validate python script completion.
-
-    // Check for more chunks cached.  This would happen if the script
-    // ommitted a final endplayprint command, or simply used the -o
-    // option to specify the output file.
-
-    if (state->m_chunks->getUsed() > 0) {
-        endPlayprint();
-    }
+    // Run the script.
+    int status = runLayoutScript(state);
+    if (status != 0)
+        exit(status);
 
     // Clean up state.
     if (state->m_root != nullptr) delete state->m_root;
@@ -310,10 +309,6 @@ int main(int argc, char *argv[])
     if (state->m_scriptfile != nullptr) mlFree(state->m_scriptfile);
     if (state->m_chunks != NULL) delete state->m_chunks;
     if (state != nullptr) mlFree(state);
-#if USE_PYTHON_SIMPLE_STRING
-    mlFree(script);
-#endif /* USE_PYTHON_SIMPLE_STRING */
-	mlFClose(fp);
     
     return 0;
 }
@@ -20,10 +20,12 @@ INCLUDEPATH += $$PWD/../../common/include $$PWD/../../linux/include /opt/MagicLa
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+        $$PWD/../../common/src/DPPGenerator/DppBuild.cpp \
         $$PWD/../../common/src/DPPGenerator/DppGenCode.cpp \
         $$PWD/../../common/src/DPPGenerator/DppGenMakefile.cpp
 
 HEADERS += \
+        $$PWD/../../common/include/mle/DppBuild.h \
         $$PWD/../../common/include/mle/DppGenCode.h
         $$PWD/../../common/include/mle/DppGenMakefile.h
 
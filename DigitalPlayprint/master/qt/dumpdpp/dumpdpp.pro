@@ -18,7 +18,11 @@ INCLUDEPATH += $$PWD/../../common/include $$PWD/../../linux/include /opt/MagicLa
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    $$PWD/../../common/src/dumpdpp/dumpdpp.cpp
+    $$PWD/../../common/src/dumpdpp/dumpdpp.cpp \
+    $$PWD/../../common/src/dumpgroup/dumpvisitor.cpp
+
+HEADERS += \
+    $$PWD/../../common/src/dumpgroup/dumpvisitor.h
 
 unix:!macx {
     LIBS += -L/opt/MagicLantern/lib -lDPPGen -lDPP -lDWP -lplayprint -lmlmath -lmlutil -Wl,--no-as-needed -ldl
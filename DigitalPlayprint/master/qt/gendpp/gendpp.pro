@@ -30,6 +30,7 @@ SOURCES += \
         $$PWD/../../common/src/layout/DppLayoutManager.cpp \
         $$PWD/../../common/src/layout/gencode.cpp \
         $$PWD/../../common/src/layout/pymain.cpp \
+        $$PWD/../../common/src/layout/chkorder.cpp \
         $$PWD/../../common/src/layout/dppmodule.cpp \
 
 HEADERS += \
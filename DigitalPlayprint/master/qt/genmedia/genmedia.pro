@@ -18,14 +18,18 @@ INCLUDEPATH += $$PWD/../../common/include $$PWD/../../linux/include /opt/MagicLa
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-        $$PWD/../../common/src/genmedia/genmedia.cpp
+        $$PWD/../../common/src/genmedia/genmedia.cpp \
+        $$PWD/../../common/src/genmedia/mediaout.cpp
+
+HEADERS += \
+        $$PWD/../../common/src/genmedia/mediaout.h
 
 unix: QMAKE_LFLAGS_RPATH=
 unix: QMAKE_LFLAGS += \
     "-Wl,-rpath,/opt/MagicLantern/lib"
 
 unix:!macx {
-    LIBS += -L/opt/MagicLantern/lib -lDPPGen -lDPP -lDWP -lplayprint -lmlmath -lmlutil -Wl,--no-as-needed -ldl
+    LIBS += -L/opt/MagicLantern/lib -lDPPGen -lDPP -lDWP -lplayprint -lmlmath -lmlutil -Wl,--no-as-needed -ldl -lpthread
 }
 
 macx {
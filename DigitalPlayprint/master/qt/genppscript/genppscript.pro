@@ -18,7 +18,11 @@ INCLUDEPATH += $$PWD/../../common/include $$PWD/../../linux/include /opt/MagicLa
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-        $$PWD/../../common/src/layout/genppscript.cpp
+        $$PWD/../../common/src/layout/genppscript.cpp \
+        $$PWD/../../common/src/layout/ppscript.cpp
+
+HEADERS += \
+        $$PWD/../../common/src/layout/ppscript.h
 
 unix: QMAKE_LFLAGS_RPATH=
 unix: QMAKE_LFLAGS += \
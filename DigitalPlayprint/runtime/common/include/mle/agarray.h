@@ -0,0 +1,166 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Runtime Library API - Master */
+
+/**
+ *  @file agarray.h
+ *  @ingroup MleDPPMaster
+ *
+ *  This file defines the decoding of encoded array properties
+ *  of an actor group chunk.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_AGARRAY_H_
+#define __MLE_AGARRAY_H_
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agdecode.h"
+
+
+/**
+ * This class decodes the arrays written by copyEncodedArrayPropertyOpcode.
+ *
+ * The encodings and their error bounds are described in agopcode.h. The
+ * half float and 16-bit kernels use F16C and SSE2 on x86 or NEON on ARM
+ * when the processor has them and the chunk is in the byte order of the
+ * processor; the delta kernel is serial by nature.
+ */
+class MleDppEncodedArray
+{
+  public:
+
+    /**
+     * Construct a decoder.
+     *
+     * @param isLittle TRUE if the chunk is in Little Endian byte order.
+     */
+    MleDppEncodedArray(MlBoolean isLittle);
+
+    // destructor.
+    virtual ~MleDppEncodedArray(void);
+
+    /**
+     * Decode an encoded array into native elements.
+     *
+     * @param instruction A decoded copyEncodedArrayPropertyOpcode.
+     * @param elementSize The current property length, the size of one
+     * element.
+     * @param elements Receives instruction->m_operand elements of
+     * elementSize bytes, as copyArrayPropertyOpcode would have set them,
+     * but in the byte order of the processor.
+     *
+     * @return TRUE is returned if the data decoded cleanly.
+     */
+    MlBoolean decode(const MleDppInstruction *instruction,MlInt elementSize,void *elements);
+
+    /**
+     * Decode half floats.
+     *
+     * @param src count halves.
+     * @param dst Receives count floats.
+     */
+    void decodeHalf(const MlByte *src,float *dst,MlInt count);
+
+    /**
+     * Decode 16-bit steps between per-component ranges.
+     *
+     * @param src count steps.
+     * @param dst Receives count floats.
+     * @param count The number of components; a multiple of components.
+     * @param components The number of components in an element.
+     * @param ranges A (min, max) pair for each component.
+     */
+    void decodeNorm16(const MlByte *src,float *dst,MlInt count,
+        MlInt components,const float *ranges);
+
+    /**
+     * Decode zigzag deltas.
+     *
+     * @param src The encoded data.
+     * @param length The number of bytes of data.
+     * @param dst Receives count ints.
+     * @param count The number of ints.
+     *
+     * @return TRUE is returned if the data held exactly count values.
+     */
+    static MlBoolean decodeDelta(const MlByte *src,MlInt length,MlInt *dst,MlInt count);
+
+	/**
+	 * Override operator new.
+	 *
+	 * @param tSize The size, in bytes, to allocate.
+	 */
+	void* operator new(size_t tSize);
+
+    /**
+     * Override operator new array.
+     *
+     * @param tSize The size, in bytes, to allocate.
+     */
+    void* operator new[](size_t tSize);
+
+	/**
+	 * Override operator delete.
+	 *
+	 * @param p A pointer to the memory to delete.
+	 */
+    void  operator delete(void *p);
+
+    /**
+     * Override operator delete array.
+     *
+     * @param p A pointer to the memory to delete.
+     */
+    void  operator delete[](void* p);
+
+  private:
+
+    // Hide default constructor.
+    MleDppEncodedArray(void) {};
+
+    // Read a 16-bit value in the byte order of the chunk.
+    MlUShort getShort(const MlByte *data);
+
+    // Read a float in the byte order of the chunk.
+    float getFloat(const MlByte *data);
+
+    // TRUE if the chunk is in Little Endian byte order.
+    MlBoolean m_littleEndian;
+    // TRUE if the vector kernels may load the chunk directly.
+    MlBoolean m_nativeOrder;
+};
+
+
+#endif /* __MLE_AGARRAY_H_ */
@@ -0,0 +1,219 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Runtime Library API - Master */
+
+/**
+ *  @file agblock.h
+ *  @ingroup MleDPPMaster
+ *
+ *  This file defines access to the class blocks of an
+ *  actor group chunk.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_AGBLOCK_H_
+#define __MLE_AGBLOCK_H_
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agdecode.h"
+
+
+/**
+ * This class holds a record layout read from a defineClassLayoutOpcode.
+ *
+ * A layout names an actor class, the fixed-length properties every actor
+ * of a class block sets and the bindings every actor gets. The matching
+ * createActorBlockOpcode carries the property values as one column per
+ * property, so the actors of a block can be filled with a copy per column
+ * instead of interpreting an instruction per property.
+ *
+ * Property offsets are the same runtime property indexes used by
+ * setPropertyOffsetOpcode.
+ */
+class MleDppClassLayout
+{
+  public:
+
+    /**
+     * Construct an empty layout.
+     *
+     * @param isLittle TRUE if the chunk is in Little Endian byte order.
+     */
+    MleDppClassLayout(MlBoolean isLittle);
+
+    // destructor.
+    virtual ~MleDppClassLayout(void);
+
+    /**
+     * Read the layout from a decoded defineClassLayoutOpcode.
+     *
+     * @return TRUE is returned if the layout is well formed.
+     */
+    MlBoolean set(const MleDppInstruction *instruction);
+
+    /**
+     * Get the layout index that blocks refer to.
+     */
+    MlInt getLayout(void)
+    { return m_layout; }
+
+    /**
+     * Get the runtime index of the actor class.
+     */
+    MlInt getActorClass(void)
+    { return m_actorClass; }
+
+    /**
+     * Get the number of properties set by the layout.
+     */
+    MlInt getNumProperties(void)
+    { return m_numProperties; }
+
+    /**
+     * Get the runtime property index of a property.
+     */
+    MlInt getPropertyOffset(MlInt property)
+    { return m_properties[2 * property]; }
+
+    /**
+     * Get the size of a property, in bytes.
+     */
+    MlInt getPropertyLength(MlInt property)
+    { return m_properties[2 * property + 1]; }
+
+    /**
+     * Get the number of bytes of property values for one actor.
+     */
+    MlInt getRecordSize(void)
+    { return m_recordSize; }
+
+    /**
+     * Get the number of bindings each actor gets.
+     */
+    MlInt getNumBindings(void)
+    { return m_numBindings; }
+
+    /**
+     * Get the set (forum) of a binding.
+     */
+    MlInt getBindingSet(MlInt binding)
+    { return m_bindings[2 * binding]; }
+
+    /**
+     * Get the role (delegate) class of a binding.
+     */
+    MlInt getBindingRole(MlInt binding)
+    { return m_bindings[2 * binding + 1]; }
+
+    /**
+     * Check that a decoded createActorBlockOpcode uses this layout and
+     * holds a full record for each of its actors.
+     */
+    MlBoolean checkBlock(const MleDppInstruction *block);
+
+    /**
+     * Get the values of one property for every actor of a block.
+     *
+     * @param block A createActorBlockOpcode accepted by checkBlock().
+     * @param property The property of the layout.
+     *
+     * @return The column is returned; the value of actor i is at
+     * i * getPropertyLength(property).
+     */
+    const MlByte *getColumn(const MleDppInstruction *block,MlInt property);
+
+    /**
+     * Copy one property of every actor of a block into the actors.
+     *
+     * @param block A createActorBlockOpcode accepted by checkBlock().
+     * @param property The property of the layout.
+     * @param actors The block's actors, in order.
+     * @param byteOffset The byte offset of the property in the actors.
+     */
+    void scatterColumn(const MleDppInstruction *block,MlInt property,
+        MlByte **actors,MlInt byteOffset);
+
+	/**
+	 * Override operator new.
+	 *
+	 * @param tSize The size, in bytes, to allocate.
+	 */
+	void* operator new(size_t tSize);
+
+    /**
+     * Override operator new array.
+     *
+     * @param tSize The size, in bytes, to allocate.
+     */
+    void* operator new[](size_t tSize);
+
+	/**
+	 * Override operator delete.
+	 *
+	 * @param p A pointer to the memory to delete.
+	 */
+    void  operator delete(void *p);
+
+    /**
+     * Override operator delete array.
+     *
+     * @param p A pointer to the memory to delete.
+     */
+    void  operator delete[](void* p);
+
+  private:
+
+    // Hide default constructor.
+    MleDppClassLayout(void) {};
+
+    // Read an int in the byte order of the chunk.
+    MlInt getInt(const MlByte *data);
+
+    // TRUE if the chunk is in Little Endian byte order.
+    MlBoolean m_littleEndian;
+    // The layout index and actor class.
+    MlInt m_layout;
+    MlInt m_actorClass;
+    // The (offset, length) pairs of the properties.
+    MlInt *m_properties;
+    MlInt m_numProperties;
+    // The (set, role) pairs of the bindings.
+    MlInt *m_bindings;
+    MlInt m_numBindings;
+    // The sum of the property lengths.
+    MlInt m_recordSize;
+};
+
+
+#endif /* __MLE_AGBLOCK_H_ */
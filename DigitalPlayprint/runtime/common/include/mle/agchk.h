@@ -47,14 +47,16 @@
 
 // Include Digital Playprint header files.
 #include "mle/mlTypes.h"
+#include "mle/mlMalloc.h"
 #include "mle/Dpp.h"
+#include "mle/agdecode.h"
 
 
 /**
  * @brief This class is used to create Actor Group Chunks for the Magic
  * Lantern Digital Playprint format.
  */
-class MleDppActorGroupChunk
+class MleDppActorGroupChunk : public MleDppOpcodeVisitor
 {	
   public:
 
@@ -75,6 +77,8 @@ class MleDppActorGroupChunk
 	{
 		if (m_mediaNames != NULL)
 			delete [] m_mediaNames;
+		if (m_sets != NULL)
+			mlFree(m_sets);
 		//if (m_fp != NULL)
 		//	fclose(m_fp);
 	};
@@ -111,11 +115,57 @@ class MleDppActorGroupChunk
      * with the value in the indices array; it returns the address and length of the
      * resolved actor group chunk.
 	 * <p>
+     * If the chunk carries an actor directory, it is kept at the end of the
+     * resolved chunk with its offsets moved to match the resolved stream.
+	 * </p>
+	 * <p>
      * It is the caller's responsibility to call delete on the method result.
 	 * </p>
 	 */
     const unsigned char *resolveNames(int* length, const MlInt* indices);
 
+    /**
+	 * @brief Pack runs of like actors into class blocks.
+	 *
+     * When enabled, resolveNames() replaces each run of consecutive actors
+     * that share a class, the same fixed-length properties and the same
+     * bindings with a class layout and a class block (see agopcode.h).
+     * Chunks carrying an actor directory are left unpacked. It is off by
+     * default.
+	 *
+	 * @param enable Set to <b>true</b> to pack class blocks.
+	 */
+    static void setClassBlocks(MlBoolean enable);
+
+    /**
+	 * @brief Write allocation hints in the group header.
+	 *
+     * When enabled, resolveNames() sets the groupHintsFlag in the group
+     * class and writes the number of actors of each class and the size of
+     * the dynamic properties after it (see agopcode.h), so the loader can
+     * make one allocation for the group. Only loaders that know the flag
+     * can read such a chunk. It is off by default.
+	 *
+	 * @param enable Set to <b>true</b> to write allocation hints.
+	 */
+    static void setGroupHints(MlBoolean enable);
+
+    /**
+	 * @brief Get the sets the actors of the group are placed in.
+	 *
+     * The sets are found by resolveNames(), which must be called first.
+	 *
+     * @return An array of runtime set indexes, each listed once.
+	 */
+    const MlInt *getSets(void)
+	{ return m_sets; };
+
+    /**
+	 * @brief Get the number of sets returned by getSets().
+	 */
+    int countSets(void)
+	{ return m_numSets; };
+
 	/**
 	 * Override operator new.
 	 *
@@ -152,7 +202,6 @@ class MleDppActorGroupChunk
 	MlInt m_nameLength;
 	MlInt m_littleEndian;
 	
-	const MlByte * m_chunkRef;
 	const MlByte * m_chunkStart;
 	const MlByte * m_chunkEnd;
 
@@ -160,23 +209,108 @@ class MleDppActorGroupChunk
 	MlByte * m_resolvedChunkBuf;
 	MlByte * m_resolvedChunkPtr;
 
-	MlByte nextChunkByte(void);
-	
-	MlByte copyStreamByte(void);
-	
-	MlInt readIndex(void);
-	
+	MlInt * m_sets;
+	int m_numSets;
+
+	// The actor directory, as (offset, class) pairs, and the offset
+	// of the end of the last actor.
+	MlInt * m_directory;
+	int m_numDirectory;
+	MlInt m_directoryEnd;
+	int m_directoryNext;
+	MlBoolean m_directoryEndMapped;
+
+	// The media reference indices passed to resolveNames().
+	const MlInt * m_indices;
+
+	// An actor found while scanning for class blocks. Its properties are
+	// (offset, length, data offset) triples in m_blockProperties and its
+	// bindings are (set, role) pairs in m_blockBindings.
+	typedef struct _BlockActor
+	{
+		MlInt m_start;
+		MlInt m_end;
+		MlInt m_actorClass;
+		int m_firstProperty;
+		int m_numProperties;
+		int m_firstBinding;
+		int m_numBindings;
+		MlBoolean m_packable;
+	} BlockActor;
+
+	// A run of actors packed into one class block.
+	typedef struct _BlockRun
+	{
+		MlInt m_start;
+		MlInt m_end;
+		int m_firstActor;
+		int m_numActors;
+		int m_layout;
+	} BlockRun;
+
+	BlockActor * m_blockActors;
+	int m_numBlockActors;
+	int m_maxBlockActors;
+	int m_scanActor;
+	MlInt * m_blockProperties;
+	int m_numBlockProperties;
+	int m_maxBlockProperties;
+	MlInt * m_blockBindings;
+	int m_numBlockBindings;
+	int m_maxBlockBindings;
+	BlockRun * m_blockRuns;
+	int m_numBlockRuns;
+	int m_nextBlockRun;
+	int m_numLayoutsWritten;
+	MlBoolean m_scanning;
+	// The end of the actors replaced by the last class block.
+	MlInt m_blockEnd;
+
+	// The property offset, property length and set last given by the
+	// chunk and by the resolved chunk; they differ after a class block.
+	MlInt m_sourceOffset;
+	MlInt m_sourceLength;
+	MlInt m_sourceSet;
+	MlInt m_resolvedOffset;
+	MlInt m_resolvedLength;
+	MlInt m_resolvedSet;
+
+	// Pack class blocks.
+	static MlBoolean g_classBlocks;
+
+	// Write allocation hints.
+	static MlBoolean g_groupHints;
+
+	void addSet(MlInt set);
+
+	MlInt getInt(const MlByte *data);
+
+	MlBoolean readDirectory(int chunkLength);
+
+	void mapDirectory(MlInt srcOffset);
+
 	MlInt writeIndex(MlInt index);
 	
-	MlInt readInt(void);
-	
 	MlInt writeInt(MlInt index);
-	
-	MlInt copyIndex()
-	{ return writeIndex(readIndex()); };
-	
-	MlInt copyInt()
-	{ return writeInt(readInt()); };
+
+	void writeBytes(const MlByte *data, int length);
+
+	void findClassBlocks(int chunkLength, int start);
+
+	MlBoolean scanActor(const MleDppInstruction *instruction);
+
+	void endScanActor(MlInt offset);
+
+	MlBoolean sameLayout(const BlockActor *a, const BlockActor *b);
+
+	void writeClassBlock(const BlockRun *run);
+
+	void restoreState(MlByte opcode);
+
+	void freeClassBlocks(void);
+
+	// Copy one decoded instruction to the resolved chunk.
+	MlBoolean visit(const MleDppInstruction *instruction);
 };
 
 #endif /* __MLE_DPP_ACTORGROUPCHUNK_H_ */
@@ -0,0 +1,261 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Runtime Library API - Master */
+
+/**
+ *  @file agdecode.h
+ *  @ingroup MleDPPMaster
+ *
+ *  This file defines a decoder for the opcode stream of actor
+ *  group and set chunks.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_AGDECODE_H_
+#define __MLE_AGDECODE_H_
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+
+
+/*
+ * Decoder status codes.
+ */
+#define MLE_DPP_DECODE_OK           0 /* End of stream or endActorGroupOpcode. */
+#define MLE_DPP_DECODE_STOPPED      1 /* The visitor stopped decoding. */
+#define MLE_DPP_DECODE_TRUNCATED    2 /* An operand runs past the end. */
+#define MLE_DPP_DECODE_BADOPCODE    3 /* Not an opcode from agopcode.h. */
+#define MLE_DPP_DECODE_BADINDEX     4 /* An index does not fit in an MlInt. */
+#define MLE_DPP_DECODE_BADLENGTH    5 /* Missing or negative property length. */
+
+
+/**
+ * One decoded instruction of an opcode stream.
+ */
+typedef struct _MleDppInstruction
+{
+    MlInt m_opcode;        /* The opcode. */
+    MlInt m_offset;        /* Offset of the opcode in the stream. */
+    MlInt m_length;        /* Encoded length, including the opcode. */
+    MlInt m_operand;       /* The index operand, the property length for
+                              copyPropertyOpcode, the byte count for
+                              copyDynamicPropertyOpcode, the element count
+                              for copyArrayPropertyOpcode and
+                              copyEncodedArrayPropertyOpcode, the layout for
+                              defineClassLayoutOpcode and
+                              createActorBlockOpcode or the string count
+                              for defineStringPoolOpcode. */
+    MlInt m_count;         /* The number of actors in a class block or the
+                              encoding of an encoded array. */
+    const MlByte *m_data;  /* The property data, the block data, the
+                              encoded layout, the pooled strings or the
+                              encoded array, if any. */
+    MlInt m_dataLength;    /* The number of bytes of data. */
+} MleDppInstruction;
+
+
+/**
+ * The interface used by MleDppOpcodeDecoder to hand out instructions.
+ */
+class MleDppOpcodeVisitor
+{
+  public:
+
+    // destructor.
+    virtual ~MleDppOpcodeVisitor(void) {};
+
+    /**
+     * Visit one instruction.
+     *
+     * @param instruction The decoded instruction. It is only valid
+     * during the call.
+     *
+     * @return Return FALSE to stop decoding.
+     */
+    virtual MlBoolean visit(const MleDppInstruction *instruction) = 0;
+};
+
+
+/**
+ * This class decodes the opcode stream of actor group and set chunks.
+ *
+ * Dispatch is through a table indexed by opcode, and the stream bounds are
+ * checked once per instruction rather than once per byte, so a malformed
+ * stream is reported with a status code instead of being read past its end.
+ * Decoding without a visitor validates the stream.
+ *
+ * Decoding stops after an endActorGroupOpcode or at the end of the stream.
+ * The property length set by setPropertyLengthOpcode is reset at the start
+ * of each call.
+ */
+class MleDppOpcodeDecoder
+{
+  public:
+
+    /**
+     * Construct a decoder.
+     *
+     * @param isLittle TRUE if the stream is in Little Endian byte order.
+     */
+    MleDppOpcodeDecoder(MlBoolean isLittle);
+
+    // destructor.
+    virtual ~MleDppOpcodeDecoder(void);
+
+    /**
+     * Decode the instructions of a stream.
+     *
+     * @param stream The opcode stream.
+     * @param length The size of the stream, in bytes.
+     * @param offset The offset of the first instruction.
+     * @param visitor The visitor to hand each instruction to, or NULL to
+     * only validate the stream.
+     *
+     * @return One of the MLE_DPP_DECODE status codes is returned.
+     * getOffset() tells where decoding stopped.
+     */
+    MlInt decode(const MlByte *stream,MlInt length,MlInt offset,
+        MleDppOpcodeVisitor *visitor);
+
+    /**
+     * Check that a stream decodes cleanly.
+     *
+     * @return One of the MLE_DPP_DECODE status codes is returned.
+     */
+    MlInt validate(const MlByte *stream,MlInt length,MlInt offset)
+    { return decode(stream,length,offset,NULL); }
+
+    /**
+     * Decode the header of an actor group stream.
+     *
+     * @param stream The group stream, starting with the group class.
+     * @param length The size of the stream, in bytes.
+     * @param groupClass Returns the runtime index of the group's class,
+     * without the groupHintsFlag.
+     * @param numActors Returns the number of actors in the group.
+     *
+     * @return The offset of the first instruction, after any allocation
+     * hints, is returned, or -1 if the header is malformed.
+     */
+    MlInt decodeGroupHeader(const MlByte *stream,MlInt length,
+        MlInt *groupClass,MlInt *numActors);
+
+    /**
+     * Get the offset after the last instruction decoded.
+     *
+     * If decoding failed, this is the offset of the bad instruction.
+     */
+    MlInt getOffset(void)
+    { return m_offset; }
+
+    /**
+     * Read an int in the byte order of the stream.
+     *
+     * @param data At least four bytes.
+     */
+    MlInt readInt(const MlByte *data);
+
+    /**
+     * Read an index.
+     *
+     * An index is a big-endian sequence of 7-bit groups, ended by the next
+     * opcode or by the end of the stream.
+     *
+     * @param data The index.
+     * @param length The number of bytes available.
+     * @param value Returns the index.
+     *
+     * @return The number of bytes in the index is returned, or -1 if it
+     * does not fit in an MlInt.
+     */
+    static MlInt readIndex(const MlByte *data,MlInt length,MlInt *value);
+
+	/**
+	 * Override operator new.
+	 *
+	 * @param tSize The size, in bytes, to allocate.
+	 */
+	void* operator new(size_t tSize);
+
+    /**
+     * Override operator new array.
+     *
+     * @param tSize The size, in bytes, to allocate.
+     */
+    void* operator new[](size_t tSize);
+
+	/**
+	 * Override operator delete.
+	 *
+	 * @param p A pointer to the memory to delete.
+	 */
+    void  operator delete(void *p);
+
+    /**
+     * Override operator delete array.
+     *
+     * @param p A pointer to the memory to delete.
+     */
+    void  operator delete[](void* p);
+
+  private:
+
+    // Hide default constructor.
+    MleDppOpcodeDecoder(void) {};
+
+    // Decode the operands of one instruction, starting after its opcode.
+    typedef MlInt (MleDppOpcodeDecoder::*OperandDecoder)(
+        const MlByte *p,MlInt available,MleDppInstruction *instruction);
+
+    MlInt decodeNone(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+    MlInt decodeIndex(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+    MlInt decodeLength(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+    MlInt decodeProperty(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+    MlInt decodeDynamic(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+    MlInt decodeArray(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+    MlInt decodeLayout(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+    MlInt decodeBlock(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+    MlInt decodePool(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+    MlInt decodeEncoded(const MlByte *p,MlInt available,MleDppInstruction *instruction);
+
+    // The operand decoders, indexed by opcode - beginActorSetOpcode.
+    static const OperandDecoder g_operandDecoders[];
+
+    // TRUE if the stream is in Little Endian byte order.
+    MlBoolean m_littleEndian;
+    // The current property length, or -1 if none has been set.
+    MlInt m_propertyLength;
+    // Where decoding stopped.
+    MlInt m_offset;
+};
+
+
+#endif /* __MLE_AGDECODE_H_ */
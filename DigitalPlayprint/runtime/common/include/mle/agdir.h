@@ -0,0 +1,211 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Runtime Library API - Master */
+
+/**
+ *  @file agdir.h
+ *  @ingroup MleDPPMaster
+ *
+ *  This file defines access to the actor directory of an
+ *  actor group chunk.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_AGDIR_H_
+#define __MLE_AGDIR_H_
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+
+
+/**
+ * Callback used by MleDppActorDirectory::decodeActors().
+ *
+ * @param actor The index of the actor within its group.
+ * @param actorClass The runtime index of the actor's class.
+ * @param stream The actor's opcodes, starting with its createActorOpcode.
+ * @param length The number of bytes in stream.
+ * @param clientData The client data passed to decodeActors().
+ *
+ * @return Return FALSE to stop decoding.
+ */
+typedef MlBoolean (*MleDppActorCallback)(
+    MlInt actor,MlInt actorClass,const MlByte *stream,MlInt length,void *clientData);
+
+
+/**
+ * This class reads the actor directory of a resolved actor group chunk.
+ *
+ * The directory is optional; it is written by gengroup -a and kept by
+ * MleDppActorGroupChunk::resolveNames(). It gives the offset and class of
+ * each actor so that a few actors can be created from a large group without
+ * interpreting the opcodes of the others. Each actor's opcodes are self
+ * contained: they do not rely on a property offset or length set by an
+ * earlier actor.
+ *
+ * An actor's opcodes can be given to MleDppOpcodeDecoder::decode().
+ * The directory does not copy the chunk; the chunk must outlive it.
+ */
+class MleDppActorDirectory
+{
+  public:
+
+    /**
+     * Construct a directory over a resolved actor group chunk.
+     *
+     * @param chunk The group chunk, starting with the group class.
+     * @param length The size of the chunk, in bytes.
+     * @param isLittle TRUE if the chunk is in Little Endian byte order.
+     */
+    MleDppActorDirectory(const MlByte *chunk,MlInt length,MlBoolean isLittle);
+
+    // destructor.
+    virtual ~MleDppActorDirectory(void);
+
+    /**
+     * Determine whether the chunk has a well formed actor directory.
+     *
+     * None of the other methods return anything useful when it does not.
+     */
+    MlBoolean isValid(void)
+    { return m_directory != NULL; }
+
+    /**
+     * Get the runtime index of the group's class.
+     */
+    MlInt getGroupClass(void);
+
+    /**
+     * Get the number of actors in the group.
+     */
+    MlInt getNumActors(void)
+    { return m_numActors; }
+
+    /**
+     * Get the runtime index of an actor's class.
+     *
+     * @param actor The index of the actor within the group.
+     *
+     * @return The class index is returned, or -1 if actor is out of range.
+     */
+    MlInt getActorClass(MlInt actor);
+
+    /**
+     * Get the opcodes of one actor.
+     *
+     * @param actor The index of the actor within the group.
+     * @param length Returns the number of bytes of opcodes.
+     *
+     * @return A pointer into the chunk at the actor's createActorOpcode is
+     * returned, or NULL if actor is out of range.
+     */
+    const MlByte *getActor(MlInt actor,MlInt *length);
+
+    /**
+     * Get the opcodes that follow the last actor, such as the
+     * delegate attachments, up to and including the endActorGroupOpcode.
+     *
+     * @param length Returns the number of bytes of opcodes.
+     */
+    const MlByte *getAttachments(MlInt *length);
+
+    /**
+     * Hand the opcodes of selected actors to a callback.
+     *
+     * Only the selected actors are touched; the rest of the stream is
+     * never read.
+     *
+     * @param actors The indexes of the actors to decode, in any order.
+     * @param numActors The number of entries in actors.
+     * @param callback Called once for each actor.
+     * @param clientData Passed through to the callback.
+     *
+     * @return TRUE is returned if every actor was handed to the callback.
+     * FALSE is returned if an index is out of range or the callback stopped.
+     */
+    MlBoolean decodeActors(const MlInt *actors,MlInt numActors,
+        MleDppActorCallback callback,void *clientData);
+
+	/**
+	 * Override operator new.
+	 *
+	 * @param tSize The size, in bytes, to allocate.
+	 */
+	void* operator new(size_t tSize);
+
+    /**
+     * Override operator new array.
+     *
+     * @param tSize The size, in bytes, to allocate.
+     */
+    void* operator new[](size_t tSize);
+
+	/**
+	 * Override operator delete.
+	 *
+	 * @param p A pointer to the memory to delete.
+	 */
+    void  operator delete(void *p);
+
+    /**
+     * Override operator delete array.
+     *
+     * @param p A pointer to the memory to delete.
+     */
+    void  operator delete[](void* p);
+
+  private:
+
+    // Hide default constructor.
+    MleDppActorDirectory(void) {};
+
+    // Read an int in the byte order of the chunk.
+    MlInt getInt(const MlByte *data);
+
+    // Check the directory against the stream it indexes.
+    MlBoolean validate(void);
+
+    // The group chunk.
+    const MlByte *m_chunk;
+    // The (offset, class) pairs of the directory, or NULL if there is none.
+    const MlByte *m_directory;
+    // The number of actors in the directory.
+    MlInt m_numActors;
+    // The offset of the end of the last actor.
+    MlInt m_actorsEnd;
+    // The offset of the endActorGroupOpcode.
+    MlInt m_streamEnd;
+    // TRUE if the chunk is in Little Endian byte order.
+    MlBoolean m_littleEndian;
+};
+
+
+#endif /* __MLE_AGDIR_H_ */
@@ -0,0 +1,224 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Runtime Library API - Master */
+
+/**
+ *  @file aghints.h
+ *  @ingroup MleDPPMaster
+ *
+ *  This file defines access to the allocation hints of an
+ *  actor group chunk.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+
+#ifndef __MLE_AGHINTS_H_
+#define __MLE_AGHINTS_H_
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agdecode.h"
+#include "mle/agpool.h"
+
+
+/**
+ * This class holds the allocation hints of an actor group chunk.
+ *
+ * The hints are written after the group header when the groupHintsFlag is
+ * set in the group class (see agopcode.h). They tell how many actors of
+ * each class the group creates and how many bytes its dynamic properties
+ * take, so a loader can size one MleDppArena for the whole group instead
+ * of allocating per actor and per property. The hints of a chunk without
+ * them can also be computed by decoding it.
+ */
+class MleDppGroupHints : public MleDppOpcodeVisitor
+{
+  public:
+
+    /**
+     * Construct empty hints.
+     *
+     * @param isLittle TRUE if chunks are in Little Endian byte order.
+     */
+    MleDppGroupHints(MlBoolean isLittle);
+
+    // destructor.
+    virtual ~MleDppGroupHints(void);
+
+    /**
+     * Read the hints from the header of a group chunk.
+     *
+     * @param chunk The group chunk, starting with the group class.
+     * @param length The size of the chunk, in bytes.
+     *
+     * @return TRUE is returned if the chunk has well formed hints.
+     */
+    MlBoolean read(const MlByte *chunk,MlInt length);
+
+    /**
+     * Compute the hints by decoding the opcodes of a group chunk.
+     *
+     * This is used by the mastering tools to write the hints, and may be
+     * used by a loader for chunks written without them.
+     *
+     * @param chunk The group chunk, starting with the group class.
+     * @param length The size of the chunk, in bytes.
+     *
+     * @return TRUE is returned if the chunk decodes cleanly.
+     */
+    MlBoolean compute(const MlByte *chunk,MlInt length);
+
+    /**
+     * Get the number of actor classes the group creates.
+     */
+    MlInt getNumClasses(void)
+    { return m_numClasses; }
+
+    /**
+     * Get the runtime index of an actor class, in order of first use.
+     *
+     * @return The class is returned, or -1 if i is out of range.
+     */
+    MlInt getActorClass(MlInt i);
+
+    /**
+     * Get the number of actors of a class.
+     *
+     * @param i The same index as for getActorClass().
+     *
+     * @return The count is returned, or -1 if i is out of range.
+     */
+    MlInt getNumActors(MlInt i);
+
+    /**
+     * Get the number of dynamic, pooled string and array properties.
+     */
+    MlInt getNumDynamic(void)
+    { return m_numDynamic; }
+
+    /**
+     * Get the number of bytes the dynamic properties take once decoded.
+     */
+    MlInt getDynamicBytes(void)
+    { return m_dynamicBytes; }
+
+    /**
+     * Get the size of the hints as written after the group header,
+     * including hintsLength.
+     */
+    MlInt getSize(void)
+    { return (MlInt)sizeof(MlInt) * (4 + 2 * m_numClasses); }
+
+    /**
+     * Get the size of an MleDppArena that holds every actor and dynamic
+     * property of the group.
+     *
+     * @param classSizes The size of an actor of each runtime class.
+     * @param numClassSizes The number of entries in classSizes.
+     *
+     * @return The size is returned, or 0 if the group uses a class without
+     * a size.
+     */
+    MlUInt getArenaSize(const MlUInt *classSizes,MlInt numClassSizes);
+
+    /**
+     * Count one instruction; used by compute().
+     */
+    virtual MlBoolean visit(const MleDppInstruction *instruction);
+
+	/**
+	 * Override operator new.
+	 *
+	 * @param tSize The size, in bytes, to allocate.
+	 */
+	void* operator new(size_t tSize);
+
+    /**
+     * Override operator new array.
+     *
+     * @param tSize The size, in bytes, to allocate.
+     */
+    void* operator new[](size_t tSize);
+
+	/**
+	 * Override operator delete.
+	 *
+	 * @param p A pointer to the memory to delete.
+	 */
+    void  operator delete(void *p);
+
+    /**
+     * Override operator delete array.
+     *
+     * @param p A pointer to the memory to delete.
+     */
+    void  operator delete[](void* p);
+
+  private:
+
+    // Hide default constructor.
+    MleDppGroupHints(void) {};
+
+    // Forget the hints and the decoding state.
+    void clear(void);
+
+    // Count count more actors of a class.
+    MlBoolean addActors(MlInt actorClass,MlInt count);
+
+    // Count a dynamic property of some bytes.
+    MlBoolean addDynamic(MlInt bytes);
+
+    // Read an int in the byte order of the chunk.
+    MlInt readInt(const MlByte *data);
+
+    // TRUE if chunks are in Little Endian byte order.
+    MlBoolean m_littleEndian;
+
+    // (actorClass, numActors) pairs, in order of first use.
+    MlInt *m_classes;
+    MlInt m_numClasses;
+    MlInt m_maxClasses;
+    MlInt m_numDynamic;
+    MlInt m_dynamicBytes;
+
+    // Decoding state for compute(): the runs of actors created so far as
+    // (firstActor, actorClass) pairs, for clones; the class of each
+    // layout, for blocks; the string pool and the property length.
+    MlInt *m_runs;
+    MlInt m_numRuns;
+    MlInt m_maxRuns;
+    MlInt m_numCreated;
+    MlInt *m_layouts;
+    MlInt m_numLayouts;
+    MleDppStringPool m_pool;
+    MlInt m_propertyLength;
+};
+
+
+#endif /* __MLE_AGHINTS_H_ */
@@ -0,0 +1,156 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Runtime Library API - Master */
+
+/**
+ *  @file agpool.h
+ *  @ingroup MleDPPMaster
+ *
+ *  This file defines access to the string pool of an
+ *  actor group chunk.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_AGPOOL_H_
+#define __MLE_AGPOOL_H_
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agdecode.h"
+
+
+/**
+ * This class holds the string pool read from a defineStringPoolOpcode.
+ *
+ * The pool is written by gengroup -s. Each string of the group is kept
+ * once, ended by a zero byte, and actors name it with
+ * copyPooledStringOpcode. The strings are not copied: a loader may hand
+ * the same pointer to every actor that uses a string, as long as the chunk
+ * outlives those actors.
+ */
+class MleDppStringPool
+{
+  public:
+
+    /**
+     * Construct an empty pool.
+     */
+    MleDppStringPool(void);
+
+    // destructor.
+    virtual ~MleDppStringPool(void);
+
+    /**
+     * Read the pool from a decoded defineStringPoolOpcode.
+     *
+     * @return TRUE is returned if the pool is well formed.
+     */
+    MlBoolean set(const MleDppInstruction *instruction);
+
+    /**
+     * Read the pool of a resolved actor group chunk.
+     *
+     * The pool, if any, is the first instruction after the group header,
+     * so this also serves readers that go straight to one actor through
+     * MleDppActorDirectory.
+     *
+     * @param chunk The group chunk, starting with the group class.
+     * @param length The size of the chunk, in bytes.
+     * @param isLittle TRUE if the chunk is in Little Endian byte order.
+     *
+     * @return TRUE is returned if the chunk has a well formed pool.
+     */
+    MlBoolean read(const MlByte *chunk,MlInt length,MlBoolean isLittle);
+
+    /**
+     * Get the number of strings in the pool.
+     */
+    MlInt getNumStrings(void)
+    { return m_numStrings; }
+
+    /**
+     * Get a string of the pool.
+     *
+     * @param string The index used by copyPooledStringOpcode.
+     *
+     * @return A pointer into the chunk is returned, or NULL if string is
+     * out of range.
+     */
+    const char *getString(MlInt string);
+
+    /**
+     * Get the length of a string of the pool, not counting the zero byte.
+     *
+     * @return The length is returned, or -1 if string is out of range.
+     */
+    MlInt getStringLength(MlInt string);
+
+	/**
+	 * Override operator new.
+	 *
+	 * @param tSize The size, in bytes, to allocate.
+	 */
+	void* operator new(size_t tSize);
+
+    /**
+     * Override operator new array.
+     *
+     * @param tSize The size, in bytes, to allocate.
+     */
+    void* operator new[](size_t tSize);
+
+	/**
+	 * Override operator delete.
+	 *
+	 * @param p A pointer to the memory to delete.
+	 */
+    void  operator delete(void *p);
+
+    /**
+     * Override operator delete array.
+     *
+     * @param p A pointer to the memory to delete.
+     */
+    void  operator delete[](void* p);
+
+  private:
+
+    // The offset of each string in m_data, and of the end of the data.
+    MlInt *m_offsets;
+    MlInt m_numStrings;
+    // The pooled strings, in the chunk.
+    const MlByte *m_data;
+};
+
+
+#endif /* __MLE_AGPOOL_H_ */
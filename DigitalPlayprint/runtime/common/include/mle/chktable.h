@@ -73,6 +73,12 @@ class MleDppChunkEntry
 
 	/** The offset into the chunk table for this entry. */
     MlUInt m_offset;
+
+	/** The payload size of the chunk in the playprint. */
+    MlUInt m_size;
+
+	/** The tag of the chunk in the playprint. */
+    MlUInt m_tag;
 };
 
 /**
@@ -101,6 +107,13 @@ class MleDppChunkTable
 
     void setOffset(int index, MlUInt offset);
 
+    MlUInt getSize(MlInt index);
+
+    MlUInt getTag(MlInt index);
+
+	// Record where the chunk ended up in the playprint.
+    void setLocation(int index, MlUInt offset, MlUInt size, MlUInt tag);
+
 	/**
 	 * Override operator new.
 	 *
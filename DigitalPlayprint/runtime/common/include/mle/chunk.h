@@ -100,6 +100,48 @@ typedef struct
 	MlUInt m_numMrefs; /**< Number of MediaRef chunks in MRFL LIST. */
 } MleMediaRefInfoChunk;
 
+/** The 'info' chunk is followed by an 'midx' chunk. */
+#define MLE_MREF_INFO_INDEXED 0x00000001
+
+
+/**
+ * This structure is used for reading/writing one entry of a MediaRef
+ * 'midx' chunk. There is one entry per 'mref' chunk in the MRFL LIST,
+ * in the same order.
+ */
+typedef struct
+{
+	MlUInt m_offset;   /**< File offset of the 'mref' chunk. */
+	MlUInt m_size;     /**< Size of the media data, in bytes. */
+	MlDppTag m_label;  /**< MediaRef type; the target label tag. */
+} MleMediaRefIndexEntry;
+
+
+/**
+ * This structure is used for reading/writing the header of a packed
+ * media 'mpak' chunk. It is followed by m_numMrefs MleMediaPackEntry
+ * structures, in media reference order, and then by the media data.
+ */
+typedef struct
+{
+	MlUInt m_flags;
+	MlUInt m_type;      /**< Index into runtime class constructor table. */
+	MlUInt m_numMrefs;  /**< Number of media references in the pack. */
+	MlUInt m_alignment; /**< Alignment of each media payload, in bytes. */
+} MleMediaPackHeader;
+
+/**
+ * This structure is used for reading/writing one entry of the offset
+ * table of a packed media 'mpak' chunk.
+ */
+typedef struct
+{
+	MlUInt m_flags;     /**< MediaRef flags; 0 for an external reference. */
+	MlDppTag m_label;   /**< MediaRef type; the target label tag. */
+	MlUInt m_offset;    /**< Offset of the media data from the chunk data. */
+	MlUInt m_size;      /**< Size of the media data, in bytes. */
+} MleMediaPackEntry;
+
 
 /**
  * This structure is used for reading/writing a MediaRef 'mref' chunk.
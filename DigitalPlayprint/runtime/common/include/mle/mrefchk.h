@@ -46,6 +46,7 @@
 #include "mle/mlTypes.h"
 #include "mle/chunk.h"
 #include "mle/chkfile.h"
+#include "mle/mrefstrm.h"
 
 
 /**
@@ -103,6 +104,9 @@ class MleMrefChunkFile : public MleChunkFile
     // read IFF 'mref' chunk
     MlBoolean readData(MleMediaRefChunk *chunkData);
 
+    // open IFF 'mref' chunk for ranged reads of its payload
+    MlBoolean openData(MleMediaRefStream *stream);
+
     // write IFF 'mref' chunk
     MlBoolean writeData(MleMediaRefChunk *chunkData);
 
@@ -0,0 +1,184 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Runtime Library API - Master */
+
+/**
+ *  @file mrefstrm.h
+ *  @ingroup MleDPPMaster
+ *
+ *  This file defines a handle for ranged reads of MediaRef
+ *  payloads.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_MREFSTREAM_H_
+#define __MLE_MREFSTREAM_H_
+
+// Include system header files.
+#include <stdio.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+#include "mle/pp.h"
+
+
+/**
+ * This structure is passed to the slice callback of MleMediaRefStream.
+ */
+typedef struct
+{
+    MlUInt m_offset;   /**< Offset of the slice within the payload. */
+    MlUInt m_size;     /**< Number of valid bytes in m_data. */
+    void  *m_data;     /**< The slice data. */
+} MleMediaRefSlice;
+
+
+/**
+ * This class is used to read a MediaRef payload in pieces, straight from
+ * the Digital Playprint or chunk file that contains it, instead of
+ * loading the whole payload into memory.
+ *
+ * A stream only records where the payload lives; it borrows the file
+ * handle of the reader that opened it and is valid for as long as that
+ * reader is. Reads preserve the reader's file position, so a stream may
+ * be used while the reader continues through its MediaRef list.
+ *
+ * @see MleDppInput::openMedia(), MleMrefChunkFile::openData()
+ */
+class MleMediaRefStream
+{
+  public:
+
+    // constructor.
+    MleMediaRefStream(void);
+
+    // destructor.
+    virtual ~MleMediaRefStream(void);
+
+    /**
+     * Bind the stream to a payload.
+     *
+     * @param fp The file containing the payload.
+     * @param flags The MediaRef flags; 0 for an external reference.
+     * @param type The MediaRef type.
+     * @param offset The file offset of the first payload byte.
+     * @param size The payload size, in bytes.
+     */
+    void init(FILE *fp,MlUInt flags,MlDppTag type,MlUInt offset,MlUInt size);
+
+    /**
+     * Read a range of the payload.
+     *
+     * @param offset The offset within the payload.
+     * @param buffer The memory to read into.
+     * @param length The number of bytes requested.
+     *
+     * @return The number of bytes read is returned; it is short only at
+     * the end of the payload. -1 is returned on error.
+     */
+    MlInt read(MlUInt offset,void *buffer,MlUInt length);
+
+    /**
+     * Walk the payload in fixed-size slices.
+     *
+     * The callback receives an MleMediaRefSlice as its call data, in
+     * payload order. The last slice may be short. Iteration stops early
+     * if the callback returns FALSE.
+     *
+     * @param sliceSize The slice size, in bytes.
+     * @param buffer Memory of at least sliceSize bytes to read into, or
+     * NULL to have one slice buffer allocated for the duration of the walk.
+     * @param func The callback.
+     * @param clientData Passed through to the callback.
+     *
+     * @return TRUE is returned if every slice was read and accepted.
+     */
+    int readSlices(MlUInt sliceSize,void *buffer,
+        MleDppCallback func,void *clientData);
+
+    // Get the MediaRef flags; 0 for an external reference.
+    MlUInt getFlags(void)
+    { return m_flags; }
+
+    // Get the MediaRef type.
+    MlDppTag getType(void)
+    { return m_type; }
+
+    // Get the file offset of the payload.
+    MlUInt getOffset(void)
+    { return m_offset; }
+
+    // Get the payload size, in bytes.
+    MlUInt getSize(void)
+    { return m_size; }
+
+	/**
+	 * Override operator new.
+	 *
+	 * @param tSize The size, in bytes, to allocate.
+	 */
+	void* operator new(size_t tSize);
+
+    /**
+     * Override operator new array.
+     *
+     * @param tSize The size, in bytes, to allocate.
+     */
+    void* operator new[](size_t tSize);
+
+	/**
+	 * Override operator delete.
+	 *
+	 * @param p A pointer to the memory to delete.
+	 */
+    void  operator delete(void *p);
+
+    /**
+     * Override operator delete array.
+     *
+     * @param p A pointer to the memory to delete.
+     */
+    void  operator delete[](void* p);
+
+  private:
+
+    // The file containing the payload; not owned.
+    FILE *m_fp;
+    // MediaRef flags and type.
+    MlUInt m_flags;
+    MlDppTag m_type;
+    // Location of the payload.
+    MlUInt m_offset;
+    MlUInt m_size;
+};
+
+
+#endif /* __MLE_MREFSTREAM_H_ */
@@ -78,6 +78,8 @@ typedef struct
 {
     MlUInt m_version;     /**< Version number of file format. */
     MlInt  m_date;        /**< Date file was created. */
+    MlUInt m_alignment;   /**< Alignment of chunk payloads, in bytes (0 if not aligned). */
+    MlUInt m_contentHash; /**< Hash of the Playprint contents (0 if not sealed). */
 } MleDppHeader;
 
 
@@ -117,6 +119,7 @@ enum MleDppErr
 #define MLE_PPBE_TAG mlDppMakeTag('P','P','B','E')
 #define MLE_PPLE_TAG mlDppMakeTag('P','P','L','E')
 #define MLE_LIST_TAG mlDppMakeTag('L','I','S','T')
+#define MLE_PAD_TAG  mlDppMakeTag('p','a','d',' ')
 
 
 /* Declare function prototypes. */
@@ -131,6 +134,10 @@ EXTERN char *mlDppTagToString(MlDppTag);
 EXTERN MlULong mlDppSwapLong(MlULong);
 EXTERN MlUInt mlDppSwapInt(MlUInt);
 EXTERN MlUShort mlDppSwapShort(MlUShort);
+EXTERN void mlDppSwapLongArray(MlULong *,MlUInt);
+EXTERN void mlDppSwapIntArray(MlUInt *,MlUInt);
+EXTERN void mlDppSwapShortArray(MlUShort *,MlUInt);
+EXTERN MlBoolean mlDppCopyFile(FILE *,FILE *,MlUInt,MlUInt);
 EXTERN void mlDppSetSwapRead(MlBoolean);
 EXTERN void mlDppSetSwapWrite(MlBoolean);
 EXTERN MlBoolean mlDppGetSwapRead(void);
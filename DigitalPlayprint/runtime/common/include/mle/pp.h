@@ -61,9 +61,107 @@ typedef struct
 typedef struct _MlDppTOC
 {
     MleDppTocEntry m_entry;
+    MlDppTag       m_type;        /**< Tag of the chunk, or 0 if unknown. */
+    MlUInt         m_size;        /**< Size of the chunk payload. */
+    const char    *m_name;        /**< Name the label was made from, or NULL. */
     struct _MlDppTOC *m_next;
 } MleDppTOC;
 
+/**
+ * This structure is used for reading/writing the header of the 'tocx'
+ * chunk, the named index of the table-of-contents. The 'tocx' chunk
+ * follows the 'toc ' chunk and holds this header, then one entry per
+ * table-of-contents entry, then the hash buckets (entry index plus one,
+ * or zero if empty). The 'tocn' chunk holds the NUL-terminated names.
+ */
+typedef struct
+{
+    MlUInt m_numEntries;      /**< Number of table-of-contents entries. */
+    MlUInt m_numBuckets;      /**< Number of hash buckets, a power of two. */
+    MlUInt m_namesOffset;     /**< Offset of the 'tocn' chunk, or 0. */
+    MlUInt m_namesSize;       /**< Size of the name pool. */
+    MlUInt m_manifestOffset;  /**< Offset of the 'mfst' chunk, or 0. */
+    MlUInt m_manifestSize;    /**< Size of the 'mfst' chunk payload. */
+} MleDppTocIndexHeader;
+
+/**
+ * This structure is used for reading/writing one entry of the 'tocx'
+ * chunk.
+ */
+typedef struct
+{
+    MlDppQuark m_label;       /**< Quark of the entry name. */
+    MlDppTag   m_type;        /**< Tag of the chunk. */
+    MlUInt     m_size;        /**< Size of the chunk payload. */
+    MlUInt     m_name;        /**< Offset of the name in the name pool. */
+} MleDppTocIndexEntry;
+
+/** Name offset of a 'tocx' entry that has no name. */
+#define MLE_DPP_TOC_NONAME 0xFFFFFFFF
+
+/**
+ * This structure is used for reading/writing the header of the 'mfst'
+ * chunk, which lists what each scene needs. The header is followed by
+ * the scenes, then the TOC indexes of the chunks they need, then the
+ * byte ranges covering those chunks.
+ */
+typedef struct
+{
+    MlUInt m_numScenes;       /**< Number of scenes. */
+    MlUInt m_numEntries;      /**< Total number of TOC indexes. */
+    MlUInt m_numRanges;       /**< Total number of byte ranges. */
+} MleDppManifestHeader;
+
+/**
+ * This structure is used for reading/writing one scene of the 'mfst'
+ * chunk. The scene needs its own chunk and every group, set and media
+ * chunk it reaches. Its own TOC index is listed first.
+ */
+typedef struct
+{
+    MlUInt m_scene;           /**< TOC index of the 'scn ' chunk. */
+    MlUInt m_firstEntry;      /**< First of the scene's TOC indexes. */
+    MlUInt m_numEntries;      /**< Number of TOC indexes. */
+    MlUInt m_firstRange;      /**< First of the scene's byte ranges. */
+    MlUInt m_numRanges;       /**< Number of byte ranges. */
+} MleDppManifestScene;
+
+/**
+ * A byte range of the Playprint, covering one or more whole chunks.
+ */
+typedef struct
+{
+    MlUInt m_offset;          /**< Offset from the beginning of the file. */
+    MlUInt m_size;            /**< Size in bytes. */
+} MleDppManifestRange;
+
+/**
+ * This structure is the header of a chunk access trace, as recorded by
+ * MleDppInput::startTrace(). The header is followed by one record per
+ * chunk read, in the byte order of the machine that recorded them; the
+ * magic number tells a reader whether to swap.
+ */
+typedef struct
+{
+    MlUInt m_magic;           /**< MLE_DPP_TRACE_MAGIC. */
+    MlUInt m_version;         /**< MLE_DPP_TRACE_VERSION. */
+    MlUInt m_contentHash;     /**< Content hash of the traced Playprint. */
+    MlUInt m_numEntries;      /**< Number of TOC entries it has. */
+} MleDppTraceHeader;
+
+#define MLE_DPP_TRACE_MAGIC   mlDppMakeTag('d','t','r','c')
+#define MLE_DPP_TRACE_VERSION 1
+
+/**
+ * One chunk read in an access trace.
+ */
+typedef struct
+{
+    MlUInt m_time;            /**< Milliseconds since the trace began. */
+    MlUInt m_index;           /**< TOC index of the chunk. */
+    MlUInt m_size;            /**< Bytes read, or 0 if unknown. */
+} MleDppTraceRecord;
+
 
 /**
  * @brief This class is used to read and write Digital Playprint files.
@@ -75,9 +173,11 @@ class MleDpp
 
   public:
 
-    // Define the Playprint version for this reader/writer.
+    // Define the Playprint version for this reader/writer. Version 2
+    // Playprints may have a longer header and chunks that version 1
+    // readers do not know, such as 'pad ' filler.
     enum {
-	    PLAYPRINT_VERSION = 1
+	    PLAYPRINT_VERSION = 2
     };
     
     // Define the Playprint access modes.
@@ -107,8 +207,32 @@ class MleDpp
     MlUInt     m_numTOCUsed;
     MleDppTOC *m_TOC;
 
+    // tocEntry: the entries of the list above, by TOC index; it has
+    // room for every reserved entry.
+    MleDppTOC **m_tocEntry;
+
+    // contentHash: hash of the Playprint contents, from the header.
+    MlUInt m_contentHash;
+
+    // manifestOffset, manifestSize: location of the 'mfst' chunk, if any.
+    MlUInt m_manifestOffset;
+    MlUInt m_manifestSize;
+
   private:
 
+    // tocSlot: TOC index for the next entry, or -1 to append it.
+    MlInt m_tocSlot;
+
+    // Size the table of entries by TOC index for num entries.
+    MlBoolean allocTOCEntries(MlUInt num);
+
+    // hashContent: if TRUE, the header has room for a content hash.
+    MlBoolean m_hashContent;
+
+    // hdrOffset: offset of the 'hdr ' chunk payload, when writing a
+    // header with room for the content hash.
+    MlUInt m_hdrOffset;
+
     // formInfo: IFF bookkeeping structure.
     MleDppChunkInfo m_formInfo;
 
@@ -145,6 +269,23 @@ class MleDpp
     // write IFF 'hdr' chunk
     MlBoolean writeHeader(MleDppHeader *chunkData);
 
+    // Request a content hash. This must be set before the header is
+    // written; without it, and without payload alignment, the header
+    // keeps its original version 1 layout.
+    void setHashContent(MlBoolean hash)
+    { m_hashContent = hash; };
+
+    MlBoolean getHashContent(void)
+    { return m_hashContent; };
+
+    // Hash the finished Playprint and store the hash in its header.
+    // Call after end(); the hash is also returned by getContentHash().
+    MlBoolean writeContentHash(void);
+
+    // Get the content hash read or written with the header.
+    MlUInt getContentHash(void)
+    { return m_contentHash; };
+
     // Accessor utiliites.
 
     void setSwap(MlBoolean swap);
@@ -170,8 +311,36 @@ class MleDpp
 
     MlBoolean addTOCEntry(MlDppQuark, MlUInt);
 
+    // Add a named entry; its label is the quark of the name.
+    MlBoolean addTOCEntry(const char *name, MlDppTag type,
+                          MlUInt offset, MlUInt size);
+
+    // Give the next entry added a particular TOC index, so that chunks
+    // can be written in a different order than they are indexed. Once
+    // this is used the TOC holds all the entries reserved by beginTOC();
+    // any left unfilled have offset 0.
+    MlBoolean setTOCIndex(MlUInt index);
+
+    // Set aside the entry for a chunk before writing it, so that if the
+    // chunk cannot be written it leaves a hole (offset 0) instead of
+    // shifting the indexes of the chunks after it. This takes the index
+    // given to setTOCIndex(), if any. Returns the TOC index, or -1.
+    MlInt reserveTOCEntry(void);
+
+    // Fill in an entry set aside by reserveTOCEntry().
+    MlBoolean setTOCEntry(MlUInt index, const char *name, MlDppTag type,
+                          MlUInt offset, MlUInt size);
+
+    // Map a chunk name to its table-of-contents label. Never 0, which
+    // marks an unlabelled entry.
+    static MlDppQuark getQuark(const char *name);
+
     MlBoolean endTOC(void);
 
+    // Get the offset, payload size and type of a table-of-contents entry.
+    MlBoolean getTOCEntry(MlUInt index, MlUInt *offset,
+                          MlUInt *size, MlDppTag *type);
+
 	/**
 	 * Override operator new.
 	 *
@@ -204,6 +373,16 @@ class MleDpp
 
 	// Protect the default constructor.
     MleDpp(void) {};
+
+    // Write the IFF 'tocn' chunk holding the entry names.
+    MlBoolean writeTOCNames(MlUInt *namesOffset, MlUInt *namesSize);
+
+    // Fill in the IFF 'tocx' chunk reserved by beginTOC().
+    MlBoolean writeTOCIndex(MlUInt namesOffset, MlUInt namesSize);
+
+    // Number of hash buckets and size of the 'tocx' chunk for num entries.
+    static MlUInt getTOCBuckets(MlUInt num);
+    static MlUInt getTOCIndexSize(MlUInt num);
 };
 
 
@@ -0,0 +1,174 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Runtime Library API - Master */
+
+/**
+ *  @file pparena.h
+ *  @ingroup MleDPPMaster
+ *
+ *  This file defines a bump allocator for reading Digital
+ *  Playprint chunks.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_PPARENA_H_
+#define __MLE_PPARENA_H_
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+
+
+/**
+ * This class is used to hand out chunk buffers from one block of memory.
+ *
+ * Allocation simply advances a pointer and nothing is freed individually;
+ * the whole arena is reset at once, typically when a new level is loaded.
+ * The block is either owned by the arena or supplied by the caller.
+ *
+ * @see MleDppInput
+ */
+class MleDppArena
+{
+  public:
+
+    // Every allocation is aligned to this many bytes.
+    static const MlUInt ALIGNMENT = 16;
+
+    /**
+     * Construct an arena that owns its memory.
+     *
+     * @param capacity The size of the arena, in bytes.
+     */
+    MleDppArena(MlUInt capacity);
+
+    /**
+     * Construct an arena over caller-supplied memory.
+     *
+     * The memory must outlive the arena and is not freed by it.
+     *
+     * @param buffer The memory to allocate from.
+     * @param capacity The size of the memory, in bytes.
+     */
+    MleDppArena(void *buffer,MlUInt capacity);
+
+    // destructor.
+    virtual ~MleDppArena(void);
+
+    /**
+     * Allocate memory from the arena.
+     *
+     * @param size The number of bytes required.
+     *
+     * @return A pointer to the memory is returned, or NULL if the arena
+     * is exhausted.
+     */
+    void *alloc(MlUInt size);
+
+    /**
+     * Release every allocation at once.
+     */
+    void reset(void)
+    { m_used = 0; }
+
+    /**
+     * Get the size of the arena, in bytes.
+     */
+    MlUInt getCapacity(void)
+    { return m_capacity; }
+
+    /**
+     * Get the number of bytes allocated since the last reset.
+     */
+    MlUInt getUsed(void)
+    { return m_used; }
+
+    /**
+     * Get the largest number of bytes ever in use, for tuning the capacity.
+     */
+    MlUInt getHighWater(void)
+    { return m_highWater; }
+
+    /**
+     * Round a request up to the size it occupies in an arena.
+     *
+     * @param size The number of bytes required.
+     */
+    static MlUInt alignSize(MlUInt size)
+    { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+	/**
+	 * Override operator new.
+	 *
+	 * @param tSize The size, in bytes, to allocate.
+	 */
+	void* operator new(size_t tSize);
+
+    /**
+     * Override operator new array.
+     *
+     * @param tSize The size, in bytes, to allocate.
+     */
+    void* operator new[](size_t tSize);
+
+	/**
+	 * Override operator delete.
+	 *
+	 * @param p A pointer to the memory to delete.
+	 */
+    void  operator delete(void *p);
+
+    /**
+     * Override operator delete array.
+     *
+     * @param p A pointer to the memory to delete.
+     */
+    void  operator delete[](void* p);
+
+  private:
+
+    // Hide default constructor.
+    MleDppArena(void) {};
+
+    // The memory being handed out, and the start of its first aligned byte.
+    MlByte *m_block;
+    MlByte *m_base;
+    // TRUE if the arena allocated the block itself.
+    MlBoolean m_owned;
+    // The number of usable bytes from m_base.
+    MlUInt m_capacity;
+    // The number of bytes allocated.
+    MlUInt m_used;
+    // The high-water mark of m_used.
+    MlUInt m_highWater;
+};
+
+
+#endif /* __MLE_PPARENA_H_ */
@@ -0,0 +1,242 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Runtime Library API - Master */
+
+/**
+ *  @file ppcache.h
+ *  @ingroup MleDPPMaster
+ *
+ *  This file defines a bounded cache of Digital Playprint
+ *  chunk payloads.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this header file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+#ifndef __MLE_PPCACHE_H_
+#define __MLE_PPCACHE_H_
+
+// Include Magic Lantern header files.
+#include "mle/mlTypes.h"
+#include "mle/playprnt.h"
+
+
+/**
+ * This class is used to keep the most recently read chunk payloads
+ * of a Digital Playprint in memory.
+ *
+ * Entries are keyed by table-of-contents index and evicted in least
+ * recently used order once the byte budget is exceeded. Every payload
+ * handed out carries a reference count; a payload is never freed while
+ * a reference is outstanding, so a callback may retain a buffer beyond
+ * its own return. A budget of zero caches nothing, but the reference
+ * counting still applies.
+ *
+ * The cache is not thread-safe.
+ *
+ * @see MleDppInput
+ */
+class MleDppChunkCache
+{
+  public:
+
+    // constructor.
+    MleDppChunkCache(MlUInt budget = 0);
+
+    // destructor.
+    virtual ~MleDppChunkCache(void);
+
+    /**
+     * Find the payload for a table-of-contents index.
+     *
+     * On a hit the payload is returned with one reference held by the
+     * caller, which must be dropped with release().
+     *
+     * @param tocIndex The table-of-contents index of the chunk.
+     * @param tag The expected chunk tag.
+     * @param size Returns the payload size, in bytes; may be NULL.
+     *
+     * @return A pointer to the payload is returned, or NULL if the chunk
+     * is not cached.
+     */
+    void *lookup(MlUInt tocIndex,MlDppTag tag,MlUInt *size);
+
+    /**
+     * Allocate an uncached payload buffer.
+     *
+     * The buffer holds one reference for the caller. It is entered into
+     * the cache with insert(), or discarded with release().
+     *
+     * @param size The payload size, in bytes.
+     *
+     * @return A pointer to the buffer is returned, or NULL if it could not
+     * be allocated.
+     */
+    void *allocate(MlUInt size);
+
+    /**
+     * Enter a buffer obtained from allocate() into the cache.
+     *
+     * The caller keeps its reference. Unreferenced entries are evicted
+     * until the cache is within its budget.
+     *
+     * @param tocIndex The table-of-contents index of the chunk.
+     * @param tag The chunk tag.
+     * @param data The buffer returned by allocate().
+     */
+    void insert(MlUInt tocIndex,MlDppTag tag,void *data);
+
+    /**
+     * Add a reference to a payload handed out by the cache.
+     *
+     * @param data The payload.
+     */
+    void retain(void *data);
+
+    /**
+     * Drop a reference to a payload handed out by the cache.
+     *
+     * A payload that is no longer cached is freed with its last reference.
+     *
+     * @param data The payload.
+     */
+    void release(void *data);
+
+    /**
+     * Set the byte budget, evicting entries as required.
+     *
+     * @param budget The maximum number of payload bytes to keep cached.
+     */
+    void setBudget(MlUInt budget);
+
+    /**
+     * Get the byte budget.
+     */
+    MlUInt getBudget(void)
+    { return m_budget; }
+
+    /**
+     * Get the number of payload bytes currently cached.
+     */
+    MlUInt getUsed(void)
+    { return m_used; }
+
+    /**
+     * Get the number of lookups that were satisfied from the cache.
+     */
+    MlUInt getHits(void)
+    { return m_hits; }
+
+    /**
+     * Get the number of lookups that were not satisfied from the cache.
+     */
+    MlUInt getMisses(void)
+    { return m_misses; }
+
+    /**
+     * Get the number of entries evicted to stay within the budget.
+     */
+    MlUInt getEvictions(void)
+    { return m_evictions; }
+
+    /**
+     * Drop every unreferenced entry.
+     */
+    void flush(void);
+
+	/**
+	 * Override operator new.
+	 *
+	 * @param tSize The size, in bytes, to allocate.
+	 */
+	void* operator new(size_t tSize);
+
+    /**
+     * Override operator new array.
+     *
+     * @param tSize The size, in bytes, to allocate.
+     */
+    void* operator new[](size_t tSize);
+
+	/**
+	 * Override operator delete.
+	 *
+	 * @param p A pointer to the memory to delete.
+	 */
+    void  operator delete(void *p);
+
+    /**
+     * Override operator delete array.
+     *
+     * @param p A pointer to the memory to delete.
+     */
+    void  operator delete[](void* p);
+
+  private:
+
+    // A cache entry; the payload follows it in the same allocation.
+    typedef struct _MleDppCacheEntry
+    {
+        struct _MleDppCacheEntry *m_prev;
+        struct _MleDppCacheEntry *m_next;
+        MlDppTag m_tag;
+        MlUInt m_tocIndex;
+        MlUInt m_size;
+        MlUInt m_refCount;
+        MlBoolean m_cached;
+    } MleDppCacheEntry;
+
+    // Map a payload pointer back to its entry.
+    static MleDppCacheEntry *getEntry(void *data);
+
+    // Remove an entry from the index and the LRU list.
+    void unlink(MleDppCacheEntry *entry);
+
+    // Evict unreferenced entries until the cache is within budget.
+    void trim(void);
+
+    // The byte budget.
+    MlUInt m_budget;
+    // The number of payload bytes cached.
+    MlUInt m_used;
+    // Entries indexed by table-of-contents index.
+    MleDppCacheEntry **m_index;
+    // The number of allocated index slots.
+    MlUInt m_indexAllocated;
+    // The most and least recently used entries.
+    MleDppCacheEntry *m_head;
+    MleDppCacheEntry *m_tail;
+    // Statistics.
+    MlUInt m_hits;
+    MlUInt m_misses;
+    MlUInt m_evictions;
+};
+
+
+#endif /* __MLE_PPCACHE_H_ */
@@ -49,6 +49,9 @@
 #include "mle/playprnt.h"
 #include "mle/pp.h"
 #include "mle/chunk.h"
+#include "mle/ppcache.h"
+#include "mle/pparena.h"
+#include "mle/mrefstrm.h"
 
 
 /**
@@ -65,6 +68,45 @@ class MleDppInput: public MleDpp
     // mrefListInfo: IFF book keeping structure.
 
     MleDppChunkInfo m_mrefListInfo;
+
+    // Index of the 'mref' chunks in the current MRFL LIST.
+    MleMediaRefIndexEntry *m_mrefIndex;
+    MlUInt m_mrefIndexSize;
+    MlBoolean m_mrefIndexValid;
+    // Offset of the first 'mref' chunk in the current MRFL LIST.
+    MlUInt m_mrefFirst;
+
+    // Cache of chunk payloads read by TOC index.
+    MleDppChunkCache *m_cache;
+
+    // Table-of-contents entries as read, for indexed offset lookups.
+    MleDppTocEntry *m_tocTable;
+
+    // Named index of the table-of-contents ('tocx' and 'tocn' chunks).
+    MlUInt *m_tocIndex;
+    MleDppTocIndexEntry *m_tocEntries;
+    MlUInt *m_tocBuckets;
+    MlUInt m_tocNumBuckets;
+    char *m_tocNames;
+    MlUInt m_tocNamesSize;
+
+    // Scene manifests ('mfst' chunk), loaded on first use.
+    MlUInt *m_manifest;
+    MleDppManifestScene *m_manifestScenes;
+    MlUInt *m_manifestEntries;
+    MleDppManifestRange *m_manifestRanges;
+    MlUInt m_manifestNumScenes;
+
+    // Access trace, if one is being recorded.
+    FILE *m_traceFp;
+    MleDppTraceRecord *m_traceRecords;
+    MlUInt m_traceUsed;
+    MlULong m_traceStart;
+
+    // Chunk locations generated by gendpp, used in place of the TOC.
+    const MlUInt *m_tocOffsets;
+    const MlUInt *m_tocSizes;
+    const MlDppTag *m_tocTypes;
     
     // declare member functions.
 
@@ -91,6 +133,73 @@ class MleDppInput: public MleDpp
     // read IFF 'mref' chunk.
     int readMedia(MleDppCallback func,void *clientData);
 
+    // get the number of 'mref' chunks in the current MRFL LIST.
+    MlUInt getMediaCount(void)
+    { return m_mrefIndexSize; }
+
+    /**
+     * Read an IFF 'mref' chunk of the current MRFL LIST by ordinal.
+     *
+     * The 'midx' chunk written with the list locates the chunk directly;
+     * for older playprints the list is scanned once, on first use. The
+     * position of sequential readMedia() calls is not disturbed.
+     *
+     * @param ordinal The position of the chunk in the list.
+     * @param func The callback, which receives an MleMediaRefChunk.
+     * @param clientData Passed through to the callback.
+     */
+    int readMediaByIndex(MlUInt ordinal,MleDppCallback func,void *clientData);
+
+    /**
+     * Read the first IFF 'mref' chunk of the current MRFL LIST with the
+     * given label tag.
+     *
+     * @param label The target label tag, as stored in m_type.
+     * @param func The callback, which receives an MleMediaRefChunk.
+     * @param clientData Passed through to the callback.
+     */
+    int readMediaByLabel(MlDppTag label,MleDppCallback func,void *clientData);
+
+    /**
+     * Open the next IFF 'mref' chunk for ranged reads.
+     *
+     * Only the MediaRef header is read; the payload is left in the
+     * file and the reader moves on to the following chunk.
+     *
+     * @param stream Returns the location of the payload.
+     *
+     * @return TRUE is returned if an 'mref' chunk was found.
+     */
+    MlBoolean openMedia(MleMediaRefStream *stream);
+
+    /**
+     * Open one payload of a packed media 'mpak' chunk for ranged reads.
+     *
+     * @param tocIndex The table-of-contents index of the 'mpak' chunk.
+     * @param ordinal The media reference within the pack.
+     * @param stream Returns the location of the payload.
+     *
+     * @return TRUE is returned if the payload was found. The file
+     * position is preserved.
+     */
+    MlBoolean openPackedMedia(MlUInt tocIndex,MlUInt ordinal,MleMediaRefStream *stream);
+
+    /**
+     * Locate one payload of a packed media 'mpak' chunk in memory, for
+     * a Playprint that has been mapped or loaded whole. The chunk must
+     * be in native byte order; nothing is parsed beyond one table entry.
+     *
+     * @param pack The 'mpak' chunk data, just past its chunk header.
+     * @param ordinal The media reference within the pack.
+     * @param size Returns the payload size; may be NULL.
+     * @param label Returns the payload label tag; may be NULL.
+     *
+     * @return A pointer to the payload is returned, or NULL if the ordinal
+     * is out of range.
+     */
+    static const void *getPackedMedia(const void *pack,MlUInt ordinal,
+        MlUInt *size,MlDppTag *label = NULL);
+
     // read IFF 'set' chunk.
     int readSet(MleDppCallback func,void *clientData);
 
@@ -103,12 +212,182 @@ class MleDppInput: public MleDpp
     // get chunk offset from table-of-content.
     MlInt getTOCOffset(MlUInt tocIndex);
 
+    /**
+     * Use chunk locations generated by gendpp instead of reading the
+     * 'toc ' chunk. The tables are only used if they were generated for
+     * this Playprint, that is, if hash matches the content hash read by
+     * readHeader(); otherwise the caller should fall back to readTOC().
+     * The tables are not copied and must outlive this object.
+     *
+     * The tables hold no names and the named index is not read, so
+     * getTOCLabel(), getTOCName(), findTOCEntry() and getSceneManifest()
+     * fail while they are in use. Chunks are found by the generated
+     * symbols instead; use readTOC() if names or manifests are needed.
+     *
+     * @param hash The content hash the tables were generated for.
+     * @param count The number of chunks.
+     * @param offsets The chunk offsets, indexed by TOC index.
+     * @param sizes The chunk payload sizes, or NULL.
+     * @param types The chunk types, or NULL.
+     *
+     * @return TRUE if the tables are in use, FALSE if they do not
+     * belong to this Playprint.
+     */
+    MlBoolean setTOCTables(MlUInt hash,MlUInt count,const MlUInt *offsets,
+        const MlUInt *sizes,const MlDppTag *types);
+
     // go to location within Playprint.
     void goTo(MlInt tocOffset);
 
-#if 0
+    // read IFF 'grp' chunk by TOC index, through the chunk cache.
+    int readGroup(MlUInt tocIndex,MleDppCallback func,void *clientData);
+
+    // read IFF 'set' chunk by TOC index, through the chunk cache.
+    int readSet(MlUInt tocIndex,MleDppCallback func,void *clientData);
+
+    // read IFF 'scn' chunk by TOC index, through the chunk cache.
+    int readScene(MlUInt tocIndex,MleDppCallback func,void *clientData);
+
+    /**
+     * Set the byte budget of the chunk cache.
+     *
+     * Chunks read by TOC index are kept in memory, least recently used
+     * first out, up to this many payload bytes. The default of zero
+     * disables caching.
+     *
+     * @param budget The budget, in bytes.
+     */
+    void setCacheBudget(MlUInt budget)
+    { m_cache->setBudget(budget); }
+
+    /**
+     * Keep a payload passed to a callback by a TOC index read alive after
+     * the callback returns. Each call must be matched by releaseChunk().
+     *
+     * @param callData The payload passed to the callback.
+     */
+    void retainChunk(void *callData)
+    { m_cache->retain(callData); }
+
+    /**
+     * Drop a reference taken with retainChunk().
+     *
+     * @param callData The payload passed to the callback.
+     */
+    void releaseChunk(void *callData)
+    { m_cache->release(callData); }
+
+    // read IFF 'hdr' chunk into a caller-supplied header.
+    int readHeader(MleDppHeader *hdrData,MleDppCallback func,void *clientData);
+
+    // read IFF 'grp' chunk into a caller-supplied buffer.
+    int readGroup(void *buffer,MlUInt size,MleDppCallback func,void *clientData);
+
+    // read IFF 'set' chunk into a caller-supplied buffer.
+    int readSet(void *buffer,MlUInt size,MleDppCallback func,void *clientData);
+
+    // read IFF 'scn' chunk into a caller-supplied buffer.
+    int readScene(void *buffer,MlUInt size,MleDppCallback func,void *clientData);
+
+    // read IFF 'grp' chunk into memory from an arena.
+    int readGroup(MleDppArena *arena,MleDppCallback func,void *clientData);
+
+    // read IFF 'set' chunk into memory from an arena.
+    int readSet(MleDppArena *arena,MleDppCallback func,void *clientData);
+
+    // read IFF 'scn' chunk into memory from an arena.
+    int readScene(MleDppArena *arena,MleDppCallback func,void *clientData);
+
+    // read IFF 'mref' chunk, and its data, into memory from an arena.
+    int readMedia(MleDppArena *arena,MleDppCallback func,void *clientData);
+
+    /**
+     * Get the payload size of a chunk without reading it.
+     *
+     * The current file position is preserved.
+     *
+     * @param tocIndex The table-of-contents index of the chunk.
+     *
+     * @return The size in bytes is returned, or -1 if the chunk header
+     * could not be read.
+     */
+    MlInt getChunkSize(MlUInt tocIndex);
+
+    /**
+     * Get the arena capacity needed to read a set of chunks.
+     *
+     * For a media reference list, room is included for every
+     * MleMediaRefChunk and its data.
+     *
+     * @param tocIndexes The table-of-contents indexes to read, or NULL
+     * for every entry in the table of contents.
+     * @param count The number of indexes.
+     *
+     * @return The size in bytes is returned.
+     */
+    MlUInt getArenaSize(const MlUInt *tocIndexes,MlUInt count);
+
+    // Chunk cache statistics.
+    MlUInt getCacheHits(void)
+    { return m_cache->getHits(); }
+    MlUInt getCacheMisses(void)
+    { return m_cache->getMisses(); }
+    MlUInt getCacheEvictions(void)
+    { return m_cache->getEvictions(); }
+
+    // get chunk label from table-of-content; 0 if the entry has no name,
+    // or if the TOC was replaced by setTOCTables().
     MlDppQuark getTOCLabel(MlUInt tocIndex);
-#endif /* 0 */
+
+    // get chunk name, type and payload size from table-of-content.
+    // Playprints without a named index return NULL, 0 and 0.
+    const char *getTOCName(MlUInt tocIndex);
+    MlDppTag getTOCType(MlUInt tocIndex);
+    MlUInt getTOCSize(MlUInt tocIndex);
+
+    /**
+     * Find a chunk by the name it was given in the chunk table, using the
+     * hashed index next to the table-of-contents.
+     *
+     * @param name The chunk name.
+     *
+     * @return The TOC index of the chunk, or -1 if there is no such name
+     * or the Playprint has no named index.
+     */
+    MlInt findTOCEntry(const char *name);
+
+    /**
+     * Start recording which chunks are read, and when, to a trace file.
+     * Every chunk located through the TOC is recorded with its TOC index,
+     * the milliseconds since the trace began and the bytes read. gendpp
+     * can lay out the next Playprint from such traces.
+     *
+     * @param filename The trace file to write.
+     *
+     * @return TRUE if the trace file was created, FALSE otherwise.
+     */
+    MlBoolean startTrace(const char *filename);
+
+    // Finish the trace file, if one is being recorded.
+    MlBoolean stopTrace(void);
+
+    /**
+     * Get the manifest of a scene: the TOC indexes of every chunk the
+     * scene needs, itself included, and the byte ranges of the Playprint
+     * that hold them, sorted by offset. Reading the ranges up front brings
+     * in everything needed to load the scene.
+     *
+     * @param tocIndex The TOC index of the 'scn ' chunk.
+     * @param ranges Returns the ranges; they belong to this object.
+     * @param numRanges Returns the number of ranges.
+     * @param entries Returns the TOC indexes, or pass NULL.
+     * @param numEntries Returns the number of TOC indexes, or pass NULL.
+     *
+     * @return TRUE if the scene has a manifest, FALSE if it does not or
+     * the Playprint has none.
+     */
+    MlBoolean getSceneManifest(MlUInt tocIndex,const MleDppManifestRange **ranges,
+        MlUInt *numRanges,const MlUInt **entries = NULL,MlUInt *numEntries = NULL);
     
 	/**
 	 * Override operator new.
@@ -147,7 +426,35 @@ class MleDppInput: public MleDpp
     MlBoolean beginMrefList(void);
     MlBoolean endMrefList(void);
     MlBoolean readMrefInfo(MleMediaRefInfoChunk *chunkData);
-    MlBoolean readMref(MleMediaRefChunk *chunkData);
+    MlBoolean readMrefIndex(void);
+    MlBoolean buildMrefIndex(void);
+    void freeMrefIndex(void);
+
+    // Load the 'tocx' chunk if it follows the 'toc ' chunk.
+    MlBoolean readTOCIndex(void);
+    void freeTOCIndex(void);
+
+    // Load the 'mfst' chunk named by the 'tocx' chunk.
+    MlBoolean readManifest(void);
+
+    // Look up a chunk offset without recording an access.
+    MlInt lookupTOCOffset(MlUInt tocIndex);
+
+    // Record an access in the trace, if there is one.
+    void traceAccess(MlUInt tocIndex,MlUInt size);
+    MlBoolean flushTrace(void);
+    MlBoolean readMref(MleMediaRefChunk *chunkData,MleDppArena *arena = NULL);
+
+    // Descend into the next chunk, skipping 'pad ' filler chunks.
+    MlBoolean descendChunk(MleDppChunkInfo *info);
+
+    // Read the next chunk into a buffer, or into memory from an arena.
+    int readChunkInto(MlDppTag tag,void *buffer,MlUInt size,
+        MleDppArena *arena,MleDppCallback func,void *clientData);
+
+    // Read a chunk by TOC index through the chunk cache.
+    int readCachedChunk(MlUInt tocIndex,MlDppTag tag,
+        MleDppCallback func,void *clientData);
 };
 
 
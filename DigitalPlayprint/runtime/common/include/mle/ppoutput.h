@@ -51,6 +51,29 @@
 #include "mle/chunk.h"
 #include "mle/chktable.h"
 
+class MleMrefChunkFile;
+
+
+// Declare the book keeping structure used to de-duplicate chunk payloads.
+typedef struct
+{
+    MlDppTag m_tag;       /**< Tag of the written chunk. */
+    MlUInt   m_hash;      /**< FNV-1a hash of the chunk payload. */
+    MlUInt   m_size;      /**< Size of the chunk payload, in bytes. */
+    MlUInt   m_offset;    /**< Offset to the chunk from beginning of file. */
+} MleDppChunkDigest;
+
+/**
+ * This structure records the chunks a group or scene chunk needs, for
+ * building the scene manifests.
+ */
+typedef struct
+{
+    MlUInt  *m_needs;     /**< TOC indexes of the chunks needed. */
+    MlUInt   m_numNeeds;  /**< Number of TOC indexes. */
+    MlBoolean m_isScene;  /**< TRUE if the chunk is a 'scn ' chunk. */
+} MleDppChunkNeeds;
+
 
 /**
  * @brief This class is used to write Digital Playprint files.
@@ -66,6 +89,46 @@ class MleDppOutput: public MleDpp
     // mrefListInfo: IFF book keeping structure.
     MleDppChunkInfo m_mrefListInfo;
 
+    // dedup: if TRUE, byte-identical chunk payloads are written only once.
+    MlBoolean m_dedup;
+
+    // digests of the unique chunks written so far.
+    MleDppChunkDigest *m_digests;
+    MlUInt             m_numDigests;
+    MlUInt             m_numDigestsAlloc;
+
+    // number of chunks and payload bytes that were not written because
+    // an identical chunk was already in the Playprint.
+    MlUInt m_dedupCount;
+    MlUInt m_dedupBytes;
+
+    // alignment: if non-zero, the payload of every chunk is aligned to
+    // this many bytes by inserting 'pad ' filler chunks.
+    MlUInt m_alignment;
+
+    // packMedia: if TRUE, each MediaRef chunk file is written as one
+    // 'mpak' chunk instead of an 'MRFL' LIST.
+    MlBoolean m_packMedia;
+
+    // indexMedia: if TRUE, an 'MRFL' LIST is given a 'midx' index of
+    // its 'mref' chunks.
+    MlBoolean m_indexMedia;
+
+    // tocName: chunk table name given to the TOC entry of the chunk being
+    // written, or NULL.
+    const char *m_tocName;
+
+    // chunkEntry: TOC index reserved for the chunk being written, or -1
+    // to add its entry once it has been written.
+    MlInt m_chunkEntry;
+
+    // needs: what each chunk needs, indexed by TOC index.
+    MleDppChunkNeeds *m_needs;
+
+    // setChunks: TOC index of each runtime set, indexed by set number.
+    MlInt *m_setChunks;
+    MlInt  m_numSetChunks;
+
 
     // Declare member functions.
 
@@ -85,12 +148,78 @@ class MleDppOutput: public MleDpp
 
     // write IFF 'MRFL' LIST chunk (includes 'mref' chunks).
     MlBoolean writeMedia(char *filename);
+    MlBoolean writeMedia(MleDppChunkTable *table, MlInt mediaIndex);
 
     // write IFF 'set' chunk.
     MlBoolean writeSet(char *filename);
+    MlBoolean writeSet(MleDppChunkTable *table, MlInt setIndex);
     
     // write IFF 'scn' chunk.
     MlBoolean writeScene(MleDppChunkTable *table, MlInt sceneIndex);
+
+    // Support for chunk de-duplication. When enabled, a 'grp ', 'set ' or
+    // 'scn ' chunk whose payload matches one already written is not written
+    // again; its TOC entry aliases the offset of the earlier chunk instead.
+
+    void setDedup(MlBoolean dedup)
+    { m_dedup = dedup; };
+
+    MlBoolean getDedup(void)
+    { return m_dedup; };
+
+    // number of chunks that were aliased to an earlier chunk.
+    MlUInt getDedupCount(void)
+    { return m_dedupCount; };
+
+    // number of bytes saved by aliasing, including chunk headers and padding.
+    MlUInt getDedupBytes(void)
+    { return m_dedupBytes; };
+
+    // Support for aligned chunk payloads. The alignment must be 0 (none),
+    // 16, 64 or 4096 bytes and must be set before the header is written,
+    // since it is recorded there. For 'mref' chunks it is the media data,
+    // not the mref header, that is aligned.
+
+    MlBoolean setAlignment(MlUInt alignment);
+
+    MlUInt getAlignment(void)
+    { return m_alignment; };
+
+    // Support for packed media. When enabled, writeMedia() emits a single
+    // 'mpak' chunk per MediaRef chunk file, in place of its 'MRFL' LIST,
+    // holding an offset table followed by every media payload of the file,
+    // each aligned to the chunk alignment (16 bytes if none is set), so a
+    // runtime with the Playprint mapped can reach any payload directly.
+
+    void setPackMedia(MlBoolean pack)
+    { m_packMedia = pack; };
+
+    MlBoolean getPackMedia(void)
+    { return m_packMedia; };
+
+    // Support for indexed media. When enabled, each 'MRFL' LIST has a
+    // 'midx' chunk, after its 'info' chunk, locating every 'mref' chunk
+    // so that a reader can go straight to any one of them. Older readers
+    // expect the 'mref' chunks right after the 'info' chunk, so it is
+    // off by default.
+
+    void setIndexMedia(MlBoolean index)
+    { m_indexMedia = index; };
+
+    MlBoolean getIndexMedia(void)
+    { return m_indexMedia; };
+
+    // Support for scene manifests. Groups name their media and sets, and
+    // scenes name their groups; writeManifest() follows these from every
+    // scene written so far and records, in an 'mfst' chunk, which chunks
+    // the scene needs and the merged byte ranges covering them. Call it
+    // after the last chunk and before endTOC().
+
+    // Map runtime set numbers, as used by group chunks, to TOC indexes.
+    // Without the map, manifests leave out sets.
+    void setSetChunks(const MlInt *chunks, MlInt num);
+
+    MlBoolean writeManifest(void);
     
 	/**
 	 * Override operator new.
@@ -129,7 +258,28 @@ class MleDppOutput: public MleDpp
     MlBoolean beginMrefList(void);
     MlBoolean endMrefList(void);
     MlBoolean writeMrefInfo(MleMediaRefInfoChunk *chunkData);
+    MlBoolean writeMrefIndex(MleMediaRefIndexEntry *entries,MlUInt numEntries,
+                             MlUInt *offset);
     MlBoolean writeMref(MleMediaRefChunk *chunkData);
+    MlBoolean writeMref(MleMediaRefChunk *chunkData,FILE *src,MlUInt offset,
+                        MlUInt *chunkOffset = NULL);
+    MlBoolean beginMref(MleMediaRefChunk *chunkData,MleDppChunkInfo *mediaInfo);
+    MlBoolean writeMediaPack(MleMrefChunkFile *in,MleMediaRefInfoChunk *info);
+
+    // Chunk utilities.
+    MlUInt getPaddingSize(MlUInt skip, MlUInt alignment = 0);
+    MlBoolean writePadding(MlUInt skip, MlUInt alignment = 0);
+    MlBoolean writeChunk(MlDppTag tag, const MlByte *data, MlInt size);
+    MlBoolean setChunkEntry(MlDppTag tag, MlUInt offset, MlUInt size);
+    MlBoolean writeChunk(MlDppTag tag, FILE *src, MlUInt offset, MlInt size);
+    MlBoolean findChunk(MlDppTag tag, MlUInt hash, const MlByte *data,
+                        MlInt size, MlUInt *offset);
+    MlBoolean addChunkDigest(MlDppTag tag, MlUInt hash, MlInt size,
+                             MlUInt offset);
+
+    // Manifest utilities.
+    MlBoolean addNeeds(MlUInt tocIndex, const MlInt *needs, MlInt num,
+                       MlBoolean isScene);
 };
 
 
@@ -0,0 +1,462 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file agarray.cxx
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+
+// Declare system header files.
+#include <stddef.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MLE_DPP_ARRAY_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif (defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)) && ! defined(__ARM_BIG_ENDIAN)
+#define MLE_DPP_ARRAY_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Include Magic Lantern header files.
+#include "mle/mlMalloc.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agopcode.h"
+#include "mle/agarray.h"
+
+
+// The 16-bit kernels work on this many values at a time, so that the
+// components of 1, 2, 3, 4 or 6 component elements line up with lanes.
+#define NORM16_PERIOD 12
+
+/*
+ * The vector kernels convert as many whole vectors as they can and return
+ * the number of values converted; the scalar loops do the rest. They load
+ * the chunk directly, so they are only used when it is in the byte order of
+ * the processor.
+ */
+typedef MlInt (*HalfKernel)(const MlByte *src,float *dst,MlInt count);
+typedef MlInt (*Norm16Kernel)(const MlByte *src,float *dst,MlInt count,
+    const float *scale,const float *bias);
+
+static MlInt halfNone(const MlByte *src,float *dst,MlInt count)
+{
+    (void)src;
+    (void)dst;
+    (void)count;
+
+    return(0);
+}
+
+static MlInt norm16None(const MlByte *src,float *dst,MlInt count,
+    const float *scale,const float *bias)
+{
+    (void)src;
+    (void)dst;
+    (void)count;
+    (void)scale;
+    (void)bias;
+
+    return(0);
+}
+
+#if defined(MLE_DPP_ARRAY_X86)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MLE_DPP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MLE_DPP_TARGET(isa)
+#endif
+
+MLE_DPP_TARGET("avx,f16c")
+static MlInt halfF16C(const MlByte *src,float *dst,MlInt count)
+{
+    // Declare local variables.
+    MlInt done = 0;
+
+    while (count - done >= 8)
+    {
+        __m128i h = _mm_loadu_si128((const __m128i *)(src + 2 * done));
+        _mm256_storeu_ps(dst + done,_mm256_cvtph_ps(h));
+        done += 8;
+    }
+
+    return(done);
+}
+
+MLE_DPP_TARGET("sse2")
+static MlInt norm16SSE2(const MlByte *src,float *dst,MlInt count,
+    const float *scale,const float *bias)
+{
+    // Declare local variables.
+    __m128i zero = _mm_setzero_si128();
+    MlInt done = 0;
+    int i;
+
+    while (count - done >= NORM16_PERIOD)
+    {
+        for (i = 0; i < NORM16_PERIOD; i += 4)
+        {
+            __m128i q = _mm_loadl_epi64((const __m128i *)(src + 2 * (done + i)));
+            __m128 v = _mm_cvtepi32_ps(_mm_unpacklo_epi16(q,zero));
+            v = _mm_add_ps(_mm_mul_ps(v,_mm_loadu_ps(&scale[i])),_mm_loadu_ps(&bias[i]));
+            _mm_storeu_ps(dst + done + i,v);
+        }
+        done += NORM16_PERIOD;
+    }
+
+    return(done);
+}
+
+static void selectKernels(HalfKernel *half,Norm16Kernel *norm16)
+{
+#if defined(_MSC_VER)
+    // Declare local variables.
+    int info[4];
+    MlBoolean f16c = FALSE;
+
+    __cpuid(info,1);
+    *norm16 = ((info[3] & (1 << 26)) != 0) ? norm16SSE2 : norm16None;
+    if (((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0) &&
+        ((_xgetbv(0) & 0x6) == 0x6))
+    {
+        // AVX state is enabled by the OS; check for F16C.
+        f16c = (info[2] & (1 << 29)) != 0;
+    }
+    *half = f16c ? halfF16C : halfNone;
+#else
+    __builtin_cpu_init();
+    *half = (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c")) ?
+        halfF16C : halfNone;
+    *norm16 = __builtin_cpu_supports("sse2") ? norm16SSE2 : norm16None;
+#endif
+}
+
+#elif defined(MLE_DPP_ARRAY_NEON)
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+static MlInt halfNEON(const MlByte *src,float *dst,MlInt count)
+{
+    // Declare local variables.
+    MlInt done = 0;
+
+    while (count - done >= 4)
+    {
+        float16x4_t h = vreinterpret_f16_u16(vld1_u16((const uint16_t *)(src + 2 * done)));
+        vst1q_f32(dst + done,vcvt_f32_f16(h));
+        done += 4;
+    }
+
+    return(done);
+}
+#endif
+
+static MlInt norm16NEON(const MlByte *src,float *dst,MlInt count,
+    const float *scale,const float *bias)
+{
+    // Declare local variables.
+    MlInt done = 0;
+    int i;
+
+    while (count - done >= NORM16_PERIOD)
+    {
+        for (i = 0; i < NORM16_PERIOD; i += 4)
+        {
+            uint16x4_t q = vld1_u16((const uint16_t *)(src + 2 * (done + i)));
+            float32x4_t v = vcvtq_f32_u32(vmovl_u16(q));
+            v = vmlaq_f32(vld1q_f32(&bias[i]),v,vld1q_f32(&scale[i]));
+            vst1q_f32(dst + done + i,v);
+        }
+        done += NORM16_PERIOD;
+    }
+
+    return(done);
+}
+
+static void selectKernels(HalfKernel *half,Norm16Kernel *norm16)
+{
+    // NEON is always present where this is compiled.
+#if defined(__aarch64__) || defined(_M_ARM64)
+    *half = halfNEON;
+#else
+    *half = halfNone;
+#endif
+    *norm16 = norm16NEON;
+}
+
+#else
+
+static void selectKernels(HalfKernel *half,Norm16Kernel *norm16)
+{
+    *half = halfNone;
+    *norm16 = norm16None;
+}
+
+#endif /* MLE_DPP_ARRAY_X86 */
+
+
+/*
+ * The kernels are chosen once, on first use. Concurrent first calls may
+ * each select them, but they always store the same values.
+ */
+static HalfKernel g_halfKernel = NULL;
+static Norm16Kernel g_norm16Kernel = NULL;
+
+static void initKernels(void)
+{
+    // Declare local variables.
+    HalfKernel half;
+    Norm16Kernel norm16;
+
+    if (g_halfKernel != NULL)
+        return;
+    selectKernels(&half,&norm16);
+    g_norm16Kernel = norm16;
+    g_halfKernel = half;
+}
+
+
+// Convert an IEEE half float.
+static float halfToFloat(MlUShort h)
+{
+    // Declare local variables.
+    MlUInt sign = (MlUInt)(h & 0x8000) << 16;
+    MlUInt exponent = (h >> 10) & 0x1f;
+    MlUInt mantissa = h & 0x3ff;
+    MlUInt bits;
+    float f;
+
+    if (exponent == 0)
+    {
+        // Zero or subnormal: mantissa * 2^-24.
+        f = (float)mantissa * (1.0f / 16777216.0f);
+        return(sign ? -f : f);
+    }
+    if (exponent == 31)
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    else
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+    memcpy(&f,&bits,sizeof(f));
+    return(f);
+}
+
+
+MleDppEncodedArray::MleDppEncodedArray(MlBoolean isLittle)
+{
+    m_littleEndian = isLittle;
+#if defined(MLE_DPP_ARRAY_X86) || defined(MLE_DPP_ARRAY_NEON)
+    m_nativeOrder = isLittle;
+#else
+    m_nativeOrder = FALSE;
+#endif
+    initKernels();
+}
+
+
+MleDppEncodedArray::~MleDppEncodedArray()
+{
+    // Do nothing.
+}
+
+
+MlUShort MleDppEncodedArray::getShort(const MlByte *data)
+{
+    if (m_littleEndian)
+        return((MlUShort)(data[0] | (data[1] << 8)));
+    else
+        return((MlUShort)((data[0] << 8) | data[1]));
+}
+
+
+float MleDppEncodedArray::getFloat(const MlByte *data)
+{
+    // Declare local variables.
+    MlUInt bits;
+    float f;
+
+    if (m_littleEndian)
+        bits = data[0] | (data[1] << 8) | (data[2] << 16) | ((MlUInt)data[3] << 24);
+    else
+        bits = ((MlUInt)data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+
+    memcpy(&f,&bits,sizeof(f));
+    return(f);
+}
+
+
+void MleDppEncodedArray::decodeHalf(const MlByte *src,float *dst,MlInt count)
+{
+    // Declare local variables.
+    MlInt i = 0;
+
+    if (m_nativeOrder)
+        i = g_halfKernel(src,dst,count);
+    for (; i < count; i++)
+        dst[i] = halfToFloat(getShort(&src[2 * i]));
+}
+
+
+
+
+void MleDppEncodedArray::decodeNorm16(const MlByte *src,float *dst,MlInt count,
+    MlInt components,const float *ranges)
+{
+    // Declare local variables.
+    float scale[NORM16_PERIOD],bias[NORM16_PERIOD];
+    MlInt i = 0;
+    MlInt c;
+
+    if ((components <= 0) || (count % components != 0))
+        return;
+
+    if (m_nativeOrder && (NORM16_PERIOD % components == 0))
+    {
+        // Lay the per-component scale and bias out across the lanes.
+        for (c = 0; c < NORM16_PERIOD; c++)
+        {
+            scale[c] = (ranges[2 * (c % components) + 1] - ranges[2 * (c % components)]) / 65535.0f;
+            bias[c] = ranges[2 * (c % components)];
+        }
+        i = g_norm16Kernel(src,dst,count,scale,bias);
+    }
+
+    for (c = 0; i < count; i++)
+    {
+        dst[i] = ranges[2 * c] +
+            (float)getShort(&src[2 * i]) * ((ranges[2 * c + 1] - ranges[2 * c]) / 65535.0f);
+        if (++c == components)
+            c = 0;
+    }
+}
+
+
+MlBoolean MleDppEncodedArray::decodeDelta(const MlByte *src,MlInt length,MlInt *dst,MlInt count)
+{
+    // Declare local variables.
+    MlUInt value,previous = 0;
+    MlInt i,shift,pos = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        value = 0;
+        shift = 0;
+        do
+        {
+            // At most five groups hold 32 bits.
+            if ((pos >= length) || (shift > 28))
+                return(FALSE);
+            value |= (MlUInt)(src[pos] & 0x7f) << shift;
+            shift += 7;
+        } while (src[pos++] & 0x80);
+
+        // Undo the zigzag mapping and add the delta.
+        previous += (value >> 1) ^ (0 - (value & 1));
+        dst[i] = (MlInt)previous;
+    }
+
+    return(pos == length);
+}
+
+
+MlBoolean MleDppEncodedArray::decode(const MleDppInstruction *instruction,MlInt elementSize,void *elements)
+{
+    // Declare local variables.
+    MlInt components,count,i;
+    const MlByte *data = instruction->m_data;
+    float *ranges;
+
+    if ((instruction->m_opcode != copyEncodedArrayPropertyOpcode) ||
+        (elementSize <= 0) || (elementSize % sizeof(MlInt) != 0))
+        return(FALSE);
+    components = elementSize / sizeof(MlInt);
+    count = instruction->m_operand * components;
+
+    switch (instruction->m_count)
+    {
+      case halfArrayEncoding:
+        if (instruction->m_dataLength != 2 * count)
+            return(FALSE);
+        decodeHalf(data,(float *)elements,count);
+        return(TRUE);
+
+      case norm16ArrayEncoding:
+        if (instruction->m_dataLength != (MlInt)(2 * components * sizeof(float)) + 2 * count)
+            return(FALSE);
+        ranges = (float *)mlMalloc(2 * components * sizeof(float));
+        for (i = 0; i < 2 * components; i++)
+            ranges[i] = getFloat(&data[i * sizeof(float)]);
+        decodeNorm16(&data[2 * components * sizeof(float)],(float *)elements,
+            count,components,ranges);
+        mlFree(ranges);
+        return(TRUE);
+
+      case deltaArrayEncoding:
+        if (components != 1)
+            return(FALSE);
+        return(decodeDelta(data,instruction->m_dataLength,(MlInt *)elements,count));
+
+      default:
+        return(FALSE);
+    }
+}
+
+
+void*
+MleDppEncodedArray::operator new(size_t tSize)
+{
+	void *p = mlMalloc(tSize);
+	return p;
+}
+
+void
+MleDppEncodedArray::operator delete(void *p)
+{
+	mlFree(p);
+}
+
+void*
+MleDppEncodedArray::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+void
+MleDppEncodedArray::operator delete[](void* p)
+{
+    mlFree(p);
+}
@@ -0,0 +1,191 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file agblock.cxx
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+
+// Declare system header files.
+#include <stddef.h>
+#include <string.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlMalloc.h"
+#include "mle/mlAssert.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agopcode.h"
+#include "mle/agblock.h"
+
+
+MleDppClassLayout::MleDppClassLayout(MlBoolean isLittle)
+{
+    m_littleEndian = isLittle;
+    m_layout = m_actorClass = -1;
+    m_properties = m_bindings = NULL;
+    m_numProperties = m_numBindings = 0;
+    m_recordSize = 0;
+}
+
+
+MleDppClassLayout::~MleDppClassLayout()
+{
+    if (m_properties != NULL)
+        mlFree(m_properties);
+}
+
+
+MlInt MleDppClassLayout::getInt(const MlByte *data)
+{
+    if (m_littleEndian)
+        return(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+    else
+        return((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+}
+
+
+MlBoolean MleDppClassLayout::set(const MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    const MlByte *p;
+    MlInt i,numInts,numProperties;
+
+    if (m_properties != NULL)
+        mlFree(m_properties);
+    m_properties = m_bindings = NULL;
+    m_numProperties = m_numBindings = 0;
+    m_recordSize = 0;
+
+    // The decoder has checked that the counts agree with the data.
+    if (instruction->m_opcode != defineClassLayoutOpcode)
+        return(FALSE);
+    p = instruction->m_data;
+    numProperties = getInt(&p[sizeof(MlInt)]);
+    numInts = instruction->m_dataLength / sizeof(MlInt) - 3;
+
+    // Keep the property and binding pairs in one allocation.
+    m_properties = (MlInt *)mlMalloc((numInts + 1) * sizeof(MlInt));
+    if (m_properties == NULL)
+        return(FALSE);
+    for (i = 0; i < 2 * numProperties; i++)
+        m_properties[i] = getInt(&p[(i + 2) * sizeof(MlInt)]);
+    for (; i < numInts; i++)
+        m_properties[i] = getInt(&p[(i + 3) * sizeof(MlInt)]);
+
+    m_layout = instruction->m_operand;
+    m_actorClass = getInt(p);
+    m_numProperties = numProperties;
+    m_numBindings = getInt(&p[(2 * numProperties + 2) * sizeof(MlInt)]);
+    m_bindings = &m_properties[2 * numProperties];
+
+    for (i = 0; i < m_numProperties; i++)
+    {
+        if (getPropertyLength(i) <= 0)
+        {
+            m_numProperties = m_recordSize = 0;
+            return(FALSE);
+        }
+        m_recordSize += getPropertyLength(i);
+    }
+
+    return(TRUE);
+}
+
+
+MlBoolean MleDppClassLayout::checkBlock(const MleDppInstruction *block)
+{
+    if ((block->m_opcode != createActorBlockOpcode) ||
+        (block->m_operand != m_layout) || (m_recordSize <= 0))
+        return(FALSE);
+
+    // Guard the product against overflow before comparing.
+    if (block->m_count > block->m_dataLength / m_recordSize)
+        return(FALSE);
+    return(block->m_count * m_recordSize == block->m_dataLength);
+}
+
+
+const MlByte *MleDppClassLayout::getColumn(const MleDppInstruction *block,MlInt property)
+{
+    // Declare local variables.
+    MlInt i,start = 0;
+
+    MLE_ASSERT((property >= 0) && (property < m_numProperties));
+
+    // The columns follow each other in property order.
+    for (i = 0; i < property; i++)
+        start += getPropertyLength(i);
+    return(&block->m_data[start * block->m_count]);
+}
+
+
+void MleDppClassLayout::scatterColumn(const MleDppInstruction *block,MlInt property,
+    MlByte **actors,MlInt byteOffset)
+{
+    // Declare local variables.
+    const MlByte *column;
+    MlInt i,length;
+
+    column = getColumn(block,property);
+    length = getPropertyLength(property);
+    for (i = 0; i < block->m_count; i++)
+        memcpy(actors[i] + byteOffset,&column[i * length],length);
+}
+
+
+void *
+MleDppClassLayout::operator new(size_t tSize)
+{
+	void *p = mlMalloc(tSize);
+	return p;
+}
+
+void
+MleDppClassLayout::operator delete(void *p)
+{
+	mlFree(p);
+}
+
+void*
+MleDppClassLayout::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+void
+MleDppClassLayout::operator delete[](void* p)
+{
+    mlFree(p);
+}
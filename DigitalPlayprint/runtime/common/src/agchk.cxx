@@ -40,6 +40,7 @@
 
 // Include system header files.
 #include <stdio.h>
+#include <string.h>
 
 // Include Magic Lantern header files.
 #include "mle/mlMalloc.h"
@@ -47,13 +48,41 @@
 
 // Include Magic Lantern Digital Playprint header files.
 #include "mle/agopcode.h"
+#include "mle/agdecode.h"
 #include "mle/agchk.h"
+#include "mle/aghints.h"
 
 
 // Code to resolve media references in an actor group chunk.
 
+// The fewest like actors worth a class block.
+#define CLASS_BLOCK_MIN_ACTORS 4
+
+// Pack class blocks.
+MlBoolean MleDppActorGroupChunk::g_classBlocks = FALSE;
+
+// Write allocation hints.
+MlBoolean MleDppActorGroupChunk::g_groupHints = FALSE;
+
+
+// Make room for one more element at the end of a growing array.
+static void *growArray(void *array, int count, int *max, size_t size)
+{
+	if (count < *max)
+		return array;
+
+	*max = (*max == 0) ? 16 : 2 * *max;
+	return mlRealloc(array, *max * size);
+}
+
+
 MleDppActorGroupChunk::MleDppActorGroupChunk(const char *filename, MlBoolean isLittle)
- : m_mediaNames(NULL), m_littleEndian(isLittle)
+ : m_mediaNames(NULL), m_littleEndian(isLittle), m_sets(NULL), m_numSets(0),
+   m_directory(NULL), m_numDirectory(0), m_directoryEnd(-1), m_indices(NULL),
+   m_blockActors(NULL), m_numBlockActors(0), m_maxBlockActors(0),
+   m_blockProperties(NULL), m_numBlockProperties(0), m_maxBlockProperties(0),
+   m_blockBindings(NULL), m_numBlockBindings(0), m_maxBlockBindings(0),
+   m_blockRuns(NULL), m_numBlockRuns(0), m_scanning(FALSE)
 {
 	m_fp = fopen(filename, "rb");
 	MLE_ASSERT(m_fp != NULL);
@@ -190,86 +219,33 @@ int MleDppActorGroupChunk::writeInt(MlInt index)
 }
 
 
-unsigned char MleDppActorGroupChunk::nextChunkByte()
-{
-	MLE_ASSERT(m_chunkRef >= m_chunkStart && m_chunkRef < m_chunkEnd);
-
-	return *m_chunkRef++;
-}
-
-unsigned char
-MleDppActorGroupChunk::copyStreamByte()
+void MleDppActorGroupChunk::writeBytes(const MlByte *data, int length)
 {
+	// Make sure the buffer is large enough to hold the bytes.
 	int buflen = m_resolvedChunkPtr - m_resolvedChunkBuf;
-	if ( buflen == m_resolvedChunkSize )
+	while ( buflen + length > m_resolvedChunkSize )
 	{
-		m_resolvedChunkBuf = (unsigned char *)
+		m_resolvedChunkBuf = (MlByte *)
 			mlRealloc(m_resolvedChunkBuf,2*m_resolvedChunkSize);
 		m_resolvedChunkPtr = m_resolvedChunkBuf + buflen;
 		m_resolvedChunkSize *= 2;
 	}
 
-	return *m_resolvedChunkPtr++ = nextChunkByte();
-}
-
-int MleDppActorGroupChunk::readIndex(void)
-{
-	//long value = 0;
-	int value = 0;
-	MlChar byte;
-	
-	while ((byte = nextChunkByte()) >= 0)
-	{
-		MLE_ASSERT((value & (MlInt) 0x80000000 >> (valueBits - 1)) == 0);
-		value = (value << valueBits) | byte;
-	}
-	MLE_ASSERT(value >= 0);
-
-	m_chunkRef--; /* Back up one, since while loop always over-advances by one. */
-
-	return value;
-}
-
-int MleDppActorGroupChunk::readInt(void)
-{
-    int value = nextChunkByte();
-
-    if (m_littleEndian)
-	{
-		value |= (nextChunkByte()<<8);
-		value |= (nextChunkByte()<<16);
-		value |= (nextChunkByte()<<24);
-    } else {
-		value = (value<<8) | nextChunkByte();
-		value = (value<<8) | nextChunkByte();
-		value = (value<<8) | nextChunkByte();
-    }
-
-
-    return value;
+	memcpy(m_resolvedChunkPtr, data, length);
+	m_resolvedChunkPtr += length;
 }
 
 
 const MlByte *
 MleDppActorGroupChunk::resolveNames(int *length, const int* indices)
 {
-    int nameCount = countNames();
-
-    // Worst case: there are five bytes per index in the stream.
-#if 0
-    MlInt resolvedByteStreamSize = 1 + m_nameOffset + m_nameCount * 5;
-    MlByte *resolvedByteStream = new MlByte[ resolvedByteStreamSize ];
-    m_resolvedChunkPtr = resolvedByteStream;
-#else
     m_resolvedChunkSize = sizeof(MlInt);
     m_resolvedChunkBuf = (MlByte *)mlMalloc(sizeof(MlInt));
     m_resolvedChunkPtr = m_resolvedChunkBuf;
-#endif
-    int propertyLength;
+    m_indices = indices;
+
     int chunkLength = m_nameOffset - sizeof(MlInt);
-    //m_chunkStart = new unsigned char[chunkLength];
 	m_chunkStart = (MlByte *)mlMalloc(chunkLength);
-    m_chunkRef = m_chunkStart;
     m_chunkEnd = &m_chunkStart[chunkLength];
 
     int err = fseek(m_fp, sizeof(MlInt), SEEK_SET);
@@ -278,74 +254,507 @@ MleDppActorGroupChunk::resolveNames(int *length, const int* indices)
     err = fread((char *) m_chunkStart, chunkLength, 1, m_fp);
     MLE_ASSERT(err == 1);
 
+    // Look for an actor directory behind the end of the stream.
+    m_directoryNext = 0;
+    m_directoryEndMapped = FALSE;
+    readDirectory(chunkLength);
+
     // The first int is the index of the group in the table of group
-    // classes, so we can invoke the right constructor.    
-    copyInt();
+    // classes, so we can invoke the right constructor. The index after
+    // it is the count of actors in this group.
+    MleDppOpcodeDecoder decoder(m_littleEndian);
+    MlInt groupClass, numActors;
+    int start = decoder.decodeGroupHeader(m_chunkStart, chunkLength, &groupClass, &numActors);
+    MLE_ASSERT(start > 0);
+    if (g_groupHints)
+    {
+        // The counts do not change when the stream is resolved or packed.
+        MleDppGroupHints hints(m_littleEndian);
+        MlBoolean ok = hints.compute(m_chunkStart, chunkLength);
+        MLE_ASSERT(ok);
+        writeInt(groupClass | groupHintsFlag);
+        writeInt(hints.getSize() - sizeof(MlInt));
+        writeInt(hints.getNumClasses());
+        for (int i = 0; i < hints.getNumClasses(); i++)
+        {
+            writeInt(hints.getActorClass(i));
+            writeInt(hints.getNumActors(i));
+        }
+        writeInt(hints.getNumDynamic());
+        writeInt(hints.getDynamicBytes());
+    }
+    else
+        writeInt(groupClass);
+    writeIndex(numActors);
+
+    // Find the runs of actors to pack. The directory addresses single
+    // actors, so a chunk carrying one is not packed.
+    if (g_classBlocks && (m_directory == NULL))
+        findClassBlocks(chunkLength, start);
+
+    // Copy the instructions, resolving the media references on the way.
+    m_nextBlockRun = 0;
+    m_numLayoutsWritten = 0;
+    m_blockEnd = -1;
+    m_sourceOffset = m_sourceLength = m_sourceSet = -1;
+    m_resolvedOffset = m_resolvedLength = m_resolvedSet = -1;
+    err = decoder.decode(m_chunkStart, chunkLength, start, this);
+    MLE_ASSERT(err == MLE_DPP_DECODE_OK);
+    freeClassBlocks();
+
+	// Append the directory, now holding offsets into the resolved stream.
+	// It is dropped if an entry did not land on an instruction.
+	if ((m_directory != NULL) && (m_directoryNext == m_numDirectory) && m_directoryEndMapped)
+	{
+		for (int i = 0; i < m_numDirectory; i++)
+		{
+			writeInt(m_directory[2 * i]);
+			writeInt(m_directory[2 * i + 1]);
+		}
+		writeInt(m_directoryEnd);
+		writeInt(m_numDirectory);
+		writeInt(actorDirectoryTag);
+	}
+	if (m_directory != NULL)
+		mlFree(m_directory);
+	m_directory = NULL;
+	m_numDirectory = 0;
+
+	// Clean up.
+	mlFree((void *)m_chunkStart);
+	m_chunkStart = NULL;
+	m_indices = NULL;
+
+	// Calculate the length of the resolved table.
+    *length = m_resolvedChunkPtr - m_resolvedChunkBuf;
+
+	// Returne a pointer to the resolved chunk table.
+    return m_resolvedChunkBuf;
+}
+
+MlBoolean MleDppActorGroupChunk::visit(const MleDppInstruction *instruction)
+{
+	if (m_scanning)
+		return scanActor(instruction);
+
+	if (m_directory != NULL)
+		mapDirectory(instruction->m_offset);
 
-    // The index is the count of actors in this group.  It can be an index
-    // because we know an opcode follows it.
-    copyIndex();
+	// Replace the next run of actors with its class block.
+	if ((m_nextBlockRun < m_numBlockRuns) &&
+		(m_blockRuns[m_nextBlockRun].m_start == instruction->m_offset))
+		writeClassBlock(&m_blockRuns[m_nextBlockRun++]);
 
-	int bytesToCopy, numElements;
-    do {
-		switch (copyStreamByte())
+	// Follow the state set by the chunk, even where it is packed, so that
+	// it can be restored after a class block.
+	MlBoolean packed = (instruction->m_offset < m_blockEnd);
+	switch (instruction->m_opcode)
+	{
+	  case setPropertyOffsetOpcode:
+		m_sourceOffset = instruction->m_operand;
+		if (! packed)
+			m_resolvedOffset = m_sourceOffset;
+		break;
+
+	  case setPropertyLengthOpcode:
+		m_sourceLength = instruction->m_operand;
+		if (! packed)
+			m_resolvedLength = m_sourceLength;
+		break;
+
+	  case setForumOpcode:
+		addSet(instruction->m_operand);
+		m_sourceSet = instruction->m_operand;
+		if (! packed)
+			m_resolvedSet = m_sourceSet;
+		break;
+
+	  default:
+		if (! packed)
+			restoreState(instruction->m_opcode);
+		break;
+	}
+	if (packed)
+		return TRUE;
+
+	if (instruction->m_opcode == copyMediaRefOpcode)
+	{
+		writeBytes(&m_chunkStart[instruction->m_offset], 1);
+		writeIndex(m_indices[instruction->m_operand]);
+		return TRUE;
+	}
+
+	writeBytes(&m_chunkStart[instruction->m_offset], instruction->m_length);
+	return TRUE;
+}
+
+void MleDppActorGroupChunk::setClassBlocks(MlBoolean enable)
+{
+	g_classBlocks = enable;
+}
+
+void MleDppActorGroupChunk::setGroupHints(MlBoolean enable)
+{
+	g_groupHints = enable;
+}
+
+void MleDppActorGroupChunk::findClassBlocks(int chunkLength, int start)
+{
+	MleDppOpcodeDecoder decoder(m_littleEndian);
+
+	// Collect the actors and what they set.
+	m_scanActor = -1;
+	m_sourceOffset = m_sourceLength = m_sourceSet = -1;
+	m_scanning = TRUE;
+	int err = decoder.decode(m_chunkStart, chunkLength, start, this);
+	m_scanning = FALSE;
+	if (err != MLE_DPP_DECODE_OK)
+	{
+		freeClassBlocks();
+		return;
+	}
+
+	// Gather runs of like actors; runs of the same kind share a layout.
+	int numLayouts = 0;
+	m_blockRuns = (BlockRun *)mlMalloc((m_numBlockActors / CLASS_BLOCK_MIN_ACTORS + 1) * sizeof(BlockRun));
+	for (int i = 0, j; i < m_numBlockActors; i = j)
+	{
+		BlockActor *first = &m_blockActors[i];
+		for (j = i + 1; j < m_numBlockActors; j++)
 		{
-		  case setForumOpcode:
-		  case createActorOpcode:
-		  case bindDelegateOpcode:
-		  case parentDelegateOpcode:
-		  case childDelegateOpcode:
-		  case setPropertyOffsetOpcode:
-			copyIndex();
-			break;
+			BlockActor *next = &m_blockActors[j];
+			if (! first->m_packable || ! next->m_packable ||
+				(next->m_start != next[-1].m_end) || ! sameLayout(first, next))
+				break;
+		}
+		if (! first->m_packable || (j - i < CLASS_BLOCK_MIN_ACTORS))
+			continue;
+
+		BlockRun *run = &m_blockRuns[m_numBlockRuns];
+		run->m_start = first->m_start;
+		run->m_end = m_blockActors[j - 1].m_end;
+		run->m_firstActor = i;
+		run->m_numActors = j - i;
+		run->m_layout = numLayouts;
+		for (int k = 0; k < m_numBlockRuns; k++)
+		{
+			if (sameLayout(&m_blockActors[m_blockRuns[k].m_firstActor], first))
+			{
+				run->m_layout = m_blockRuns[k].m_layout;
+				break;
+			}
+		}
+		if (run->m_layout == numLayouts)
+			numLayouts++;
+		m_numBlockRuns++;
+	}
+}
 
-		  case setPropertyLengthOpcode:
-			propertyLength = copyIndex();
-			break;
+MlBoolean MleDppActorGroupChunk::scanActor(const MleDppInstruction *instruction)
+{
+	BlockActor *actor = (m_scanActor >= 0) ? &m_blockActors[m_scanActor] : NULL;
 
-		  case copyPropertyOpcode:
-			MLE_ASSERT(propertyLength > 0);
-			bytesToCopy = propertyLength;
-			while (--bytesToCopy >= 0)
-			  copyStreamByte();
+	switch (instruction->m_opcode)
+	{
+	  case createActorOpcode:
+		endScanActor(instruction->m_offset);
+		m_blockActors = (BlockActor *)growArray(m_blockActors,
+			m_numBlockActors, &m_maxBlockActors, sizeof(BlockActor));
+		m_scanActor = m_numBlockActors++;
+		actor = &m_blockActors[m_scanActor];
+		actor->m_start = instruction->m_offset;
+		actor->m_end = -1;
+		actor->m_actorClass = instruction->m_operand;
+		actor->m_firstProperty = m_numBlockProperties;
+		actor->m_numProperties = 0;
+		actor->m_firstBinding = m_numBlockBindings;
+		actor->m_numBindings = 0;
+		actor->m_packable = TRUE;
+		break;
+
+	  case setPropertyOffsetOpcode:
+		m_sourceOffset = instruction->m_operand;
+		break;
+
+	  case setPropertyLengthOpcode:
+		m_sourceLength = instruction->m_operand;
+		break;
+
+	  case setForumOpcode:
+		m_sourceSet = instruction->m_operand;
+		break;
+
+	  case copyPropertyOpcode:
+		if (actor == NULL)
 			break;
-
-		  case endActorGroupOpcode:
-			m_chunkRef = m_chunkEnd;
+		if (m_sourceOffset < 0)
+		{
+			actor->m_packable = FALSE;
 			break;
-
-		  case copyMediaRefOpcode:
-			writeIndex(indices[readIndex()]);
+		}
+		m_blockProperties = (MlInt *)growArray(m_blockProperties,
+			m_numBlockProperties, &m_maxBlockProperties, 3 * sizeof(MlInt));
+		m_blockProperties[3 * m_numBlockProperties] = m_sourceOffset;
+		m_blockProperties[3 * m_numBlockProperties + 1] = instruction->m_operand;
+		m_blockProperties[3 * m_numBlockProperties + 2] = instruction->m_data - m_chunkStart;
+		m_numBlockProperties++;
+		actor->m_numProperties++;
+		break;
+
+	  case bindDelegateOpcode:
+		if (actor == NULL)
 			break;
-
-		  case copyDynamicPropertyOpcode:
-			bytesToCopy = copyInt();
-			while (--bytesToCopy >= 0)
-			  copyStreamByte();
+		if (m_sourceSet < 0)
+		{
+			actor->m_packable = FALSE;
 			break;
+		}
+		m_blockBindings = (MlInt *)growArray(m_blockBindings,
+			m_numBlockBindings, &m_maxBlockBindings, 2 * sizeof(MlInt));
+		m_blockBindings[2 * m_numBlockBindings] = m_sourceSet;
+		m_blockBindings[2 * m_numBlockBindings + 1] = instruction->m_operand;
+		m_numBlockBindings++;
+		actor->m_numBindings++;
+		break;
+
+	  case defineClassLayoutOpcode:
+	  case createActorBlockOpcode:
+		// The chunk is packed already; leave it be.
+		return FALSE;
+
+	  case cloneActorOpcode:
+		// A clone depends on its original, so it is never packed.
+	  case beginActorSetOpcode:
+	  case endActorGroupOpcode:
+	  case createForumOpcode:
+	  case endForumOpcode:
+		endScanActor(instruction->m_offset);
+		break;
+
+	  default:
+		// Media references, variable-length properties and delegate
+		// hierarchies do not fit a fixed record.
+		if (actor != NULL)
+			actor->m_packable = FALSE;
+		break;
+	}
 
-		  case copyArrayPropertyOpcode:
-			numElements = copyInt();
-			bytesToCopy = propertyLength * numElements;
-			while (--bytesToCopy >= 0)
-			  copyStreamByte();
-			break;
+	return TRUE;
+}
+
+void MleDppActorGroupChunk::endScanActor(MlInt offset)
+{
+	if (m_scanActor < 0)
+		return;
+
+	m_blockActors[m_scanActor].m_end = offset;
+	m_scanActor = -1;
+}
+
+MlBoolean MleDppActorGroupChunk::sameLayout(const BlockActor *a, const BlockActor *b)
+{
+	if ((a->m_actorClass != b->m_actorClass) ||
+		(a->m_numProperties != b->m_numProperties) ||
+		(a->m_numBindings != b->m_numBindings))
+		return FALSE;
 
-		  default:
-			MLE_ASSERT(0);
+	// Compare the property offsets and lengths, but not the values.
+	for (int i = 0; i < a->m_numProperties; i++)
+	{
+		const MlInt *pa = &m_blockProperties[3 * (a->m_firstProperty + i)];
+		const MlInt *pb = &m_blockProperties[3 * (b->m_firstProperty + i)];
+		if ((pa[0] != pb[0]) || (pa[1] != pb[1]))
+			return FALSE;
+	}
+
+	return (a->m_numBindings == 0) || memcmp(&m_blockBindings[2 * a->m_firstBinding],
+		&m_blockBindings[2 * b->m_firstBinding],
+		2 * a->m_numBindings * sizeof(MlInt)) == 0;
+}
+
+void MleDppActorGroupChunk::writeClassBlock(const BlockRun *run)
+{
+	const BlockActor *first = &m_blockActors[run->m_firstActor];
+	const MlInt *properties = &m_blockProperties[3 * first->m_firstProperty];
+	const MlInt *bindings = &m_blockBindings[2 * first->m_firstBinding];
+	MlByte opcode;
+	int i;
+
+	// Define the layout before its first block.
+	if (run->m_layout == m_numLayoutsWritten)
+	{
+		opcode = defineClassLayoutOpcode;
+		writeBytes(&opcode, 1);
+		writeInt(run->m_layout);
+		writeInt(first->m_actorClass);
+		writeInt(first->m_numProperties);
+		for (i = 0; i < first->m_numProperties; i++)
+		{
+			writeInt(properties[3 * i]);
+			writeInt(properties[3 * i + 1]);
 		}
-    } while (m_chunkRef < m_chunkEnd);
+		writeInt(first->m_numBindings);
+		for (i = 0; i < 2 * first->m_numBindings; i++)
+			writeInt(bindings[i]);
+		m_numLayoutsWritten++;
+	}
 
-	// Clean up.
-    //delete (unsigned char*) m_chunkStart;
-	mlFree((void *)m_chunkStart);
-	m_chunkStart = NULL;
+	int recordSize = 0;
+	for (i = 0; i < first->m_numProperties; i++)
+		recordSize += properties[3 * i + 1];
 
-	// Calculate the length of the resolved table.
-    *length = m_resolvedChunkPtr - m_resolvedChunkBuf;
+	opcode = createActorBlockOpcode;
+	writeBytes(&opcode, 1);
+	writeInt(run->m_layout);
+	writeInt(run->m_numActors);
+	writeInt(run->m_numActors * recordSize);
 
-	// Returne a pointer to the resolved chunk table.
-    return m_resolvedChunkBuf;
+	// One column of values per property.
+	for (i = 0; i < first->m_numProperties; i++)
+	{
+		for (int j = 0; j < run->m_numActors; j++)
+		{
+			const MlInt *property = &m_blockProperties[3 * (first[j].m_firstProperty + i)];
+			writeBytes(&m_chunkStart[property[2]], property[1]);
+		}
+	}
+
+	// The block leaves the property offset and length undefined, and the
+	// set at that of the last binding.
+	m_blockEnd = run->m_end;
+	m_resolvedOffset = m_resolvedLength = -1;
+	if (first->m_numBindings > 0)
+		m_resolvedSet = bindings[2 * (first->m_numBindings - 1)];
+}
+
+void MleDppActorGroupChunk::restoreState(MlByte opcode)
+{
+	MlByte stateOpcode;
+
+	switch (opcode)
+	{
+	  case copyPropertyOpcode:
+	  case copyArrayPropertyOpcode:
+	  case copyEncodedArrayPropertyOpcode:
+		if ((m_sourceLength >= 0) && (m_sourceLength != m_resolvedLength))
+		{
+			stateOpcode = setPropertyLengthOpcode;
+			writeBytes(&stateOpcode, 1);
+			writeIndex(m_sourceLength);
+			m_resolvedLength = m_sourceLength;
+		}
+		// Fall through.
+
+	  case copyMediaRefOpcode:
+	  case copyDynamicPropertyOpcode:
+	  case copyPooledStringOpcode:
+		if ((m_sourceOffset >= 0) && (m_sourceOffset != m_resolvedOffset))
+		{
+			stateOpcode = setPropertyOffsetOpcode;
+			writeBytes(&stateOpcode, 1);
+			writeIndex(m_sourceOffset);
+			m_resolvedOffset = m_sourceOffset;
+		}
+		break;
+
+	  case bindDelegateOpcode:
+	  case parentDelegateOpcode:
+	  case childDelegateOpcode:
+		if ((m_sourceSet >= 0) && (m_sourceSet != m_resolvedSet))
+		{
+			stateOpcode = setForumOpcode;
+			writeBytes(&stateOpcode, 1);
+			writeIndex(m_sourceSet);
+			m_resolvedSet = m_sourceSet;
+		}
+		break;
+	}
+}
+
+void MleDppActorGroupChunk::freeClassBlocks(void)
+{
+	if (m_blockActors != NULL)
+		mlFree(m_blockActors);
+	if (m_blockProperties != NULL)
+		mlFree(m_blockProperties);
+	if (m_blockBindings != NULL)
+		mlFree(m_blockBindings);
+	if (m_blockRuns != NULL)
+		mlFree(m_blockRuns);
+	m_blockActors = NULL;
+	m_blockProperties = NULL;
+	m_blockBindings = NULL;
+	m_blockRuns = NULL;
+	m_numBlockActors = m_maxBlockActors = 0;
+	m_numBlockProperties = m_maxBlockProperties = 0;
+	m_numBlockBindings = m_maxBlockBindings = 0;
+	m_numBlockRuns = 0;
+}
+
+MlInt MleDppActorGroupChunk::getInt(const MlByte *data)
+{
+	if (m_littleEndian)
+		return data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
+	else
+		return (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+MlBoolean MleDppActorGroupChunk::readDirectory(int chunkLength)
+{
+	// The trailer is at least the end, count and tag ints, and follows
+	// at least the endActorGroupOpcode.
+	int trailerSize = 3 * sizeof(MlInt);
+	if (chunkLength < trailerSize + 1)
+		return FALSE;
+	if (getInt(m_chunkEnd - sizeof(MlInt)) != actorDirectoryTag)
+		return FALSE;
+
+	MlInt numEntries = getInt(m_chunkEnd - 2 * sizeof(MlInt));
+	if ((numEntries < 0) ||
+		(numEntries > (chunkLength - trailerSize - 1) / (int)(2 * sizeof(MlInt))))
+		return FALSE;
+
+	trailerSize += numEntries * 2 * sizeof(MlInt);
+	const MlByte *trailer = m_chunkEnd - trailerSize;
+	if (trailer[-1] != endActorGroupOpcode)
+		return FALSE;
+
+	m_directory = (MlInt *)mlMalloc((numEntries + 1) * 2 * sizeof(MlInt));
+	for (int i = 0; i < 2 * numEntries; i++)
+		m_directory[i] = getInt(&trailer[i * sizeof(MlInt)]);
+	m_directoryEnd = getInt(&trailer[2 * numEntries * sizeof(MlInt)]);
+	m_numDirectory = numEntries;
+
+	return TRUE;
+}
+
+void MleDppActorGroupChunk::mapDirectory(MlInt srcOffset)
+{
+	// Offsets are relative to the group class int, which starts both streams.
+	MlInt dstOffset = m_resolvedChunkPtr - m_resolvedChunkBuf;
+
+	while ((m_directoryNext < m_numDirectory) && (m_directory[2 * m_directoryNext] == srcOffset))
+	{
+		m_directory[2 * m_directoryNext] = dstOffset;
+		m_directoryNext++;
+	}
+	if (! m_directoryEndMapped && (m_directoryEnd == srcOffset))
+	{
+		m_directoryEnd = dstOffset;
+		m_directoryEndMapped = TRUE;
+	}
+}
+
+void MleDppActorGroupChunk::addSet(MlInt set)
+{
+	for (int i = 0; i < m_numSets; i++)
+	{
+		if (m_sets[i] == set)
+			return;
+	}
+
+	m_sets = (MlInt *)mlRealloc(m_sets, (m_numSets + 1) * sizeof(MlInt));
+	m_sets[m_numSets++] = set;
 }
 
 void *
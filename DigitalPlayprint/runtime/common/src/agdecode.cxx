@@ -0,0 +1,454 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file agdecode.cxx
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+
+// Declare system header files.
+#include <stddef.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlMalloc.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agopcode.h"
+#include "mle/agdecode.h"
+
+
+// The largest index takes five 7-bit groups.
+#define MAX_INDEX_BYTES ((32 + valueBits - 1) / valueBits)
+
+
+const MleDppOpcodeDecoder::OperandDecoder MleDppOpcodeDecoder::g_operandDecoders[] =
+{
+    NULL,                                   // beginActorSetOpcode (unused)
+    &MleDppOpcodeDecoder::decodeIndex,      // createActorOpcode
+    &MleDppOpcodeDecoder::decodeIndex,      // setForumOpcode
+    &MleDppOpcodeDecoder::decodeIndex,      // bindDelegateOpcode
+    &MleDppOpcodeDecoder::decodeIndex,      // parentDelegateOpcode
+    &MleDppOpcodeDecoder::decodeIndex,      // childDelegateOpcode
+    &MleDppOpcodeDecoder::decodeIndex,      // setPropertyOffsetOpcode
+    &MleDppOpcodeDecoder::decodeLength,     // setPropertyLengthOpcode
+    &MleDppOpcodeDecoder::decodeProperty,   // copyPropertyOpcode
+    &MleDppOpcodeDecoder::decodeIndex,      // copyMediaRefOpcode
+    &MleDppOpcodeDecoder::decodeNone,       // endActorGroupOpcode
+    &MleDppOpcodeDecoder::decodeDynamic,    // copyDynamicPropertyOpcode
+    &MleDppOpcodeDecoder::decodeArray,      // copyArrayPropertyOpcode
+    &MleDppOpcodeDecoder::decodeIndex,      // createForumOpcode
+    &MleDppOpcodeDecoder::decodeNone,       // endForumOpcode
+    &MleDppOpcodeDecoder::decodeLayout,     // defineClassLayoutOpcode
+    &MleDppOpcodeDecoder::decodeBlock,      // createActorBlockOpcode
+    &MleDppOpcodeDecoder::decodeIndex,      // cloneActorOpcode
+    &MleDppOpcodeDecoder::decodePool,       // defineStringPoolOpcode
+    &MleDppOpcodeDecoder::decodeIndex,      // copyPooledStringOpcode
+    &MleDppOpcodeDecoder::decodeEncoded     // copyEncodedArrayPropertyOpcode
+};
+
+
+MleDppOpcodeDecoder::MleDppOpcodeDecoder(MlBoolean isLittle)
+{
+    m_littleEndian = isLittle;
+    m_propertyLength = -1;
+    m_offset = 0;
+}
+
+
+MleDppOpcodeDecoder::~MleDppOpcodeDecoder()
+{
+    // Do nothing.
+}
+
+
+MlInt MleDppOpcodeDecoder::readInt(const MlByte *data)
+{
+    if (m_littleEndian)
+        return(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+    else
+        return((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+}
+
+
+MlInt MleDppOpcodeDecoder::readIndex(const MlByte *data,MlInt length,MlInt *value)
+{
+    // Declare local variables.
+    MlInt i,limit;
+    MlUInt index = 0;
+
+    // One bound covers the whole index; a sixth group can never fit.
+    limit = (length < MAX_INDEX_BYTES) ? length : MAX_INDEX_BYTES;
+    for (i = 0; (i < limit) && (data[i] <= valueMask); i++)
+    {
+        if (index > ((MlUInt)0x7fffffff >> valueBits))
+            return(-1);
+        index = (index << valueBits) | data[i];
+    }
+    if ((i == MAX_INDEX_BYTES) && (length > i) && (data[i] <= valueMask))
+        return(-1);
+
+    *value = (MlInt)index;
+    return(i);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeNone(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    (void)p;
+    (void)available;
+
+    instruction->m_length = 1;
+    return(MLE_DPP_DECODE_OK);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeIndex(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    MlInt size;
+
+    if ((size = readIndex(p,available,&instruction->m_operand)) < 0)
+        return(MLE_DPP_DECODE_BADINDEX);
+
+    instruction->m_length = 1 + size;
+    return(MLE_DPP_DECODE_OK);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeLength(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    MlInt status;
+
+    if ((status = decodeIndex(p,available,instruction)) == MLE_DPP_DECODE_OK)
+        m_propertyLength = instruction->m_operand;
+    return(status);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeProperty(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    if (m_propertyLength <= 0)
+        return(MLE_DPP_DECODE_BADLENGTH);
+    if (m_propertyLength > available)
+        return(MLE_DPP_DECODE_TRUNCATED);
+
+    instruction->m_operand = m_propertyLength;
+    instruction->m_data = p;
+    instruction->m_dataLength = m_propertyLength;
+    instruction->m_length = 1 + m_propertyLength;
+    return(MLE_DPP_DECODE_OK);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeDynamic(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    MlInt count;
+
+    if (available < (MlInt)sizeof(MlInt))
+        return(MLE_DPP_DECODE_TRUNCATED);
+    if ((count = readInt(p)) < 0)
+        return(MLE_DPP_DECODE_BADLENGTH);
+    if (count > available - (MlInt)sizeof(MlInt))
+        return(MLE_DPP_DECODE_TRUNCATED);
+
+    instruction->m_operand = count;
+    instruction->m_data = p + sizeof(MlInt);
+    instruction->m_dataLength = count;
+    instruction->m_length = 1 + sizeof(MlInt) + count;
+    return(MLE_DPP_DECODE_OK);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeArray(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    MlInt numElements,size;
+
+    if (m_propertyLength < 0)
+        return(MLE_DPP_DECODE_BADLENGTH);
+    if (available < (MlInt)sizeof(MlInt))
+        return(MLE_DPP_DECODE_TRUNCATED);
+    if ((numElements = readInt(p)) < 0)
+        return(MLE_DPP_DECODE_BADLENGTH);
+
+    available -= sizeof(MlInt);
+    if ((m_propertyLength > 0) && (numElements > available / m_propertyLength))
+        return(MLE_DPP_DECODE_TRUNCATED);
+    size = numElements * m_propertyLength;
+
+    instruction->m_operand = numElements;
+    instruction->m_data = p + sizeof(MlInt);
+    instruction->m_dataLength = size;
+    instruction->m_length = 1 + sizeof(MlInt) + size;
+    return(MLE_DPP_DECODE_OK);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeEncoded(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    MlInt size = 3 * sizeof(MlInt);
+    MlInt numElements,encoding,length,components,expected;
+
+    // The element must be whole 32-bit components.
+    if ((m_propertyLength <= 0) || (m_propertyLength % sizeof(MlInt) != 0))
+        return(MLE_DPP_DECODE_BADLENGTH);
+    if (available < size)
+        return(MLE_DPP_DECODE_TRUNCATED);
+    numElements = readInt(p);
+    encoding = readInt(&p[sizeof(MlInt)]);
+    length = readInt(&p[2 * sizeof(MlInt)]);
+    if ((numElements < 0) || (length < 0))
+        return(MLE_DPP_DECODE_BADLENGTH);
+    if (length > available - size)
+        return(MLE_DPP_DECODE_TRUNCATED);
+
+    // Check the data against the element count; the 16-bit encodings
+    // need exactly two bytes per component.
+    components = m_propertyLength / sizeof(MlInt);
+    switch (encoding)
+    {
+      case halfArrayEncoding:
+      case norm16ArrayEncoding:
+        // The ranges of norm16ArrayEncoding come first.
+        expected = 0;
+        if (encoding == norm16ArrayEncoding)
+        {
+            if (components > length / (MlInt)(2 * sizeof(MlInt)))
+                return(MLE_DPP_DECODE_BADLENGTH);
+            expected = 2 * components * sizeof(MlInt);
+        }
+        if ((numElements > (length - expected) / (2 * components)) ||
+            (length != expected + 2 * components * numElements))
+            return(MLE_DPP_DECODE_BADLENGTH);
+        break;
+
+      case deltaArrayEncoding:
+        if ((components != 1) || (numElements > length))
+            return(MLE_DPP_DECODE_BADLENGTH);
+        break;
+
+      default:
+        return(MLE_DPP_DECODE_BADLENGTH);
+    }
+
+    instruction->m_operand = numElements;
+    instruction->m_count = encoding;
+    instruction->m_data = &p[size];
+    instruction->m_dataLength = length;
+    instruction->m_length = 1 + size + length;
+    return(MLE_DPP_DECODE_OK);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeLayout(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    MlInt numProperties,numBindings,size;
+
+    // The layout, actor class and property count come first, and the
+    // binding count follows the properties.
+    size = 3 * sizeof(MlInt);
+    if (available < size + (MlInt)sizeof(MlInt))
+        return(MLE_DPP_DECODE_TRUNCATED);
+    instruction->m_operand = readInt(p);
+    numProperties = readInt(&p[2 * sizeof(MlInt)]);
+    if ((numProperties < 0) ||
+        (numProperties > (available - size - (MlInt)sizeof(MlInt)) / (MlInt)(2 * sizeof(MlInt))))
+        return(MLE_DPP_DECODE_TRUNCATED);
+
+    // Then the property pairs and the counted binding pairs.
+    size += (2 * numProperties + 1) * sizeof(MlInt);
+    numBindings = readInt(&p[size - sizeof(MlInt)]);
+    if ((numBindings < 0) ||
+        (numBindings > (available - size) / (MlInt)(2 * sizeof(MlInt))))
+        return(MLE_DPP_DECODE_TRUNCATED);
+    size += 2 * numBindings * sizeof(MlInt);
+
+    // The layout itself is handed out as data.
+    instruction->m_data = &p[sizeof(MlInt)];
+    instruction->m_dataLength = size - sizeof(MlInt);
+    instruction->m_length = 1 + size;
+    return(MLE_DPP_DECODE_OK);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeBlock(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    MlInt size = 3 * sizeof(MlInt);
+    MlInt length;
+
+    if (available < size)
+        return(MLE_DPP_DECODE_TRUNCATED);
+    instruction->m_operand = readInt(p);
+    instruction->m_count = readInt(&p[sizeof(MlInt)]);
+    length = readInt(&p[2 * sizeof(MlInt)]);
+    if ((instruction->m_count < 0) || (length < 0))
+        return(MLE_DPP_DECODE_BADLENGTH);
+    if (length > available - size)
+        return(MLE_DPP_DECODE_TRUNCATED);
+
+    // The block leaves the property length undefined.
+    m_propertyLength = -1;
+    instruction->m_data = &p[size];
+    instruction->m_dataLength = length;
+    instruction->m_length = 1 + size + length;
+    return(MLE_DPP_DECODE_OK);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodePool(const MlByte *p,MlInt available,MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    MlInt size = 2 * sizeof(MlInt);
+    MlInt length;
+
+    if (available < size)
+        return(MLE_DPP_DECODE_TRUNCATED);
+    instruction->m_operand = readInt(p);
+    length = readInt(&p[sizeof(MlInt)]);
+    if ((instruction->m_operand < 0) || (length < 0))
+        return(MLE_DPP_DECODE_BADLENGTH);
+    if (length > available - size)
+        return(MLE_DPP_DECODE_TRUNCATED);
+
+    instruction->m_data = &p[size];
+    instruction->m_dataLength = length;
+    instruction->m_length = 1 + size + length;
+    return(MLE_DPP_DECODE_OK);
+}
+
+
+MlInt MleDppOpcodeDecoder::decode(const MlByte *stream,MlInt length,MlInt offset,
+    MleDppOpcodeVisitor *visitor)
+{
+    // Declare local variables.
+    MleDppInstruction instruction;
+    OperandDecoder operands;
+    MlInt status = MLE_DPP_DECODE_OK;
+
+    m_propertyLength = -1;
+    while (offset < length)
+    {
+        instruction.m_opcode = stream[offset];
+        if ((instruction.m_opcode < beginActorSetOpcode) || (instruction.m_opcode > copyEncodedArrayPropertyOpcode) ||
+            ((operands = g_operandDecoders[instruction.m_opcode - beginActorSetOpcode]) == NULL))
+        {
+            status = MLE_DPP_DECODE_BADOPCODE;
+            break;
+        }
+
+        instruction.m_offset = offset;
+        instruction.m_operand = 0;
+        instruction.m_count = 0;
+        instruction.m_data = NULL;
+        instruction.m_dataLength = 0;
+        status = (this->*operands)(&stream[offset + 1],length - offset - 1,&instruction);
+        if (status != MLE_DPP_DECODE_OK)
+            break;
+
+        offset += instruction.m_length;
+        if ((visitor != NULL) && ! visitor->visit(&instruction))
+        {
+            status = MLE_DPP_DECODE_STOPPED;
+            break;
+        }
+        if (instruction.m_opcode == endActorGroupOpcode)
+            break;
+    }
+
+    m_offset = offset;
+    return(status);
+}
+
+
+MlInt MleDppOpcodeDecoder::decodeGroupHeader(const MlByte *stream,MlInt length,
+    MlInt *groupClass,MlInt *numActors)
+{
+    // Declare local variables.
+    MlInt size,hintsLength;
+
+    if (length < (MlInt)sizeof(MlInt))
+        return(-1);
+    *groupClass = readInt(stream);
+    size = sizeof(MlInt);
+
+    // Skip the allocation hints, if there are any.
+    if (*groupClass & groupHintsFlag)
+    {
+        *groupClass &= ~groupHintsFlag;
+        if (length - size < (MlInt)sizeof(MlInt))
+            return(-1);
+        hintsLength = readInt(&stream[size]);
+        size += sizeof(MlInt);
+        if ((hintsLength < 0) || (hintsLength > length - size))
+            return(-1);
+        size += hintsLength;
+    }
+
+    hintsLength = readIndex(&stream[size],length - size,numActors);
+    if (hintsLength < 0)
+        return(-1);
+
+    return(size + hintsLength);
+}
+
+
+void *
+MleDppOpcodeDecoder::operator new(size_t tSize)
+{
+	void *p = mlMalloc(tSize);
+	return p;
+}
+
+void
+MleDppOpcodeDecoder::operator delete(void *p)
+{
+	mlFree(p);
+}
+
+void*
+MleDppOpcodeDecoder::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+void
+MleDppOpcodeDecoder::operator delete[](void* p)
+{
+    mlFree(p);
+}
@@ -0,0 +1,225 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file agdir.cxx
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+
+// Declare system header files.
+#include <stddef.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlMalloc.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agopcode.h"
+#include "mle/agdecode.h"
+#include "mle/agdir.h"
+
+
+MleDppActorDirectory::MleDppActorDirectory(const MlByte *chunk,MlInt length,MlBoolean isLittle)
+{
+    // Declare local variables.
+    MlInt trailerSize = 3 * sizeof(MlInt);
+    MlInt numActors;
+
+    m_chunk = chunk;
+    m_directory = NULL;
+    m_numActors = 0;
+    m_actorsEnd = m_streamEnd = 0;
+    m_littleEndian = isLittle;
+
+    // The trailer follows at least the group class and endActorGroupOpcode.
+    if ((chunk == NULL) || (length < (MlInt)sizeof(MlInt) + 1 + trailerSize))
+        return;
+    if (getInt(&chunk[length - sizeof(MlInt)]) != actorDirectoryTag)
+        return;
+
+    numActors = getInt(&chunk[length - 2 * sizeof(MlInt)]);
+    if ((numActors < 0) ||
+        (numActors > (length - trailerSize) / (MlInt)(2 * sizeof(MlInt))))
+        return;
+
+    trailerSize += numActors * 2 * sizeof(MlInt);
+    m_streamEnd = length - trailerSize - 1;
+    if ((m_streamEnd < (MlInt)sizeof(MlInt)) || (chunk[m_streamEnd] != endActorGroupOpcode))
+        return;
+
+    m_directory = &chunk[length - trailerSize];
+    m_numActors = numActors;
+    m_actorsEnd = getInt(&m_directory[2 * numActors * sizeof(MlInt)]);
+
+    if (! validate())
+    {
+        m_directory = NULL;
+        m_numActors = 0;
+    }
+}
+
+
+MleDppActorDirectory::~MleDppActorDirectory()
+{
+    // The chunk belongs to the caller.
+}
+
+
+MlInt MleDppActorDirectory::getInt(const MlByte *data)
+{
+    if (m_littleEndian)
+        return(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+    else
+        return((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+}
+
+
+MlBoolean MleDppActorDirectory::validate(void)
+{
+    // Declare local variables.
+    MleDppOpcodeDecoder decoder(m_littleEndian);
+    MlInt i,offset,last,groupClass,count;
+
+    // The actor count of the stream follows the group class and hints.
+    last = decoder.decodeGroupHeader(m_chunk,m_streamEnd,&groupClass,&count);
+    if ((last < 0) || (count != m_numActors))
+        return(FALSE);
+
+    // The actors must be in stream order, each starting with a
+    // createActorOpcode, and end before the endActorGroupOpcode.
+    for (i = 0; i < m_numActors; i++)
+    {
+        offset = getInt(&m_directory[2 * i * sizeof(MlInt)]);
+        if ((offset < last) || (offset >= m_streamEnd) ||
+            (m_chunk[offset] != createActorOpcode))
+            return(FALSE);
+        last = offset + 1;
+    }
+
+    return((m_actorsEnd >= last) && (m_actorsEnd <= m_streamEnd));
+}
+
+
+MlInt MleDppActorDirectory::getGroupClass(void)
+{
+    return((m_directory != NULL) ? (getInt(m_chunk) & ~groupHintsFlag) : -1);
+}
+
+
+MlInt MleDppActorDirectory::getActorClass(MlInt actor)
+{
+    if ((actor < 0) || (actor >= m_numActors))
+        return(-1);
+
+    return(getInt(&m_directory[(2 * actor + 1) * sizeof(MlInt)]));
+}
+
+
+const MlByte *MleDppActorDirectory::getActor(MlInt actor,MlInt *length)
+{
+    // Declare local variables.
+    MlInt start,end;
+
+    if ((actor < 0) || (actor >= m_numActors))
+    {
+        *length = 0;
+        return(NULL);
+    }
+
+    start = getInt(&m_directory[2 * actor * sizeof(MlInt)]);
+    if (actor + 1 < m_numActors)
+        end = getInt(&m_directory[2 * (actor + 1) * sizeof(MlInt)]);
+    else
+        end = m_actorsEnd;
+
+    *length = end - start;
+    return(&m_chunk[start]);
+}
+
+
+const MlByte *MleDppActorDirectory::getAttachments(MlInt *length)
+{
+    if (m_directory == NULL)
+    {
+        *length = 0;
+        return(NULL);
+    }
+
+    *length = m_streamEnd + 1 - m_actorsEnd;
+    return(&m_chunk[m_actorsEnd]);
+}
+
+
+MlBoolean MleDppActorDirectory::decodeActors(const MlInt *actors,MlInt numActors,
+    MleDppActorCallback callback,void *clientData)
+{
+    // Declare local variables.
+    const MlByte *stream;
+    MlInt i,length;
+
+    for (i = 0; i < numActors; i++)
+    {
+        if ((stream = getActor(actors[i],&length)) == NULL)
+            return(FALSE);
+        if (! callback(actors[i],getActorClass(actors[i]),stream,length,clientData))
+            return(FALSE);
+    }
+
+    return(TRUE);
+}
+
+
+void *
+MleDppActorDirectory::operator new(size_t tSize)
+{
+	void *p = mlMalloc(tSize);
+	return p;
+}
+
+void
+MleDppActorDirectory::operator delete(void *p)
+{
+	mlFree(p);
+}
+
+void*
+MleDppActorDirectory::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+void
+MleDppActorDirectory::operator delete[](void* p)
+{
+    mlFree(p);
+}
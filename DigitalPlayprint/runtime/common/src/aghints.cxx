@@ -0,0 +1,389 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file aghints.cxx
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+
+// Declare system header files.
+#include <stddef.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlMalloc.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agopcode.h"
+#include "mle/aghints.h"
+#include "mle/pparena.h"
+
+
+// The largest value an MlInt count may reach.
+#define MAX_COUNT 0x7fffffff
+
+
+MleDppGroupHints::MleDppGroupHints(MlBoolean isLittle)
+{
+    m_littleEndian = isLittle;
+    m_classes = NULL;
+    m_maxClasses = 0;
+    m_runs = NULL;
+    m_maxRuns = 0;
+    m_layouts = NULL;
+    clear();
+}
+
+
+MleDppGroupHints::~MleDppGroupHints()
+{
+    clear();
+}
+
+
+void MleDppGroupHints::clear(void)
+{
+    if (m_classes != NULL)
+        mlFree(m_classes);
+    if (m_runs != NULL)
+        mlFree(m_runs);
+    if (m_layouts != NULL)
+        mlFree(m_layouts);
+    m_classes = m_runs = m_layouts = NULL;
+    m_numClasses = m_maxClasses = 0;
+    m_numRuns = m_maxRuns = 0;
+    m_numLayouts = 0;
+    m_numCreated = 0;
+    m_numDynamic = m_dynamicBytes = 0;
+    m_propertyLength = -1;
+}
+
+
+MlInt MleDppGroupHints::readInt(const MlByte *data)
+{
+    if (m_littleEndian)
+        return(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+    else
+        return((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+}
+
+
+MlBoolean MleDppGroupHints::addActors(MlInt actorClass,MlInt count)
+{
+    // Declare local variables.
+    MlInt i;
+
+    for (i = 0; i < m_numClasses; i++)
+    {
+        if (m_classes[2 * i] == actorClass)
+            break;
+    }
+    if (i == m_numClasses)
+    {
+        if (m_numClasses == m_maxClasses)
+        {
+            // Grow the class table.
+            MlInt *classes = (MlInt *)mlRealloc(m_classes,
+                2 * (m_maxClasses + 8) * sizeof(MlInt));
+            if (classes == NULL)
+                return(FALSE);
+            m_classes = classes;
+            m_maxClasses += 8;
+        }
+        m_classes[2 * i] = actorClass;
+        m_classes[2 * i + 1] = 0;
+        m_numClasses++;
+    }
+
+    if (count > MAX_COUNT - m_classes[2 * i + 1])
+        return(FALSE);
+    m_classes[2 * i + 1] += count;
+    return(TRUE);
+}
+
+
+MlBoolean MleDppGroupHints::addDynamic(MlInt bytes)
+{
+    if ((bytes < 0) || (bytes > MAX_COUNT - m_dynamicBytes))
+        return(FALSE);
+
+    m_numDynamic++;
+    m_dynamicBytes += bytes;
+    return(TRUE);
+}
+
+
+MlBoolean MleDppGroupHints::visit(const MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    MlInt actorClass,count,lo,hi,mid,i;
+
+    actorClass = -1;
+    count = 1;
+    switch (instruction->m_opcode)
+    {
+      case setPropertyLengthOpcode:
+        m_propertyLength = instruction->m_operand;
+        return(TRUE);
+
+      case createActorOpcode:
+        actorClass = instruction->m_operand;
+        break;
+
+      case defineClassLayoutOpcode:
+        m_layouts = (MlInt *)mlRealloc(m_layouts,
+            2 * (m_numLayouts + 1) * sizeof(MlInt));
+        if (m_layouts == NULL)
+            return(FALSE);
+        m_layouts[2 * m_numLayouts] = instruction->m_operand;
+        m_layouts[2 * m_numLayouts + 1] = readInt(instruction->m_data);
+        m_numLayouts++;
+        return(TRUE);
+
+      case createActorBlockOpcode:
+        // The block leaves the property length undefined.
+        m_propertyLength = -1;
+        for (i = m_numLayouts - 1; i >= 0; i--)
+        {
+            if (m_layouts[2 * i] == instruction->m_operand)
+                break;
+        }
+        if (i < 0)
+            return(FALSE);
+        actorClass = m_layouts[2 * i + 1];
+        count = instruction->m_count;
+        if (count == 0)
+            return(TRUE);
+        break;
+
+      case cloneActorOpcode:
+        // Find the run holding the original.
+        if ((instruction->m_operand < 0) || (instruction->m_operand >= m_numCreated))
+            return(FALSE);
+        lo = 0;
+        hi = m_numRuns - 1;
+        while (lo < hi)
+        {
+            mid = (lo + hi + 1) / 2;
+            if (m_runs[2 * mid] <= instruction->m_operand)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        actorClass = m_runs[2 * lo + 1];
+        break;
+
+      case defineStringPoolOpcode:
+        return(m_pool.set(instruction));
+
+      case copyPooledStringOpcode:
+        count = m_pool.getStringLength(instruction->m_operand);
+        if (count < 0)
+            return(FALSE);
+        return(addDynamic(count + 1));
+
+      case copyDynamicPropertyOpcode:
+      case copyArrayPropertyOpcode:
+        return(addDynamic(instruction->m_dataLength));
+
+      case copyEncodedArrayPropertyOpcode:
+        if ((m_propertyLength <= 0) ||
+            (instruction->m_operand > MAX_COUNT / m_propertyLength))
+            return(FALSE);
+        return(addDynamic(instruction->m_operand * m_propertyLength));
+
+      default:
+        return(TRUE);
+    }
+
+    // Count the created actors, and remember their class for clones.
+    if (! addActors(actorClass,count) || (count > MAX_COUNT - m_numCreated))
+        return(FALSE);
+    if ((m_numRuns == 0) || (m_runs[2 * m_numRuns - 1] != actorClass))
+    {
+        if (m_numRuns == m_maxRuns)
+        {
+            // Grow the run table.
+            MlInt *runs = (MlInt *)mlRealloc(m_runs,
+                2 * (2 * m_maxRuns + 16) * sizeof(MlInt));
+            if (runs == NULL)
+                return(FALSE);
+            m_runs = runs;
+            m_maxRuns = 2 * m_maxRuns + 16;
+        }
+        m_runs[2 * m_numRuns] = m_numCreated;
+        m_runs[2 * m_numRuns + 1] = actorClass;
+        m_numRuns++;
+    }
+    m_numCreated += count;
+
+    return(TRUE);
+}
+
+
+MlBoolean MleDppGroupHints::compute(const MlByte *chunk,MlInt length)
+{
+    // Declare local variables.
+    MleDppOpcodeDecoder decoder(m_littleEndian);
+    MlInt start,groupClass,numActors,status;
+
+    clear();
+    if ((start = decoder.decodeGroupHeader(chunk,length,&groupClass,&numActors)) < 0)
+        return(FALSE);
+    status = decoder.decode(chunk,length,start,this);
+
+    // Only the hints are kept.
+    if (m_runs != NULL)
+        mlFree(m_runs);
+    if (m_layouts != NULL)
+        mlFree(m_layouts);
+    m_runs = m_layouts = NULL;
+    m_numRuns = m_maxRuns = m_numLayouts = 0;
+    if (status != MLE_DPP_DECODE_OK)
+    {
+        clear();
+        return(FALSE);
+    }
+
+    return(TRUE);
+}
+
+
+MlBoolean MleDppGroupHints::read(const MlByte *chunk,MlInt length)
+{
+    // Declare local variables.
+    MleDppOpcodeDecoder decoder(m_littleEndian);
+    const MlByte *p;
+    MlInt start,groupClass,numActors,hintsLength,numClasses,i;
+
+    clear();
+    if ((length < (MlInt)sizeof(MlInt)) || ! (readInt(chunk) & groupHintsFlag))
+        return(FALSE);
+    if ((start = decoder.decodeGroupHeader(chunk,length,&groupClass,&numActors)) < 0)
+        return(FALSE);
+
+    // The decoder has checked that the hints lie within the chunk.
+    p = &chunk[sizeof(MlInt)];
+    hintsLength = readInt(p);
+    p += sizeof(MlInt);
+    if (hintsLength < (MlInt)(3 * sizeof(MlInt)))
+        return(FALSE);
+    numClasses = readInt(p);
+    if ((numClasses < 0) ||
+        (numClasses > (hintsLength / (MlInt)sizeof(MlInt) - 3) / 2))
+        return(FALSE);
+
+    for (i = 0; i < numClasses; i++)
+    {
+        if (! addActors(readInt(&p[(2 * i + 1) * sizeof(MlInt)]),
+                readInt(&p[(2 * i + 2) * sizeof(MlInt)])))
+        {
+            clear();
+            return(FALSE);
+        }
+    }
+    m_numDynamic = readInt(&p[(2 * numClasses + 1) * sizeof(MlInt)]);
+    m_dynamicBytes = readInt(&p[(2 * numClasses + 2) * sizeof(MlInt)]);
+    if ((m_numDynamic < 0) || (m_dynamicBytes < 0))
+    {
+        clear();
+        return(FALSE);
+    }
+
+    return(TRUE);
+}
+
+
+MlInt MleDppGroupHints::getActorClass(MlInt i)
+{
+    if ((i < 0) || (i >= m_numClasses))
+        return(-1);
+
+    return(m_classes[2 * i]);
+}
+
+
+MlInt MleDppGroupHints::getNumActors(MlInt i)
+{
+    if ((i < 0) || (i >= m_numClasses))
+        return(-1);
+
+    return(m_classes[2 * i + 1]);
+}
+
+
+MlUInt MleDppGroupHints::getArenaSize(const MlUInt *classSizes,MlInt numClassSizes)
+{
+    // Declare local variables.
+    MlUInt size;
+    MlInt i,actorClass;
+
+    // Each allocation is rounded up to the arena alignment.
+    size = 0;
+    for (i = 0; i < m_numClasses; i++)
+    {
+        actorClass = m_classes[2 * i];
+        if ((actorClass < 0) || (actorClass >= numClassSizes))
+            return(0);
+        size += MleDppArena::alignSize(classSizes[actorClass]) * m_classes[2 * i + 1];
+    }
+    size += m_dynamicBytes + m_numDynamic * (MleDppArena::ALIGNMENT - 1);
+
+    return(size);
+}
+
+
+void *
+MleDppGroupHints::operator new(size_t tSize)
+{
+	void *p = mlMalloc(tSize);
+	return p;
+}
+
+void
+MleDppGroupHints::operator delete(void *p)
+{
+	mlFree(p);
+}
+
+void*
+MleDppGroupHints::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+void
+MleDppGroupHints::operator delete[](void* p)
+{
+    mlFree(p);
+}
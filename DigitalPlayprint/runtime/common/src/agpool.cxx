@@ -0,0 +1,185 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file agpool.cxx
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+
+// Declare system header files.
+#include <stddef.h>
+#include <string.h>
+
+// Include Magic Lantern header files.
+#include "mle/mlMalloc.h"
+
+// Include Magic Lantern Digital Playprint header files.
+#include "mle/agopcode.h"
+#include "mle/agpool.h"
+
+
+// Hands the first instruction after the group header to a pool.
+class MleDppStringPoolReader : public MleDppOpcodeVisitor
+{
+  public:
+
+    MleDppStringPoolReader(MleDppStringPool *pool)
+    { m_pool = pool; m_found = FALSE; }
+
+    virtual MlBoolean visit(const MleDppInstruction *instruction)
+    {
+        if (instruction->m_opcode == defineStringPoolOpcode)
+            m_found = m_pool->set(instruction);
+        return(FALSE);
+    }
+
+    MleDppStringPool *m_pool;
+    MlBoolean m_found;
+};
+
+
+MleDppStringPool::MleDppStringPool(void)
+{
+    m_offsets = NULL;
+    m_numStrings = 0;
+    m_data = NULL;
+}
+
+
+MleDppStringPool::~MleDppStringPool()
+{
+    if (m_offsets != NULL)
+        mlFree(m_offsets);
+}
+
+
+MlBoolean MleDppStringPool::set(const MleDppInstruction *instruction)
+{
+    // Declare local variables.
+    const MlByte *end;
+    MlInt i,numStrings;
+
+    if (m_offsets != NULL)
+        mlFree(m_offsets);
+    m_offsets = NULL;
+    m_numStrings = 0;
+    m_data = NULL;
+
+    if (instruction->m_opcode != defineStringPoolOpcode)
+        return(FALSE);
+    numStrings = instruction->m_operand;
+    if ((numStrings < 0) || (numStrings > instruction->m_dataLength))
+        return(FALSE);
+
+    // Find where each string starts; each must end within the data.
+    m_offsets = (MlInt *)mlMalloc((numStrings + 1) * sizeof(MlInt));
+    if (m_offsets == NULL)
+        return(FALSE);
+    m_offsets[0] = 0;
+    for (i = 0; i < numStrings; i++)
+    {
+        end = (const MlByte *)memchr(&instruction->m_data[m_offsets[i]],0,
+            instruction->m_dataLength - m_offsets[i]);
+        if (end == NULL)
+        {
+            mlFree(m_offsets);
+            m_offsets = NULL;
+            return(FALSE);
+        }
+        m_offsets[i + 1] = end + 1 - instruction->m_data;
+    }
+
+    m_numStrings = numStrings;
+    m_data = instruction->m_data;
+    return(TRUE);
+}
+
+
+MlBoolean MleDppStringPool::read(const MlByte *chunk,MlInt length,MlBoolean isLittle)
+{
+    // Declare local variables.
+    MleDppOpcodeDecoder decoder(isLittle);
+    MleDppStringPoolReader reader(this);
+    MlInt start,groupClass,numActors;
+
+    if ((start = decoder.decodeGroupHeader(chunk,length,&groupClass,&numActors)) < 0)
+        return(FALSE);
+    decoder.decode(chunk,length,start,&reader);
+
+    return(reader.m_found);
+}
+
+
+const char *MleDppStringPool::getString(MlInt string)
+{
+    if ((string < 0) || (string >= m_numStrings))
+        return(NULL);
+
+    return((const char *)&m_data[m_offsets[string]]);
+}
+
+
+MlInt MleDppStringPool::getStringLength(MlInt string)
+{
+    if ((string < 0) || (string >= m_numStrings))
+        return(-1);
+
+    return(m_offsets[string + 1] - m_offsets[string] - 1);
+}
+
+
+void *
+MleDppStringPool::operator new(size_t tSize)
+{
+	void *p = mlMalloc(tSize);
+	return p;
+}
+
+void
+MleDppStringPool::operator delete(void *p)
+{
+	mlFree(p);
+}
+
+void*
+MleDppStringPool::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+void
+MleDppStringPool::operator delete[](void* p)
+{
+    mlFree(p);
+}
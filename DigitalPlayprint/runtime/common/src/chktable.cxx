@@ -105,6 +105,8 @@ void MleDppChunkTable::addEntry(
 	m_tbl[m_used].m_name = strdup(name);
 #endif
     m_tbl[m_used].m_offset = offset;
+    m_tbl[m_used].m_size = 0;
+    m_tbl[m_used].m_tag = 0;
 
     m_used++;
 }
@@ -117,6 +119,26 @@ void MleDppChunkTable::setOffset(int index, MlUInt offset)
     }
 }
 
+MlUInt MleDppChunkTable::getSize(MlInt index)
+{
+    return index >= m_used? 0 : m_tbl[index].m_size;
+}
+
+MlUInt MleDppChunkTable::getTag(MlInt index)
+{
+    return index >= m_used? 0 : m_tbl[index].m_tag;
+}
+
+void MleDppChunkTable::setLocation(int index, MlUInt offset, MlUInt size, MlUInt tag)
+{
+    if ( index < m_used )
+	{
+		m_tbl[index].m_offset = offset;
+		m_tbl[index].m_size = size;
+		m_tbl[index].m_tag = tag;
+    }
+}
+
   
 /*
  * Extend the dynamic array of chunks.
@@ -120,9 +120,8 @@ MleMrefChunkFile::readInfo(MleMediaRefInfoChunk *chunkData)
 
             if (getSwapRead())
 			{
-                chunkData->m_flags = mlDppSwapInt(chunkData->m_flags);
-                chunkData->m_type = mlDppSwapInt(chunkData->m_type);
-                chunkData->m_numMrefs = mlDppSwapInt(chunkData->m_numMrefs);
+                // Swap m_flags, m_type and m_numMrefs.
+                mlDppSwapIntArray((MlUInt *)chunkData,3);
             }
         }
 
@@ -150,9 +149,8 @@ MleMrefChunkFile::writeInfo(MleMediaRefInfoChunk *chunkData)
 
         if (getSwapWrite())
 		{
-            chunkData->m_flags = mlDppSwapInt(chunkData->m_flags);
-            chunkData->m_type = mlDppSwapInt(chunkData->m_type);
-            chunkData->m_numMrefs = mlDppSwapInt(chunkData->m_numMrefs);
+            // Swap m_flags, m_type and m_numMrefs.
+            mlDppSwapIntArray((MlUInt *)chunkData,3);
         }
 
         // Write out 'mref' data.
@@ -190,9 +188,8 @@ MleMrefChunkFile::readData(MleMediaRefChunk *chunkData)
 
             if (getSwapRead())
 			{
-                chunkData->m_flags = mlDppSwapInt(chunkData->m_flags);
-                chunkData->m_type = mlDppSwapInt(chunkData->m_type);
-                chunkData->m_size = mlDppSwapInt(chunkData->m_size);
+                // Swap m_flags, m_type and m_size.
+                mlDppSwapIntArray((MlUInt *)chunkData,3);
             }
 
 			// The extra byte is for the string terminator. This will only
@@ -210,6 +207,41 @@ MleMrefChunkFile::readData(MleMediaRefChunk *chunkData)
 }
 
 
+MlBoolean
+MleMrefChunkFile::openData(MleMediaRefStream *stream)
+{
+    // Declare local variables.
+    MleDppChunkInfo mediaInfo;
+    MleMediaRefChunk chunkData;
+    MlBoolean status = FALSE;
+
+    if (m_mode == READING)
+	{
+        memset(&mediaInfo,0,sizeof(MleDppChunkInfo));
+
+        MLE_ERROR(mlDppDescend(getFp(),&mediaInfo,NULL,0));
+        if (mediaInfo.m_chunk.m_tag == mlDppMakeTag('m','r','e','f'))
+		{
+            // Read the 'mref' header only; the payload stays in the file.
+            if (mlFRead(&chunkData,MEDIAREF_CHUNK_SIZE,1,getFp()) == 1)
+			{
+                if (getSwapRead())
+                    mlDppSwapIntArray((MlUInt *)&chunkData,3);
+
+                stream->init(getFp(),chunkData.m_flags,chunkData.m_type,
+                    mediaInfo.m_offset + MEDIAREF_CHUNK_SIZE,chunkData.m_size);
+                status = TRUE;
+            } else
+                mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+        }
+
+        MLE_ERROR(mlDppAscend(getFp(),&mediaInfo,0));
+    }
+
+    return(status);
+}
+
+
 MlBoolean
 MleMrefChunkFile::writeData(MleMediaRefChunk *chunkData)
 {
@@ -231,9 +263,8 @@ MleMrefChunkFile::writeData(MleMediaRefChunk *chunkData)
 
         if (getSwapWrite())
 		{
-            chunkData->m_flags = mlDppSwapInt(chunkData->m_flags);
-            chunkData->m_type = mlDppSwapInt(chunkData->m_type);
-            chunkData->m_size = mlDppSwapInt(chunkData->m_size);
+            // Swap m_flags, m_type and m_size.
+            mlDppSwapIntArray((MlUInt *)chunkData,3);
         }
 
         // Write out 'mref' data
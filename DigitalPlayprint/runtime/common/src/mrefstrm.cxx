@@ -0,0 +1,178 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file mrefstrm.cxx
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+
+// Include Magic Lantern header files.
+#include "mle/mlFileio.h"
+#include "mle/mlMalloc.h"
+#include "mle/mlErrno.h"
+
+// Include Digital Playprint header files.
+#include "mle/mrefstrm.h"
+
+
+MleMediaRefStream::MleMediaRefStream(void)
+{
+    m_fp = NULL;
+    m_flags = 0;
+    m_type = 0;
+    m_offset = 0;
+    m_size = 0;
+}
+
+
+MleMediaRefStream::~MleMediaRefStream(void)
+{
+}
+
+
+void
+MleMediaRefStream::init(FILE *fp,MlUInt flags,MlDppTag type,MlUInt offset,MlUInt size)
+{
+    m_fp = fp;
+    m_flags = flags;
+    m_type = type;
+    m_offset = offset;
+    m_size = size;
+}
+
+
+MlInt
+MleMediaRefStream::read(MlUInt offset,void *buffer,MlUInt length)
+{
+    // Declare local variables.
+    long pos;
+    size_t nBytes;
+
+    if ((m_fp == NULL) || (buffer == NULL))
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+        return(-1);
+    }
+
+    // Clip the range to the payload.
+    if (offset >= m_size)
+        return(0);
+    if (length > m_size - offset)
+        length = m_size - offset;
+
+    pos = mlFTell(m_fp);
+    if (mlFSeek(m_fp,m_offset + offset,SEEK_SET) != 0)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTSEEK);
+        return(-1);
+    }
+    nBytes = mlFRead(buffer,1,length,m_fp);
+    mlFSeek(m_fp,pos,SEEK_SET);
+
+    if (nBytes != length)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+        return(-1);
+    }
+
+    return((MlInt)nBytes);
+}
+
+
+int
+MleMediaRefStream::readSlices(MlUInt sliceSize,void *buffer,
+    MleDppCallback func,void *clientData)
+{
+    // Declare local variables.
+    MleMediaRefSlice slice;
+    void *sliceBuffer = buffer;
+    MlInt nBytes;
+    int status = TRUE;
+
+    if ((sliceSize == 0) || (func == NULL))
+        return(FALSE);
+
+    if (sliceBuffer == NULL)
+	{
+        // One slice worth of memory, reused for every slice.
+        sliceBuffer = mlMalloc(sliceSize);
+        if (sliceBuffer == NULL)
+            return(FALSE);
+    }
+
+    for (slice.m_offset = 0; status && (slice.m_offset < m_size); slice.m_offset += sliceSize)
+	{
+        nBytes = read(slice.m_offset,sliceBuffer,sliceSize);
+        if (nBytes <= 0)
+		{
+            status = FALSE;
+            break;
+        }
+
+        slice.m_size = (MlUInt)nBytes;
+        slice.m_data = sliceBuffer;
+        status = func(clientData,(void *)&slice);
+    }
+
+    if (buffer == NULL)
+        mlFree(sliceBuffer);
+
+    return(status);
+}
+
+
+void *
+MleMediaRefStream::operator new(size_t tSize)
+{
+	void *p = mlMalloc(tSize);
+	return p;
+}
+
+void
+MleMediaRefStream::operator delete(void *p)
+{
+	mlFree(p);
+}
+
+void*
+MleMediaRefStream::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+void
+MleMediaRefStream::operator delete[](void* p)
+{
+    mlFree(p);
+}
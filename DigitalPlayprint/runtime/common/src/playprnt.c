@@ -61,8 +61,24 @@
 #include <sys/stat.h>
 #endif
 
-static int _mlSwapRead = 0;
-static int _mlSwapWrite = 0;
+/*
+ * The swap flags count the chunk files that want swapping. Tools may write
+ * chunk files from several threads, always in the same byte order, so the
+ * counts are kept with atomic operations.
+ */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define _mlAtomicAdd(count,n) _InterlockedExchangeAdd(count,n)
+#define _mlAtomicGet(count) _InterlockedOr(count,0)
+typedef long _MlSwapCount;
+#else
+#define _mlAtomicAdd(count,n) __atomic_fetch_add(count,n,__ATOMIC_SEQ_CST)
+#define _mlAtomicGet(count) __atomic_load_n(count,__ATOMIC_SEQ_CST)
+typedef int _MlSwapCount;
+#endif
+
+static _MlSwapCount _mlSwapRead = 0;
+static _MlSwapCount _mlSwapWrite = 0;
 
 
 MlULong mlDppSwapLong(MlULong x)
@@ -89,24 +105,24 @@ MlUShort mlDppSwapShort(MlUShort x)
 void mlDppSetSwapRead(MlBoolean flag)
 {
     if (flag == TRUE)
-        _mlSwapRead++;
+        _mlAtomicAdd(&_mlSwapRead,1);
     else
-        _mlSwapRead--;
+        _mlAtomicAdd(&_mlSwapRead,-1);
 }
 
 
 void mlDppSetSwapWrite(MlBoolean flag)
 {
     if (flag == TRUE)
-        _mlSwapWrite++;
+        _mlAtomicAdd(&_mlSwapWrite,1);
     else
-        _mlSwapWrite--;
+        _mlAtomicAdd(&_mlSwapWrite,-1);
 }
 
 
 MlBoolean mlDppGetSwapRead()
 {
-    if (_mlSwapRead > 0)
+    if (_mlAtomicGet(&_mlSwapRead) > 0)
         return(TRUE);
     else
         return(FALSE);
@@ -115,7 +131,7 @@ MlBoolean mlDppGetSwapRead()
 
 MlBoolean mlDppGetSwapWrite()
 {
-    if (_mlSwapWrite > 0)
+    if (_mlAtomicGet(&_mlSwapWrite) > 0)
         return(TRUE);
     else
         return(FALSE);
@@ -720,6 +736,8 @@ main(int argc,char *argv[])
     hdrData.m_version = 1;
     dateStamp = time(NULL);
     hdrData.m_date = dateStamp;
+    hdrData.m_alignment = 0;
+    hdrData.m_contentHash = 0;
     if (mlFWrite(&hdrData,sizeof(hdrData),1,fp) != 1)
 	{
         mlFClose(fp);
@@ -39,6 +39,7 @@
 // COPYRIGHT_END
 
 // Include system header files.
+#include <stddef.h>
 #include <string.h>
 
 // Include Magic Lantern header files.
@@ -54,9 +55,16 @@ MleDpp::MleDpp(const char *filename,Mode flags)
      m_swapRead(FALSE),
      m_swapWrite(FALSE),
      m_useTOC(FALSE),
-     m_TOC(NULL),
      m_numTOCReserved(0),
-     m_numTOCUsed(0)
+     m_numTOCUsed(0),
+     m_TOC(NULL),
+     m_tocEntry(NULL),
+     m_contentHash(0),
+     m_manifestOffset(0),
+     m_manifestSize(0),
+     m_tocSlot(-1),
+     m_hashContent(FALSE),
+     m_hdrOffset(0)
 {
     // Initialize Playprint book keeping structures.
     memset(&m_formInfo,0,sizeof(MleDppChunkInfo));
@@ -72,6 +80,22 @@ MleDpp::MleDpp(const char *filename,Mode flags)
 
 MleDpp::~MleDpp(void)
 {
+    // Declare local variables.
+    MleDppTOC *nextEntry;
+
+    // Release the table-of-contents. Names are only owned when writing;
+    // a reader's names point into its index.
+    while (m_TOC != NULL)
+	{
+        nextEntry = m_TOC->m_next;
+        if ((m_mode == WRITING) && (m_TOC->m_name != NULL))
+            mlFree((void *)m_TOC->m_name);
+        mlFree(m_TOC);
+        m_TOC = nextEntry;
+    }
+    if (m_tocEntry != NULL)
+        mlFree(m_tocEntry);
+
     // Reset low-level Playprint swap flags.
     //setSwap(FALSE);
 	if (getSwapRead()) setSwapRead(FALSE);
@@ -138,15 +162,23 @@ MlBoolean MleDpp::readHeader(MleDppHeader *chunkData)
         MLE_ERROR(mlDppDescend(getFp(),&hdrInfo,NULL,0));
         if (hdrInfo.m_chunk.m_tag == mlDppMakeTag('h','d','r',' '))
 		{
-            // Read the chunk file header.
+            // Read the chunk file header. Older Playprints have a shorter
+            // header, so the fields they lack are left zero.
         	size_t nBytes;
-            nBytes = mlFRead(chunkData,hdrInfo.m_chunk.m_size,1,getFp());
+            MlUInt size = hdrInfo.m_chunk.m_size;
+            if (size > sizeof(MleDppHeader))
+                size = sizeof(MleDppHeader);
+            memset(chunkData,0,sizeof(MleDppHeader));
+            nBytes = mlFRead(chunkData,size,1,getFp());
 
             if (m_swapRead)
 			{
                 chunkData->m_version = mlDppSwapInt(chunkData->m_version);
                 chunkData->m_date = mlDppSwapInt(chunkData->m_date);
+                chunkData->m_alignment = mlDppSwapInt(chunkData->m_alignment);
+                chunkData->m_contentHash = mlDppSwapInt(chunkData->m_contentHash);
             }
+            m_contentHash = chunkData->m_contentHash;
         }
 
         MLE_ERROR(mlDppAscend(getFp(),&hdrInfo,0));
@@ -161,27 +193,42 @@ MlBoolean MleDpp::writeHeader(MleDppHeader *chunkData)
     // Declare local variables.
     MleDppChunkInfo hdrInfo;
     MleDppHeader hdrData;
+    MlUInt hdrSize;
 
     if (m_mode == WRITING)
 	{
         memset(&hdrInfo,0,sizeof(MleDppChunkInfo));
 
+        // Version 1 readers read the whole 'hdr ' chunk into the original
+        // two-field header, so the longer header is only written when
+        // alignment or a content hash needs it.
+        if ((chunkData->m_alignment != 0) || m_hashContent)
+            hdrSize = sizeof(MleDppHeader);
+        else
+            hdrSize = offsetof(MleDppHeader,m_alignment);
+
         // Write header chunk structure.
         hdrInfo.m_chunk.m_tag = mlDppMakeTag('h','d','r',' ');
-        hdrInfo.m_chunk.m_size = sizeof(MleDppHeader);
+        hdrInfo.m_chunk.m_size = hdrSize;
         MLE_WARN(mlDppCreateChunk(getFp(),&hdrInfo,0));
 
         // Process header data.
         hdrData.m_version = chunkData->m_version;
         hdrData.m_date = chunkData->m_date;
+        hdrData.m_alignment = chunkData->m_alignment;
+        hdrData.m_contentHash = chunkData->m_contentHash;
+        if (hdrSize == sizeof(MleDppHeader))
+            m_hdrOffset = hdrInfo.m_offset;
 
         if (m_swapWrite)
 		{
             hdrData.m_version = mlDppSwapInt(hdrData.m_version);
             hdrData.m_date = mlDppSwapInt(hdrData.m_date);
+            hdrData.m_alignment = mlDppSwapInt(hdrData.m_alignment);
+            hdrData.m_contentHash = mlDppSwapInt(hdrData.m_contentHash);
         }
 
-        if (mlFWrite(&hdrData,sizeof(hdrData),1,getFp()) != 1)
+        if (mlFWrite(&hdrData,hdrSize,1,getFp()) != 1)
 		{
             mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
             return(FALSE);
@@ -193,6 +240,52 @@ MlBoolean MleDpp::writeHeader(MleDppHeader *chunkData)
 }
 
 
+MlBoolean MleDpp::writeContentHash(void)
+{
+    // Declare local variables.
+    MlByte buffer[4096];
+    MlUInt hash = 2166136261U;
+    MlUInt value;
+    size_t num,i;
+
+    if ((m_mode != WRITING) || (m_hdrOffset == 0))
+        return(FALSE);
+
+    // 32-bit FNV-1a over the whole file, taken while the hash field in
+    // the header is still zero.
+    mlFFlush(m_fp);
+    if (mlFSeek(m_fp,0,SEEK_SET) != 0)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+        return(FALSE);
+    }
+    while ((num = mlFRead(buffer,1,sizeof(buffer),m_fp)) > 0)
+	{
+        for (i = 0; i < num; i++)
+		{
+            hash ^= buffer[i];
+            hash *= 16777619U;
+        }
+    }
+
+    // Zero means the Playprint was never sealed.
+    if (hash == 0)
+        hash = 1;
+    m_contentHash = hash;
+
+    value = m_swapWrite ? mlDppSwapInt(hash) : hash;
+    if ((mlFSeek(m_fp,m_hdrOffset + offsetof(MleDppHeader,m_contentHash),SEEK_SET) != 0) ||
+        (mlFWrite(&value,sizeof(MlUInt),1,m_fp) != 1))
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        return(FALSE);
+    }
+    mlFFlush(m_fp);
+
+    return(TRUE);
+}
+
+
 MlBoolean MleDpp::beginTOC(int num)
 {
     // Declare local variables.
@@ -202,6 +295,13 @@ MlBoolean MleDpp::beginTOC(int num)
 
     MLE_ASSERT(num >= 0);
 
+    // Entries are looked up by index through a table beside the list.
+    if ((m_mode == READING) || (m_mode == WRITING))
+	{
+        if (! allocTOCEntries(num))
+            return(FALSE);
+    }
+
     if (m_mode == READING)
 	{
 
@@ -232,12 +332,96 @@ MlBoolean MleDpp::beginTOC(int num)
         m_numTOCReserved = num;
         m_useTOC = TRUE;
 
+        if (! mlDppAscend(m_fp,&tocInfo,0))
+            return(FALSE);
+
+        // Reserve the named index right after the table-of-contents;
+        // its size depends only on the number of entries.
+        memset(&tocInfo,0,sizeof(MleDppChunkInfo));
+        tocInfo.m_chunk.m_tag = mlDppMakeTag('t','o','c','x');
+        tocInfo.m_chunk.m_size = getTOCIndexSize(num);
+        MLE_WARN(mlDppCreateChunk(m_fp,&tocInfo,0));
+
+        for (MlUInt i = 0; i < tocInfo.m_chunk.m_size; i++)
+		{
+            if (mlFWrite(&byte,sizeof(MlByte),1,m_fp) != 1)
+			{
+                mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+                return(FALSE);
+            }
+        }
+
         return(mlDppAscend(m_fp,&tocInfo,0));
     } else
         return(TRUE);
 }
 
 
+MlBoolean MleDpp::allocTOCEntries(MlUInt num)
+{
+    // Declare local variables.
+    MleDppTOC **table,*nextEntry;
+    MlUInt i;
+
+    if (num < m_numTOCUsed)
+        return(FALSE);
+
+    table = (MleDppTOC **)mlMalloc(sizeof(MleDppTOC *) * ((num > 0) ? num : 1));
+    if (table == NULL)
+        return(FALSE);
+
+    // Carry over any entries already on the list.
+    nextEntry = m_TOC;
+    for (i = 0; i < m_numTOCUsed; i++, nextEntry = nextEntry->m_next)
+        table[i] = nextEntry;
+
+    if (m_tocEntry != NULL)
+        mlFree(m_tocEntry);
+    m_tocEntry = table;
+    return(TRUE);
+}
+
+
+MlUInt MleDpp::getTOCBuckets(MlUInt num)
+{
+    // Declare local variables.
+    MlUInt numBuckets = 1;
+
+    // Keep the table at most half full so probe sequences stay short.
+    while (numBuckets < 2 * num)
+        numBuckets <<= 1;
+
+    return(numBuckets);
+}
+
+
+MlUInt MleDpp::getTOCIndexSize(MlUInt num)
+{
+    return(sizeof(MleDppTocIndexHeader) + sizeof(MleDppTocIndexEntry) * num +
+           sizeof(MlUInt) * getTOCBuckets(num));
+}
+
+
+MlDppQuark MleDpp::getQuark(const char *name)
+{
+    // Declare local variables.
+    MlUInt hash = 2166136261U;
+
+    // 32-bit FNV-1a.
+    while (*name != '\0')
+	{
+        hash ^= (MlByte)*name++;
+        hash *= 16777619U;
+    }
+
+    // Zero is reserved for unlabelled entries.
+    if (hash == 0)
+        hash = 1;
+
+    return((MlDppQuark)hash);
+}
+
+
 MlBoolean MleDpp::addTOCEntry(MlDppQuark label,MlUInt offset)
 {
     /* Declare local variables */
@@ -253,7 +437,17 @@ MlBoolean MleDpp::addTOCEntry(MlDppQuark label,MlUInt offset)
             return(FALSE);
         }
 
-        if (m_numTOCUsed == m_numTOCReserved)
+        if (m_tocSlot >= 0)
+		{
+            // Fill in the entry set aside by setTOCIndex().
+            nextEntry = m_tocEntry[m_tocSlot];
+            nextEntry->m_entry.m_label = label;
+            nextEntry->m_entry.m_offset = offset;
+            m_tocSlot = -1;
+            return(TRUE);
+        }
+
+        if ((m_numTOCUsed == m_numTOCReserved) || (m_tocEntry == NULL))
 		{
             // XXX -- should set mlErrno here.
             return(FALSE);
@@ -265,20 +459,21 @@ MlBoolean MleDpp::addTOCEntry(MlDppQuark label,MlUInt offset)
             // Add new entry to table of contents.
             newEntry->m_entry.m_label = label;
             newEntry->m_entry.m_offset = offset;
+            newEntry->m_type = 0;
+            newEntry->m_size = 0;
+            newEntry->m_name = NULL;
             newEntry->m_next = NULL;
 
-            nextEntry = m_TOC;
-            if (! nextEntry)
+            if (m_numTOCUsed == 0)
 			{
                 // First entry on the list.
                 m_TOC = newEntry;
             } else {
                 // Add entry to end of list.
-                while (nextEntry->m_next != NULL)
-                    nextEntry = nextEntry->m_next;
-                nextEntry->m_next = newEntry;
+                m_tocEntry[m_numTOCUsed - 1]->m_next = newEntry;
             }
 
+            m_tocEntry[m_numTOCUsed] = newEntry;
             m_numTOCUsed++;
         } else
             // XXX -- should set mlErrno here.
@@ -290,14 +485,231 @@ MlBoolean MleDpp::addTOCEntry(MlDppQuark label,MlUInt offset)
 }
 
 
+MlBoolean MleDpp::setTOCIndex(MlUInt index)
+{
+    if ((m_mode != WRITING) || ! m_useTOC || (index >= m_numTOCReserved))
+        return(FALSE);
+
+    // Set aside every reserved entry, so that they can be filled in
+    // any order.
+    while (m_numTOCUsed < m_numTOCReserved)
+	{
+        if (! addTOCEntry((MlDppQuark) 0,0))
+            return(FALSE);
+    }
+
+    m_tocSlot = index;
+    return(TRUE);
+}
+
+
+MlInt MleDpp::reserveTOCEntry(void)
+{
+    // Declare local variables.
+    MlInt index;
+
+    if ((m_mode != WRITING) || ! m_useTOC)
+        return(-1);
+
+    // Take the entry set aside by setTOCIndex(), or add a blank one.
+    if (m_tocSlot >= 0)
+	{
+        index = m_tocSlot;
+        m_tocSlot = -1;
+    } else {
+        index = m_numTOCUsed;
+        if (! addTOCEntry((MlDppQuark) 0,0))
+            return(-1);
+    }
+
+    return(index);
+}
+
+
+MlBoolean MleDpp::setTOCEntry(MlUInt index,const char *name,MlDppTag type,
+    MlUInt offset,MlUInt size)
+{
+    // Declare local variables.
+    MleDppTOC *entry;
+    char *copy = NULL;
+
+    if ((m_mode != WRITING) || (m_tocEntry == NULL) || (index >= m_numTOCUsed))
+        return(FALSE);
+
+    if (name != NULL)
+	{
+        copy = (char *)mlMalloc(strlen(name) + 1);
+        if (copy == NULL)
+            return(FALSE);
+        strcpy(copy,name);
+    }
+
+    entry = m_tocEntry[index];
+    entry->m_entry.m_label = (name != NULL) ? getQuark(name) : 0;
+    entry->m_entry.m_offset = offset;
+    entry->m_type = type;
+    entry->m_size = size;
+    if (entry->m_name != NULL)
+        mlFree((char *)entry->m_name);
+    entry->m_name = copy;
+
+    return(TRUE);
+}
+
+
+MlBoolean MleDpp::addTOCEntry(const char *name,MlDppTag type,MlUInt offset,MlUInt size)
+{
+    // Declare local variables.
+    MlInt index;
+
+    index = reserveTOCEntry();
+    if (index < 0)
+        return(FALSE);
+
+    return(setTOCEntry(index,name,type,offset,size));
+}
+
+
+MlBoolean MleDpp::writeTOCNames(MlUInt *namesOffset,MlUInt *namesSize)
+{
+    // Declare local variables.
+    MleDppChunkInfo info;
+    MleDppTOC *nextEntry;
+    MlBoolean retValue = TRUE;
+
+    *namesOffset = 0;
+    *namesSize = 0;
+    for (nextEntry = m_TOC; nextEntry != NULL; nextEntry = nextEntry->m_next)
+	{
+        if (nextEntry->m_name != NULL)
+            *namesSize += strlen(nextEntry->m_name) + 1;
+    }
+    if (*namesSize == 0)
+        return(TRUE);
+
+    // Write the names, NUL-terminated and in table-of-contents order.
+    memset(&info,0,sizeof(MleDppChunkInfo));
+    info.m_chunk.m_tag = mlDppMakeTag('t','o','c','n');
+    info.m_chunk.m_size = *namesSize;
+    MLE_WARN(mlDppCreateChunk(m_fp,&info,0));
+    *namesOffset = info.m_offset - sizeof(MleDppChunk);
+
+    for (nextEntry = m_TOC; nextEntry != NULL; nextEntry = nextEntry->m_next)
+	{
+        if ((nextEntry->m_name != NULL) &&
+            (mlFWrite(nextEntry->m_name,strlen(nextEntry->m_name) + 1,1,m_fp) != 1))
+		{
+            mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+            retValue = FALSE;
+            break;
+        }
+    }
+
+    MLE_WARN(mlDppAscend(m_fp,&info,0));
+    return(retValue);
+}
+
+
+MlBoolean MleDpp::writeTOCIndex(MlUInt namesOffset,MlUInt namesSize)
+{
+    // Declare local variables.
+    MleDppChunkInfo info;
+    MleDppTocIndexHeader *header;
+    MleDppTocIndexEntry *entries;
+    MleDppTOC *nextEntry;
+    MlUInt *indexData,*buckets;
+    MlUInt numBuckets,indexSize,offset,i,h;
+    MlBoolean retValue = TRUE;
+
+    numBuckets = getTOCBuckets(m_numTOCReserved);
+    indexSize = getTOCIndexSize(m_numTOCReserved);
+
+    indexData = (MlUInt *)mlMalloc(indexSize);
+    if (indexData == NULL)
+        return(FALSE);
+    memset(indexData,0,indexSize);
+    header = (MleDppTocIndexHeader *)indexData;
+    entries = (MleDppTocIndexEntry *)&header[1];
+    buckets = (MlUInt *)&entries[m_numTOCReserved];
+
+    header->m_numEntries = m_numTOCUsed;
+    header->m_numBuckets = numBuckets;
+    header->m_namesOffset = namesOffset;
+    header->m_namesSize = namesSize;
+    header->m_manifestOffset = m_manifestOffset;
+    header->m_manifestSize = m_manifestSize;
+
+    // Fill in the entries and hash the named ones with linear probing.
+    // The first of several equal names wins.
+    offset = 0;
+    nextEntry = m_TOC;
+    for (i = 0; nextEntry != NULL; i++, nextEntry = nextEntry->m_next)
+	{
+        entries[i].m_label = nextEntry->m_entry.m_label;
+        entries[i].m_type = nextEntry->m_type;
+        entries[i].m_size = nextEntry->m_size;
+        entries[i].m_name = MLE_DPP_TOC_NONAME;
+
+        if (nextEntry->m_name != NULL)
+		{
+            entries[i].m_name = offset;
+            offset += strlen(nextEntry->m_name) + 1;
+
+            h = (MlUInt)nextEntry->m_entry.m_label & (numBuckets - 1);
+            while (buckets[h] != 0)
+                h = (h + 1) & (numBuckets - 1);
+            buckets[h] = i + 1;
+        }
+    }
+
+    // Fill in the reserved 'tocx' chunk.
+    memset(&info,0,sizeof(MleDppChunkInfo));
+    info.m_chunk.m_tag = mlDppMakeTag('t','o','c','x');
+    MLE_WARN(mlDppDescend(m_fp,&info,&m_formInfo,MLE_DPP_FINDCHUNK));
+
+    if (m_swapWrite)
+        mlDppSwapIntArray(indexData,indexSize / sizeof(MlUInt));
+    if (mlFWrite(indexData,indexSize,1,m_fp) != 1)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        retValue = FALSE;
+    }
+    mlFree(indexData);
+
+    MLE_WARN(mlDppAscend(m_fp,&info,0));
+    return(retValue);
+}
+
+
+MlBoolean MleDpp::getTOCEntry(MlUInt index,MlUInt *offset,MlUInt *size,MlDppTag *type)
+{
+    // Declare local variables.
+    MleDppTOC *nextEntry;
+
+    if ((m_tocEntry == NULL) || (index >= m_numTOCUsed))
+        return(FALSE);
+    nextEntry = m_tocEntry[index];
+
+    if (offset != NULL)
+        *offset = nextEntry->m_entry.m_offset;
+    if (size != NULL)
+        *size = nextEntry->m_size;
+    if (type != NULL)
+        *type = nextEntry->m_type;
+
+    return(TRUE);
+}
+
+
 MlBoolean MleDpp::endTOC()
 {
     /* Declare local variables. */
     MleDppChunkInfo tocInfo;
-    MlInt longWrite;
+    MlUInt *tocData;
     MleDppTOC *nextEntry;
+    MlUInt namesOffset,namesSize;
     MlBoolean retValue = TRUE;
-    int num;
+    int i,num;
 
     if (m_mode == WRITING)
 	{
@@ -306,43 +718,53 @@ MlBoolean MleDpp::endTOC()
 		{
             // XXX -- should set mlErrno here.
             return(FALSE);
-        } else
-		{
-            // Wrap-up Playprint book keeping.
-            mlDppAscend(m_fp,&m_formInfo,0);
         }
 
+        // The name pool goes at the end of the form.
+        if (! writeTOCNames(&namesOffset,&namesSize))
+            retValue = FALSE;
+
+        // Wrap-up Playprint book keeping.
+        mlDppAscend(m_fp,&m_formInfo,0);
+
         // Initialize table-of-contents chunk info.
         memset(&tocInfo,0,sizeof(MleDppChunkInfo));
 
         tocInfo.m_chunk.m_tag = mlDppMakeTag('t','o','c',' ');
         MLE_WARN(mlDppDescend(m_fp,&tocInfo,&m_formInfo,MLE_DPP_FINDCHUNK));
 
-        // Write TOC data.
-        longWrite = m_numTOCUsed;
-        if (m_swapWrite)
-            longWrite = mlDppSwapInt(longWrite);
-        num = mlFWrite(&longWrite,sizeof(MlInt),1,m_fp);
+        // Gather the TOC data (count followed by label/offset pairs) so
+        // that it can be byte swapped and written as one block.
+        tocData = (MlUInt *)mlMalloc(sizeof(MlUInt) * (1 + 2 * m_numTOCUsed));
+        if (tocData == NULL)
+            return(FALSE);
 
+        tocData[0] = m_numTOCUsed;
         nextEntry = m_TOC;
-        while (nextEntry)
+        for (i = 1; nextEntry != NULL; nextEntry = nextEntry->m_next)
 		{
-            // Write label for TOC entry.
-            longWrite = nextEntry->m_entry.m_label;
-            if (m_swapWrite)
-                longWrite = mlDppSwapInt(longWrite);
-            num = mlFWrite(&longWrite,sizeof(MlInt),1,m_fp);
-            // Write offset for TOC entry.
-            longWrite = nextEntry->m_entry.m_offset;
-            if (m_swapWrite)
-                longWrite = mlDppSwapInt(longWrite);
-            num = mlFWrite(&longWrite,sizeof(MlInt),1,m_fp);
-            nextEntry = nextEntry->m_next;
+            tocData[i++] = nextEntry->m_entry.m_label;
+            tocData[i++] = nextEntry->m_entry.m_offset;
         }
 
-        mlFFlush(m_fp);
+        // Write TOC data.
+        if (m_swapWrite)
+            mlDppSwapIntArray(tocData,1 + 2 * m_numTOCUsed);
+        num = mlFWrite(tocData,sizeof(MlUInt) * (1 + 2 * m_numTOCUsed),1,m_fp);
+        if (num != 1)
+		{
+            mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+            retValue = FALSE;
+        }
+        mlFree(tocData);
 
         MLE_WARN(mlDppAscend(m_fp,&tocInfo,0));
+
+        // Fill in the named index next to it.
+        if (! writeTOCIndex(namesOffset,namesSize))
+            retValue = FALSE;
+
+        mlFFlush(m_fp);
     }
 
     return(retValue);
@@ -396,6 +818,7 @@ void main(int argc,char *argv[])
 
     hdrData.m_version = MleDpp::PLAYPRINT_VERSION;
     hdrData.m_date = timeStamp;
+    hdrData.m_alignment = 0;
 
     // Create Big Endian Playprint.
     out = new MleDpp(TESTBE_FILE,MleDpp::WRITING);
@@ -0,0 +1,123 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file pparena.cxx
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+
+// Declare system header files.
+#include <stddef.h>
+
+// Include Magic Lantern header files.
+#include "mle/pparena.h"
+#include "mle/mlMalloc.h"
+
+
+MleDppArena::MleDppArena(MlUInt capacity)
+{
+    // Over-allocate so the first allocation can be aligned.
+    m_block = (MlByte *)mlMalloc(capacity + ALIGNMENT);
+    m_owned = TRUE;
+    m_capacity = (m_block != NULL) ? capacity : 0;
+    m_base = m_block;
+    if (m_block != NULL)
+        m_base += (ALIGNMENT - ((size_t)m_block & (ALIGNMENT - 1))) & (ALIGNMENT - 1);
+    m_used = m_highWater = 0;
+}
+
+
+MleDppArena::MleDppArena(void *buffer,MlUInt capacity)
+{
+    // Declare local variables.
+    MlUInt skip;
+
+    m_block = (MlByte *)buffer;
+    m_owned = FALSE;
+    skip = (ALIGNMENT - ((size_t)m_block & (ALIGNMENT - 1))) & (ALIGNMENT - 1);
+    m_base = m_block + skip;
+    m_capacity = ((buffer != NULL) && (capacity > skip)) ? capacity - skip : 0;
+    m_used = m_highWater = 0;
+}
+
+
+MleDppArena::~MleDppArena()
+{
+    if (m_owned && (m_block != NULL))
+        mlFree(m_block);
+}
+
+
+void *MleDppArena::alloc(MlUInt size)
+{
+    // Declare local variables.
+    void *p;
+
+    size = alignSize(size);
+    if (size > m_capacity - m_used)
+        return(NULL);
+
+    p = m_base + m_used;
+    m_used += size;
+    if (m_used > m_highWater)
+        m_highWater = m_used;
+
+    return(p);
+}
+
+
+void *
+MleDppArena::operator new(size_t tSize)
+{
+	void *p = mlMalloc(tSize);
+	return p;
+}
+
+void
+MleDppArena::operator delete(void *p)
+{
+	mlFree(p);
+}
+
+void*
+MleDppArena::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+void
+MleDppArena::operator delete[](void* p)
+{
+    mlFree(p);
+}
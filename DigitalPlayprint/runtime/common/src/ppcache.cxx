@@ -0,0 +1,355 @@
+/** @defgroup MleDPPMaster Magic Lantern Digital Playprint Library API - Master */
+
+/**
+ * @file ppcache.cxx
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+
+// Declare system header files.
+#include <string.h>
+
+// Include Magic Lantern header files.
+#include "mle/ppcache.h"
+#include "mle/mlMalloc.h"
+#include "mle/mlAssert.h"
+
+
+// Payloads start on a 16 byte boundary after their entry header.
+#define CACHE_ENTRY_SIZE \
+    ((sizeof(MleDppCacheEntry) + 15) & ~((size_t)15))
+
+#define INDEX_ALLOC_INC 128
+
+
+MleDppChunkCache::MleDppChunkCache(MlUInt budget)
+{
+    m_budget = budget;
+    m_used = 0;
+    m_index = NULL;
+    m_indexAllocated = 0;
+    m_head = m_tail = NULL;
+    m_hits = m_misses = m_evictions = 0;
+}
+
+
+MleDppChunkCache::~MleDppChunkCache()
+{
+    // Declare local variables.
+    MleDppCacheEntry *entry,*next;
+
+    // Outstanding references do not survive the cache.
+    for (entry = m_head; entry != NULL; entry = next)
+	{
+        next = entry->m_next;
+        mlFree(entry);
+    }
+
+    if (m_index != NULL)
+        mlFree(m_index);
+}
+
+
+MleDppChunkCache::MleDppCacheEntry *MleDppChunkCache::getEntry(void *data)
+{
+    return((MleDppCacheEntry *)((MlByte *)data - CACHE_ENTRY_SIZE));
+}
+
+
+void *MleDppChunkCache::lookup(MlUInt tocIndex,MlDppTag tag,MlUInt *size)
+{
+    // Declare local variables.
+    MleDppCacheEntry *entry = NULL;
+
+    if (tocIndex < m_indexAllocated)
+        entry = m_index[tocIndex];
+
+    if ((entry == NULL) || (entry->m_tag != tag))
+	{
+        m_misses++;
+        return(NULL);
+    }
+
+    // Move the entry to the front of the LRU list.
+    if (entry != m_head)
+	{
+        entry->m_prev->m_next = entry->m_next;
+        if (entry->m_next != NULL)
+            entry->m_next->m_prev = entry->m_prev;
+        else
+            m_tail = entry->m_prev;
+        entry->m_prev = NULL;
+        entry->m_next = m_head;
+        m_head->m_prev = entry;
+        m_head = entry;
+    }
+
+    m_hits++;
+    entry->m_refCount++;
+    if (size != NULL)
+        *size = entry->m_size;
+    return((MlByte *)entry + CACHE_ENTRY_SIZE);
+}
+
+
+void *MleDppChunkCache::allocate(MlUInt size)
+{
+    // Declare local variables.
+    MleDppCacheEntry *entry;
+
+    entry = (MleDppCacheEntry *)mlMalloc(CACHE_ENTRY_SIZE + size);
+    if (entry == NULL)
+        return(NULL);
+
+    memset(entry,0,sizeof(MleDppCacheEntry));
+    entry->m_size = size;
+    entry->m_refCount = 1;
+    return((MlByte *)entry + CACHE_ENTRY_SIZE);
+}
+
+
+void MleDppChunkCache::insert(MlUInt tocIndex,MlDppTag tag,void *data)
+{
+    // Declare local variables.
+    MleDppCacheEntry *entry = getEntry(data);
+
+    MLE_ASSERT(! entry->m_cached);
+
+    // A chunk larger than the whole budget is never kept.
+    if (entry->m_size > m_budget)
+        return;
+
+    // Grow the index to cover the TOC index.
+    if (tocIndex >= m_indexAllocated)
+	{
+        MlUInt allocated = (tocIndex / INDEX_ALLOC_INC + 1) * INDEX_ALLOC_INC;
+        MleDppCacheEntry **index = (MleDppCacheEntry **)mlRealloc(m_index,
+            sizeof(MleDppCacheEntry *) * allocated);
+        if (index == NULL)
+            return;
+        memset(&index[m_indexAllocated],0,
+            sizeof(MleDppCacheEntry *) * (allocated - m_indexAllocated));
+        m_index = index;
+        m_indexAllocated = allocated;
+    }
+
+    // Replace a stale entry for the same index.
+    if (m_index[tocIndex] != NULL)
+	{
+        MleDppCacheEntry *old = m_index[tocIndex];
+        unlink(old);
+        if (old->m_refCount == 0)
+            mlFree(old);
+    }
+
+    entry->m_tag = tag;
+    entry->m_tocIndex = tocIndex;
+    entry->m_cached = TRUE;
+    entry->m_prev = NULL;
+    entry->m_next = m_head;
+    if (m_head != NULL)
+        m_head->m_prev = entry;
+    else
+        m_tail = entry;
+    m_head = entry;
+    m_index[tocIndex] = entry;
+    m_used += entry->m_size;
+
+    trim();
+}
+
+
+void MleDppChunkCache::retain(void *data)
+{
+    if (data != NULL)
+        getEntry(data)->m_refCount++;
+}
+
+
+void MleDppChunkCache::release(void *data)
+{
+    // Declare local variables.
+    MleDppCacheEntry *entry;
+
+    if (data == NULL)
+        return;
+
+    entry = getEntry(data);
+    MLE_ASSERT(entry->m_refCount > 0);
+
+    if (--entry->m_refCount == 0)
+	{
+        if (! entry->m_cached)
+            mlFree(entry);
+        else if (m_used > m_budget)
+            // An entry pinned past the budget may go now.
+            trim();
+    }
+}
+
+
+void MleDppChunkCache::setBudget(MlUInt budget)
+{
+    m_budget = budget;
+    trim();
+}
+
+
+void MleDppChunkCache::flush(void)
+{
+    // Declare local variables.
+    MleDppCacheEntry *entry,*prev;
+
+    for (entry = m_tail; entry != NULL; entry = prev)
+	{
+        prev = entry->m_prev;
+        if (entry->m_refCount == 0)
+		{
+            unlink(entry);
+            mlFree(entry);
+        }
+    }
+}
+
+
+void MleDppChunkCache::unlink(MleDppCacheEntry *entry)
+{
+    if (entry->m_prev != NULL)
+        entry->m_prev->m_next = entry->m_next;
+    else
+        m_head = entry->m_next;
+    if (entry->m_next != NULL)
+        entry->m_next->m_prev = entry->m_prev;
+    else
+        m_tail = entry->m_prev;
+
+    m_index[entry->m_tocIndex] = NULL;
+    m_used -= entry->m_size;
+    entry->m_prev = entry->m_next = NULL;
+    entry->m_cached = FALSE;
+}
+
+
+void MleDppChunkCache::trim(void)
+{
+    // Declare local variables.
+    MleDppCacheEntry *entry,*prev;
+
+    // Walk from the least recently used end, skipping pinned entries.
+    for (entry = m_tail; (entry != NULL) && (m_used > m_budget); entry = prev)
+	{
+        prev = entry->m_prev;
+        if (entry->m_refCount == 0)
+		{
+            unlink(entry);
+            mlFree(entry);
+            m_evictions++;
+        }
+    }
+}
+
+
+void *
+MleDppChunkCache::operator new(size_t tSize)
+{
+	void *p = mlMalloc(tSize);
+	return p;
+}
+
+void
+MleDppChunkCache::operator delete(void *p)
+{
+	mlFree(p);
+}
+
+void*
+MleDppChunkCache::operator new[](size_t tSize)
+{
+    void* p = mlMalloc(tSize);
+    return p;
+}
+
+void
+MleDppChunkCache::operator delete[](void* p)
+{
+    mlFree(p);
+}
+
+#ifdef UNIT_TEST
+
+// Include system header files.
+#include <stdio.h>
+
+int main(int argc,char *argv[])
+{
+    // Declare local variables.
+    MleDppChunkCache *cache = new MleDppChunkCache(256);
+    MlDppTag tag = mlDppMakeTag('g','r','p',' ');
+    void *data,*pinned;
+    int i,status = 0;
+
+    // Fill past the budget; the oldest unreferenced entries go first.
+    for (i = 0; i < 4; i++)
+	{
+        data = cache->allocate(100);
+        memset(data,i,100);
+        cache->insert(i,tag,data);
+        if (i == 1)
+            pinned = data;
+        else
+            cache->release(data);
+    }
+
+    // Entry 0 was evicted; entry 1 is pinned, so it survives.
+    if ((cache->lookup(0,tag,NULL) != NULL) ||
+        ((data = cache->lookup(1,tag,NULL)) != pinned) ||
+        (((MlByte *)data)[99] != 1))
+        status = 1;
+    cache->release(data);
+    cache->release(pinned);
+
+    if ((cache->getUsed() > cache->getBudget()) ||
+        (cache->getHits() != 1) || (cache->getMisses() != 1) ||
+        (cache->getEvictions() < 1))
+        status = 1;
+
+    if (status == 0)
+        fprintf(stdout,"Chunk cache test passed.\n");
+    else
+        fprintf(stderr,"Chunk cache test failed!\n");
+
+    delete cache;
+    return(status);
+}
+
+#endif /* UNIT_TEST */
@@ -0,0 +1,183 @@
+/**
+ * @file ppcopy.c
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API - file to file copying.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+/* Include system header files. */
+#if defined(__linux__)
+#define MLE_DPP_COPY_LINUX 1
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+#include <stdio.h>
+#if defined(MLE_DPP_COPY_LINUX)
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/sendfile.h>
+#endif
+
+/* Include Magic Lantern header files. */
+#include "mle/mlFileio.h"
+#include "mle/mlMalloc.h"
+#include "mle/mlErrno.h"
+#include "mle/mlAssert.h"
+#include "mle/playprnt.h"
+
+
+#if !defined(MLE_RUNTIME)
+
+/* Size of the bounce buffer used when the kernel cannot copy for us. */
+#define COPY_BUFFER_SIZE (64 * 1024)
+
+#if defined(MLE_DPP_COPY_LINUX)
+
+/*
+ * Copy in the kernel, first with copy_file_range() and then with
+ * sendfile(). Returns the number of bytes copied, which is short if
+ * neither call is usable for this pair of files.
+ */
+static MlUInt _kernelCopy(int dstFd,int srcFd,off_t srcOff,off_t dstOff,MlUInt size)
+{
+    /* Declare local variables. */
+    MlUInt done = 0;
+    ssize_t n;
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 27)))
+    while (done < size)
+	{
+        n = copy_file_range(srcFd,&srcOff,dstFd,&dstOff,size - done,0);
+        if (n <= 0)
+            break;
+        done += (MlUInt)n;
+    }
+    if (done == size)
+        return(done);
+#endif
+
+    /* sendfile() writes at the current offset of the destination. */
+    if (lseek(dstFd,dstOff,SEEK_SET) == (off_t)-1)
+        return(done);
+    while (done < size)
+	{
+        n = sendfile(dstFd,srcFd,&srcOff,size - done);
+        if (n <= 0)
+            break;
+        done += (MlUInt)n;
+    }
+
+    return(done);
+}
+
+#endif /* MLE_DPP_COPY_LINUX */
+
+
+/*
+ * Copy "size" bytes, starting at "offset" in "src", to the current
+ * position of "dst", leaving "dst" positioned after them. The kernel
+ * does the copy where it can; otherwise a small buffer is cycled.
+ * The position of "src" is preserved.
+ */
+MlBoolean mlDppCopyFile(FILE *dst,FILE *src,MlUInt offset,MlUInt size)
+{
+    /* Declare local variables. */
+    MlUInt done = 0,n;
+    long dstPos,srcPos;
+    void *buffer;
+
+    MLE_VALIDATE_PTR(dst);
+    MLE_VALIDATE_PTR(src);
+
+    /* Anything still buffered must reach the file before the copy. */
+    if (mlFFlush(dst) != 0)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        return(FALSE);
+    }
+    dstPos = mlFTell(dst);
+
+#if defined(MLE_DPP_COPY_LINUX)
+    done = _kernelCopy(fileno(dst),fileno(src),(off_t)offset,(off_t)dstPos,size);
+#endif
+
+    /* Continue, or start, with a bounded read/write loop. */
+    if (mlFSeek(dst,dstPos + done,SEEK_SET) != 0)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTSEEK);
+        return(FALSE);
+    }
+    if (done == size)
+        return(TRUE);
+
+    /* The source position belongs to its reader; put it back afterwards. */
+    srcPos = mlFTell(src);
+    if (mlFSeek(src,offset + done,SEEK_SET) != 0)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTSEEK);
+        return(FALSE);
+    }
+
+    buffer = mlMalloc(COPY_BUFFER_SIZE);
+    if (buffer == NULL)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        return(FALSE);
+    }
+
+    while (done < size)
+	{
+        n = size - done;
+        if (n > COPY_BUFFER_SIZE)
+            n = COPY_BUFFER_SIZE;
+        if (mlFRead(buffer,1,n,src) != n)
+		{
+            mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+            break;
+        }
+        if (mlFWrite(buffer,1,n,dst) != n)
+		{
+            mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+            break;
+        }
+        done += n;
+    }
+
+    mlFree(buffer);
+    mlFSeek(src,srcPos,SEEK_SET);
+    return(done == size);
+}
+
+#endif /* MLE_RUNTIME */
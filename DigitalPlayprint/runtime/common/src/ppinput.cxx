@@ -40,6 +40,11 @@
 
 // Declare system header files.
 #include <string.h>
+#if defined(_WINDOWS)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
 
 // Include Magic Lantern header files.
 #include "mle/ppinput.h"
@@ -53,11 +58,41 @@ MleDppInput::MleDppInput(const char *filename)
 {
     // Initialize Playprint book keeping structures.
     memset(&m_mrefListInfo,0,sizeof(MleDppChunkInfo));
+    m_mrefIndex = NULL;
+    m_mrefIndexSize = 0;
+    m_mrefIndexValid = FALSE;
+    m_mrefFirst = 0;
+    m_tocTable = NULL;
+    m_tocIndex = NULL;
+    m_tocEntries = NULL;
+    m_tocBuckets = NULL;
+    m_tocNumBuckets = 0;
+    m_tocNames = NULL;
+    m_tocNamesSize = 0;
+    m_manifest = NULL;
+    m_manifestScenes = NULL;
+    m_manifestEntries = NULL;
+    m_manifestRanges = NULL;
+    m_manifestNumScenes = 0;
+    m_tocOffsets = NULL;
+    m_tocSizes = NULL;
+    m_tocTypes = NULL;
+    m_traceFp = NULL;
+    m_traceRecords = NULL;
+    m_traceUsed = 0;
+    m_traceStart = 0;
+
+    // The cache starts out disabled.
+    m_cache = new MleDppChunkCache(0);
 }
 
 
 MleDppInput::~MleDppInput()
 {
+    stopTrace();
+    freeMrefIndex();
+    freeTOCIndex();
+    delete m_cache;
 }
 
 
@@ -85,11 +120,30 @@ int MleDppInput::readHeader(MleDppCallback func,void *clientData)
 }
 
 
+int MleDppInput::readHeader(MleDppHeader *hdrData,MleDppCallback func,void *clientData)
+{
+    // Declare local variables.
+    int status = FALSE;
+
+    if (hdrData == NULL)
+        return(FALSE);
+
+    // Read Playprint header.
+    MleDpp::readHeader(hdrData);
+
+    if (func)
+        status = func(clientData,(void *)hdrData);
+    else
+        status = TRUE;
+
+    return(status);
+}
+
+
 int MleDppInput::readTOC(MleDppCallback func,void *clientData)
 {
     // declare local variables.
     MleDppChunkInfo tocInfo;
-    MleDppTocEntry entry;
     MlUInt numEntries;
     int status = FALSE;
 
@@ -101,17 +155,30 @@ int MleDppInput::readTOC(MleDppCallback func,void *clientData)
         // Read number of TOC entries.
     	size_t nBytes;
         nBytes = mlFRead(&numEntries,sizeof(MlUInt),1,getFp());
+        if (getSwapRead())
+            numEntries = mlDppSwapInt(numEntries);
         beginTOC(numEntries);
+        freeTOCIndex();
 
-        // Read each TOC entry.
-        for (MlUInt i = 0; i < numEntries; i++)
+        // Read the TOC entries as one block and swap them in bulk. The
+        // block is kept so offsets can be looked up by index.
+        m_tocTable = (MleDppTocEntry *)mlMalloc(sizeof(MleDppTocEntry) * numEntries);
+        if ((m_tocTable != NULL) && (numEntries > 0))
 		{
-            nBytes = mlFRead(&entry,sizeof(MleDppTocEntry),1,getFp());
-            addTOCEntry(entry.m_label,entry.m_offset);
+            nBytes = mlFRead(m_tocTable,sizeof(MleDppTocEntry) * numEntries,1,getFp());
+            if (getSwapRead())
+                mlDppSwapIntArray((MlUInt *)m_tocTable,2 * numEntries);
+
+            for (MlUInt i = 0; i < numEntries; i++)
+                addTOCEntry(m_tocTable[i].m_label,m_tocTable[i].m_offset);
         }
 
         // Finish TOC reading.
         endTOC();
+        MLE_ERROR(mlDppAscend(getFp(),&tocInfo,0));
+
+        // Pick up the names, types and sizes, if the Playprint has them.
+        readTOCIndex();
 
         if (func)
 		{
@@ -119,6 +186,7 @@ int MleDppInput::readTOC(MleDppCallback func,void *clientData)
             status = func(clientData,calldata);
         } else
             status = TRUE;
+        return(status);
     }
 
     MLE_ERROR(mlDppAscend(getFp(),&tocInfo,0));
@@ -126,50 +194,489 @@ int MleDppInput::readTOC(MleDppCallback func,void *clientData)
 }
 
 
+MlBoolean MleDppInput::readTOCIndex(void)
+{
+    // Declare local variables.
+    MleDppChunkInfo info;
+    MleDppTocIndexHeader *header;
+    MleDppTOC *nextEntry;
+    MlUInt numEntries,namesOffset,i;
+    long pos;
+
+    memset(&info,0,sizeof(MleDppChunkInfo));
+
+    // Older Playprints go straight on to the next chunk.
+    pos = mlFTell(getFp());
+    if ((! descendChunk(&info)) ||
+        (info.m_chunk.m_tag != mlDppMakeTag('t','o','c','x')) ||
+        (info.m_chunk.m_size < sizeof(MleDppTocIndexHeader)))
+	{
+        mlFSeek(getFp(),pos,SEEK_SET);
+        return(FALSE);
+    }
+
+    m_tocIndex = (MlUInt *)mlMalloc(info.m_chunk.m_size);
+    if ((m_tocIndex == NULL) ||
+        (mlFRead(m_tocIndex,info.m_chunk.m_size,1,getFp()) != 1))
+	{
+        freeTOCIndex();
+        mlDppAscend(getFp(),&info,0);
+        return(FALSE);
+    }
+    mlDppAscend(getFp(),&info,0);
+    pos = mlFTell(getFp());
+
+    if (getSwapRead())
+        mlDppSwapIntArray(m_tocIndex,info.m_chunk.m_size / sizeof(MlUInt));
+
+    header = (MleDppTocIndexHeader *)m_tocIndex;
+    numEntries = header->m_numEntries;
+    m_tocNumBuckets = header->m_numBuckets;
+    namesOffset = header->m_namesOffset;
+    m_tocNamesSize = header->m_namesSize;
+    m_manifestOffset = header->m_manifestOffset;
+    m_manifestSize = header->m_manifestSize;
+    if ((numEntries != m_numTOCUsed) || (m_tocNumBuckets == 0) ||
+        ((m_tocNumBuckets & (m_tocNumBuckets - 1)) != 0) ||
+        (info.m_chunk.m_size < sizeof(MleDppTocIndexHeader) + sizeof(MlUInt) * m_tocNumBuckets +
+            sizeof(MleDppTocIndexEntry) * numEntries))
+	{
+        freeTOCIndex();
+        return(FALSE);
+    }
+    m_tocEntries = (MleDppTocIndexEntry *)&header[1];
+    m_tocBuckets = (MlUInt *)&m_tocEntries[numEntries];
+
+    // Read the name pool; it lives at the end of the form.
+    if (m_tocNamesSize > 0)
+	{
+        memset(&info,0,sizeof(MleDppChunkInfo));
+        goTo(namesOffset);
+        m_tocNames = (char *)mlMalloc(m_tocNamesSize + 1);
+        if ((m_tocNames == NULL) || (! mlDppDescend(getFp(),&info,NULL,0)) ||
+            (info.m_chunk.m_tag != mlDppMakeTag('t','o','c','n')) ||
+            (info.m_chunk.m_size < m_tocNamesSize) ||
+            (mlFRead(m_tocNames,m_tocNamesSize,1,getFp()) != 1))
+		{
+            mlFSeek(getFp(),pos,SEEK_SET);
+            freeTOCIndex();
+            return(FALSE);
+        }
+        m_tocNames[m_tocNamesSize] = '\0';
+        mlFSeek(getFp(),pos,SEEK_SET);
+    }
+
+    // Share what was found with the table-of-contents list.
+    nextEntry = m_TOC;
+    for (i = 0; (nextEntry != NULL) && (i < numEntries); i++, nextEntry = nextEntry->m_next)
+	{
+        nextEntry->m_type = m_tocEntries[i].m_type;
+        nextEntry->m_size = m_tocEntries[i].m_size;
+        nextEntry->m_name = getTOCName(i);
+    }
+
+    return(TRUE);
+}
+
+
+void MleDppInput::freeTOCIndex(void)
+{
+    // Declare local variables.
+    MleDppTOC *nextEntry;
+
+    // Names in the table-of-contents list point into the pool.
+    for (nextEntry = m_TOC; nextEntry != NULL; nextEntry = nextEntry->m_next)
+        nextEntry->m_name = NULL;
+
+    if (m_tocTable != NULL)
+        mlFree(m_tocTable);
+    if (m_tocIndex != NULL)
+        mlFree(m_tocIndex);
+    if (m_tocNames != NULL)
+        mlFree(m_tocNames);
+    if (m_manifest != NULL)
+        mlFree(m_manifest);
+    m_tocTable = NULL;
+    m_tocIndex = NULL;
+    m_tocEntries = NULL;
+    m_tocBuckets = NULL;
+    m_tocNumBuckets = 0;
+    m_tocNames = NULL;
+    m_tocNamesSize = 0;
+    m_manifest = NULL;
+    m_manifestScenes = NULL;
+    m_manifestEntries = NULL;
+    m_manifestRanges = NULL;
+    m_manifestNumScenes = 0;
+    m_tocOffsets = NULL;
+    m_tocSizes = NULL;
+    m_tocTypes = NULL;
+}
+
+
+MlBoolean MleDppInput::readManifest(void)
+{
+    // Declare local variables.
+    MleDppChunkInfo info;
+    MleDppManifestHeader *header;
+    MlUInt size;
+    long pos;
+
+    if (m_manifest != NULL)
+        return(TRUE);
+    if ((m_manifestOffset == 0) || (m_manifestSize < sizeof(MleDppManifestHeader)))
+        return(FALSE);
+
+    memset(&info,0,sizeof(MleDppChunkInfo));
+    pos = mlFTell(getFp());
+    goTo(m_manifestOffset);
+    m_manifest = (MlUInt *)mlMalloc(m_manifestSize);
+    if ((m_manifest == NULL) || (! mlDppDescend(getFp(),&info,NULL,0)) ||
+        (info.m_chunk.m_tag != mlDppMakeTag('m','f','s','t')) ||
+        (info.m_chunk.m_size != m_manifestSize) ||
+        (mlFRead(m_manifest,m_manifestSize,1,getFp()) != 1))
+	{
+        mlFSeek(getFp(),pos,SEEK_SET);
+        if (m_manifest != NULL)
+            mlFree(m_manifest);
+        m_manifest = NULL;
+        return(FALSE);
+    }
+    mlFSeek(getFp(),pos,SEEK_SET);
+
+    if (getSwapRead())
+        mlDppSwapIntArray(m_manifest,m_manifestSize / sizeof(MlUInt));
+
+    header = (MleDppManifestHeader *)m_manifest;
+    size = sizeof(MleDppManifestHeader) +
+        header->m_numScenes * sizeof(MleDppManifestScene) +
+        header->m_numEntries * sizeof(MlUInt) +
+        header->m_numRanges * sizeof(MleDppManifestRange);
+    if (size > m_manifestSize)
+	{
+        mlFree(m_manifest);
+        m_manifest = NULL;
+        return(FALSE);
+    }
+    m_manifestNumScenes = header->m_numScenes;
+    m_manifestScenes = (MleDppManifestScene *)&header[1];
+    m_manifestEntries = (MlUInt *)&m_manifestScenes[m_manifestNumScenes];
+    m_manifestRanges = (MleDppManifestRange *)&m_manifestEntries[header->m_numEntries];
+
+    return(TRUE);
+}
+
+
+MlBoolean MleDppInput::getSceneManifest(MlUInt tocIndex,const MleDppManifestRange **ranges,
+    MlUInt *numRanges,const MlUInt **entries,MlUInt *numEntries)
+{
+    // Declare local variables.
+    MleDppManifestHeader *header;
+    MleDppManifestScene *scene;
+
+    if (! readManifest())
+        return(FALSE);
+
+    header = (MleDppManifestHeader *)m_manifest;
+    for (MlUInt i = 0; i < m_manifestNumScenes; i++)
+	{
+        scene = &m_manifestScenes[i];
+        if (scene->m_scene != tocIndex)
+            continue;
+
+        // Stay within the chunk, whatever it says.
+        if ((scene->m_firstRange + scene->m_numRanges > header->m_numRanges) ||
+            (scene->m_firstEntry + scene->m_numEntries > header->m_numEntries))
+            return(FALSE);
+
+        *ranges = &m_manifestRanges[scene->m_firstRange];
+        *numRanges = scene->m_numRanges;
+        if (entries != NULL)
+            *entries = &m_manifestEntries[scene->m_firstEntry];
+        if (numEntries != NULL)
+            *numEntries = scene->m_numEntries;
+        return(TRUE);
+    }
+
+    return(FALSE);
+}
+
+
+// Records are written out this many at a time.
+#define TRACE_BUFFER_RECORDS 256
+
+static MlULong _getTraceTime(void)
+{
+#if defined(_WINDOWS)
+    return(GetTickCount64());
+#else
+    // Declare local variables.
+    struct timeval now;
+
+    gettimeofday(&now,NULL);
+    return((MlULong)now.tv_sec * 1000 + now.tv_usec / 1000);
+#endif
+}
+
+
+MlBoolean MleDppInput::startTrace(const char *filename)
+{
+    // Declare local variables.
+    MleDppTraceHeader header;
+
+    stopTrace();
+
+    m_traceRecords = (MleDppTraceRecord *)mlMalloc(TRACE_BUFFER_RECORDS * sizeof(MleDppTraceRecord));
+    if (m_traceRecords == NULL)
+        return(FALSE);
+    m_traceFp = mlFOpen(filename,"wb");
+    if (m_traceFp == NULL)
+	{
+        mlFree(m_traceRecords);
+        m_traceRecords = NULL;
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        return(FALSE);
+    }
+
+    // The header is written again, complete, by stopTrace().
+    memset(&header,0,sizeof(MleDppTraceHeader));
+    header.m_magic = MLE_DPP_TRACE_MAGIC;
+    header.m_version = MLE_DPP_TRACE_VERSION;
+    if (mlFWrite(&header,sizeof(MleDppTraceHeader),1,m_traceFp) != 1)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        stopTrace();
+        return(FALSE);
+    }
+
+    m_traceUsed = 0;
+    m_traceStart = _getTraceTime();
+    return(TRUE);
+}
+
+
+MlBoolean MleDppInput::stopTrace(void)
+{
+    // Declare local variables.
+    MleDppTraceHeader header;
+    MlBoolean status;
+
+    if (m_traceFp == NULL)
+        return(TRUE);
+
+    status = flushTrace();
+
+    header.m_magic = MLE_DPP_TRACE_MAGIC;
+    header.m_version = MLE_DPP_TRACE_VERSION;
+    header.m_contentHash = m_contentHash;
+    header.m_numEntries = m_numTOCUsed;
+    if ((mlFSeek(m_traceFp,0,SEEK_SET) != 0) ||
+        (mlFWrite(&header,sizeof(MleDppTraceHeader),1,m_traceFp) != 1))
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        status = FALSE;
+    }
+
+    mlFClose(m_traceFp);
+    mlFree(m_traceRecords);
+    m_traceFp = NULL;
+    m_traceRecords = NULL;
+    m_traceUsed = 0;
+
+    return(status);
+}
+
+
+void MleDppInput::traceAccess(MlUInt tocIndex,MlUInt size)
+{
+    // Declare local variables.
+    MleDppTraceRecord *record;
+
+    if (m_traceFp == NULL)
+        return;
+
+    record = &m_traceRecords[m_traceUsed++];
+    record->m_time = (MlUInt)(_getTraceTime() - m_traceStart);
+    record->m_index = tocIndex;
+    record->m_size = size;
+
+    if (m_traceUsed == TRACE_BUFFER_RECORDS)
+        flushTrace();
+}
+
+
+MlBoolean MleDppInput::flushTrace(void)
+{
+    // Declare local variables.
+    MlBoolean status = TRUE;
+
+    if ((m_traceUsed > 0) &&
+        (mlFWrite(m_traceRecords,sizeof(MleDppTraceRecord),m_traceUsed,m_traceFp) != m_traceUsed))
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        status = FALSE;
+    }
+    m_traceUsed = 0;
+
+    return(status);
+}
+
+
 MlInt MleDppInput::getTOCOffset(MlUInt index)
+{
+    // Declare local variables.
+    MlInt offset = lookupTOCOffset(index);
+
+    // Callers look chunks up to read them.
+    if ((m_traceFp != NULL) && (offset >= 0))
+        traceAccess(index,getTOCSize(index));
+
+    return(offset);
+}
+
+
+MlInt MleDppInput::lookupTOCOffset(MlUInt index)
 {
     // Declare local variables.
     MleDppTOC *nextEntry;
 
     MLE_ASSERT(index < m_numTOCUsed);
 
-    if (m_TOC)
-        nextEntry = m_TOC;
-    else
-        return(-1);
+    if (m_tocOffsets != NULL)
+        return(m_tocOffsets[index]);
+    if (m_tocTable != NULL)
+        return(m_tocTable[index].m_offset);
 
-    for (MlUInt i = 0; i < index; i++)
-        nextEntry = nextEntry->m_next;
+    if (m_tocEntry == NULL)
+        return(-1);
+    nextEntry = m_tocEntry[index];
 
     return(nextEntry->m_entry.m_offset);
 }
 
 
+MlBoolean MleDppInput::setTOCTables(MlUInt hash,MlUInt count,const MlUInt *offsets,
+    const MlUInt *sizes,const MlDppTag *types)
+{
+    if ((hash == 0) || (hash != m_contentHash) || (offsets == NULL))
+        return(FALSE);
+
+    // Stand in for the 'toc ' chunk; it is never read. Neither is the
+    // named index, so there are no names or manifest.
+    freeTOCIndex();
+    m_manifestOffset = 0;
+    m_manifestSize = 0;
+    m_tocOffsets = offsets;
+    m_tocSizes = sizes;
+    m_tocTypes = types;
+    m_numTOCReserved = count;
+    m_numTOCUsed = count;
+    m_useTOC = TRUE;
+
+    return(TRUE);
+}
+
+
 void MleDppInput::goTo(MlInt tocOffset)
 {
     mlFSeek(getFp(),tocOffset,0);
 }
 
 
-#if 0
-MleDppQuark MleDppInput::getTOCLabel(MlUInt index)
+MlDppQuark MleDppInput::getTOCLabel(MlUInt index)
 {
     // declare local variables
     MleDppTOC *nextEntry;
 
     MLE_ASSERT(index < m_numTOCUsed);
 
-    if (m_TOC)
-        nextEntry = m_TOC;
-    else
-        return(-1);
+    // Generated tables carry no labels.
+    if (m_tocOffsets != NULL)
+	{
+        mlSetErrno(MLE_DPP_ERR_CHUNKNOTFOUND);
+        return(0);
+    }
 
-    for (int i = 0; i < index; i++)
-        nextEntry = nextEntry->m_next;
+    if (m_tocTable != NULL)
+        return(m_tocTable[index].m_label);
+
+    if (m_tocEntry == NULL)
+        return(0);
+    nextEntry = m_tocEntry[index];
 
     return(nextEntry->m_entry.m_label);
 }
-#endif /* 0 */
+
+
+const char *MleDppInput::getTOCName(MlUInt index)
+{
+    // Declare local variables.
+    MlUInt offset;
+
+    if ((m_tocEntries == NULL) || (m_tocNames == NULL) || (index >= m_numTOCUsed))
+        return(NULL);
+
+    offset = m_tocEntries[index].m_name;
+    if (offset >= m_tocNamesSize)
+        return(NULL);
+
+    return(&m_tocNames[offset]);
+}
+
+
+MlDppTag MleDppInput::getTOCType(MlUInt index)
+{
+    if (m_tocTypes != NULL)
+        return((index < m_numTOCUsed) ? m_tocTypes[index] : 0);
+    if ((m_tocEntries == NULL) || (index >= m_numTOCUsed))
+        return(0);
+
+    return(m_tocEntries[index].m_type);
+}
+
+
+MlUInt MleDppInput::getTOCSize(MlUInt index)
+{
+    if (m_tocSizes != NULL)
+        return((index < m_numTOCUsed) ? m_tocSizes[index] : 0);
+    if ((m_tocEntries == NULL) || (index >= m_numTOCUsed))
+        return(0);
+
+    return(m_tocEntries[index].m_size);
+}
+
+
+MlInt MleDppInput::findTOCEntry(const char *name)
+{
+    // Declare local variables.
+    MlDppQuark label;
+    const char *entryName;
+    MlUInt h,index,probes;
+
+    if ((name == NULL) || (m_tocBuckets == NULL))
+        return(-1);
+
+    // Probe from the home bucket until an empty one is reached; labels
+    // are compared first and the name settles any collision.
+    label = getQuark(name);
+    h = (MlUInt)label & (m_tocNumBuckets - 1);
+    for (probes = 0; probes < m_tocNumBuckets; probes++)
+	{
+        if (m_tocBuckets[h] == 0)
+            break;
+
+        index = m_tocBuckets[h] - 1;
+        if ((index < m_numTOCUsed) && (m_tocEntries[index].m_label == label))
+		{
+            entryName = getTOCName(index);
+            if ((entryName != NULL) && (strcmp(entryName,name) == 0))
+                return((MlInt)index);
+        }
+        h = (h + 1) & (m_tocNumBuckets - 1);
+    }
+
+    return(-1);
+}
 
 
 int MleDppInput::readGroup(MleDppCallback func,void *clientData)
@@ -181,7 +688,7 @@ int MleDppInput::readGroup(MleDppCallback func,void *clientData)
 
     memset(&groupInfo,0,sizeof(MleDppChunkInfo));
 
-    MLE_ERROR(mlDppDescend(getFp(),&groupInfo,NULL,0));
+    MLE_ERROR(descendChunk(&groupInfo));
     if (groupInfo.m_chunk.m_tag == mlDppMakeTag('g','r','p',' '))
 	{
         if (func)
@@ -211,7 +718,7 @@ int MleDppInput::readScene(MleDppCallback func,void *clientData)
 
     memset(&sceneInfo,0,sizeof(MleDppChunkInfo));
 
-    MLE_ERROR(mlDppDescend(getFp(),&sceneInfo,NULL,0));
+    MLE_ERROR(descendChunk(&sceneInfo));
     if (sceneInfo.m_chunk.m_tag == mlDppMakeTag('s','c','n',' '))
 	{
         if (func)
@@ -241,7 +748,7 @@ int MleDppInput::readSet(MleDppCallback func,void *clientData)
 
     memset(&setInfo,0,sizeof(MleDppChunkInfo));
 
-    MLE_ERROR(mlDppDescend(getFp(),&setInfo,NULL,0));
+    MLE_ERROR(descendChunk(&setInfo));
     if (setInfo.m_chunk.m_tag == mlDppMakeTag('s','e','t',' '))
 	{
         if (func)
@@ -262,6 +769,222 @@ int MleDppInput::readSet(MleDppCallback func,void *clientData)
 }
 
 
+int MleDppInput::readGroup(void *buffer,MlUInt size,MleDppCallback func,void *clientData)
+{
+    return(readChunkInto(mlDppMakeTag('g','r','p',' '),buffer,size,NULL,func,clientData));
+}
+
+
+int MleDppInput::readScene(void *buffer,MlUInt size,MleDppCallback func,void *clientData)
+{
+    return(readChunkInto(mlDppMakeTag('s','c','n',' '),buffer,size,NULL,func,clientData));
+}
+
+
+int MleDppInput::readSet(void *buffer,MlUInt size,MleDppCallback func,void *clientData)
+{
+    return(readChunkInto(mlDppMakeTag('s','e','t',' '),buffer,size,NULL,func,clientData));
+}
+
+
+int MleDppInput::readGroup(MleDppArena *arena,MleDppCallback func,void *clientData)
+{
+    return(readChunkInto(mlDppMakeTag('g','r','p',' '),NULL,0,arena,func,clientData));
+}
+
+
+int MleDppInput::readScene(MleDppArena *arena,MleDppCallback func,void *clientData)
+{
+    return(readChunkInto(mlDppMakeTag('s','c','n',' '),NULL,0,arena,func,clientData));
+}
+
+
+int MleDppInput::readSet(MleDppArena *arena,MleDppCallback func,void *clientData)
+{
+    return(readChunkInto(mlDppMakeTag('s','e','t',' '),NULL,0,arena,func,clientData));
+}
+
+
+int MleDppInput::readChunkInto(MlDppTag tag,void *buffer,MlUInt size,
+    MleDppArena *arena,MleDppCallback func,void *clientData)
+{
+    // Declare local variables.
+    MleDppChunkInfo chunkInfo;
+    int status = FALSE;
+
+    memset(&chunkInfo,0,sizeof(MleDppChunkInfo));
+
+    MLE_ERROR(descendChunk(&chunkInfo));
+    if (chunkInfo.m_chunk.m_tag == tag)
+	{
+        if (func)
+		{
+            if (arena != NULL)
+			{
+                buffer = arena->alloc(chunkInfo.m_chunk.m_size);
+                size = chunkInfo.m_chunk.m_size;
+            }
+
+            // The payload must fit; nothing is allocated on this path.
+            if ((buffer != NULL) && (chunkInfo.m_chunk.m_size <= size) &&
+                (mlFRead(buffer,chunkInfo.m_chunk.m_size,1,getFp()) == 1))
+                status = func(clientData,buffer);
+            else
+                mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+        } else
+            status = TRUE;
+    }
+
+    MLE_ERROR(mlDppAscend(getFp(),&chunkInfo,0));
+    return(status);
+}
+
+
+MlInt MleDppInput::getChunkSize(MlUInt tocIndex)
+{
+    // Declare local variables.
+    MleDppChunkInfo chunkInfo;
+    MlInt size = -1;
+    long pos;
+
+    if (tocIndex >= m_numTOCUsed)
+        return(-1);
+
+    memset(&chunkInfo,0,sizeof(MleDppChunkInfo));
+
+    pos = mlFTell(getFp());
+    goTo(lookupTOCOffset(tocIndex));
+    if (mlDppDescend(getFp(),&chunkInfo,NULL,0))
+        size = chunkInfo.m_chunk.m_size;
+    mlFSeek(getFp(),pos,SEEK_SET);
+
+    return(size);
+}
+
+
+MlUInt MleDppInput::getArenaSize(const MlUInt *tocIndexes,MlUInt count)
+{
+    // Declare local variables.
+    MleDppChunkInfo chunkInfo,mediaInfo;
+    MleMediaRefInfoChunk mrefInfoData;
+    MlUInt index,total = 0;
+    long pos;
+
+    if (tocIndexes == NULL)
+        count = m_numTOCUsed;
+
+    pos = mlFTell(getFp());
+    for (MlUInt i = 0; i < count; i++)
+	{
+        index = (tocIndexes != NULL) ? tocIndexes[i] : i;
+        if (index >= m_numTOCUsed)
+            continue;
+
+        memset(&chunkInfo,0,sizeof(MleDppChunkInfo));
+        goTo(lookupTOCOffset(index));
+        if (! mlDppDescend(getFp(),&chunkInfo,NULL,0))
+            continue;
+        total += MleDppArena::alignSize(chunkInfo.m_chunk.m_size);
+
+        if ((chunkInfo.m_chunk.m_tag == MLE_LIST_TAG) &&
+            (chunkInfo.m_form == mlDppMakeTag('M','R','F','L')))
+		{
+            // Each media reference also needs its chunk structure, a
+            // terminator for external names and alignment slack.
+            memset(&mediaInfo,0,sizeof(MleDppChunkInfo));
+            if (mlDppDescend(getFp(),&mediaInfo,NULL,0) &&
+                (mediaInfo.m_chunk.m_tag == mlDppMakeTag('i','n','f','o')) &&
+                (mlFRead(&mrefInfoData,sizeof(MleMediaRefInfoChunk),1,getFp()) == 1))
+			{
+                if (getSwapRead())
+                    mlDppSwapIntArray((MlUInt *)&mrefInfoData,3);
+                total += mrefInfoData.m_numMrefs *
+                    (MleDppArena::alignSize(sizeof(MleMediaRefChunk)) + MleDppArena::ALIGNMENT);
+            }
+        }
+    }
+    mlFSeek(getFp(),pos,SEEK_SET);
+
+    return(total);
+}
+
+
+int MleDppInput::readGroup(MlUInt tocIndex,MleDppCallback func,void *clientData)
+{
+    return(readCachedChunk(tocIndex,mlDppMakeTag('g','r','p',' '),func,clientData));
+}
+
+
+int MleDppInput::readScene(MlUInt tocIndex,MleDppCallback func,void *clientData)
+{
+    return(readCachedChunk(tocIndex,mlDppMakeTag('s','c','n',' '),func,clientData));
+}
+
+
+int MleDppInput::readSet(MlUInt tocIndex,MleDppCallback func,void *clientData)
+{
+    return(readCachedChunk(tocIndex,mlDppMakeTag('s','e','t',' '),func,clientData));
+}
+
+
+int MleDppInput::readCachedChunk(MlUInt tocIndex,MlDppTag tag,
+    MleDppCallback func,void *clientData)
+{
+    // Declare local variables.
+    MleDppChunkInfo chunkInfo;
+    void *callData;
+    int status = FALSE;
+
+    if (tocIndex >= m_numTOCUsed)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+        return(FALSE);
+    }
+
+    if (func == NULL)
+        return(TRUE);
+
+    // Serve the payload from memory if we can.
+    callData = m_cache->lookup(tocIndex,tag,NULL);
+    if (callData == NULL)
+	{
+        memset(&chunkInfo,0,sizeof(MleDppChunkInfo));
+
+        goTo(lookupTOCOffset(tocIndex));
+        MLE_ERROR(descendChunk(&chunkInfo));
+        if (chunkInfo.m_chunk.m_tag == tag)
+		{
+            // An empty payload is valid; there is just nothing to read.
+            callData = m_cache->allocate(chunkInfo.m_chunk.m_size);
+            if ((callData != NULL) &&
+                ((chunkInfo.m_chunk.m_size == 0) ||
+                 (mlFRead(callData,chunkInfo.m_chunk.m_size,1,getFp()) == 1)))
+			{
+                m_cache->insert(tocIndex,tag,callData);
+                traceAccess(tocIndex,chunkInfo.m_chunk.m_size);
+            } else
+			{
+                m_cache->release(callData);
+                callData = NULL;
+                mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+            }
+        } else
+            // The TOC entry is for some other kind of chunk.
+            mlSetErrno(MLE_DPP_ERR_CHUNKNOTFOUND);
+        MLE_ERROR(mlDppAscend(getFp(),&chunkInfo,0));
+    }
+
+    if (callData != NULL)
+	{
+        // The callback may retain the payload past this point.
+        status = func(clientData,callData);
+        m_cache->release(callData);
+    }
+
+    return(status);
+}
+
+
 int MleDppInput::beginMref(MleDppCallback func,void *clientData)
 {
     // Declare local variables.
@@ -275,6 +998,13 @@ int MleDppInput::beginMref(MleDppCallback func,void *clientData)
     // Read IFF 'info' chunk.
     readMrefInfo(&mrefInfoData);
 
+    // Read IFF 'midx' chunk, if the list has one.
+    freeMrefIndex();
+    m_mrefIndexSize = mrefInfoData.m_numMrefs;
+    if (mrefInfoData.m_flags & MLE_MREF_INFO_INDEXED)
+        readMrefIndex();
+    m_mrefFirst = mlFTell(getFp());
+
     if (func)
 	{
         callData = (void *)&mrefInfoData;
@@ -292,6 +1022,8 @@ int MleDppInput::endMref(MleDppCallback func,void *clientData)
 
     // End IFF 'MRFL' LIST chunk.
     endMrefList();
+    freeMrefIndex();
+    m_mrefIndexSize = 0;
 
     if (func)
 	{
@@ -302,6 +1034,36 @@ int MleDppInput::endMref(MleDppCallback func,void *clientData)
 }
 
 
+int MleDppInput::readMedia(MleDppArena *arena,MleDppCallback func,void *clientData)
+{
+    // Declare local variables.
+    MleMediaRefChunk *mrefData;
+    int status = FALSE;
+
+    if (arena == NULL)
+        return(readMedia(func,clientData));
+
+    mrefData = (MleMediaRefChunk *)arena->alloc(sizeof(MleMediaRefChunk));
+    if (mrefData == NULL)
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+        return(FALSE);
+    }
+
+    // Read IFF 'mref' chunk; nothing is freed, the arena is reset instead.
+    mrefData->m_data = NULL;
+    if (readMref(mrefData,arena) && (mrefData->m_data != NULL))
+	{
+        if (func)
+            status = func(clientData,(void *)mrefData);
+        else
+            status = TRUE;
+    }
+
+    return(status);
+}
+
+
 int MleDppInput::readMedia(MleDppCallback func,void *clientData)
 {
     // Declare local variables.
@@ -330,6 +1092,45 @@ int MleDppInput::readMedia(MleDppCallback func,void *clientData)
 }
 
 
+int MleDppInput::readMediaByIndex(MlUInt ordinal,MleDppCallback func,void *clientData)
+{
+    // Declare local variables.
+    long pos;
+    int status;
+
+    if (! m_mrefIndexValid)
+        buildMrefIndex();
+    if ((! m_mrefIndexValid) || (ordinal >= m_mrefIndexSize))
+	{
+        mlSetErrno(MLE_DPP_ERR_CHUNKNOTFOUND);
+        return(FALSE);
+    }
+
+    pos = mlFTell(getFp());
+    goTo(m_mrefIndex[ordinal].m_offset);
+    status = readMedia(func,clientData);
+    mlFSeek(getFp(),pos,SEEK_SET);
+
+    return(status);
+}
+
+
+int MleDppInput::readMediaByLabel(MlDppTag label,MleDppCallback func,void *clientData)
+{
+    if (! m_mrefIndexValid)
+        buildMrefIndex();
+
+    for (MlUInt i = 0; m_mrefIndexValid && (i < m_mrefIndexSize); i++)
+	{
+        if (m_mrefIndex[i].m_label == label)
+            return(readMediaByIndex(i,func,clientData));
+    }
+
+    mlSetErrno(MLE_DPP_ERR_CHUNKNOTFOUND);
+    return(FALSE);
+}
+
+
 MlBoolean MleDppInput::beginMrefList(void)
 {
     m_mrefListInfo.m_form = mlDppMakeTag('M','R','F','L');
@@ -360,9 +1161,8 @@ MlBoolean MleDppInput::readMrefInfo(MleMediaRefInfoChunk *chunkData)
 
         if (getSwapRead())
 		{
-            chunkData->m_flags = mlDppSwapInt(chunkData->m_flags);
-            chunkData->m_type = mlDppSwapInt(chunkData->m_type);
-            chunkData->m_numMrefs = mlDppSwapInt(chunkData->m_numMrefs);
+            // Swap m_flags, m_type and m_numMrefs.
+            mlDppSwapIntArray((MlUInt *)chunkData,3);
         }
     }
 
@@ -372,9 +1172,85 @@ MlBoolean MleDppInput::readMrefInfo(MleMediaRefInfoChunk *chunkData)
 }
 
 
+MlBoolean MleDppInput::readMrefIndex(void)
+{
+    // Declare local variables.
+    MleDppChunkInfo indexInfo;
+    MlUInt size = sizeof(MleMediaRefIndexEntry) * m_mrefIndexSize;
+
+    memset(&indexInfo,0,sizeof(MleDppChunkInfo));
+
+    MLE_ERROR(mlDppDescend(getFp(),&indexInfo,NULL,0));
+    if ((indexInfo.m_chunk.m_tag == mlDppMakeTag('m','i','d','x')) &&
+        (indexInfo.m_chunk.m_size == size))
+	{
+        m_mrefIndex = (MleMediaRefIndexEntry *)mlMalloc(size > 0 ? size : 1);
+        if ((m_mrefIndex != NULL) &&
+            ((size == 0) || (mlFRead(m_mrefIndex,size,1,getFp()) == 1)))
+		{
+            if (getSwapRead())
+                mlDppSwapIntArray((MlUInt *)m_mrefIndex,3 * m_mrefIndexSize);
+            m_mrefIndexValid = TRUE;
+        } else
+            mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+    }
+
+    MLE_ERROR(mlDppAscend(getFp(),&indexInfo,0));
+    return(m_mrefIndexValid);
+}
+
+
+MlBoolean MleDppInput::buildMrefIndex(void)
+{
+    // Declare local variables.
+    MleDppChunkInfo mediaInfo;
+    MlUInt header[3];
+    long pos;
+    MlUInt i;
+
+    // A list without an 'midx' chunk is scanned once.
+    freeMrefIndex();
+    m_mrefIndex = (MleMediaRefIndexEntry *)mlMalloc(
+        sizeof(MleMediaRefIndexEntry) * (m_mrefIndexSize > 0 ? m_mrefIndexSize : 1));
+    if (m_mrefIndex == NULL)
+        return(FALSE);
+
+    pos = mlFTell(getFp());
+    goTo(m_mrefFirst);
+    for (i = 0; i < m_mrefIndexSize; i++)
+	{
+        memset(&mediaInfo,0,sizeof(MleDppChunkInfo));
+        if ((! descendChunk(&mediaInfo)) ||
+            (mediaInfo.m_chunk.m_tag != mlDppMakeTag('m','r','e','f')) ||
+            (mlFRead(header,sizeof(header),1,getFp()) != 1))
+            break;
+        if (getSwapRead())
+            mlDppSwapIntArray(header,3);
+
+        m_mrefIndex[i].m_offset = mediaInfo.m_offset - sizeof(MleDppChunk);
+        m_mrefIndex[i].m_label = header[1];
+        m_mrefIndex[i].m_size = header[2];
+        mlDppAscend(getFp(),&mediaInfo,0);
+    }
+    mlFSeek(getFp(),pos,SEEK_SET);
+
+    m_mrefIndexValid = (i == m_mrefIndexSize);
+    return(m_mrefIndexValid);
+}
+
+
+void MleDppInput::freeMrefIndex(void)
+{
+    if (m_mrefIndex != NULL)
+        mlFree(m_mrefIndex);
+    m_mrefIndex = NULL;
+    m_mrefIndexValid = FALSE;
+}
+
+
 #define MEDIAREF_CHUNK_SIZE (3 * sizeof(MlUInt))
 
-MlBoolean MleDppInput::readMref(MleMediaRefChunk *chunkData)
+MlBoolean MleDppInput::readMref(MleMediaRefChunk *chunkData,MleDppArena *arena)
 {
     // declare local variables.
     MleDppChunkInfo mediaInfo;
@@ -382,7 +1258,7 @@ MlBoolean MleDppInput::readMref(MleMediaRefChunk *chunkData)
 
     memset(&mediaInfo,0,sizeof(MleDppChunkInfo));
 
-    MLE_ERROR(mlDppDescend(getFp(),&mediaInfo,NULL,0));
+    MLE_ERROR(descendChunk(&mediaInfo));
     if (mediaInfo.m_chunk.m_tag == mlDppMakeTag('m','r','e','f'))
 	{
         // Read the 'mref' data.
@@ -391,19 +1267,24 @@ MlBoolean MleDppInput::readMref(MleMediaRefChunk *chunkData)
 
         if (getSwapRead())
 		{
-            chunkData->m_flags = mlDppSwapInt(chunkData->m_flags);
-            chunkData->m_type = mlDppSwapInt(chunkData->m_type);
-            chunkData->m_size = mlDppSwapInt(chunkData->m_size);
+            // Swap m_flags, m_type and m_size.
+            mlDppSwapIntArray((MlUInt *)chunkData,3);
         }
 
-        if (chunkData->m_flags == 0)
-            // External MediaRef; data is a filename.
-            chunkData->m_data = (char *)mlMalloc(chunkData->m_size + 1);
+        // External MediaRef; data is a filename and needs a terminator.
+        MlUInt allocSize = chunkData->m_size + ((chunkData->m_flags == 0) ? 1 : 0);
+        if (arena != NULL)
+            chunkData->m_data = (char *)arena->alloc(allocSize);
         else
-            chunkData->m_data = (char *)mlMalloc(chunkData->m_size);
-        nBytes = mlFRead(chunkData->m_data,chunkData->m_size,1,getFp());
+            chunkData->m_data = (char *)mlMalloc(allocSize);
+        if (chunkData->m_data == NULL)
+		{
+            mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+            status = FALSE;
+        } else
+            nBytes = mlFRead(chunkData->m_data,chunkData->m_size,1,getFp());
 
-        if (chunkData->m_flags == 0)
+        if ((chunkData->m_data != NULL) && (chunkData->m_flags == 0))
 		{
             // terminate filename
             chunkData->m_data[chunkData->m_size] = '\0';
@@ -416,6 +1297,121 @@ MlBoolean MleDppInput::readMref(MleMediaRefChunk *chunkData)
     return(status);
 }
 
+
+MlBoolean MleDppInput::openMedia(MleMediaRefStream *stream)
+{
+    // Declare local variables.
+    MleDppChunkInfo mediaInfo;
+    MleMediaRefChunk chunkData;
+    MlBoolean status = FALSE;
+
+    memset(&mediaInfo,0,sizeof(MleDppChunkInfo));
+
+    MLE_ERROR(descendChunk(&mediaInfo));
+    if (mediaInfo.m_chunk.m_tag == mlDppMakeTag('m','r','e','f'))
+	{
+        // Read the 'mref' header only.
+        if (mlFRead(&chunkData,MEDIAREF_CHUNK_SIZE,1,getFp()) == 1)
+		{
+            if (getSwapRead())
+                mlDppSwapIntArray((MlUInt *)&chunkData,3);
+
+            stream->init(getFp(),chunkData.m_flags,chunkData.m_type,
+                mediaInfo.m_offset + MEDIAREF_CHUNK_SIZE,chunkData.m_size);
+            status = TRUE;
+        } else
+            mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+    }
+
+    // Skip over the payload.
+    MLE_ERROR(mlDppAscend(getFp(),&mediaInfo,0));
+
+    return(status);
+}
+
+
+MlBoolean MleDppInput::openPackedMedia(MlUInt tocIndex,MlUInt ordinal,
+    MleMediaRefStream *stream)
+{
+    // Declare local variables.
+    MleDppChunkInfo packInfo;
+    MleMediaPackHeader header;
+    MleMediaPackEntry entry;
+    MlBoolean status = FALSE;
+    long pos;
+
+    if (tocIndex >= m_numTOCUsed)
+        return(FALSE);
+
+    memset(&packInfo,0,sizeof(MleDppChunkInfo));
+
+    pos = mlFTell(getFp());
+    goTo(lookupTOCOffset(tocIndex));
+    if (descendChunk(&packInfo) &&
+        (packInfo.m_chunk.m_tag == mlDppMakeTag('m','p','a','k')) &&
+        (mlFRead(&header,sizeof(MleMediaPackHeader),1,getFp()) == 1))
+	{
+        if (getSwapRead())
+            mlDppSwapIntArray((MlUInt *)&header,4);
+
+        // Read just the one table entry.
+        if ((ordinal < header.m_numMrefs) &&
+            (mlFSeek(getFp(),sizeof(MleMediaPackEntry) * ordinal,SEEK_CUR) == 0) &&
+            (mlFRead(&entry,sizeof(MleMediaPackEntry),1,getFp()) == 1))
+		{
+            if (getSwapRead())
+                mlDppSwapIntArray((MlUInt *)&entry,4);
+
+            stream->init(getFp(),entry.m_flags,entry.m_label,
+                packInfo.m_offset + entry.m_offset,entry.m_size);
+            traceAccess(tocIndex,entry.m_size);
+            status = TRUE;
+        }
+    }
+    if (! status)
+        mlSetErrno(MLE_DPP_ERR_CHUNKNOTFOUND);
+    mlFSeek(getFp(),pos,SEEK_SET);
+
+    return(status);
+}
+
+
+const void *MleDppInput::getPackedMedia(const void *pack,MlUInt ordinal,
+    MlUInt *size,MlDppTag *label)
+{
+    // Declare local variables.
+    const MleMediaPackHeader *header = (const MleMediaPackHeader *)pack;
+    const MleMediaPackEntry *entry;
+
+    if ((header == NULL) || (ordinal >= header->m_numMrefs))
+        return(NULL);
+
+    entry = (const MleMediaPackEntry *)(header + 1) + ordinal;
+    if (size != NULL)
+        *size = entry->m_size;
+    if (label != NULL)
+        *label = entry->m_label;
+
+    return((const MlByte *)pack + entry->m_offset);
+}
+
+
+MlBoolean MleDppInput::descendChunk(MleDppChunkInfo *info)
+{
+    // Declare local variables.
+    MlBoolean status;
+
+    status = mlDppDescend(getFp(),info,NULL,0);
+    while (status && (info->m_chunk.m_tag == MLE_PAD_TAG))
+	{
+        // Skip alignment filler.
+        mlDppAscend(getFp(),info,0);
+        status = mlDppDescend(getFp(),info,NULL,0);
+    }
+
+    return(status);
+}
+
 void *
 MleDppInput::operator new(size_t tSize)
 {
@@ -41,6 +41,7 @@
 // Include system header files.
 #include <sys/types.h>
 #include <time.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 
@@ -65,12 +66,344 @@ MleDppOutput::MleDppOutput(const char *filename)
 {
     // Initialize Playprint book keeping structures.
     memset(&m_mrefListInfo,0,sizeof(MleDppChunkInfo));
+
+    // Chunk de-duplication is off by default.
+    m_dedup = FALSE;
+    m_digests = NULL;
+    m_numDigests = 0;
+    m_numDigestsAlloc = 0;
+    m_dedupCount = 0;
+    m_dedupBytes = 0;
+
+    // Chunk payloads are only padded to even offsets by default.
+    m_alignment = 0;
+    m_packMedia = FALSE;
+    m_indexMedia = FALSE;
+    m_tocName = NULL;
+    m_chunkEntry = -1;
+
+    // Nothing is known about what chunks need until they are written.
+    m_needs = NULL;
+    m_setChunks = NULL;
+    m_numSetChunks = 0;
 }
 
 
 MleDppOutput::~MleDppOutput()
 {
-    // Do nothing extra.
+    if (m_digests)
+        mlFree(m_digests);
+
+    if (m_needs)
+	{
+        for (MlUInt i = 0; i < m_numTOCReserved; i++)
+		{
+            if (m_needs[i].m_needs)
+                mlFree(m_needs[i].m_needs);
+        }
+        mlFree(m_needs);
+    }
+    if (m_setChunks)
+        mlFree(m_setChunks);
+}
+
+
+// Size of the digest table allocation increment.
+#define DIGEST_ALLOC_INC 64
+
+// Size of the buffer used to compare chunk payloads against the Playprint.
+#define DIGEST_COMPARE_SIZE 4096
+
+// Compute the 32-bit FNV-1a hash of a chunk payload.
+static MlUInt _hashChunk(const MlByte *data, MlInt size)
+{
+    MlUInt hash = 2166136261U;
+
+    for (MlInt i = 0; i < size; i++)
+	{
+        hash ^= data[i];
+        hash *= 16777619U;
+    }
+
+    return(hash);
+}
+
+
+MlBoolean MleDppOutput::addChunkDigest(MlDppTag tag, MlUInt hash, MlInt size,
+    MlUInt offset)
+{
+    if (m_numDigests == m_numDigestsAlloc)
+	{
+        MleDppChunkDigest *digests = (MleDppChunkDigest *)mlRealloc(m_digests,
+            (m_numDigestsAlloc + DIGEST_ALLOC_INC) * sizeof(MleDppChunkDigest));
+        if (digests == NULL)
+            return(FALSE);
+        m_digests = digests;
+        m_numDigestsAlloc += DIGEST_ALLOC_INC;
+    }
+
+    m_digests[m_numDigests].m_tag = tag;
+    m_digests[m_numDigests].m_hash = hash;
+    m_digests[m_numDigests].m_size = size;
+    m_digests[m_numDigests].m_offset = offset;
+    m_numDigests++;
+
+    return(TRUE);
+}
+
+
+/*
+ * Look for a previously written chunk with the same tag and payload. A
+ * matching hash is confirmed by comparing the payload against the bytes
+ * already in the Playprint, so a hash collision can never alias two
+ * different chunks. The file position is restored before returning.
+ */
+MlBoolean MleDppOutput::findChunk(MlDppTag tag, MlUInt hash, const MlByte *data,
+    MlInt size, MlUInt *offset)
+{
+    // Declare local variables.
+    MlByte buffer[DIGEST_COMPARE_SIZE];
+    MlBoolean found = FALSE;
+    long position;
+
+    position = mlFTell(m_fp);
+
+    for (MlUInt i = 0; (i < m_numDigests) && (! found); i++)
+	{
+        if ((m_digests[i].m_tag != tag) || (m_digests[i].m_hash != hash) ||
+            (m_digests[i].m_size != (MlUInt)size))
+            continue;
+
+        // Compare the payload of the candidate chunk.
+        if (mlFSeek(m_fp,m_digests[i].m_offset + sizeof(MleDppChunk),SEEK_SET) != 0)
+            break;
+
+        MlInt compared = 0;
+        while (compared < size)
+		{
+            MlInt length = size - compared;
+            if (length > DIGEST_COMPARE_SIZE)
+                length = DIGEST_COMPARE_SIZE;
+            if (mlFRead(buffer,length,1,m_fp) != 1)
+                break;
+            if (memcmp(buffer,data + compared,length) != 0)
+                break;
+            compared += length;
+        }
+
+        if (compared == size)
+		{
+            *offset = m_digests[i].m_offset;
+            found = TRUE;
+        }
+    }
+
+    if (m_numDigests > 0)
+        mlFSeek(m_fp,position,SEEK_SET);
+
+    return(found);
+}
+
+
+MlBoolean MleDppOutput::setAlignment(MlUInt alignment)
+{
+    if ((alignment != 0) && (alignment != 16) &&
+        (alignment != 64) && (alignment != 4096))
+        return(FALSE);
+
+    m_alignment = alignment;
+    return(TRUE);
+}
+
+
+/*
+ * Get the number of bytes, filler chunk header included, that
+ * writePadding() would write at the current file position.
+ */
+MlUInt MleDppOutput::getPaddingSize(MlUInt skip, MlUInt alignment)
+{
+    // Declare local variables.
+    MlUInt dataStart,padSize;
+
+    if (alignment == 0)
+        alignment = m_alignment;
+    if (alignment == 0)
+        return(0);
+
+    // Determine where the aligned data would start without padding.
+    dataStart = mlFTell(m_fp) + sizeof(MleDppChunk) + skip;
+    padSize = (alignment - (dataStart % alignment)) % alignment;
+
+    // The filler needs room for its own chunk header.
+    if ((padSize != 0) && (padSize < sizeof(MleDppChunk)))
+        padSize += alignment;
+
+    return(padSize);
+}
+
+
+/*
+ * Write a 'pad ' filler chunk so that the data located "skip" bytes into
+ * the payload of the next chunk starts on an alignment boundary. Nothing
+ * is written if the data would already be aligned. Readers skip filler
+ * chunks, and TOC entries always refer to the chunk that follows them.
+ */
+MlBoolean MleDppOutput::writePadding(MlUInt skip, MlUInt alignment)
+{
+    // Declare local variables.
+    MleDppChunkInfo padInfo;
+    MlByte pad[256];
+    MlUInt padSize;
+
+    padSize = getPaddingSize(skip,alignment);
+    if (padSize == 0)
+        return(TRUE);
+    padSize -= sizeof(MleDppChunk);
+
+    memset(&padInfo,0,sizeof(MleDppChunkInfo));
+    padInfo.m_chunk.m_tag = MLE_PAD_TAG;
+    padInfo.m_chunk.m_size = padSize;
+    MLE_WARN(mlDppCreateChunk(m_fp,&padInfo,0));
+
+    memset(pad,0,sizeof(pad));
+    while (padSize > 0)
+	{
+        MlUInt length = (padSize > sizeof(pad)) ? sizeof(pad) : padSize;
+        if (mlFWrite(pad,length,1,m_fp) != 1)
+		{
+            mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+            return(FALSE);
+        }
+        padSize -= length;
+    }
+
+    return(mlDppAscend(m_fp,&padInfo,0));
+}
+
+
+/*
+ * Write a simple (non-LIST) chunk and add its TOC entry. The TOC offset is
+ * placed at the beginning of the chunk. When de-duplication is enabled and
+ * an identical chunk has already been written, nothing is written and the
+ * TOC entry aliases the earlier chunk.
+ */
+MlBoolean MleDppOutput::writeChunk(MlDppTag tag, const MlByte *data, MlInt size)
+{
+    // Declare local variables.
+    MleDppChunkInfo info;
+    MlUInt hash = 0;
+    MlUInt offset;
+
+    if (m_dedup)
+	{
+        hash = _hashChunk(data,size);
+        if (findChunk(tag,hash,data,size,&offset))
+		{
+            // Count the filler the chunk would have needed as well.
+            m_dedupCount++;
+            m_dedupBytes += getPaddingSize(0) + sizeof(MleDppChunk) +
+                            size + (size & 1);
+
+            // Fill in TOC entry.
+            setChunkEntry(tag,offset,size);
+            return(TRUE);
+        }
+    }
+
+    // Align the payload if requested.
+    if (! writePadding(0))
+        return(FALSE);
+
+    // Create the chunk structure.
+    memset(&info,0,sizeof(MleDppChunkInfo));
+    info.m_chunk.m_tag = tag;
+    info.m_chunk.m_size = size;
+    MLE_WARN(mlDppCreateChunk(m_fp,&info,0));
+
+    // Write out the chunk data.
+    if ((size > 0) && (mlFWrite(data,size,1,m_fp) != 1))
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        return(FALSE);
+    }
+
+    offset = info.m_offset - sizeof(MleDppChunk);
+    if (m_dedup)
+        addChunkDigest(tag,hash,size,offset);
+
+    /*
+     * Update the Playprint table of content if needed. This places
+     * the TOC offset at the beginning of the chunk.
+     */
+    setChunkEntry(tag,offset,size);
+
+    // The ascend will go back to the top, figure out the chunk\'s size,
+    // and write it into the header.
+    return(mlDppAscend(m_fp,&info,0));
+}
+
+
+/*
+ * Fill in the TOC entry of the chunk just written: the one reserved for
+ * it, if any, or a new one.
+ */
+MlBoolean MleDppOutput::setChunkEntry(MlDppTag tag, MlUInt offset, MlUInt size)
+{
+    if (! m_useTOC)
+        return(TRUE);
+
+    if (m_chunkEntry >= 0)
+        return(setTOCEntry(m_chunkEntry,m_tocName,tag,offset,size));
+    return(addTOCEntry(m_tocName,tag,offset,size));
+}
+
+
+// Payloads up to this size are buffered so they can be shared; larger
+// ones are copied straight from their file and are never deduplicated.
+#define STREAM_THRESHOLD (1024 * 1024)
+
+MlBoolean MleDppOutput::writeChunk(MlDppTag tag, FILE *src, MlUInt offset, MlInt size)
+{
+    // Declare local variables.
+    MleDppChunkInfo info;
+    MlByte *data;
+    MlBoolean status;
+
+    if (m_dedup && (size <= STREAM_THRESHOLD))
+	{
+        data = (MlByte *)mlMalloc(size > 0 ? size : 1);
+        if ((data == NULL) || (mlFSeek(src,offset,SEEK_SET) != 0) ||
+            ((size > 0) && (mlFRead(data,size,1,src) != 1)))
+		{
+            if (data != NULL)
+                mlFree(data);
+            mlSetErrno(MLE_DPP_ERR_CANNOTREAD);
+            return(FALSE);
+        }
+
+        status = writeChunk(tag,data,size);
+        mlFree(data);
+        return(status);
+    }
+
+    // Align the payload if requested.
+    if (! writePadding(0))
+        return(FALSE);
+
+    // Create the chunk structure.
+    memset(&info,0,sizeof(MleDppChunkInfo));
+    info.m_chunk.m_tag = tag;
+    info.m_chunk.m_size = size;
+    MLE_WARN(mlDppCreateChunk(m_fp,&info,0));
+
+    // Copy the payload without bringing it into memory.
+    if (! mlDppCopyFile(m_fp,src,offset,size))
+        return(FALSE);
+
+    // Fill in TOC entry.
+    setChunkEntry(tag,info.m_offset - sizeof(MleDppChunk),size);
+
+    return(mlDppAscend(m_fp,&info,0));
 }
 
 
@@ -82,6 +415,8 @@ MlBoolean MleDppOutput::writeHeader()
     // Write header chunk data.
     hdrData.m_version = MleDpp::PLAYPRINT_VERSION;
     hdrData.m_date = time(NULL);
+    hdrData.m_alignment = m_alignment;
+    hdrData.m_contentHash = 0;
 
     return(MleDpp::writeHeader(&hdrData));
 }
@@ -91,10 +426,6 @@ MlBoolean MleDppOutput::writeGroup(MleDppChunkTable *table, MlInt groupIndex)
 {
     int i;
 
-    // Create group chunk info structure.
-    MleDppChunkInfo groupInfo;
-    memset(&groupInfo,0,sizeof(MleDppChunkInfo));
-
     // Open group chunk file and resolve media references.
     MlBoolean isLittle = getSwapWrite();
 #if BYTE_ORDER == LITTLE_ENDIAN
@@ -110,6 +441,7 @@ MlBoolean MleDppOutput::writeGroup(MleDppChunkTable *table, MlInt groupIndex)
     printf("Found %d media refs in group chunk file %s\n", numberOfMediaRefsInCurrentChunkFile, table->getFilename(groupIndex));
 #endif
     MlInt *indices = NULL;
+    int mrefcount = 0;
     if (numberOfMediaRefsInCurrentChunkFile > 0)
     {
 		indices = (int *) mlMalloc(numberOfMediaRefsInCurrentChunkFile * sizeof(MlInt));
@@ -122,7 +454,6 @@ MlBoolean MleDppOutput::writeGroup(MleDppChunkTable *table, MlInt groupIndex)
 		while (nextRefName = groupChunk->nextName(nextRefName));
 		nextRefName = namesOfMediaRefsInThisChunkFile;
 
-		int mrefcount = 0;
 		do
 		    for (i=0; i < numberOfChunkFiles; i++)
 			{
@@ -140,40 +471,42 @@ MlBoolean MleDppOutput::writeGroup(MleDppChunkTable *table, MlInt groupIndex)
     MlInt size;
     resolvedChunk = groupChunk->resolveNames(&size, indices);
 
-    // Create 'grp ' chunk structure.
-    groupInfo.m_chunk.m_tag = mlDppMakeTag('g','r','p',' ');
-    groupInfo.m_chunk.m_size = size;
-    MLE_WARN(mlDppCreateChunk(m_fp,&groupInfo,0));
-
-    // Write out 'grp ' data.
-    if (mlFWrite(resolvedChunk,size,1,m_fp) != 1)
-	{
-        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
-        return(FALSE);
+    // Reserve the TOC entry first, so that if the chunk cannot be written
+    // later indexes do not shift. The group needs the media that was found,
+    // the first mrefcount indices, and the sets its actors are placed in;
+    // names with no chunk are left at 0 only for resolveNames().
+    MlInt tocIndex = reserveTOCEntry();
+    MlInt numSets = groupChunk->countSets();
+    const MlInt *sets = groupChunk->getSets();
+    MlInt *needs = (MlInt *) mlMalloc((numberOfMediaRefsInCurrentChunkFile + numSets + 1) * sizeof(MlInt));
+    MlInt numNeeds = 0;
+    for (i = 0; i < mrefcount; i++)
+        needs[numNeeds++] = indices[i];
+    for (i = 0; i < numSets; i++)
+    {
+        if ((sets[i] >= 0) && (sets[i] < m_numSetChunks) && (m_setChunks[sets[i]] >= 0))
+            needs[numNeeds++] = m_setChunks[sets[i]];
     }
+    if (tocIndex >= 0)
+        addNeeds(tocIndex, needs, numNeeds, FALSE);
+    mlFree(needs);
+
+    // Write 'grp ' chunk, named after its chunk table entry.
+    m_tocName = table->getName(groupIndex);
+    m_chunkEntry = tocIndex;
+    MlBoolean status = writeChunk(mlDppMakeTag('g','r','p',' '),resolvedChunk,size);
+    m_chunkEntry = -1;
+    m_tocName = NULL;
 
     //delete (unsigned char *) resolvedChunk;
 	mlFree((void *)resolvedChunk);
 
-    /*
-     * Update the Playprint table of content if needed. This places
-     * the TOC offset at the beginning of the 'grp' chunk.
-     */
-    if (m_useTOC)
-        // Add TOC entry.
-        addTOCEntry(0, // XXX ignored for now (was label)
-                    groupInfo.m_offset - sizeof(MleDppChunk));
-
-    return(mlDppAscend(m_fp,&groupInfo,0));
+    return(status);
 }
 
 
 MlBoolean MleDppOutput::writeScene(MleDppChunkTable *table, MlInt sceneIndex)
 {
-    // Create scene chunk info structure.
-    MleDppChunkInfo sceneInfo;
-    memset(&sceneInfo,0,sizeof(MleDppChunkInfo));
-
     // Open scene chunk file .
     MleDppSceneChunk *sceneChunk =
         new MleDppSceneChunk(table->getFilename(sceneIndex),getSwapWrite());
@@ -183,30 +516,68 @@ MlBoolean MleDppOutput::writeScene(MleDppChunkTable *table, MlInt sceneIndex)
     MlInt size;
     resolvedChunk = sceneChunk->loadChunk(&size);
 
-    // Create 'scn ' chunk structure.
-    sceneInfo.m_chunk.m_tag = mlDppMakeTag('s','c','n',' ');
-    sceneInfo.m_chunk.m_size = size;
-    MLE_WARN(mlDppCreateChunk(m_fp,&sceneInfo,0));
+    // Reserve the TOC entry first, so that if the chunk cannot be written
+    // later indexes do not shift. The scene needs the groups it names.
+    MlInt tocIndex = reserveTOCEntry();
+    MlInt numberOfGroups = sceneChunk->countNames();
+    if (numberOfGroups > 0)
+    {
+        MlInt *needs = (MlInt *) mlMalloc(numberOfGroups * sizeof(MlInt));
+        MlInt numNeeds = 0;
+        for (const char *nextGroupName = sceneChunk->getNames();
+             nextGroupName != NULL;
+             nextGroupName = sceneChunk->nextName(nextGroupName))
+        {
+            for (MlInt i = 0; i < numberOfChunkFiles; i++)
+            {
+                if ((table->getType(i) == CHUNK_GROUP) &&
+                    (strcmp(table->getName(i), nextGroupName) == 0))
+                {
+                    needs[numNeeds++] = i;
+                    break;
+                }
+            }
+        }
+        if (tocIndex >= 0)
+            addNeeds(tocIndex, needs, numNeeds, TRUE);
+        mlFree(needs);
+    } else if (tocIndex >= 0)
+        addNeeds(tocIndex, NULL, 0, TRUE);
+
+    // Write 'scn ' chunk, named after its chunk table entry.
+    m_tocName = table->getName(sceneIndex);
+    m_chunkEntry = tocIndex;
+    MlBoolean status = writeChunk(mlDppMakeTag('s','c','n',' '),resolvedChunk,size);
+    m_chunkEntry = -1;
+    m_tocName = NULL;
 
-    // Write out 'scn ' data
-    if (mlFWrite(resolvedChunk,size,1,m_fp) != 1)
-	{
-        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
-        return(FALSE);
-    }
+    return(status);
+}
 
-    /*
-     * Update the Playprint table of content if needed. This places
-     * the TOC offset at the beginning of the 'scn' chunk.
-     */
-    if (m_useTOC)
-        // Add TOC entry.
-        addTOCEntry(0, // XXX ignored for now (was label)
-                    sceneInfo.m_offset - sizeof(MleDppChunk));
 
-    // The ascend will go back to the top, figure out the chunk\'s size,
-    // and write it into the header.
-    return(mlDppAscend(m_fp,&sceneInfo,0));
+MlBoolean MleDppOutput::writeMedia(MleDppChunkTable *table, MlInt mediaIndex)
+{
+    // Declare local variables.
+    MlBoolean status;
+
+    m_tocName = table->getName(mediaIndex);
+    status = writeMedia(table->getFilename(mediaIndex));
+    m_tocName = NULL;
+
+    return(status);
+}
+
+
+MlBoolean MleDppOutput::writeSet(MleDppChunkTable *table, MlInt setIndex)
+{
+    // Declare local variables.
+    MlBoolean status;
+
+    m_tocName = table->getName(setIndex);
+    status = writeSet(table->getFilename(setIndex));
+    m_tocName = NULL;
+
+    return(status);
 }
 
 
@@ -217,6 +588,10 @@ MlBoolean MleDppOutput::writeMedia(char *chunkFilename)
     MleChunkFileHeader hdrData;
     MleMediaRefInfoChunk inMrefInfoData,outMrefInfoData;
     MleMediaRefChunk mrefData;
+    MleMediaRefStream mrefStream;
+    MleMediaRefIndexEntry *index;
+    MlUInt indexOffset = 0,numMrefs;
+    MlBoolean status = TRUE;
 
     // Prepare the MediaRef Chunk File for reading.
     in = new MleMrefChunkFile(chunkFilename,MleMrefChunkFile::READING);
@@ -238,46 +613,114 @@ MlBoolean MleDppOutput::writeMedia(char *chunkFilename)
     in->readHeader(&hdrData);
     in->beginList();
 
-    // Begin IFF 'MRFL' LIST chunk.
-    beginMrefList();
-
     // Read IFF 'info' chunk.
     in->readInfo(&inMrefInfoData);
 
+    // Reserve the TOC entry of the media before writing it, so that if
+    // it cannot be written later indexes do not shift.
+    m_chunkEntry = reserveTOCEntry();
+
+    if (m_packMedia)
+	{
+        // Write IFF 'mpak' chunk instead of a list.
+        status = writeMediaPack(in,&inMrefInfoData);
+        m_chunkEntry = -1;
+
+        in->endList();
+        in->end();
+        delete in;
+        return(status);
+    }
+
+    // Begin IFF 'MRFL' LIST chunk.
+    beginMrefList();
+
     memcpy(&outMrefInfoData,&inMrefInfoData,sizeof(MleMediaRefInfoChunk));
+    numMrefs = inMrefInfoData.m_numMrefs;
+    if (m_indexMedia)
+        outMrefInfoData.m_flags |= MLE_MREF_INFO_INDEXED;
+    else
+        outMrefInfoData.m_flags &= ~MLE_MREF_INFO_INDEXED;
 
     // Write IFF 'info' chunk.
     writeMrefInfo(&outMrefInfoData);
 
-    for (MlUInt i = 0; i < inMrefInfoData.m_numMrefs; i++)
+    // Reserve IFF 'midx' chunk; it is filled in once the offsets are known.
+    index = (MleMediaRefIndexEntry *)mlMalloc(
+        sizeof(MleMediaRefIndexEntry) * (numMrefs > 0 ? numMrefs : 1));
+    if (index == NULL)
 	{
-        // Read IFF 'mref' chunk.
-        in->readData(&mrefData);
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        status = FALSE;
+        numMrefs = 0;
+    } else
+        memset(index,0,sizeof(MleMediaRefIndexEntry) * numMrefs);
+    if (status && m_indexMedia)
+        status = writeMrefIndex(index,numMrefs,&indexOffset);
+
+    for (MlUInt i = 0; status && (i < numMrefs); i++)
+	{
+        // Locate IFF 'mref' chunk; its payload is not read into memory.
+        if (! in->openData(&mrefStream))
+		{
+            status = FALSE;
+            break;
+        }
+
+        // Copy IFF 'mref' chunk.
+        mrefData.m_flags = mrefStream.getFlags();
+        mrefData.m_type = mrefStream.getType();
+        mrefData.m_size = mrefStream.getSize();
+        mrefData.m_data = NULL;
+        index[i].m_size = mrefData.m_size;
+        index[i].m_label = mrefData.m_type;
+        status = writeMref(&mrefData,in->getFp(),mrefStream.getOffset(),
+                           &index[i].m_offset);
+    }
 
-        // Write IFF 'mref' chunk.
-        writeMref(&mrefData);
+    // Fill in IFF 'midx' chunk.
+    if (status && m_indexMedia)
+	{
+        long endOffset = mlFTell(getFp());
+        if (getSwapWrite())
+            mlDppSwapIntArray((MlUInt *)index,3 * numMrefs);
+        if ((mlFSeek(getFp(),indexOffset,SEEK_SET) != 0) ||
+            ((numMrefs > 0) &&
+             (mlFWrite(index,sizeof(MleMediaRefIndexEntry) * numMrefs,1,getFp()) != 1)) ||
+            (mlFSeek(getFp(),endOffset,SEEK_SET) != 0))
+		{
+            mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+            status = FALSE;
+        }
     }
+    if (index != NULL)
+        mlFree(index);
 
     // End IFF 'MRFL' LIST chunk.
     endMrefList();
+    m_chunkEntry = -1;
 
     // Close MediaRef Chunk File.
     in->endList();
     in->end();
     delete in;
 
-    return(TRUE);
+    return(status);
 }
 
 
 MlBoolean
 MleDppOutput::writeSet(char *chunkFilename)
 {
-    MlByte *ppSetChunk;
     MlInt size, ppSetChunkLength;
     struct stat fileStat;
     FILE *setChunkFilePtr;
-    MleDppChunkInfo setChunkInfo;
+
+    /*
+     * Reserve the TOC entry first, so that if the chunk cannot be
+     * written later indexes do not shift.
+     */
+    MlInt tocIndex = reserveTOCEntry();
 
     /*
      * Stat the set chunk file.
@@ -311,24 +754,12 @@ MleDppOutput::writeSet(char *chunkFilename)
 			   chunkFilename, fileStat.st_size);
 #endif
 
-    /*
-     * Allocate a buffer to store the set chunk that is going
-     * into the playprint.  Note we don't need the first four bytes
-     * which contain the size of this set chunk file.
-     */
-    ppSetChunkLength = fileStat.st_size - 4;
-    ppSetChunk = new MlByte[ppSetChunkLength];
-    memset(ppSetChunk, 0, ppSetChunkLength);
-
     /*
      * Read the first four bytes in the set chunk file (contains the
-     * file the size).  Read in the rest of set chunk file and close it
-     * after finish reading.
+     * file the size). We don't copy them into the playprint.
      */
     size_t nBytes;
     nBytes = mlFRead(&size, 4, 1, setChunkFilePtr);
-    nBytes = mlFRead(ppSetChunk, ppSetChunkLength, 1, setChunkFilePtr);
-    mlFClose(setChunkFilePtr);
 
     /*
      * The size from stat should agree with the size read in from the
@@ -337,32 +768,17 @@ MleDppOutput::writeSet(char *chunkFilename)
     MLE_ASSERT(size == fileStat.st_size);
 
     /*
-     * Initialize 'frm' (set) chunk structure for the playprint and
-     * write out the set chunk into the playprint.
+     * Copy the rest of the set chunk file into the playprint and close
+     * it after finishing.
      */
-    memset(&setChunkInfo, 0, sizeof(MleDppChunkInfo));
-    setChunkInfo.m_chunk.m_tag = mlDppMakeTag('s', 'e', 't', ' ');
-    setChunkInfo.m_chunk.m_size = ppSetChunkLength;
-
-    MLE_WARN(mlDppCreateChunk(m_fp, &setChunkInfo, 0));
-
-    if (mlFWrite(ppSetChunk, ppSetChunkLength, 1, m_fp) != 1)
-	{
-		mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
-		return(FALSE);
-    }
-
-    /*
-     * Update the Playprint table of content if needed. This places
-     * the TOC offset at the beginning of the 'frm' chunk.
-     */
-    if (m_useTOC)
-        addTOCEntry(0, // XXX ignored for now (wsa label).
-	            setChunkInfo.m_offset - sizeof(MleDppChunk));
-
-    delete [] ppSetChunk;
+    ppSetChunkLength = fileStat.st_size - 4;
+    m_chunkEntry = tocIndex;
+    MlBoolean status = writeChunk(mlDppMakeTag('s', 'e', 't', ' '),
+        setChunkFilePtr, 4, ppSetChunkLength);
+    m_chunkEntry = -1;
+    mlFClose(setChunkFilePtr);
 
-    return(mlDppAscend(m_fp, &setChunkInfo, 0));
+    return(status);
 }
 
 
@@ -374,21 +790,28 @@ MlBoolean MleDppOutput::beginMrefList(void)
     m_mrefListInfo.m_form = mlDppMakeTag('M','R','F','L');
     status = mlDppCreateChunk(getFp(),&m_mrefListInfo,MLE_DPP_CREATELIST);
 
-    /*
-     * Update the Playprint table of content if needed. This places
-     * the TOC offset at the beginning of the 'MRFL' LIST chunk.
-     */
-    if (status && m_useTOC)
-        addTOCEntry(0, // XXX ignored for now (wsa label).
-	            m_mrefListInfo.m_offset - sizeof(MleDppChunk) - 4);
-
     return(status);
 }
 
 
 MlBoolean MleDppOutput::endMrefList(void)
 {
-    return(mlDppAscend(getFp(),&m_mrefListInfo,0));
+    // Declare local variables.
+    MlBoolean status;
+
+    status = mlDppAscend(getFp(),&m_mrefListInfo,0);
+
+    /*
+     * Update the Playprint table of content if needed. This places
+     * the TOC offset at the beginning of the 'MRFL' LIST chunk; the
+     * entry is filled in here, once the size of the list is known.
+     */
+    if (status)
+        setChunkEntry(m_mrefListInfo.m_form,
+                      m_mrefListInfo.m_offset - sizeof(MleDppChunk) - 4,
+                      m_mrefListInfo.m_chunk.m_size);
+
+    return(status);
 }
 
 
@@ -406,9 +829,8 @@ MlBoolean MleDppOutput::writeMrefInfo(MleMediaRefInfoChunk *chunkData)
 
     if (getSwapWrite())
 	{
-        chunkData->m_flags = mlDppSwapInt(chunkData->m_flags);
-        chunkData->m_type = mlDppSwapInt(chunkData->m_type);
-        chunkData->m_numMrefs = mlDppSwapInt(chunkData->m_numMrefs);
+        // Swap m_flags, m_type and m_numMrefs.
+        mlDppSwapIntArray((MlUInt *)chunkData,3);
     }
 
     // Write out 'mref' data.
@@ -422,39 +844,203 @@ MlBoolean MleDppOutput::writeMrefInfo(MleMediaRefInfoChunk *chunkData)
 }
 
 
+MlBoolean MleDppOutput::writeMrefIndex(MleMediaRefIndexEntry *entries,
+    MlUInt numEntries,MlUInt *offset)
+{
+    // Declare local variables.
+    MleDppChunkInfo indexInfo;
+    MlUInt size = sizeof(MleMediaRefIndexEntry) * numEntries;
+
+    memset(&indexInfo,0,sizeof(MleDppChunkInfo));
+
+    // Create 'midx' chunk structure.
+    indexInfo.m_chunk.m_tag = mlDppMakeTag('m','i','d','x');
+    indexInfo.m_chunk.m_size = size;
+    MLE_WARN(mlDppCreateChunk(getFp(),&indexInfo,0));
+    *offset = indexInfo.m_offset;
+
+    // Write out the entries as given; the caller rewrites them in place.
+    if ((size > 0) && (mlFWrite(entries,size,1,getFp()) != 1))
+    {
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        return(FALSE);
+    }
+
+    return(mlDppAscend(getFp(),&indexInfo,0));
+}
+
+
 #define MEDIAREF_CHUNK_SIZE (3 * sizeof(MlUInt))
 
-MlBoolean MleDppOutput::writeMref(MleMediaRefChunk *chunkData)
+// Alignment of packed media when no chunk alignment is set.
+#define MEDIA_PACK_ALIGNMENT 16
+
+#define ALIGN_UP(value,alignment) \
+    ((((value) + (alignment) - 1) / (alignment)) * (alignment))
+
+MlBoolean MleDppOutput::writeMediaPack(MleMrefChunkFile *in,MleMediaRefInfoChunk *info)
 {
     // Declare local variables.
-    MleDppChunkInfo mediaInfo;
-    int size;
+    MleDppChunkInfo packInfo;
+    MleMediaPackHeader header;
+    MleMediaPackEntry *table;
+    MleMediaRefStream *streams;
+    MlUInt numMrefs = info->m_numMrefs;
+    MlUInt alignment = m_alignment ? m_alignment : MEDIA_PACK_ALIGNMENT;
+    MlUInt tableSize,size,written,i;
+    MlByte pad[256];
+    MlBoolean status = TRUE;
+
+    table = (MleMediaPackEntry *)mlMalloc(
+        sizeof(MleMediaPackEntry) * (numMrefs > 0 ? numMrefs : 1));
+    streams = new MleMediaRefStream[numMrefs > 0 ? numMrefs : 1];
+    if ((table == NULL) || (streams == NULL))
+	{
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        status = FALSE;
+    }
 
-    memset(&mediaInfo,0,sizeof(MleDppChunkInfo));
+    // Lay out the payloads after the table; only their headers are read.
+    tableSize = sizeof(MleMediaPackHeader) + sizeof(MleMediaPackEntry) * numMrefs;
+    size = ALIGN_UP(tableSize,alignment);
+    for (i = 0; status && (i < numMrefs); i++)
+	{
+        if (! in->openData(&streams[i]))
+		{
+            status = FALSE;
+            break;
+        }
+        table[i].m_flags = streams[i].getFlags();
+        table[i].m_label = streams[i].getType();
+        table[i].m_offset = size;
+        table[i].m_size = streams[i].getSize();
+        size = ALIGN_UP(size + table[i].m_size,alignment);
+    }
 
-    // Create 'mref' chunk structure.
-    mediaInfo.m_chunk.m_tag = mlDppMakeTag('m','r','e','f');
-    mediaInfo.m_chunk.m_size = chunkData->m_size + MEDIAREF_CHUNK_SIZE;
-    MLE_WARN(mlDppCreateChunk(getFp(),&mediaInfo,0));
+    // The chunk data, and so every payload, starts on an aligned offset.
+    if (status)
+        status = writePadding(0,alignment);
+
+    if (status)
+	{
+        memset(&packInfo,0,sizeof(MleDppChunkInfo));
+        packInfo.m_chunk.m_tag = mlDppMakeTag('m','p','a','k');
+        packInfo.m_chunk.m_size = size;
+        MLE_WARN(mlDppCreateChunk(m_fp,&packInfo,0));
+
+        header.m_flags = info->m_flags;
+        header.m_type = info->m_type;
+        header.m_numMrefs = numMrefs;
+        header.m_alignment = alignment;
+        if (getSwapWrite())
+		{
+            mlDppSwapIntArray((MlUInt *)&header,4);
+            mlDppSwapIntArray((MlUInt *)table,4 * numMrefs);
+        }
+
+        if ((mlFWrite(&header,sizeof(MleMediaPackHeader),1,m_fp) != 1) ||
+            ((numMrefs > 0) &&
+             (mlFWrite(table,sizeof(MleMediaPackEntry) * numMrefs,1,m_fp) != 1)))
+		{
+            mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+            status = FALSE;
+        }
+    }
+
+    // Copy each payload to its aligned offset.
+    memset(pad,0,sizeof(pad));
+    written = tableSize;
+    for (i = 0; status && (i <= numMrefs); i++)
+	{
+        MlUInt next = (i < numMrefs) ? streams[i].getOffset() : 0;
+        MlUInt target = (i < numMrefs) ? ALIGN_UP(written,alignment) : size;
+
+        while (status && (written < target))
+		{
+            MlUInt length = target - written;
+            if (length > sizeof(pad))
+                length = sizeof(pad);
+            if (mlFWrite(pad,length,1,m_fp) != 1)
+			{
+                mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+                status = FALSE;
+            }
+            written += length;
+        }
+
+        if (status && (i < numMrefs))
+		{
+            status = mlDppCopyFile(m_fp,in->getFp(),next,streams[i].getSize());
+            written += streams[i].getSize();
+        }
+    }
+
+    if (status)
+	{
+        status = mlDppAscend(m_fp,&packInfo,0);
+
+        if (status)
+            // Fill in TOC entry.
+            setChunkEntry(packInfo.m_chunk.m_tag,
+                          packInfo.m_offset - sizeof(MleDppChunk),
+                          packInfo.m_chunk.m_size);
+    }
+
+    if (table != NULL)
+        mlFree(table);
+    if (streams != NULL)
+        delete [] streams;
 
-    // Remember actual size to write.
-    size = chunkData->m_size;
+    return(status);
+}
+
+MlBoolean MleDppOutput::beginMref(MleMediaRefChunk *chunkData,MleDppChunkInfo *mediaInfo)
+{
+    // Declare local variables.
+    MleDppChunkInfo *info = mediaInfo;
+    MlUInt header[3];
+
+    memset(info,0,sizeof(MleDppChunkInfo));
 
+    // Align the media data, which follows the mref header, if requested.
+    if (! writePadding(MEDIAREF_CHUNK_SIZE))
+        return(FALSE);
+
+    // Create 'mref' chunk structure.
+    info->m_chunk.m_tag = mlDppMakeTag('m','r','e','f');
+    info->m_chunk.m_size = chunkData->m_size + MEDIAREF_CHUNK_SIZE;
+    MLE_WARN(mlDppCreateChunk(getFp(),info,0));
+
+    header[0] = chunkData->m_flags;
+    header[1] = chunkData->m_type;
+    header[2] = chunkData->m_size;
     if (getSwapWrite())
 	{
-        chunkData->m_flags = mlDppSwapInt(chunkData->m_flags);
-        chunkData->m_type = mlDppSwapInt(chunkData->m_type);
-        chunkData->m_size = mlDppSwapInt(chunkData->m_size);
+        // Swap m_flags, m_type and m_size.
+        mlDppSwapIntArray(header,3);
     }
 
-    // Write out 'mref' data.
-    if (mlFWrite(chunkData,MEDIAREF_CHUNK_SIZE,1,getFp()) != 1)
+    // Write out 'mref' header.
+    if (mlFWrite(header,MEDIAREF_CHUNK_SIZE,1,getFp()) != 1)
     {
         mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
         return(FALSE);
     }
 
-    if (mlFWrite(chunkData->m_data,size,1,getFp()) != 1)
+    return(TRUE);
+}
+
+
+MlBoolean MleDppOutput::writeMref(MleMediaRefChunk *chunkData)
+{
+    // Declare local variables.
+    MleDppChunkInfo mediaInfo;
+
+    if (! beginMref(chunkData,&mediaInfo))
+        return(FALSE);
+
+    // Write out 'mref' data.
+    if (mlFWrite(chunkData->m_data,chunkData->m_size,1,getFp()) != 1)
     {
         mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
         return(FALSE);
@@ -463,6 +1049,284 @@ MlBoolean MleDppOutput::writeMref(MleMediaRefChunk *chunkData)
     return(mlDppAscend(getFp(),&mediaInfo,0));
 }
 
+
+MlBoolean MleDppOutput::writeMref(MleMediaRefChunk *chunkData,FILE *src,MlUInt offset,
+    MlUInt *chunkOffset)
+{
+    // Declare local variables.
+    MleDppChunkInfo mediaInfo;
+
+    if (! beginMref(chunkData,&mediaInfo))
+        return(FALSE);
+    if (chunkOffset != NULL)
+        *chunkOffset = mediaInfo.m_offset - sizeof(MleDppChunk);
+
+    // Copy the 'mref' data straight from the source file.
+    if (! mlDppCopyFile(getFp(),src,offset,chunkData->m_size))
+        return(FALSE);
+
+    return(mlDppAscend(getFp(),&mediaInfo,0));
+}
+
+MlBoolean MleDppOutput::addNeeds(MlUInt tocIndex, const MlInt *needs, MlInt num,
+                                 MlBoolean isScene)
+{
+    if (tocIndex >= m_numTOCReserved)
+        return(FALSE);
+
+    if (m_needs == NULL)
+    {
+        m_needs = (MleDppChunkNeeds *) mlMalloc(m_numTOCReserved * sizeof(MleDppChunkNeeds));
+        if (m_needs == NULL)
+            return(FALSE);
+        memset(m_needs, 0, m_numTOCReserved * sizeof(MleDppChunkNeeds));
+    }
+
+    MleDppChunkNeeds *entry = &m_needs[tocIndex];
+    if (entry->m_needs)
+        mlFree(entry->m_needs);
+    entry->m_needs = NULL;
+    entry->m_numNeeds = 0;
+    entry->m_isScene = isScene;
+
+    if (num > 0)
+    {
+        entry->m_needs = (MlUInt *) mlMalloc(num * sizeof(MlUInt));
+        for (MlInt i = 0; i < num; i++)
+        {
+            // Drop references outside the TOC.
+            if ((needs[i] >= 0) && ((MlUInt) needs[i] < m_numTOCReserved))
+                entry->m_needs[entry->m_numNeeds++] = needs[i];
+        }
+    }
+
+    return(TRUE);
+}
+
+
+void MleDppOutput::setSetChunks(const MlInt *chunks, MlInt num)
+{
+    if (m_setChunks)
+        mlFree(m_setChunks);
+    m_setChunks = NULL;
+    m_numSetChunks = 0;
+
+    if ((chunks != NULL) && (num > 0))
+    {
+        m_setChunks = (MlInt *) mlMalloc(num * sizeof(MlInt));
+        memcpy(m_setChunks, chunks, num * sizeof(MlInt));
+        m_numSetChunks = num;
+    }
+}
+
+
+// Chunks this close together are read as one range.
+#define MANIFEST_RANGE_GAP 4096
+
+static int _compareRanges(const void *a, const void *b)
+{
+    MlUInt aOffset = ((const MleDppManifestRange *) a)->m_offset;
+    MlUInt bOffset = ((const MleDppManifestRange *) b)->m_offset;
+    return((aOffset < bOffset) ? -1 : ((aOffset > bOffset) ? 1 : 0));
+}
+
+/*
+ * Walk everything a scene reaches through the recorded needs, the scene
+ * included, and return how many chunks that is. Chunks reached are marked
+ * with the stamp, which must differ from walk to walk, and stored in
+ * entries if it is given.
+ */
+static MlUInt _walkNeeds(const MleDppChunkNeeds *needs, MlUInt numChunks,
+    MlUInt scene, MlUInt stamp, MlUInt *marks, MlUInt *stack, MlUInt *entries)
+{
+    // Declare local variables.
+    MlUInt depth = 0, count = 0;
+
+    marks[scene] = stamp;
+    stack[depth++] = scene;
+    while (depth > 0)
+    {
+        MlUInt next = stack[--depth];
+        if (entries != NULL)
+            entries[count] = next;
+        count++;
+
+        for (MlUInt j = 0; j < needs[next].m_numNeeds; j++)
+        {
+            MlUInt need = needs[next].m_needs[j];
+            if ((need < numChunks) && (marks[need] != stamp))
+            {
+                marks[need] = stamp;
+                stack[depth++] = need;
+            }
+        }
+    }
+
+    return(count);
+}
+
+MlBoolean MleDppOutput::writeManifest(void)
+{
+    // Declare local variables.
+    MleDppChunkInfo manifestInfo;
+    MleDppManifestHeader header;
+    MleDppManifestScene *scenes = NULL;
+    MlUInt *entries = NULL, *stack = NULL, *marks = NULL;
+    MleDppManifestRange *ranges = NULL, *sceneRanges;
+    MlUInt numScenes = 0, numEntries = 0, numRanges = 0;
+    MlUInt maxEntries = ((MlUInt) ~0) / sizeof(MleDppManifestRange);
+    MlUInt i, j, count, stamp = 0;
+    MlBoolean status = TRUE;
+
+    if (! m_useTOC || (m_needs == NULL))
+        // Nothing recorded; there are no scenes to describe.
+        return(TRUE);
+
+    for (i = 0; i < m_numTOCUsed; i++)
+    {
+        if (m_needs[i].m_isScene)
+            numScenes++;
+    }
+    if (numScenes == 0)
+        return(TRUE);
+
+    // A chunk is marked with the stamp of the walk that last reached it.
+    scenes = (MleDppManifestScene *) mlMalloc(numScenes * sizeof(MleDppManifestScene));
+    stack = (MlUInt *) mlMalloc(m_numTOCUsed * sizeof(MlUInt));
+    marks = (MlUInt *) mlMalloc(m_numTOCUsed * sizeof(MlUInt));
+    if (! scenes || ! stack || ! marks)
+    {
+        status = FALSE;
+        goto done;
+    }
+    memset(marks, 0, m_numTOCUsed * sizeof(MlUInt));
+
+    // Size the entries by what the scenes actually reach; each scene has
+    // at most a range per entry.
+    for (i = 0; i < m_numTOCUsed; i++)
+    {
+        if (! m_needs[i].m_isScene)
+            continue;
+
+        count = _walkNeeds(m_needs, m_numTOCUsed, i, ++stamp, marks, stack, NULL);
+        if (count > maxEntries - numEntries)
+        {
+            status = FALSE;
+            goto done;
+        }
+        numEntries += count;
+    }
+
+    entries = (MlUInt *) mlMalloc(numEntries * sizeof(MlUInt));
+    ranges = (MleDppManifestRange *) mlMalloc(numEntries * sizeof(MleDppManifestRange));
+    if (! entries || ! ranges)
+    {
+        status = FALSE;
+        goto done;
+    }
+
+    numScenes = 0;
+    numEntries = 0;
+    for (i = 0; i < m_numTOCUsed; i++)
+    {
+        if (! m_needs[i].m_isScene)
+            continue;
+
+        // Walk everything reachable from the scene, the scene included.
+        MleDppManifestScene *scene = &scenes[numScenes++];
+        scene->m_scene = i;
+        scene->m_firstEntry = numEntries;
+        scene->m_firstRange = numRanges;
+        scene->m_numEntries = _walkNeeds(m_needs, m_numTOCUsed, i, ++stamp,
+                                         marks, stack, &entries[numEntries]);
+        numEntries += scene->m_numEntries;
+
+        // Find where each chunk lies in the playprint. Chunks that could
+        // not be written have no place in it.
+        sceneRanges = &ranges[numRanges];
+        count = 0;
+        for (j = 0; j < scene->m_numEntries; j++)
+        {
+            MlUInt offset, size;
+            MlDppTag type;
+            if (! getTOCEntry(entries[scene->m_firstEntry + j], &offset, &size, &type) ||
+                (offset == 0))
+                continue;
+
+            // A LIST's size does not cover its form tag.
+            size += sizeof(MleDppChunk) + (size & 1);
+            if (type == mlDppMakeTag('M','R','F','L'))
+                size += sizeof(MlDppTag);
+            sceneRanges[count].m_offset = offset;
+            sceneRanges[count].m_size = size;
+            count++;
+        }
+
+        // Merge neighbouring chunks into as few reads as reasonable.
+        qsort(sceneRanges, count, sizeof(MleDppManifestRange), _compareRanges);
+        MlUInt merged = 0;
+        for (j = 0; j < count; j++)
+        {
+            if (merged > 0)
+            {
+                MleDppManifestRange *last = &sceneRanges[merged - 1];
+                MlUInt lastEnd = last->m_offset + last->m_size;
+                if (sceneRanges[j].m_offset <= lastEnd + MANIFEST_RANGE_GAP)
+                {
+                    MlUInt end = sceneRanges[j].m_offset + sceneRanges[j].m_size;
+                    if (end > lastEnd)
+                        last->m_size = end - last->m_offset;
+                    continue;
+                }
+            }
+            sceneRanges[merged++] = sceneRanges[j];
+        }
+        scene->m_numRanges = merged;
+        numRanges += merged;
+    }
+
+    header.m_numScenes = numScenes;
+    header.m_numEntries = numEntries;
+    header.m_numRanges = numRanges;
+    if (getSwapWrite())
+    {
+        mlDppSwapIntArray((MlUInt *) &header, sizeof(header) / sizeof(MlUInt));
+        mlDppSwapIntArray((MlUInt *) scenes, numScenes * sizeof(MleDppManifestScene) / sizeof(MlUInt));
+        mlDppSwapIntArray(entries, numEntries);
+        mlDppSwapIntArray((MlUInt *) ranges, numRanges * sizeof(MleDppManifestRange) / sizeof(MlUInt));
+    }
+
+    // Write the 'mfst' chunk; it is found through the TOC index, not the TOC.
+    memset(&manifestInfo, 0, sizeof(MleDppChunkInfo));
+    manifestInfo.m_chunk.m_tag = mlDppMakeTag('m','f','s','t');
+    if (! mlDppCreateChunk(m_fp, &manifestInfo, 0))
+    {
+        status = FALSE;
+        goto done;
+    }
+    if ((mlFWrite(&header, sizeof(header), 1, m_fp) != 1) ||
+        (mlFWrite(scenes, sizeof(MleDppManifestScene), numScenes, m_fp) != numScenes) ||
+        (mlFWrite(entries, sizeof(MlUInt), numEntries, m_fp) != numEntries) ||
+        (mlFWrite(ranges, sizeof(MleDppManifestRange), numRanges, m_fp) != numRanges))
+    {
+        mlSetErrno(MLE_DPP_ERR_CANNOTWRITE);
+        status = FALSE;
+        goto done;
+    }
+    status = mlDppAscend(m_fp, &manifestInfo, 0);
+    m_manifestOffset = manifestInfo.m_offset - sizeof(MleDppChunk);
+    m_manifestSize = manifestInfo.m_chunk.m_size;
+
+done:
+    if (scenes) mlFree(scenes);
+    if (entries) mlFree(entries);
+    if (ranges) mlFree(ranges);
+    if (stack) mlFree(stack);
+    if (marks) mlFree(marks);
+
+    return(status);
+}
+
 void *
 MleDppOutput::operator new(size_t tSize)
 {
@@ -0,0 +1,306 @@
+/**
+ * @file ppswap.c
+ * @ingroup MleDPPMaster
+ *
+ * Magic Lantern Digital Playprint Library API - bulk byte swapping.
+ */
+
+// COPYRIGHT_BEGIN
+//
+// Copyright (c) 2015-2025 Wizzer Works
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//  For information concerning this source file, contact Mark S. Millard,
+//  of Wizzer Works at msm@wizzerworks.com.
+//
+//  More information concerning Wizzer Works may be found at
+//
+//      http://www.wizzerworks.com
+//
+// COPYRIGHT_END
+
+/* Include system header files. */
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MLE_DPP_SWAP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define MLE_DPP_SWAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* Include Magic Lantern header files. */
+#include "mle/playprnt.h"
+
+
+#if !defined(MLE_RUNTIME)
+
+/*
+ * The vector kernels swap as many whole 16 or 32 byte blocks as they can
+ * and return the number of bytes processed; the remaining elements are
+ * swapped with the scalar routines. Unaligned data is fine.
+ */
+typedef MlUInt (*_MleDppSwapKernel)(MlByte *data,MlUInt numBytes,MlUInt width);
+
+static MlUInt _swapNone(MlByte *data,MlUInt numBytes,MlUInt width)
+{
+    (void)data;
+    (void)numBytes;
+    (void)width;
+
+    return(0);
+}
+
+#if defined(MLE_DPP_SWAP_X86)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MLE_DPP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MLE_DPP_TARGET(isa)
+#endif
+
+/* Byte shuffle masks for 16, 32 and 64-bit elements, one 128-bit lane each. */
+static const MlByte _swapMask[3][16] =
+{
+    { 1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14 },
+    { 3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12 },
+    { 7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8 }
+};
+
+static const MlByte *_getSwapMask(MlUInt width)
+{
+    return(_swapMask[(width == 2) ? 0 : ((width == 4) ? 1 : 2)]);
+}
+
+MLE_DPP_TARGET("ssse3")
+static MlUInt _swapSSSE3(MlByte *data,MlUInt numBytes,MlUInt width)
+{
+    /* Declare local variables. */
+    __m128i mask = _mm_loadu_si128((const __m128i *)_getSwapMask(width));
+    MlUInt done = 0;
+
+    while (numBytes - done >= 16)
+	{
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + done));
+        _mm_storeu_si128((__m128i *)(data + done),_mm_shuffle_epi8(v,mask));
+        done += 16;
+    }
+
+    return(done);
+}
+
+MLE_DPP_TARGET("avx2")
+static MlUInt _swapAVX2(MlByte *data,MlUInt numBytes,MlUInt width)
+{
+    /* Declare local variables. */
+    __m128i lane = _mm_loadu_si128((const __m128i *)_getSwapMask(width));
+    __m256i mask = _mm256_broadcastsi128_si256(lane);
+    MlUInt done = 0;
+
+    while (numBytes - done >= 32)
+	{
+        __m256i v = _mm256_loadu_si256((const __m256i *)(data + done));
+        _mm256_storeu_si256((__m256i *)(data + done),_mm256_shuffle_epi8(v,mask));
+        done += 32;
+    }
+
+    /* Finish with one 128-bit block, if there is one left. */
+    if (numBytes - done >= 16)
+	{
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + done));
+        _mm_storeu_si128((__m128i *)(data + done),_mm_shuffle_epi8(v,lane));
+        done += 16;
+    }
+
+    return(done);
+}
+
+static _MleDppSwapKernel _selectSwapKernel(void)
+{
+#if defined(_MSC_VER)
+    /* Declare local variables. */
+    int info[4];
+    MlBoolean ssse3,avx2 = FALSE;
+
+    __cpuid(info,1);
+    ssse3 = (info[2] & (1 << 9)) != 0;
+    if (((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0) &&
+        ((_xgetbv(0) & 0x6) == 0x6))
+	{
+        /* AVX state is enabled by the OS; check for AVX2. */
+        __cpuidex(info,7,0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+
+    if (avx2)
+        return(_swapAVX2);
+    if (ssse3)
+        return(_swapSSSE3);
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return(_swapAVX2);
+    if (__builtin_cpu_supports("ssse3"))
+        return(_swapSSSE3);
+#endif
+
+    return(_swapNone);
+}
+
+#elif defined(MLE_DPP_SWAP_NEON)
+
+static MlUInt _swapNEON(MlByte *data,MlUInt numBytes,MlUInt width)
+{
+    /* Declare local variables. */
+    MlUInt done = 0;
+
+    while (numBytes - done >= 16)
+	{
+        uint8x16_t v = vld1q_u8(data + done);
+        if (width == 2)
+            v = vrev16q_u8(v);
+        else if (width == 4)
+            v = vrev32q_u8(v);
+        else
+            v = vrev64q_u8(v);
+        vst1q_u8(data + done,v);
+        done += 16;
+    }
+
+    return(done);
+}
+
+static _MleDppSwapKernel _selectSwapKernel(void)
+{
+    /* NEON is always present where this is compiled. */
+    return(_swapNEON);
+}
+
+#else
+
+static _MleDppSwapKernel _selectSwapKernel(void)
+{
+    return(_swapNone);
+}
+
+#endif /* MLE_DPP_SWAP_X86 */
+
+
+/*
+ * The kernel is chosen once, on first use. Concurrent first calls may each
+ * select it, but they always store the same value.
+ */
+static _MleDppSwapKernel _swapKernel = NULL;
+
+static MlUInt _swapBlocks(void *data,MlUInt numBytes,MlUInt width)
+{
+    if (_swapKernel == NULL)
+        _swapKernel = _selectSwapKernel();
+
+    return(_swapKernel((MlByte *)data,numBytes,width));
+}
+
+
+void mlDppSwapShortArray(MlUShort *data,MlUInt count)
+{
+    /* Declare local variables. */
+    MlUInt i;
+
+    i = _swapBlocks(data,count * sizeof(MlUShort),sizeof(MlUShort)) / sizeof(MlUShort);
+    for (; i < count; i++)
+        data[i] = mlDppSwapShort(data[i]);
+}
+
+
+void mlDppSwapIntArray(MlUInt *data,MlUInt count)
+{
+    /* Declare local variables. */
+    MlUInt i;
+
+    i = _swapBlocks(data,count * sizeof(MlUInt),sizeof(MlUInt)) / sizeof(MlUInt);
+    for (; i < count; i++)
+        data[i] = mlDppSwapInt(data[i]);
+}
+
+
+void mlDppSwapLongArray(MlULong *data,MlUInt count)
+{
+    /* Declare local variables. */
+    MlUInt i;
+
+    i = _swapBlocks(data,count * sizeof(MlULong),sizeof(MlULong)) / sizeof(MlULong);
+    for (; i < count; i++)
+        data[i] = mlDppSwapLong(data[i]);
+}
+
+#endif /* MLE_RUNTIME */
+
+
+#ifdef UNIT_TEST
+
+/* Include system header files. */
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_COUNT 67
+
+int main(int argc,char *argv[])
+{
+    /* Declare local variables. */
+    MlUShort shorts[TEST_COUNT];
+    MlUInt ints[TEST_COUNT];
+    MlULong longs[TEST_COUNT];
+    int i,status = 0;
+
+    (void)argc;
+    (void)argv;
+
+    for (i = 0; i < TEST_COUNT; i++)
+	{
+        shorts[i] = (MlUShort)(0x0102 + i);
+        ints[i] = 0x01020304 + i;
+        longs[i] = 0x0102030405060708ULL + i;
+    }
+
+    /* Start at an odd element so the vector loads are unaligned. */
+    mlDppSwapShortArray(&shorts[1],TEST_COUNT - 1);
+    mlDppSwapIntArray(&ints[1],TEST_COUNT - 1);
+    mlDppSwapLongArray(&longs[1],TEST_COUNT - 1);
+
+    for (i = 1; i < TEST_COUNT; i++)
+	{
+        if ((shorts[i] != mlDppSwapShort((MlUShort)(0x0102 + i))) ||
+            (ints[i] != mlDppSwapInt(0x01020304 + i)) ||
+            (longs[i] != mlDppSwapLong(0x0102030405060708ULL + i)))
+		{
+            fprintf(stderr,"Bulk swap test failed at element %d!\n",i);
+            status = 1;
+            break;
+        }
+    }
+
+    if (status == 0)
+        fprintf(stdout,"Bulk swap test passed.\n");
+    return(status);
+}
+
+#endif /* UNIT_TEST */
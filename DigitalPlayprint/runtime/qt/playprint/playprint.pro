@@ -20,24 +20,44 @@ INCLUDEPATH += $$PWD/../../common/include $$PWD/../../linux/include /opt/MagicLa
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    $$PWD/../../common/src/agarray.cxx \
+    $$PWD/../../common/src/agblock.cxx \
     $$PWD/../../common/src/agchk.cxx \
+    $$PWD/../../common/src/agdecode.cxx \
+    $$PWD/../../common/src/agdir.cxx \
+    $$PWD/../../common/src/aghints.cxx \
+    $$PWD/../../common/src/agpool.cxx \
     $$PWD/../../common/src/chkfile.cxx \
     $$PWD/../../common/src/chktable.cxx \
     $$PWD/../../common/src/mrefchk.cxx \
+    $$PWD/../../common/src/mrefstrm.cxx \
     $$PWD/../../common/src/playprnt.c \
     $$PWD/../../common/src/pp.cxx \
+    $$PWD/../../common/src/pparena.cxx \
+    $$PWD/../../common/src/ppcache.cxx \
+    $$PWD/../../common/src/ppcopy.c \
     $$PWD/../../common/src/ppinput.cxx \
     $$PWD/../../common/src/ppoutput.cxx \
+    $$PWD/../../common/src/ppswap.c \
     $$PWD/../../common/src/scenechk.cxx
 
 HEADERS += \
+    $$PWD/../../common/include/mle/agarray.h \
+    $$PWD/../../common/include/mle/agblock.h \
     $$PWD/../../common/include/mle/agchk.h \
+    $$PWD/../../common/include/mle/agdecode.h \
+    $$PWD/../../common/include/mle/agdir.h \
+    $$PWD/../../common/include/mle/aghints.h \
+    $$PWD/../../common/include/mle/agpool.h \
     $$PWD/../../common/include/mle/chkfile.h \
     $$PWD/../../common/include/mle/chktable.h \
     $$PWD/../../common/include/mle/chunk.h \
     $$PWD/../../common/include/mle/mrefchk.h \
+    $$PWD/../../common/include/mle/mrefstrm.h \
     $$PWD/../../common/include/mle/playprnt.h \
     $$PWD/../../common/include/mle/pp.h \
+    $$PWD/../../common/include/mle/pparena.h \
+    $$PWD/../../common/include/mle/ppcache.h \
     $$PWD/../../common/include/mle/ppinput.h \
     $$PWD/../../common/include/mle/ppoutput.h \
     $$PWD/../../common/include/mle/scenechk.h